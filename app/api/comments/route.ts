@@ -1,5 +1,5 @@
 import { NextRequest, NextResponse } from 'next/server';
-import { requireAuth, requireWorkspaceAccess } from '@/lib/api-helpers';
+import { getUserSummaries, requireAuth, requireWorkspaceAccess } from '@/lib/api-helpers';
 import { prisma } from '@/lib/db';
 
 export async function GET(request: NextRequest) {
@@ -25,21 +25,13 @@ export async function GET(request: NextRequest) {
     // Check workspace access
     await requireWorkspaceAccess(node.workspaceId, false);
 
-    // Get comments with user info
-    const comments = await prisma.comment.findMany({
+    // Thread in (nodeId, createdAt) index order; authors in one batched lookup
+    const rows = await prisma.comment.findMany({
       where: { nodeId },
-      include: {
-        user: {
-          select: {
-            id: true,
-            email: true,
-            name: true,
-            avatarUrl: true,
-          },
-        },
-      },
-      orderBy: { createdAt: 'asc' },
+      orderBy: [{ createdAt: 'asc' }, { id: 'asc' }],
     });
+    const users = await getUserSummaries(rows.map((row) => row.userId));
+    const comments = rows.map((row) => ({ ...row, user: users.get(row.userId) ?? null }));
 
     return NextResponse.json({ comments }, { status: 200 });
   } catch (error: any) {
@@ -1,8 +1,11 @@
 import { NextRequest, NextResponse } from 'next/server';
 import { requireWorkspaceAccess } from '@/lib/api-helpers';
 import { prisma } from '@/lib/db';
+import { traceRoute } from '@/lib/tracing';
 
-export async function POST(request: NextRequest) {
+export const POST = traceRoute('POST /api/edges', createEdge);
+
+async function createEdge(request: NextRequest) {
   try {
     const body = await request.json();
     const { workspaceId, source, target, label, similarity } = body;
@@ -79,7 +82,9 @@ export async function POST(request: NextRequest) {
   }
 }
 
-export async function DELETE(request: NextRequest) {
+export const DELETE = traceRoute('DELETE /api/edges', deleteEdge);
+
+async function deleteEdge(request: NextRequest) {
   try {
     const { searchParams } = new URL(request.url);
     const edgeId = searchParams.get('edgeId');
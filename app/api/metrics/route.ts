@@ -0,0 +1,19 @@
+import { NextRequest, NextResponse } from 'next/server';
+import { getLatencyMetrics } from '@/lib/tracing';
+
+// GET /api/metrics - p50/p95/p99 latency per traced route and per span name for this
+// server instance. Requires `Authorization: Bearer $METRICS_TOKEN`; disabled when unset.
+export async function GET(request: NextRequest) {
+  const token = process.env.METRICS_TOKEN;
+  if (!token) {
+    return NextResponse.json({ error: 'Not found' }, { status: 404 });
+  }
+  if (request.headers.get('authorization') !== `Bearer ${token}`) {
+    return NextResponse.json({ error: 'Unauthorized' }, { status: 401 });
+  }
+
+  return NextResponse.json(getLatencyMetrics(), {
+    status: 200,
+    headers: { 'Cache-Control': 'no-store' },
+  });
+}
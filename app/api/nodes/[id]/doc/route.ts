@@ -0,0 +1,103 @@
+import { NextRequest, NextResponse } from 'next/server';
+import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import { prisma } from '@/lib/db';
+import { publishDocUpdate } from '@/lib/collabHub';
+import {
+  MAX_NODE_DOC_UPDATE_BYTES,
+  appendNodeDocumentUpdate,
+  getNodeDocument,
+  isValidNodeDocUpdate,
+} from '@/lib/nodeDocuments';
+
+// GET /api/nodes/[id]/doc?sv=<base64 state vector> - the node's Yjs document as a binary
+// update (only the part missing from `sv` when given). X-Doc-Epoch identifies the document;
+// 409 when the node has no rich text content
+export async function GET(
+  request: NextRequest,
+  { params }: { params: Promise<{ id: string }> }
+) {
+  try {
+    const { id: nodeId } = await params;
+
+    const node = await prisma.node.findUnique({
+      where: { id: nodeId },
+      select: { id: true, workspaceId: true, content: true },
+    });
+    if (!node) {
+      return NextResponse.json({ error: 'Node not found' }, { status: 404 });
+    }
+
+    await requireWorkspaceAccess(node.workspaceId, false);
+
+    const sv = request.nextUrl.searchParams.get('sv');
+    const document = await getNodeDocument(node, sv ? Buffer.from(sv, 'base64') : undefined);
+    if (!document) {
+      return NextResponse.json({ error: 'Node has no rich text content' }, { status: 409 });
+    }
+
+    return new Response(Buffer.from(document.update), {
+      status: 200,
+      headers: {
+        'Content-Type': 'application/octet-stream',
+        'Cache-Control': 'no-store',
+        'X-Doc-Epoch': document.epoch,
+      },
+    });
+  } catch (error: any) {
+    console.error('Error loading node document:', error);
+    if (error.message === 'Unauthorized' || error.message?.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+    return NextResponse.json({ error: 'Failed to load node document' }, { status: 500 });
+  }
+}
+
+// POST /api/nodes/[id]/doc - append one binary Yjs update (body) to the document named by
+// X-Doc-Epoch and relay it to the workspace's other editors. X-Collab-Client is the sender's
+// collaboration channel id, so it can skip the echo. 409 means the document was rebuilt:
+// reload it
+export async function POST(
+  request: NextRequest,
+  { params }: { params: Promise<{ id: string }> }
+) {
+  try {
+    const { id: nodeId } = await params;
+    const epoch = request.headers.get('x-doc-epoch');
+    const from = request.headers.get('x-collab-client') || '';
+
+    if (!epoch) {
+      return NextResponse.json({ error: 'Missing X-Doc-Epoch header' }, { status: 400 });
+    }
+
+    const node = await prisma.node.findUnique({
+      where: { id: nodeId },
+      select: { workspaceId: true },
+    });
+    if (!node) {
+      return NextResponse.json({ error: 'Node not found' }, { status: 404 });
+    }
+
+    const { user } = await requireWorkspaceAccess(node.workspaceId, true);
+
+    const update = new Uint8Array(await request.arrayBuffer());
+    if (update.byteLength > MAX_NODE_DOC_UPDATE_BYTES) {
+      return NextResponse.json({ error: 'Update too large' }, { status: 413 });
+    }
+    if (!isValidNodeDocUpdate(update)) {
+      return NextResponse.json({ error: 'Invalid document update' }, { status: 400 });
+    }
+
+    if (!(await appendNodeDocumentUpdate(nodeId, epoch, update, user.id))) {
+      return NextResponse.json({ error: 'Document was reset' }, { status: 409 });
+    }
+
+    publishDocUpdate(node.workspaceId, from, nodeId, update);
+    return new Response(null, { status: 204 });
+  } catch (error: any) {
+    console.error('Error applying node document update:', error);
+    if (error.message === 'Unauthorized' || error.message?.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+    return NextResponse.json({ error: 'Failed to apply document update' }, { status: 500 });
+  }
+}
@@ -0,0 +1,54 @@
+import { NextRequest, NextResponse } from 'next/server';
+import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import { prisma } from '@/lib/db';
+import { getNodeRevision } from '@/lib/nodeRevisions';
+
+// GET /api/nodes/[id]/history/[revision] - title, content and tags of one revision
+export async function GET(
+  request: NextRequest,
+  { params }: { params: Promise<{ id: string; revision: string }> }
+) {
+  try {
+    const { id: nodeId, revision } = await params;
+    const revisionNumber = Number(revision);
+    if (!Number.isInteger(revisionNumber)) {
+      return NextResponse.json({ error: 'Invalid revision' }, { status: 400 });
+    }
+
+    const node = await prisma.node.findUnique({
+      where: { id: nodeId },
+      select: { workspaceId: true },
+    });
+    if (!node) {
+      return NextResponse.json({ error: 'Node not found' }, { status: 404 });
+    }
+
+    await requireWorkspaceAccess(node.workspaceId, false);
+
+    const found = await getNodeRevision(nodeId, revisionNumber);
+    if (!found) {
+      return NextResponse.json({ error: 'Revision not found' }, { status: 404 });
+    }
+
+    return NextResponse.json({
+      revision: {
+        revision: found.revision,
+        keyframe: found.keyframe,
+        createdBy: found.createdBy,
+        createdAt: found.createdAt.toISOString(),
+        ...found.snapshot,
+      },
+    }, { status: 200 });
+  } catch (error: any) {
+    console.error('Error in node revision API:', error);
+
+    if (error.message === 'Unauthorized' || error.message.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+
+    return NextResponse.json(
+      { error: error.message || 'Internal server error' },
+      { status: 500 }
+    );
+  }
+}
@@ -0,0 +1,53 @@
+import { NextRequest, NextResponse } from 'next/server';
+import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import { prisma } from '@/lib/db';
+import { listNodeRevisions } from '@/lib/nodeRevisions';
+
+// GET /api/nodes/[id]/history?before=<revision>&limit=<n>
+// One page of revisions, newest first (metadata only - GET .../history/[revision] rebuilds
+// the content of one). Pass nextCursor back as `before` for the next page.
+export async function GET(
+  request: NextRequest,
+  { params }: { params: Promise<{ id: string }> }
+) {
+  try {
+    const { id: nodeId } = await params;
+    const { searchParams } = new URL(request.url);
+    const before = searchParams.get('before');
+    const limit = searchParams.get('limit');
+
+    const node = await prisma.node.findUnique({
+      where: { id: nodeId },
+      select: { workspaceId: true },
+    });
+    if (!node) {
+      return NextResponse.json({ error: 'Node not found' }, { status: 404 });
+    }
+
+    await requireWorkspaceAccess(node.workspaceId, false);
+
+    const page = await listNodeRevisions(nodeId, {
+      before: before !== null && Number.isFinite(Number(before)) ? Number(before) : undefined,
+      limit: limit !== null && Number.isFinite(Number(limit)) ? Number(limit) : undefined,
+    });
+
+    return NextResponse.json({
+      revisions: page.revisions.map((revision) => ({
+        ...revision,
+        createdAt: revision.createdAt.toISOString(),
+      })),
+      nextCursor: page.nextCursor,
+    }, { status: 200 });
+  } catch (error: any) {
+    console.error('Error in node history API:', error);
+
+    if (error.message === 'Unauthorized' || error.message.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+
+    return NextResponse.json(
+      { error: error.message || 'Internal server error' },
+      { status: 500 }
+    );
+  }
+}
@@ -1,8 +1,11 @@
 import { NextRequest, NextResponse } from 'next/server';
 import { requireWorkspaceAccess } from '@/lib/api-helpers';
 import { prisma } from '@/lib/db';
+import { traceRoute } from '@/lib/tracing';
 
-export async function GET(
+export const GET = traceRoute('GET /api/nodes/[id]', getNode);
+
+async function getNode(
   request: NextRequest,
   { params }: { params: Promise<{ id: string }> }
 ) {
@@ -42,7 +45,9 @@ export async function GET(
   }
 }
 
-export async function DELETE(
+export const DELETE = traceRoute('DELETE /api/nodes/[id]', deleteNode);
+
+async function deleteNode(
   request: NextRequest,
   { params }: { params: Promise<{ id: string }> }
 ) {
@@ -0,0 +1,139 @@
+import { NextRequest, NextResponse } from 'next/server';
+import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import { Prisma } from '@prisma/client';
+import { prisma } from '@/lib/db';
+import { traceRoute } from '@/lib/tracing';
+
+// Upper bound on updates per request - clients split larger flushes into several batches
+const MAX_BATCH_SIZE = 1000;
+
+interface BatchNodeUpdate {
+  nodeId: string;
+  x?: number;
+  y?: number;
+  zIndex?: number;
+}
+
+function isFiniteNumber(value: unknown): value is number {
+  return typeof value === 'number' && Number.isFinite(value);
+}
+
+// Batch position/layer update - used by the client-side update queue in lib/performance.ts
+// Applies all updates in one transaction with a single workspace access check,
+// instead of one PUT /api/nodes/update (findUnique + access check + write) per node
+export const PUT = traceRoute('PUT /api/nodes/batch', updateNodesBatch);
+
+async function updateNodesBatch(request: NextRequest) {
+  try {
+    let body;
+    try {
+      body = await request.json();
+    } catch (parseError: any) {
+      console.error('[API] Failed to parse batch request body:', parseError?.message);
+      return NextResponse.json(
+        { error: 'Invalid JSON in request body' },
+        { status: 400 }
+      );
+    }
+
+    const { workspaceId, updates } = body;
+
+    if (!workspaceId || !Array.isArray(updates)) {
+      return NextResponse.json(
+        { error: 'Missing workspaceId or updates' },
+        { status: 400 }
+      );
+    }
+
+    if (updates.length > MAX_BATCH_SIZE) {
+      return NextResponse.json(
+        { error: `Too many updates in one batch (max ${MAX_BATCH_SIZE})` },
+        { status: 400 }
+      );
+    }
+
+    // Validate and merge duplicate entries for the same node (last write wins per field)
+    const merged = new Map<string, BatchNodeUpdate>();
+    for (const update of updates as BatchNodeUpdate[]) {
+      if (!update || typeof update.nodeId !== 'string') continue;
+
+      const entry = merged.get(update.nodeId) || { nodeId: update.nodeId };
+      if (isFiniteNumber(update.x)) entry.x = update.x;
+      if (isFiniteNumber(update.y)) entry.y = update.y;
+      if (isFiniteNumber(update.zIndex)) entry.zIndex = Math.round(update.zIndex);
+      merged.set(update.nodeId, entry);
+    }
+
+    if (merged.size === 0) {
+      return NextResponse.json({ updated: 0 }, { status: 200 });
+    }
+
+    // Single access check for the whole batch
+    await requireWorkspaceAccess(workspaceId, true);
+
+    const entries = Array.from(merged.values());
+
+    const moves = entries.filter((e) => e.x !== undefined || e.y !== undefined);
+    const layers = entries.filter((e) => e.zIndex !== undefined);
+
+    // One statement per kind; the workspace_id condition scopes the writes without a separate
+    // ownership read, so ids from other workspaces are silently ignored. zIndex lives in
+    // content.nodeMetadata and is set in place with jsonb inside the same transaction, so a
+    // content edit committed meanwhile can't be overwritten with a stale copy
+    const updated = await prisma.$transaction(async (tx) => {
+      const ids = new Set<string>();
+      if (moves.length > 0) {
+        const rows = moves.map(
+          (e) => Prisma.sql`(${e.nodeId}, ${e.x ?? null}::float8, ${e.y ?? null}::float8)`
+        );
+        const moved = await tx.$queryRaw<{ id: string }[]>`
+          UPDATE nodes AS n
+          SET x = COALESCE(v.x, n.x), y = COALESCE(v.y, n.y), updated_at = NOW()
+          FROM (VALUES ${Prisma.join(rows)}) AS v(id, x, y)
+          WHERE n.id = v.id AND n.workspace_id = ${workspaceId}
+          RETURNING n.id
+        `;
+        moved.forEach((row) => ids.add(row.id));
+      }
+      if (layers.length > 0) {
+        const rows = layers.map((e) => Prisma.sql`(${e.nodeId}, ${e.zIndex}::int)`);
+        const layered = await tx.$queryRaw<{ id: string }[]>`
+          UPDATE nodes AS n
+          SET content = CASE WHEN jsonb_typeof(n.content) = 'object' THEN n.content ELSE '{}'::jsonb END
+                || jsonb_build_object(
+                  'nodeMetadata',
+                  CASE WHEN jsonb_typeof(n.content->'nodeMetadata') = 'object'
+                    THEN n.content->'nodeMetadata' ELSE '{}'::jsonb END
+                  || jsonb_build_object('zIndex', v.z_index)
+                ),
+              updated_at = NOW()
+          FROM (VALUES ${Prisma.join(rows)}) AS v(id, z_index)
+          WHERE n.id = v.id AND n.workspace_id = ${workspaceId}
+          RETURNING n.id
+        `;
+        layered.forEach((row) => ids.add(row.id));
+      }
+      return ids.size;
+    });
+
+    return NextResponse.json({ updated }, { status: 200 });
+  } catch (error: any) {
+    console.error('[API] Error in batch node update API:', {
+      message: error?.message,
+      code: error?.code,
+      meta: error?.meta,
+    });
+
+    if (error.message === 'Unauthorized' || error.message.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+
+    return NextResponse.json(
+      {
+        error: error.message || 'Internal server error',
+        details: process.env.NODE_ENV === 'development' ? error.stack : undefined,
+      },
+      { status: 500 }
+    );
+  }
+}
@@ -3,10 +3,14 @@ import { prisma } from '@/lib/db';
 import { generateId } from '@/lib/utils';
 import { generateEmbedding } from '@/lib/ai';
 import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import { storeNodeEmbeddings } from '@/lib/db-server';
+import { traceRoute } from '@/lib/tracing';
 
 // Legacy route - redirects to /api/nodes/create
 // Kept for backward compatibility with old Canvas.tsx component
-export async function POST(request: NextRequest) {
+export const POST = traceRoute('POST /api/nodes', createNodeWithEmbedding);
+
+async function createNodeWithEmbedding(request: NextRequest) {
   try {
     const body = await request.json();
     const { workspaceId, title, content, x, y, tags } = body;
@@ -42,21 +46,9 @@ export async function POST(request: NextRequest) {
       },
     });
 
-    // Update embedding using raw SQL (pgvector) - OPTIONAL, skip silently if column doesn't exist
+    // Store embedding (pgvector) - OPTIONAL, skipped if the column doesn't exist
     if (embedding && embedding.length > 0 && process.env.OPENAI_API_KEY) {
-      try {
-        // Only try to update embedding if OPENAI_API_KEY is set
-        const vectorText = `[${embedding.join(',')}]`;
-        await prisma.$executeRaw`
-          UPDATE nodes
-          SET embedding = ${vectorText}::vector
-          WHERE id = ${newNode.id}::uuid
-        `.catch(() => {
-          // Silently fail if embedding column doesn't exist
-        });
-      } catch (embeddingError: any) {
-        // Silently skip embedding update if it fails
-      }
+      await storeNodeEmbeddings([{ id: newNode.id, embedding }]);
     }
 
     return NextResponse.json({
@@ -1,9 +1,29 @@
 import { NextRequest, NextResponse } from 'next/server';
 import { requireWorkspaceAccess } from '@/lib/api-helpers';
 import { prisma } from '@/lib/db';
-import { searchNodes } from '@/lib/search';
+import { searchWorkspaceNodes } from '@/lib/searchIndex';
+import { traceRoute } from '@/lib/tracing';
 
-export async function GET(request: NextRequest) {
+function serializeSearchNode(n: any) {
+  return {
+    id: n.id,
+    workspaceId: n.workspaceId,
+    title: n.title,
+    content: n.content,
+    tags: n.tags,
+    x: n.x,
+    y: n.y,
+    createdAt: n.createdAt.toISOString(),
+    updatedAt: n.updatedAt.toISOString(),
+  };
+}
+
+// GET /api/nodes/search?q=&workspaceId=&tags=&dateFrom=&dateTo=&limit=&offset=&semantic=
+// With q: hybrid ranked search over the Postgres search index (lib/searchIndex.ts)
+// Filters only: newest matching nodes first. Both paginate with offset / nextOffset
+export const GET = traceRoute('GET /api/nodes/search', searchNodes);
+
+async function searchNodes(request: NextRequest) {
   try {
     const { searchParams } = new URL(request.url);
     const query = searchParams.get('q');
@@ -11,7 +31,9 @@ export async function GET(request: NextRequest) {
     const tags = searchParams.get('tags')?.split(',');
     const dateFrom = searchParams.get('dateFrom');
     const dateTo = searchParams.get('dateTo');
-    const limit = parseInt(searchParams.get('limit') || '50');
+    const limit = Math.min(Math.max(parseInt(searchParams.get('limit') || '50') || 50, 1), 100);
+    const offset = Math.max(parseInt(searchParams.get('offset') || '0') || 0, 0);
+    const semantic = searchParams.get('semantic') !== 'false';
 
     if (!query && !tags && !dateFrom && !dateTo) {
       return NextResponse.json({ error: 'Missing search parameters' }, { status: 400 });
@@ -24,87 +46,69 @@ export async function GET(request: NextRequest) {
     // Check access
     await requireWorkspaceAccess(workspaceId, false);
 
-    // Build Prisma query
-    const where: any = {
-      workspaceId,
+    const filters = {
+      tags: tags && tags.length > 0 ? tags : undefined,
+      dateFrom: dateFrom ? new Date(dateFrom) : undefined,
+      dateTo: dateTo ? new Date(dateTo) : undefined,
     };
 
-    // Apply filters
-    if (tags && tags.length > 0) {
-      where.tags = {
-        hasSome: tags,
-      };
-    }
+    let results: ReturnType<typeof serializeSearchNode>[];
+    let total: number;
+    let nextOffset: number | null;
 
-    if (dateFrom || dateTo) {
-      where.createdAt = {};
-      if (dateFrom) {
-        where.createdAt.gte = new Date(dateFrom);
+    if (query) {
+      const page = await searchWorkspaceNodes(workspaceId, query, {
+        ...filters,
+        limit,
+        offset,
+        semantic,
+      });
+
+      // Hydrate the page of hits, keeping rank order
+      const nodes = await prisma.node.findMany({
+        where: { workspaceId, id: { in: page.hits.map((hit) => hit.id) } },
+      });
+      const nodesById = new Map(nodes.map((n) => [n.id, n]));
+      results = page.hits
+        .map((hit) => nodesById.get(hit.id))
+        .filter((n): n is NonNullable<typeof n> => !!n)
+        .map(serializeSearchNode);
+      total = page.total;
+      nextOffset = page.nextOffset;
+    } else {
+      const where: any = { workspaceId };
+      if (filters.tags) {
+        where.tags = { hasSome: filters.tags };
       }
-      if (dateTo) {
-        where.createdAt.lte = new Date(dateTo);
+      if (filters.dateFrom || filters.dateTo) {
+        where.createdAt = {};
+        if (filters.dateFrom) {
+          where.createdAt.gte = filters.dateFrom;
+        }
+        if (filters.dateTo) {
+          where.createdAt.lte = filters.dateTo;
+        }
       }
-    }
 
-    // Fetch nodes
-    const nodes = await prisma.node.findMany({
-      where,
-      take: limit,
-      orderBy: { createdAt: 'desc' },
-    });
-
-    if (!nodes || nodes.length === 0) {
-      return NextResponse.json({ results: [], total: 0 }, { status: 200 });
-    }
-
-    // Apply text search if query provided
-    let results: Array<{
-      id: string;
-      workspaceId: string;
-      title: string;
-      content: any;
-      tags: string[];
-      x: number;
-      y: number;
-      createdAt: string;
-      updatedAt: string;
-    }>;
-    
-    if (query) {
-      const searchResults = searchNodes(
-        query,
-        nodes.map((n) => ({
-          id: n.id,
-          workspaceId: n.workspaceId,
-          title: n.title,
-          content: n.content,
-          tags: n.tags,
-          x: n.x,
-          y: n.y,
-          createdAt: n.createdAt.toISOString(),
-          updatedAt: n.updatedAt.toISOString(),
-        })),
-        { limit }
-      );
-      results = searchResults.map((r) => r.node);
-    } else {
-      results = nodes.map((n) => ({
-        id: n.id,
-        workspaceId: n.workspaceId,
-        title: n.title,
-        content: n.content,
-        tags: n.tags,
-        x: n.x,
-        y: n.y,
-        createdAt: n.createdAt.toISOString(),
-        updatedAt: n.updatedAt.toISOString(),
-      }));
+      const [nodes, count] = await Promise.all([
+        prisma.node.findMany({
+          where,
+          skip: offset,
+          take: limit,
+          orderBy: { createdAt: 'desc' },
+        }),
+        prisma.node.count({ where }),
+      ]);
+      results = nodes.map(serializeSearchNode);
+      total = count;
+      nextOffset = offset + limit < count ? offset + limit : null;
     }
 
     return NextResponse.json(
       {
         results,
-        total: results.length,
+        total,
+        nextOffset,
         query: query || undefined,
         filters: {
           tags: tags || undefined,
@@ -1,10 +1,16 @@
 import { NextRequest, NextResponse } from 'next/server';
 import { requireWorkspaceAccess } from '@/lib/api-helpers';
 import { prisma } from '@/lib/db';
-import { getNodeEmbedding } from '@/lib/embeddings';
-import { findSimilarNodes } from '@/lib/db-server';
+import { enqueueNodeIndexing } from '@/lib/nodeJobs';
+import { logActivity } from '@/lib/activityLog';
+import { replaceNodeContent } from '@/lib/nodeDocuments';
+import { recordNodeRevision } from '@/lib/nodeRevisions';
+import { traceRoute } from '@/lib/tracing';
+import { isPartialContent, PARTIAL_CONTENT_KEY } from '@/lib/graphPayload';
 
-export async function PUT(request: NextRequest) {
+export const PUT = traceRoute('PUT /api/nodes/update', updateNode);
+
+async function updateNode(request: NextRequest) {
   try {
     let body;
     try {
@@ -43,128 +49,55 @@ export async function PUT(request: NextRequest) {
     const updateData: any = {};
 
     if (title !== undefined) updateData.title = title;
-    if (content !== undefined) updateData.content = content;
+    if (content !== undefined) {
+      // Content from a binary skeleton load that hasn't been fetched yet - merge the client's
+      // keys onto what's stored instead of dropping everything it never saw. Stored text or
+      // arrays have no keys to merge into, so the client has to load the content first
+      // (ensureNodeContent in lib/nodeContentLoader.ts)
+      if (isPartialContent(content)) {
+        const stored = existingNode.content;
+        if (!stored || typeof stored !== 'object' || Array.isArray(stored)) {
+          return NextResponse.json(
+            { error: 'Node content is not loaded yet' },
+            { status: 409 }
+          );
+        }
+        const { [PARTIAL_CONTENT_KEY]: _partial, ...known } = content;
+        updateData.content = { ...(stored as Record<string, unknown>), ...known };
+      } else {
+        updateData.content = content;
+      }
+    }
     if (tags !== undefined) updateData.tags = tags;
     if (x !== undefined) updateData.x = x;
     if (y !== undefined) updateData.y = y;
 
-    // Regenerate embedding if title or content changed (optional - don't fail if this errors)
-    if (title !== undefined || content !== undefined) {
-      try {
-        const newEmbedding = await getNodeEmbedding({
-          title: title || existingNode.title,
-          content: content !== undefined ? content : existingNode.content,
-        });
-
-        // Update embedding using raw SQL (optional - don't fail if pgvector isn't set up)
-        if (newEmbedding && newEmbedding.length > 0 && process.env.OPENAI_API_KEY) {
-          try {
-            // Only try to update embedding if OPENAI_API_KEY is set
-            // Skip the column check to avoid error logs
-            const vectorText = `[${newEmbedding.join(',')}]`;
-            await prisma.$executeRaw`
-              UPDATE nodes
-              SET embedding = ${vectorText}::vector
-              WHERE id = ${nodeId}::uuid
-            `.catch(() => {
-              // Silently fail if embedding column doesn't exist
-            });
-            
-            // Re-check auto-linking (optional - don't fail if this errors)
-            try {
-              const similarNodes = await findSimilarNodes(
-                newEmbedding,
-                existingNode.workspaceId,
-                nodeId,
-                0.82, // auto-link threshold
-                10 // limit
-              );
-
-              if (similarNodes.length > 0) {
-                // Get existing edges from this node
-                const existingEdges = await prisma.edge.findMany({
-                  where: {
-                    workspaceId: existingNode.workspaceId,
-                    source: nodeId,
-                  },
-                  select: { target: true },
-                });
-
-                const existingTargets = new Set(existingEdges.map((e) => e.target));
-
-                // Create new auto-edges for nodes that don't already have edges
-                const newTargets = similarNodes.filter(
-                  (node) => !existingTargets.has(node.id)
-                );
+    // A whole-content write replaces the collaborative document too (same transaction);
+    // open editors get a 409 on their next update and reload from the new content
+    const updatedNode = content !== undefined
+      ? await replaceNodeContent(nodeId, updateData)
+      : await prisma.node.update({ where: { id: nodeId }, data: updateData });
 
-                if (newTargets.length > 0) {
-                  await prisma.edge.createMany({
-                    data: newTargets.map((targetNode) => ({
-                      workspaceId: existingNode.workspaceId,
-                      source: nodeId,
-                      target: targetNode.id,
-                      similarity: targetNode.similarity || 1,
-                    })),
-                    skipDuplicates: true,
-                  });
+    if (title !== undefined || content !== undefined || tags !== undefined) {
+      await recordNodeRevision(updatedNode, user.id, existingNode);
+    }
 
-                  // Log activity (optional - don't fail if this errors)
-                  try {
-                    await prisma.activityLog.create({
-                      data: {
-                        workspaceId: existingNode.workspaceId,
-                        userId: user.id,
-                        action: 'auto_link',
-                        entityType: 'edge',
-                        details: {
-                          sourceNodeId: nodeId,
-                          targetNodesCount: newTargets.length,
-                        },
-                      },
-                    });
-                  } catch (logError: any) {
-                    console.warn('[API] Failed to log auto-link activity (continuing):', logError?.message);
-                  }
-                }
-              }
-            } catch (autoLinkError: any) {
-              console.warn('[API] Failed to auto-link nodes (continuing):', autoLinkError?.message);
-              // Continue without auto-linking - node update will still succeed
-            }
-          } catch (embeddingError: any) {
-            // Silently skip embedding update if it fails (column doesn't exist or other error)
-            // Node update will still succeed without embedding
-          }
-        }
-      } catch (embeddingGenError: any) {
-        console.warn('[API] Failed to generate embedding (continuing without embedding):', embeddingGenError?.message);
-        // Continue without embedding - node update will still succeed
-      }
+    // Re-embed + re-link in the background if the text changed - debounced so a burst
+    // of edits to the same node coalesces into one embedding call
+    if (title !== undefined || content !== undefined) {
+      await enqueueNodeIndexing(updatedNode, user.id, { debounce: true });
     }
 
-    // Update node
-    const updatedNode = await prisma.node.update({
-      where: { id: nodeId },
-      data: updateData,
+    // Buffered - inserted with other activity in the next batch
+    logActivity({
+      workspaceId: existingNode.workspaceId,
+      userId: user.id,
+      action: 'update',
+      entityType: 'node',
+      entityId: nodeId,
+      details: { title: updatedNode.title },
     });
 
-    // Log activity (optional - don't fail if this errors)
-    try {
-      await prisma.activityLog.create({
-        data: {
-          workspaceId: existingNode.workspaceId,
-          userId: user.id,
-          action: 'update',
-          entityType: 'node',
-          entityId: nodeId,
-          details: { title: updatedNode.title },
-        },
-      });
-    } catch (logError: any) {
-      console.warn('[API] Failed to log activity (continuing):', logError?.message);
-      // Continue without logging - node update will still succeed
-    }
-
     return NextResponse.json({
       node: {
         ...updatedNode,
@@ -1,5 +1,5 @@
 import { NextRequest, NextResponse } from 'next/server';
-import { getCurrentUser } from '@/lib/api-helpers';
+import { getCurrentUser, invalidateUser } from '@/lib/api-helpers';
 import { prisma } from '@/lib/db';
 
 export async function DELETE(request: NextRequest) {
@@ -14,6 +14,7 @@ export async function DELETE(request: NextRequest) {
     await prisma.user.delete({
       where: { id: user.id },
     });
+    invalidateUser(user.id);
 
     return NextResponse.json({ success: true }, { status: 200 });
   } catch (error: any) {
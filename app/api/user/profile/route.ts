@@ -1,5 +1,5 @@
 import { NextRequest, NextResponse } from 'next/server';
-import { getCurrentUser } from '@/lib/api-helpers';
+import { getCurrentUser, invalidateUser } from '@/lib/api-helpers';
 import { prisma } from '@/lib/db';
 
 export async function PATCH(request: NextRequest) {
@@ -28,6 +28,7 @@ export async function PATCH(request: NextRequest) {
         plan: true,
       },
     });
+    invalidateUser(userId);
 
     return NextResponse.json({ user: updatedUser }, { status: 200 });
   } catch (error: any) {
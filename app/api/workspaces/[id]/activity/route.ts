@@ -1,7 +1,10 @@
 import { NextRequest, NextResponse } from 'next/server';
 import { requireWorkspaceAccess } from '@/lib/api-helpers';
-import { prisma } from '@/lib/db';
+import { listActivity } from '@/lib/activityLog';
 
+// GET /api/workspaces/[id]/activity?before=<cursor>&limit=<n>
+// One page of activity, newest first, with each row's user. Pass nextCursor back as
+// `before` for the next page.
 export async function GET(
   request: NextRequest,
   { params }: { params: Promise<{ id: string }> }
@@ -11,26 +14,23 @@ export async function GET(
     await requireWorkspaceAccess(workspaceId, false);
     
     const { searchParams } = new URL(request.url);
-    const limit = parseInt(searchParams.get('limit') || '50');
+    const before = searchParams.get('before');
+    const limit = Number(searchParams.get('limit') || '50');
 
-    // Get activity log with user info
-    const activities = await prisma.activityLog.findMany({
-      where: { workspaceId },
-      include: {
-        user: {
-          select: {
-            id: true,
-            email: true,
-            name: true,
-            avatarUrl: true,
-          },
-        },
-      },
-      orderBy: { createdAt: 'desc' },
-      take: limit,
-    });
+    let page;
+    try {
+      page = await listActivity(workspaceId, {
+        before: before || undefined,
+        limit: Number.isFinite(limit) ? limit : undefined,
+      });
+    } catch (error: any) {
+      if (error.message === 'Invalid cursor') {
+        return NextResponse.json({ error: error.message }, { status: 400 });
+      }
+      throw error;
+    }
 
-    return NextResponse.json({ activities }, { status: 200 });
+    return NextResponse.json(page, { status: 200 });
   } catch (error: any) {
     console.error('Error fetching activity:', error);
     
@@ -0,0 +1,110 @@
+import { NextRequest, NextResponse } from 'next/server';
+import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import { autoLinkNodes } from '@/lib/db-server';
+import { SIMILARITY_THRESHOLDS } from '@/lib/similarity';
+
+const MAX_NODE_IDS = 10000;
+const MAX_NEIGHBOURS = 50;
+
+// POST /api/workspaces/[id]/auto-link
+// Bulk auto-link: { nodeIds?: string[], threshold?: number, limit?: number, stream?: boolean }
+// Omit nodeIds to relink every node in the workspace. Candidates come from one pgvector
+// query per chunk of nodes and all new edges are inserted set-based (lib/db-server.ts)
+// With stream: true the response is NDJSON - {type:'progress',...} lines, then {type:'done',...}
+export async function POST(
+  request: NextRequest,
+  { params }: { params: Promise<{ id: string }> }
+) {
+  try {
+    const { id: workspaceId } = await params;
+
+    let body: any = {};
+    try {
+      body = await request.json();
+    } catch {
+      // Empty body - relink the whole workspace with defaults
+    }
+
+    const {
+      nodeIds,
+      threshold = SIMILARITY_THRESHOLDS.AUTO_LINK,
+      limit = 10,
+      stream = false,
+    } = body || {};
+
+    if (nodeIds !== undefined && (!Array.isArray(nodeIds) || nodeIds.some((id) => typeof id !== 'string'))) {
+      return NextResponse.json({ error: 'nodeIds must be an array of strings' }, { status: 400 });
+    }
+    if (Array.isArray(nodeIds) && nodeIds.length > MAX_NODE_IDS) {
+      return NextResponse.json(
+        { error: `Too many nodeIds (max ${MAX_NODE_IDS})` },
+        { status: 400 }
+      );
+    }
+    // Never link below the suggestion threshold - those pairs aren't related enough to show
+    if (typeof threshold !== 'number' || threshold < SIMILARITY_THRESHOLDS.SUGGEST_LINK || threshold > 1) {
+      return NextResponse.json(
+        { error: `threshold must be between ${SIMILARITY_THRESHOLDS.SUGGEST_LINK} and 1` },
+        { status: 400 }
+      );
+    }
+    if (!Number.isInteger(limit) || limit < 1 || limit > MAX_NEIGHBOURS) {
+      return NextResponse.json(
+        { error: `limit must be an integer between 1 and ${MAX_NEIGHBOURS}` },
+        { status: 400 }
+      );
+    }
+
+    // Creates edges, so edit access is required
+    await requireWorkspaceAccess(workspaceId, true);
+
+    const ids = nodeIds ? Array.from(new Set<string>(nodeIds)) : null;
+
+    if (stream) {
+      const encoder = new TextEncoder();
+      const startTime = Date.now();
+
+      const responseStream = new ReadableStream<Uint8Array>({
+        async start(controller) {
+          const send = (message: Record<string, any>) => {
+            controller.enqueue(encoder.encode(JSON.stringify(message) + '\n'));
+          };
+
+          try {
+            const edges = await autoLinkNodes(workspaceId, ids, threshold, limit, (progress) => {
+              send({ type: 'progress', ...progress });
+            });
+            send({ type: 'done', created: edges.length, durationMs: Date.now() - startTime });
+          } catch (error: any) {
+            console.error('Error streaming workspace auto-link:', error);
+            send({ type: 'error', error: 'Failed to auto-link workspace' });
+          } finally {
+            controller.close();
+          }
+        },
+      });
+
+      return new Response(responseStream, {
+        headers: {
+          'Content-Type': 'application/x-ndjson',
+          'Cache-Control': 'no-cache',
+        },
+      });
+    }
+
+    const edges = await autoLinkNodes(workspaceId, ids, threshold, limit);
+
+    return NextResponse.json({ created: edges.length, edges });
+  } catch (error: any) {
+    console.error('Error bulk auto-linking workspace:', error);
+
+    if (error.message === 'Unauthorized' || error.message?.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+
+    return NextResponse.json(
+      { error: 'Failed to auto-link workspace' },
+      { status: 500 }
+    );
+  }
+}
@@ -0,0 +1,63 @@
+import { NextRequest, NextResponse } from 'next/server';
+import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import { hasEmbeddingColumn } from '@/lib/db-server';
+import { prisma } from '@/lib/db';
+import {
+  INLINE_CLUSTER_MAX_NODES,
+  computeClusters,
+  enqueueClusterComputation,
+  getStoredClusters,
+  type StoredClusters,
+} from '@/lib/clusterCache';
+
+function serializeClusters(stored: StoredClusters) {
+  return { k: stored.k, computedAt: stored.computedAt.toISOString(), clusters: stored.clusters };
+}
+
+/**
+ * Semantic clusters of the workspace's embedded nodes
+ * Serves the stored clusters (kept current between runs by incremental assignment). When
+ * none exist yet, small workspaces are clustered inline; large ones are queued and this
+ * returns 202 with no clusters.
+ */
+export async function GET(
+  request: NextRequest,
+  { params }: { params: Promise<{ id: string }> }
+) {
+  try {
+    const { id: workspaceId } = await params;
+    await requireWorkspaceAccess(workspaceId);
+
+    const stored = await getStoredClusters(workspaceId);
+    if (stored) {
+      return NextResponse.json(serializeClusters(stored));
+    }
+
+    const embedded = (await hasEmbeddingColumn())
+      ? (
+          await prisma.$queryRaw<Array<{ count: number }>>`
+            SELECT COUNT(*)::int AS count FROM nodes
+            WHERE workspace_id = ${workspaceId} AND embedding IS NOT NULL
+          `
+        )[0]?.count ?? 0
+      : 0;
+
+    if (embedded < 2) {
+      return NextResponse.json({ k: 0, computedAt: null, clusters: [] });
+    }
+
+    if (embedded <= INLINE_CLUSTER_MAX_NODES) {
+      const computed = await computeClusters(workspaceId);
+      return NextResponse.json(computed ? serializeClusters(computed) : { k: 0, computedAt: null, clusters: [] });
+    }
+
+    await enqueueClusterComputation(workspaceId);
+    return NextResponse.json({ k: 0, computedAt: null, clusters: [], pending: true }, { status: 202 });
+  } catch (error: any) {
+    console.error('Error loading clusters:', error);
+    if (error.message?.includes('Unauthorized') || error.message?.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+    return NextResponse.json({ error: 'Failed to load clusters' }, { status: 500 });
+  }
+}
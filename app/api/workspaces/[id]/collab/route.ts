@@ -0,0 +1,117 @@
+import { NextRequest, NextResponse } from 'next/server';
+import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import { prisma } from '@/lib/db';
+import { publishOps, subscribeWorkspace, type CollabEvent } from '@/lib/collabHub';
+import { MAX_OPS_PER_MESSAGE, isGraphOp } from '@/lib/collabOps';
+
+// Long-lived streams must never be cached or statically rendered
+export const dynamic = 'force-dynamic';
+
+// Comment line every so often so proxies keep the connection open
+const HEARTBEAT_MS = 25_000;
+
+// GET /api/workspaces/[id]/collab - Server-Sent Events stream for a workspace
+// Events: hello {version}, ops {from, ops}, doc {from, nodeId, update}, version {version},
+// activity {activities}
+// The browser's EventSource reconnects on its own; after a reconnect clients delta sync
+export async function GET(
+  request: NextRequest,
+  { params }: { params: Promise<{ id: string }> }
+) {
+  try {
+    const { id: workspaceId } = await params;
+    await requireWorkspaceAccess(workspaceId, false);
+
+    const workspace = await prisma.workspace.findUnique({
+      where: { id: workspaceId },
+      select: { graphVersion: true },
+    });
+
+    const encoder = new TextEncoder();
+    let cleanup: (() => void) | null = null;
+
+    const stream = new ReadableStream<Uint8Array>({
+      start(controller) {
+        const write = (chunk: string) => controller.enqueue(encoder.encode(chunk));
+        const send = ({ event, data }: CollabEvent | { event: 'hello'; data: any }) => {
+          write(`event: ${event}\ndata: ${JSON.stringify(data)}\n\n`);
+        };
+
+        write('retry: 3000\n\n');
+        send({ event: 'hello', data: { version: workspace?.graphVersion ?? null } });
+
+        const unsubscribe = subscribeWorkspace(workspaceId, send);
+        const heartbeat = setInterval(() => write(': ping\n\n'), HEARTBEAT_MS);
+
+        cleanup = () => {
+          clearInterval(heartbeat);
+          unsubscribe();
+          cleanup = null;
+          try {
+            controller.close();
+          } catch {
+            // Already closed by the client
+          }
+        };
+        request.signal.addEventListener('abort', () => cleanup?.());
+      },
+      cancel() {
+        cleanup?.();
+      },
+    });
+
+    return new Response(stream, {
+      headers: {
+        'Content-Type': 'text/event-stream',
+        'Cache-Control': 'no-cache, no-transform',
+        Connection: 'keep-alive',
+        // Disable proxy buffering (nginx) so events are not held back
+        'X-Accel-Buffering': 'no',
+      },
+    });
+  } catch (error: any) {
+    console.error('Error opening collaboration stream:', error);
+    if (error.message === 'Unauthorized' || error.message?.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+    return NextResponse.json({ error: 'Failed to open collaboration stream' }, { status: 500 });
+  }
+}
+
+// POST /api/workspaces/[id]/collab - { from, ops } batch from one client, relayed to the others
+// Nothing is persisted here; the sender saves through the regular node/edge routes
+export async function POST(
+  request: NextRequest,
+  { params }: { params: Promise<{ id: string }> }
+) {
+  try {
+    const { id: workspaceId } = await params;
+    await requireWorkspaceAccess(workspaceId, true);
+
+    const body = await request.json().catch(() => null);
+    const from = body?.from;
+    const ops = body?.ops;
+
+    if (typeof from !== 'string' || !Array.isArray(ops)) {
+      return NextResponse.json({ error: 'Expected { from, ops }' }, { status: 400 });
+    }
+    if (ops.length > MAX_OPS_PER_MESSAGE) {
+      return NextResponse.json(
+        { error: `Too many ops (max ${MAX_OPS_PER_MESSAGE})` },
+        { status: 400 }
+      );
+    }
+    if (!ops.every(isGraphOp)) {
+      return NextResponse.json({ error: 'Invalid op' }, { status: 400 });
+    }
+
+    publishOps(workspaceId, { from, ops });
+    return new Response(null, { status: 204 });
+  } catch (error: any) {
+    console.error('Error relaying collaboration ops:', error);
+    if (error.message === 'Unauthorized' || error.message?.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+    return NextResponse.json({ error: 'Failed to relay ops' }, { status: 500 });
+  }
+}
@@ -0,0 +1,61 @@
+import { NextRequest, NextResponse } from 'next/server';
+import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import { prisma } from '@/lib/db';
+import { MAX_CONTENT_NODES_PER_REQUEST } from '@/lib/graphPayload';
+import { traceRoute } from '@/lib/tracing';
+
+// POST /api/workspaces/[id]/content  { nodeIds: string[] }  ->  { contents: { [nodeId]: content } }
+// Full content for nodes loaded from the binary skeleton (lib/graphPayload.ts).
+// POST rather than GET so a chunk of ids doesn't run into URL length limits; ids that
+// aren't in the workspace (deleted since the skeleton load) are simply left out
+export const POST = traceRoute('POST /api/workspaces/[id]/content', getNodeContents);
+
+async function getNodeContents(
+  request: NextRequest,
+  { params }: { params: Promise<{ id: string }> }
+) {
+  try {
+    const { id: workspaceId } = await params;
+
+    await requireWorkspaceAccess(workspaceId, false);
+
+    let body;
+    try {
+      body = await request.json();
+    } catch {
+      return NextResponse.json({ error: 'Invalid JSON in request body' }, { status: 400 });
+    }
+
+    const nodeIds = body?.nodeIds;
+    if (!Array.isArray(nodeIds) || !nodeIds.every((id) => typeof id === 'string')) {
+      return NextResponse.json({ error: 'nodeIds must be an array of strings' }, { status: 400 });
+    }
+    if (nodeIds.length > MAX_CONTENT_NODES_PER_REQUEST) {
+      return NextResponse.json(
+        { error: `Too many nodes (max ${MAX_CONTENT_NODES_PER_REQUEST})` },
+        { status: 400 }
+      );
+    }
+
+    const nodes = await prisma.node.findMany({
+      where: { workspaceId, id: { in: nodeIds } },
+      select: { id: true, content: true },
+    });
+
+    const contents: Record<string, unknown> = {};
+    for (const node of nodes) contents[node.id] = node.content ?? {};
+
+    return NextResponse.json({ contents });
+  } catch (error: any) {
+    console.error('Error fetching node contents:', error);
+
+    if (error.message === 'Unauthorized' || error.message?.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+
+    return NextResponse.json(
+      { error: 'Failed to fetch node contents' },
+      { status: 500 }
+    );
+  }
+}
@@ -1,10 +1,28 @@
 import { NextRequest, NextResponse } from 'next/server';
 import { requireWorkspaceAccess } from '@/lib/api-helpers';
 import { prisma } from '@/lib/db';
+import {
+  edgeSyncSelect,
+  getGraphSkeleton,
+  nodeSyncSelect,
+  pruneGraphTombstones,
+  serializeEdge,
+  serializeNode,
+} from '@/lib/graphSync';
+import { getTileSummaries } from '@/lib/graphTiles';
+import { WINDOWED_NODE_THRESHOLD } from '@/lib/viewportTiles';
+import { traceRoute } from '@/lib/tracing';
+import { encodeGraphPayload, GRAPH_PAYLOAD_CONTENT_TYPE } from '@/lib/graphPayload';
 
 // API route to fetch workspace data (workspace, nodes, edges)
 // Used by WorkspaceProvider instead of direct Supabase queries
-export async function GET(
+// With ?windowed=1, workspaces above WINDOWED_NODE_THRESHOLD return per-tile aggregates
+// (`windowed: true, summaries`) instead of every node; the canvas then pages tiles in
+// With ?format=binary a full load is answered with the columnar skeleton from lib/graphPayload.ts
+// (workspace info in header.extra); windowed responses stay JSON
+export const GET = traceRoute('GET /api/workspaces/[id]/data', getWorkspaceData);
+
+async function getWorkspaceData(
   request: NextRequest,
   { params }: { params: Promise<{ id: string }> }
 ) {
@@ -31,63 +49,66 @@ export async function GET(
       return NextResponse.json({ error: 'Workspace not found' }, { status: 404 });
     }
 
-    // Fetch nodes
-    const nodes = await prisma.node.findMany({
-      where: { workspaceId },
-      orderBy: { createdAt: 'desc' },
-    });
+    const workspaceInfo = {
+      id: workspace.id,
+      name: workspace.name,
+      ownerId: workspace.ownerId,
+      owner: workspace.owner,
+      createdAt: workspace.createdAt.toISOString(),
+      updatedAt: workspace.updatedAt.toISOString(),
+    };
 
-    // Fetch edges
-    const edges = await prisma.edge.findMany({
-      where: { workspaceId },
+    if (request.nextUrl.searchParams.get('windowed') === '1') {
+      const nodeCount = await prisma.node.count({ where: { workspaceId } });
+      if (nodeCount > WINDOWED_NODE_THRESHOLD) {
+        return NextResponse.json({
+          workspace: workspaceInfo,
+          version: workspace.graphVersion,
+          windowed: true,
+          nodeCount,
+          summaries: await getTileSummaries(workspaceId),
+        });
+      }
+    }
+
+    // Housekeeping for delta sync - never blocks or fails the load
+    pruneGraphTombstones(workspaceId).catch((error) => {
+      console.warn('[API] Failed to prune graph tombstones (continuing):', error?.message);
     });
 
-    // Helper function to safely serialize JSON content
-    const serializeContent = (content: any): any => {
-      if (content === null || content === undefined) {
-        return {};
-      }
-      // If it's already a plain object/array, return as-is (NextResponse.json will handle serialization)
-      // If it's a Prisma JsonValue type, it should already be serializable
-      try {
-        // Ensure it's a plain serializable object by parsing and stringifying
-        // This handles any edge cases with Prisma's JsonValue type
-        return JSON.parse(JSON.stringify(content));
-      } catch (error) {
-        console.warn('[API] Failed to serialize node content, using empty object:', error);
-        return {};
-      }
-    };
+    // Fetch nodes and edges (workspace.graphVersion was read first, so any change
+    // racing with these reads is re-sent by the next ?since= delta rather than lost)
+    if (request.nextUrl.searchParams.get('format') === 'binary') {
+      const skeleton = await getGraphSkeleton(workspaceId);
+      const payload = encodeGraphPayload(
+        { workspaceId, version: workspace.graphVersion, ...skeleton },
+        { workspace: workspaceInfo }
+      );
+      return new Response(Buffer.from(payload.buffer, payload.byteOffset, payload.byteLength), {
+        headers: {
+          'Content-Type': GRAPH_PAYLOAD_CONTENT_TYPE,
+          'Cache-Control': 'no-store',
+        },
+      });
+    }
+
+    const [nodes, edges] = await Promise.all([
+      prisma.node.findMany({
+        where: { workspaceId },
+        orderBy: { createdAt: 'desc' },
+        select: nodeSyncSelect,
+      }),
+      prisma.edge.findMany({
+        where: { workspaceId },
+        select: edgeSyncSelect,
+      }),
+    ]);
 
     return NextResponse.json({
-      workspace: {
-        id: workspace.id,
-        name: workspace.name,
-        ownerId: workspace.ownerId,
-        owner: workspace.owner,
-        createdAt: workspace.createdAt.toISOString(),
-        updatedAt: workspace.updatedAt.toISOString(),
-      },
-      nodes: nodes.map((node) => ({
-        id: node.id,
-        workspaceId: node.workspaceId,
-        title: node.title || '',
-        content: serializeContent(node.content),
-        tags: node.tags || [],
-        x: node.x ?? 0,
-        y: node.y ?? 0,
-        createdAt: node.createdAt.toISOString(),
-        updatedAt: node.updatedAt.toISOString(),
-      })),
-      edges: edges.map((edge) => ({
-        id: edge.id,
-        workspaceId: edge.workspaceId,
-        source: edge.source,
-        target: edge.target,
-        label: edge.label || null,
-        similarity: edge.similarity ?? null,
-        createdAt: edge.createdAt.toISOString(),
-      })),
+      workspace: workspaceInfo,
+      version: workspace.graphVersion,
+      nodes: nodes.map(serializeNode),
+      edges: edges.map(serializeEdge),
     });
   } catch (error: any) {
     console.error('[API] Error fetching workspace data:', {
@@ -1,8 +1,11 @@
 import { NextRequest, NextResponse } from 'next/server';
-import { requireAuth, requireWorkspaceAccess } from '@/lib/api-helpers';
+import { requireWorkspaceAccess } from '@/lib/api-helpers';
 import { prisma } from '@/lib/db';
-import { exportAsMarkdown } from '@/lib/export';
+import { isExportFormat, streamWorkspaceExport } from '@/lib/exportStream';
 
+// GET /api/workspaces/[id]/export?format=json|ndjson|markdown
+// Every format is streamed from paginated reads (lib/exportStream.ts); ndjson is the
+// line-per-record format for very large workspaces and incremental consumers
 export async function GET(
   request: NextRequest,
   { params }: { params: Promise<{ id: string }> }
@@ -13,6 +16,9 @@ export async function GET(
     
     const { searchParams } = new URL(request.url);
     const format = searchParams.get('format') || 'json';
+    if (!isExportFormat(format)) {
+      return NextResponse.json({ error: 'Unsupported format (json, ndjson, markdown)' }, { status: 400 });
+    }
 
     // Get workspace
     const workspace = await prisma.workspace.findUnique({
@@ -30,107 +36,32 @@ export async function GET(
       return NextResponse.json({ error: 'Workspace not found' }, { status: 404 });
     }
 
-    // Get nodes
-    const nodes = await prisma.node.findMany({
-      where: { workspaceId },
-      select: {
-        id: true,
-        workspaceId: true,
-        title: true,
-        content: true,
-        tags: true,
-        x: true,
-        y: true,
-        createdAt: true,
-        updatedAt: true,
-      },
-    });
+    const disposition = (extension: string) =>
+      `attachment; filename="${workspace.name.replace(/["\\\r\n]/g, '_')}.${extension}"`;
+    const stream = streamWorkspaceExport(workspace, format, user.id);
 
-    // Get edges
-    const edges = await prisma.edge.findMany({
-      where: { workspaceId },
-      select: {
-        id: true,
-        workspaceId: true,
-        source: true,
-        target: true,
-        label: true,
-        similarity: true,
-        createdAt: true,
-      },
-    });
-
-    // Get members
-    const members = await prisma.workspaceMember.findMany({
-      where: { workspaceId },
-      include: {
-        user: {
-          select: {
-            id: true,
-            email: true,
-            name: true,
-          },
+    if (format === 'ndjson') {
+      return new Response(stream, {
+        headers: {
+          'Content-Type': 'application/x-ndjson',
+          'Content-Disposition': disposition('ndjson'),
         },
-      },
-    });
+      });
+    }
 
-    // Export in requested format
     if (format === 'markdown') {
-      const exportData = {
-        workspace: {
-          ...workspace,
-          createdAt: workspace.createdAt.toISOString(),
-          updatedAt: workspace.updatedAt.toISOString(),
-        },
-        nodes: nodes.map(n => ({
-          ...n,
-          workspaceId: n.workspaceId,
-          createdAt: n.createdAt.toISOString(),
-          updatedAt: n.updatedAt.toISOString(),
-        })),
-        edges: edges.map(e => ({
-          ...e,
-          workspaceId: e.workspaceId,
-          label: e.label || undefined,
-          similarity: e.similarity || undefined,
-          createdAt: e.createdAt.toISOString(),
-        })),
-        exported_at: new Date().toISOString(),
-        exported_by: user.id,
-      };
-      const markdown = exportAsMarkdown(exportData);
-      return new NextResponse(markdown, {
+      return new Response(stream, {
         headers: {
           'Content-Type': 'text/markdown',
-          'Content-Disposition': `attachment; filename="${workspace.name}.md"`,
+          'Content-Disposition': disposition('md'),
         },
       });
     }
 
-    // Default: JSON format
-    return NextResponse.json({
-      workspace: {
-        ...workspace,
-        createdAt: workspace.createdAt.toISOString(),
-        updatedAt: workspace.updatedAt.toISOString(),
-      },
-      nodes: nodes.map(n => ({
-        ...n,
-        createdAt: n.createdAt.toISOString(),
-        updatedAt: n.updatedAt.toISOString(),
-      })),
-      edges: edges.map(e => ({
-        ...e,
-        createdAt: e.createdAt.toISOString(),
-      })),
-      members: members.map(m => ({
-        userId: m.userId,
-        role: m.role,
-        email: m.user.email,
-        name: m.user.name,
-        createdAt: m.createdAt.toISOString(),
-      })),
-    }, { status: 200 });
+    // Default: JSON format (same document as before, streamed)
+    return new Response(stream, {
+      headers: { 'Content-Type': 'application/json' },
+    });
   } catch (error: any) {
     console.error('Error exporting workspace:', error);
     
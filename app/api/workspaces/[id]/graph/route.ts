@@ -1,8 +1,23 @@
 import { NextRequest, NextResponse } from 'next/server';
 import { prisma } from '@/lib/db';
 import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import {
+  edgeSyncSelect,
+  getGraphDelta,
+  getGraphSkeleton,
+  nodeSyncSelect,
+  serializeEdge,
+  serializeNode,
+} from '@/lib/graphSync';
+import { traceRoute } from '@/lib/tracing';
+import { encodeGraphPayload, GRAPH_PAYLOAD_CONTENT_TYPE } from '@/lib/graphPayload';
 
-export async function GET(
+// GET /api/workspaces/[id]/graph           - full graph plus current version
+// GET /api/workspaces/[id]/graph?since=42  - only nodes/edges changed or deleted after version 42
+// GET /api/workspaces/[id]/graph?format=binary - full graph as the columnar skeleton (lib/graphPayload.ts)
+export const GET = traceRoute('GET /api/workspaces/[id]/graph', getGraph);
+
+async function getGraph(
   request: NextRequest,
   { params }: { params: Promise<{ id: string }> }
 ) {
@@ -12,53 +27,64 @@ export async function GET(
     // Check workspace access
     await requireWorkspaceAccess(workspaceId, false);
 
-    // Get nodes
-    const nodes = await prisma.node.findMany({
-      where: { workspaceId },
-      select: {
-        id: true,
-        workspaceId: true,
-        title: true,
-        content: true,
-        tags: true,
-        x: true,
-        y: true,
-        createdAt: true,
-        updatedAt: true,
-      },
-    });
+    const sinceParam = request.nextUrl.searchParams.get('since');
+
+    if (sinceParam !== null) {
+      const since = Number(sinceParam);
+      if (!Number.isInteger(since) || since < 0) {
+        return NextResponse.json({ error: 'Invalid since version' }, { status: 400 });
+      }
 
-    // Get edges
-    const edges = await prisma.edge.findMany({
-      where: { workspaceId },
-      select: {
-        id: true,
-        workspaceId: true,
-        source: true,
-        target: true,
-        label: true,
-        similarity: true,
-        createdAt: true,
-      },
+      const delta = await getGraphDelta(workspaceId, since);
+      if (!delta) {
+        return NextResponse.json({ error: 'Workspace not found' }, { status: 404 });
+      }
+
+      return NextResponse.json(delta);
+    }
+
+    // Read the version before the rows - rows may be newer than it, which only means
+    // the next delta re-sends them (upserts are idempotent), never that a change is missed
+    const workspace = await prisma.workspace.findUnique({
+      where: { id: workspaceId },
+      select: { graphVersion: true },
     });
 
+    if (!workspace) {
+      return NextResponse.json({ error: 'Workspace not found' }, { status: 404 });
+    }
+
+    if (request.nextUrl.searchParams.get('format') === 'binary') {
+      const skeleton = await getGraphSkeleton(workspaceId);
+      const payload = encodeGraphPayload({ workspaceId, version: workspace.graphVersion, ...skeleton });
+      return new Response(Buffer.from(payload.buffer, payload.byteOffset, payload.byteLength), {
+        headers: {
+          'Content-Type': GRAPH_PAYLOAD_CONTENT_TYPE,
+          'Cache-Control': 'no-store',
+        },
+      });
+    }
+
+    const [nodes, edges] = await Promise.all([
+      prisma.node.findMany({ where: { workspaceId }, select: nodeSyncSelect }),
+      prisma.edge.findMany({ where: { workspaceId }, select: edgeSyncSelect }),
+    ]);
+
     return NextResponse.json({
-      nodes: nodes.map((n) => ({
-        ...n,
-        createdAt: n.createdAt.toISOString(),
-        updatedAt: n.updatedAt.toISOString(),
-      })),
-      edges: edges.map((e) => ({
-        ...e,
-        createdAt: e.createdAt.toISOString(),
-      })),
+      version: workspace.graphVersion,
+      nodes: nodes.map(serializeNode),
+      edges: edges.map(serializeEdge),
     });
-  } catch (error) {
+  } catch (error: any) {
     console.error('Error fetching graph:', error);
+
+    if (error.message === 'Unauthorized' || error.message?.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+
     return NextResponse.json(
       { error: 'Failed to fetch graph' },
       { status: 500 }
     );
   }
 }
-
@@ -1,8 +1,78 @@
 import { NextRequest, NextResponse } from 'next/server';
 import { prisma } from '@/lib/db';
 import { requireWorkspaceAccess } from '@/lib/api-helpers';
-import { runForceLayout } from '@/lib/layout';
+import {
+  INLINE_LAYOUT_MAX_NODES,
+  applyLayout,
+  computeLayout,
+  enqueueLayoutComputation,
+  getCachedLayout,
+  isLayoutType,
+  serializeLayout,
+  type LayoutConfig,
+  type LayoutType,
+} from '@/lib/layoutCache';
 
+function parseLayoutRequest(type: unknown, rootId: unknown): { type: LayoutType; config: LayoutConfig } | null {
+  const layoutType = type ?? 'force';
+  if (!isLayoutType(layoutType)) return null;
+  return { type: layoutType, config: typeof rootId === 'string' && rootId ? { rootId } : {} };
+}
+
+/**
+ * Cached layout positions: ?type=force|radial|hierarchical[&root=<nodeId>]
+ * Serves the stored layout when it matches the current graph. Otherwise small graphs are
+ * computed inline; large ones are queued and this returns 202 with the stale layout (if any).
+ */
+export async function GET(
+  request: NextRequest,
+  { params }: { params: Promise<{ id: string }> }
+) {
+  try {
+    const { id: workspaceId } = await params;
+    const { user } = await requireWorkspaceAccess(workspaceId);
+
+    const searchParams = request.nextUrl.searchParams;
+    const layoutRequest = parseLayoutRequest(searchParams.get('type') ?? undefined, searchParams.get('root'));
+    if (!layoutRequest) {
+      return NextResponse.json({ error: 'Unknown layout type' }, { status: 400 });
+    }
+    const { type, config } = layoutRequest;
+
+    const cached = await getCachedLayout(workspaceId, type, config);
+    if (cached?.fresh) {
+      return NextResponse.json({ layout: serializeLayout(cached.layout), cached: true });
+    }
+
+    const nodeCount = await prisma.node.count({ where: { workspaceId } });
+    if (nodeCount <= INLINE_LAYOUT_MAX_NODES) {
+      const layout = await computeLayout(workspaceId, user.id, type, config);
+      return NextResponse.json({
+        layout: serializeLayout(layout),
+        cached: false,
+        incremental: layout.incremental,
+      });
+    }
+
+    await enqueueLayoutComputation(workspaceId, user.id, type, config);
+    return NextResponse.json(
+      { layout: cached ? serializeLayout(cached.layout) : null, pending: true, stale: !!cached },
+      { status: 202 }
+    );
+  } catch (error: any) {
+    console.error('Error loading layout:', error);
+    if (error.message?.includes('Unauthorized') || error.message?.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+    return NextResponse.json({ error: 'Failed to load layout' }, { status: 500 });
+  }
+}
+
+/**
+ * Apply a layout to the workspace nodes (body: { type?, rootId? }, default force)
+ * Uses the cached layout when it is current, otherwise recomputes (incrementally for force);
+ * a large graph is computed and applied by a background job and this returns 202
+ */
 export async function POST(
   request: NextRequest,
   { params }: { params: Promise<{ id: string }> }
@@ -11,81 +81,54 @@ export async function POST(
     const { id: workspaceId } = await params;
 
     // Check workspace access
-    await requireWorkspaceAccess(workspaceId, true);
+    const { user } = await requireWorkspaceAccess(workspaceId, true);
 
-    // Get nodes
-    const nodes = await prisma.node.findMany({
-      where: { workspaceId },
-      select: {
-        id: true,
-        workspaceId: true,
-        title: true,
-        content: true,
-        tags: true,
-        x: true,
-        y: true,
-        createdAt: true,
-        updatedAt: true,
-      },
-    });
-
-    // Get edges
-    const edges = await prisma.edge.findMany({
-      where: { workspaceId },
-      select: {
-        id: true,
-        workspaceId: true,
-        source: true,
-        target: true,
-        label: true,
-        similarity: true,
-        createdAt: true,
-      },
-    });
+    const body = await request.json().catch(() => ({}));
+    const layoutRequest = parseLayoutRequest(body?.type, body?.rootId);
+    if (!layoutRequest) {
+      return NextResponse.json({ error: 'Unknown layout type' }, { status: 400 });
+    }
+    const { type, config } = layoutRequest;
 
-    if (nodes.length === 0) {
-      return NextResponse.json({ success: true });
+    const cached = await getCachedLayout(workspaceId, type, config);
+    if (!cached?.fresh) {
+      const nodeCount = await prisma.node.count({ where: { workspaceId } });
+      if (nodeCount > INLINE_LAYOUT_MAX_NODES) {
+        const queued = await enqueueLayoutComputation(workspaceId, user.id, type, config, { apply: true });
+        if (!queued) {
+          return NextResponse.json({ error: 'Layout queue is full, try again later' }, { status: 503 });
+        }
+        return NextResponse.json({ success: true, type, pending: true }, { status: 202 });
+      }
     }
 
-    // Convert to format expected by runForceLayout
-    const layoutNodes = nodes.map(n => ({
-      id: n.id,
-      workspaceId: n.workspaceId,
-      title: n.title,
-      content: typeof n.content === 'string' ? n.content : JSON.stringify(n.content),
-      x: n.x,
-      y: n.y,
-      createdAt: new Date(n.createdAt).getTime(),
-      updatedAt: new Date(n.updatedAt).getTime(),
-    }));
-    const layoutEdges = edges.map(e => ({
-      id: e.id,
-      workspaceId: e.workspaceId,
-      sourceId: e.source,
-      targetId: e.target,
-      weight: e.similarity || 1,
-      createdAt: new Date(e.createdAt).getTime(),
-    }));
+    const layout = cached?.fresh
+      ? { ...cached.layout, incremental: false }
+      : await computeLayout(workspaceId, user.id, type, config);
 
-    const positions = runForceLayout(layoutNodes, layoutEdges);
+    if (layout.nodeIds.length === 0) {
+      return NextResponse.json({ success: true });
+    }
 
-    // Update node positions
-    await Promise.all(
-      Array.from(positions.entries()).map(([nodeId, pos]) =>
-        prisma.node.update({
-          where: { id: nodeId },
-          data: { x: pos.x, y: pos.y },
-        })
-      )
-    );
+    // Position writes bump graphVersion only - the cached layout stays valid
+    const moved = await applyLayout(workspaceId, layout);
 
-    return NextResponse.json({ success: true });
-  } catch (error) {
+    return NextResponse.json({
+      success: true,
+      type,
+      topologyVersion: layout.topologyVersion,
+      cached: !!cached?.fresh,
+      incremental: layout.incremental,
+      moved,
+    });
+  } catch (error: any) {
     console.error('Error running layout:', error);
+    if (error.message?.includes('Unauthorized') || error.message?.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
     return NextResponse.json(
       { error: 'Failed to run layout' },
       { status: 500 }
     );
   }
 }
-
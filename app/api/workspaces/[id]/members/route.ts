@@ -1,5 +1,5 @@
 import { NextRequest, NextResponse } from 'next/server';
-import { requireAuth, requireWorkspaceAccess } from '@/lib/api-helpers';
+import { invalidateWorkspaceAccess, requireWorkspaceAccess } from '@/lib/api-helpers';
 import { prisma } from '@/lib/db';
 
 export async function GET(
@@ -58,7 +58,7 @@ export async function POST(
 ) {
   try {
     const { id: workspaceId } = await params;
-    const { role } = await requireWorkspaceAccess(workspaceId, true); // Need edit permission
+    const { user: currentUser, role } = await requireWorkspaceAccess(workspaceId, true); // Need edit permission
     
     const body = await request.json();
     const { email, memberRole = 'editor' } = body;
@@ -109,10 +109,8 @@ export async function POST(
         },
       },
     });
+    invalidateWorkspaceAccess(workspaceId, user.id);
 
-    // Get current user for activity log
-    const currentUser = await requireAuth();
-    
     // Log activity
     await prisma.activityLog.create({
       data: {
@@ -157,7 +155,7 @@ export async function PUT(
 ) {
   try {
     const { id: workspaceId } = await params;
-    const { role } = await requireWorkspaceAccess(workspaceId, true);
+    const { user: currentUser, role } = await requireWorkspaceAccess(workspaceId, true);
     
     const body = await request.json();
     const { userId: targetUserId, role: newRole } = body;
@@ -193,10 +191,8 @@ export async function PUT(
         },
       },
     });
+    invalidateWorkspaceAccess(workspaceId, targetUserId);
 
-    // Get current user for activity log
-    const currentUser = await requireAuth();
-    
     // Log activity
     await prisma.activityLog.create({
       data: {
@@ -241,7 +237,7 @@ export async function DELETE(
 ) {
   try {
     const { id: workspaceId } = await params;
-    const { role } = await requireWorkspaceAccess(workspaceId, true);
+    const { user: currentUser, role } = await requireWorkspaceAccess(workspaceId, true);
     
     const { searchParams } = new URL(request.url);
     const userId = searchParams.get('userId');
@@ -282,10 +278,8 @@ export async function DELETE(
         },
       },
     });
+    invalidateWorkspaceAccess(workspaceId, userId);
 
-    // Get current user for activity log
-    const currentUser = await requireAuth();
-    
     // Log activity
     await prisma.activityLog.create({
       data: {
@@ -1,5 +1,5 @@
 import { NextRequest, NextResponse } from 'next/server';
-import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import { invalidateWorkspaceAccess, requireWorkspaceAccess } from '@/lib/api-helpers';
 import { prisma } from '@/lib/db';
 
 export async function GET(
@@ -160,6 +160,7 @@ export async function DELETE(
     await prisma.workspace.delete({
       where: { id: workspaceId },
     });
+    invalidateWorkspaceAccess(workspaceId);
 
     return NextResponse.json({ success: true });
   } catch (error: any) {
@@ -1,8 +1,13 @@
 import { NextRequest, NextResponse } from 'next/server';
 import { requireWorkspaceAccess } from '@/lib/api-helpers';
-import { prisma } from '@/lib/db';
+import { searchWorkspaceNodes } from '@/lib/searchIndex';
+import { traceRoute } from '@/lib/tracing';
 
-export async function GET(
+// GET /api/workspaces/[id]/search?q=...&limit=&offset=
+// Ranked hybrid search (full-text + trigram + semantic), see lib/searchIndex.ts
+export const GET = traceRoute('GET /api/workspaces/[id]/search', searchWorkspace);
+
+async function searchWorkspace(
   request: NextRequest,
   { params }: { params: Promise<{ id: string }> }
 ) {
@@ -10,31 +15,24 @@ export async function GET(
     const { id: workspaceId } = await params;
     const { searchParams } = new URL(request.url);
     const query = searchParams.get('q');
+    const limit = parseInt(searchParams.get('limit') || '100');
+    const offset = parseInt(searchParams.get('offset') || '0');
 
     // Check authentication and workspace access
     await requireWorkspaceAccess(workspaceId, false);
 
     if (!query) {
-      return NextResponse.json({ nodeIds: [] });
+      return NextResponse.json({ nodeIds: [], total: 0, nextOffset: null });
     }
 
-    // Use Prisma to search nodes - search in title and tags
-    const nodes = await prisma.node.findMany({
-      where: {
-        workspaceId,
-        OR: [
-          { title: { contains: query, mode: 'insensitive' } },
-          { tags: { has: query } },
-        ],
-      },
-      select: {
-        id: true,
-      },
+    const page = await searchWorkspaceNodes(workspaceId, query, {
+      limit: Number.isFinite(limit) ? limit : 100,
+      offset: Number.isFinite(offset) ? offset : 0,
     });
 
-    const nodeIds = nodes.map((n) => n.id);
+    const nodeIds = page.hits.map((hit) => hit.id);
 
-    return NextResponse.json({ nodeIds });
+    return NextResponse.json({ nodeIds, total: page.total, nextOffset: page.nextOffset });
   } catch (error: any) {
     console.error('Error searching:', error);
     if (error.message === 'Unauthorized' || error.message.includes('Forbidden')) {
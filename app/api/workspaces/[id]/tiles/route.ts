@@ -0,0 +1,89 @@
+import { NextRequest, NextResponse } from 'next/server';
+import { requireWorkspaceAccess } from '@/lib/api-helpers';
+import { prisma } from '@/lib/db';
+import { getTileGraph, getTileSummaries } from '@/lib/graphTiles';
+import {
+  MAX_TILES_PER_REQUEST,
+  TILE_SIZE,
+  parseTileKey,
+  tileKey,
+  type TileCoord,
+} from '@/lib/viewportTiles';
+import { traceRoute } from '@/lib/tracing';
+
+// GET /api/workspaces/[id]/tiles?tiles=0:0,1:0  - nodes in those tiles plus their edges
+// GET /api/workspaces/[id]/tiles                - per-tile aggregates for the whole workspace
+// Tile grid is defined in lib/viewportTiles.ts. `version` is read before the rows, so
+// anything racing with the read is re-sent by the next ?since= delta
+export const GET = traceRoute('GET /api/workspaces/[id]/tiles', getGraphTiles);
+
+async function getGraphTiles(
+  request: NextRequest,
+  { params }: { params: Promise<{ id: string }> }
+) {
+  try {
+    const { id: workspaceId } = await params;
+
+    await requireWorkspaceAccess(workspaceId, false);
+
+    const tilesParam = request.nextUrl.searchParams.get('tiles');
+
+    let tiles: TileCoord[] | null = null;
+    if (tilesParam !== null) {
+      const keys = Array.from(new Set(tilesParam.split(',').filter(Boolean)));
+      if (keys.length > MAX_TILES_PER_REQUEST) {
+        return NextResponse.json(
+          { error: `Too many tiles (max ${MAX_TILES_PER_REQUEST})` },
+          { status: 400 }
+        );
+      }
+      tiles = [];
+      for (const key of keys) {
+        const tile = parseTileKey(key);
+        if (!tile) {
+          return NextResponse.json({ error: `Invalid tile key: ${key}` }, { status: 400 });
+        }
+        tiles.push(tile);
+      }
+    }
+
+    const workspace = await prisma.workspace.findUnique({
+      where: { id: workspaceId },
+      select: { graphVersion: true },
+    });
+
+    if (!workspace) {
+      return NextResponse.json({ error: 'Workspace not found' }, { status: 404 });
+    }
+
+    if (!tiles) {
+      const summaries = await getTileSummaries(workspaceId);
+      return NextResponse.json({
+        version: workspace.graphVersion,
+        tileSize: TILE_SIZE,
+        summaries,
+      });
+    }
+
+    const { nodes, edges } = await getTileGraph(workspaceId, tiles);
+
+    return NextResponse.json({
+      version: workspace.graphVersion,
+      tileSize: TILE_SIZE,
+      tiles: tiles.map((tile) => tileKey(tile.tx, tile.ty)),
+      nodes,
+      edges,
+    });
+  } catch (error: any) {
+    console.error('Error fetching graph tiles:', error);
+
+    if (error.message === 'Unauthorized' || error.message?.includes('Forbidden')) {
+      return NextResponse.json({ error: error.message }, { status: 403 });
+    }
+
+    return NextResponse.json(
+      { error: 'Failed to fetch graph tiles' },
+      { status: 500 }
+    );
+  }
+}
@@ -0,0 +1,36 @@
+/**
+ * Copy the modules shared with the Next.js app into src/shared/
+ *
+ * Usage (runs automatically before dev and build):
+ *   npm run shared
+ *
+ * lib/vectorStore.ts and lib/clustering.ts are the only source; the copies under
+ * src/shared/ are generated and not committed. Imports between shared modules get the
+ * .js suffix this package's ESM output needs.
+ */
+
+import { mkdirSync, readFileSync, writeFileSync } from 'fs';
+import { dirname, resolve } from 'path';
+import { fileURLToPath } from 'url';
+
+const SHARED_MODULES = ['vectorStore', 'clustering'];
+
+const backendDir = resolve(dirname(fileURLToPath(import.meta.url)), '..');
+const sourceDir = resolve(backendDir, '../lib');
+const targetDir = resolve(backendDir, 'src/shared');
+
+mkdirSync(targetDir, { recursive: true });
+
+for (const name of SHARED_MODULES) {
+  const source = readFileSync(resolve(sourceDir, `${name}.ts`), 'utf8');
+  const rewritten = source.replace(
+    /from '\.\/([A-Za-z0-9_-]+)'/g,
+    (match, module: string) => (SHARED_MODULES.includes(module) ? `from './${module}.js'` : match)
+  );
+  writeFileSync(
+    resolve(targetDir, `${name}.ts`),
+    `// Generated from lib/${name}.ts by scripts/copy-shared.ts - edit that file instead\n\n${rewritten}`
+  );
+}
+
+console.log(`Copied ${SHARED_MODULES.length} shared modules into src/shared/`);
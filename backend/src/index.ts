@@ -10,7 +10,8 @@ const app = express();
 const PORT = process.env.PORT || 3001;
 
 app.use(cors());
-app.use(express.json());
+// Large graphs post their full id and edge lists to /api/graph
+app.use(express.json({ limit: '10mb' }));
 
 // Routes
 app.use('/api/ai', aiRouter);
@@ -4,16 +4,25 @@ import { suggestConnections, generateEmbedding } from '../services/aiService.js'
 export const aiRouter = Router();
 
 // Suggest connections for a new node
+// Optional `workspaceVersion` (any string that changes with the graph) skips hashing node
+// contents for the cache key - the node ids are always part of it; `candidates` sets how
+// many nodes the rerank stage sees
 aiRouter.post('/suggest-connections', async (req, res) => {
   try {
-    const { content, existingNodes } = req.body;
+    const { content, existingNodes, workspaceVersion, candidates } = req.body;
     
     if (!content) {
       return res.status(400).json({ error: 'Content is required' });
     }
+    if (existingNodes !== undefined && !Array.isArray(existingNodes)) {
+      return res.status(400).json({ error: 'existingNodes must be an array' });
+    }
 
-    const suggestions = await suggestConnections(content, existingNodes || []);
-    res.json({ suggestions });
+    const result = await suggestConnections(content, existingNodes || [], {
+      workspaceVersion: typeof workspaceVersion === 'string' ? workspaceVersion : undefined,
+      candidates: Number.isFinite(candidates) ? candidates : undefined,
+    });
+    res.json(result);
   } catch (error) {
     console.error('Error suggesting connections:', error);
     res.status(500).json({ error: 'Failed to suggest connections' });
@@ -1,5 +1,6 @@
 import { Router } from 'express';
-import { clusterNodes, calculateNodeImportance } from '../services/graphService.js';
+import { assignToClusters, clusterNodes, calculateNodeImportance } from '../services/graphService.js';
+import { getGraphAnalytics } from '../services/graphAnalytics.js';
 
 export const graphRouter = Router();
 
@@ -20,6 +21,22 @@ graphRouter.post('/cluster', async (req, res) => {
   }
 });
 
+// Assign new nodes to previously computed clusters (nearest centroid) without reclustering
+graphRouter.post('/cluster/assign', async (req, res) => {
+  try {
+    const { nodes, clusters } = req.body;
+
+    if (!Array.isArray(nodes) || !Array.isArray(clusters)) {
+      return res.status(400).json({ error: 'Nodes and clusters arrays are required' });
+    }
+
+    res.json({ assignments: assignToClusters(nodes, clusters) });
+  } catch (error) {
+    console.error('Error assigning nodes to clusters:', error);
+    res.status(500).json({ error: 'Failed to assign nodes to clusters' });
+  }
+});
+
 // Calculate importance scores for nodes
 graphRouter.post('/importance', async (req, res) => {
   try {
@@ -37,3 +54,29 @@ graphRouter.post('/importance', async (req, res) => {
   }
 });
 
+
+// PageRank, betweenness and connected components for a graph topology
+// Body: { nodeIds: string[], edges: [source, target][] } - ids only, so clients need not
+// resend titles and content. Results are cached per graph version (topology hash).
+graphRouter.post('/analytics', async (req, res) => {
+  try {
+    const { nodeIds, edges } = req.body;
+
+    if (!Array.isArray(nodeIds) || nodeIds.some((id) => typeof id !== 'string')) {
+      return res.status(400).json({ error: 'nodeIds array is required' });
+    }
+    if (edges !== undefined && !Array.isArray(edges)) {
+      return res.status(400).json({ error: 'edges must be an array of [source, target] pairs' });
+    }
+
+    const pairs = (edges || [])
+      .filter((edge: unknown) => Array.isArray(edge) && edge.length >= 2)
+      .map(([source, target]: [unknown, unknown]) => ({ source: String(source), target: String(target) }));
+
+    const { analytics, cached } = getGraphAnalytics(nodeIds, pairs);
+    res.json({ ...analytics, cached });
+  } catch (error) {
+    console.error('Error computing graph analytics:', error);
+    res.status(500).json({ error: 'Failed to compute graph analytics' });
+  }
+});
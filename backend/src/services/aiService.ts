@@ -1,4 +1,6 @@
+import { createHash } from 'crypto';
 import OpenAI from 'openai';
+import { VectorStore } from '../shared/vectorStore.js';
 
 const openai = new OpenAI({
   apiKey: process.env.OPENAI_API_KEY || '',
@@ -8,6 +10,8 @@ interface Node {
   id: string;
   title: string;
   content: string;
+  embedding?: number[];
+  updatedAt?: string;
 }
 
 interface ConnectionSuggestion {
@@ -16,59 +20,223 @@ interface ConnectionSuggestion {
   confidence: number;
 }
 
-// Suggest connections for a new node based on existing nodes
-export async function suggestConnections(
+export interface SuggestConnectionsOptions {
+  // Opaque version of the workspace graph; derived from node ids and updatedAt when omitted
+  workspaceVersion?: string;
+  // Candidates handed to the rerank stage
+  candidates?: number;
+}
+
+// Connection suggestions run in two stages so cost scales with the candidate count, not
+// the workspace:
+// 1. retrieval - the nearest CANDIDATE_COUNT nodes to the note's embedding from a VectorStore
+//    over the nodes' embeddings (int8 first pass + exact rescoring on large workspaces),
+//    topped up by keyword overlap for nodes that have no embedding yet
+// 2. rerank - one chat call over just those candidates; without an API key, or if the call
+//    fails, the retrieval order is returned as is
+// Results are cached per (content hash, node set, workspace version), the vector index per
+// (node set, workspace version), and note embeddings per content hash. The node set is a hash
+// of the posted node ids, so a caller-supplied version can't hand one workspace's index or
+// suggestions to another.
+const CANDIDATE_COUNT = 20;
+const MAX_CANDIDATES = 50;
+const MAX_SUGGESTIONS = 5;
+const MIN_CONFIDENCE = 0.3;
+// Above this many embedded nodes the index keeps int8 codes for the first pass
+const QUANTIZE_ABOVE = 5000;
+const SUGGESTION_CACHE_SIZE = 256;
+const INDEX_CACHE_SIZE = 8;
+const EMBEDDING_CACHE_SIZE = 256;
+
+// Least recently used first
+const suggestionCache = new Map<string, ConnectionSuggestion[]>();
+const indexCache = new Map<string, VectorStore>();
+const embeddingCache = new Map<string, number[]>();
+
+function cacheGet<V>(cache: Map<string, V>, key: string): V | undefined {
+  const hit = cache.get(key);
+  if (hit !== undefined) {
+    cache.delete(key);
+    cache.set(key, hit);
+  }
+  return hit;
+}
+
+function cacheSet<V>(cache: Map<string, V>, key: string, value: V, size: number) {
+  cache.set(key, value);
+  if (cache.size > size) cache.delete(cache.keys().next().value!);
+}
+
+function hashText(text: string): string {
+  return createHash('sha1').update(text).digest('hex');
+}
+
+// The posted node ids - part of every workspace-derived cache key
+function nodeSetHash(nodes: Node[]): string {
+  const hash = createHash('sha1');
+  for (const node of nodes) hash.update(node.id).update('\0');
+  return hash.digest('hex');
+}
+
+// Ids and updatedAt (the text itself when a node has none), plus whether an embedding arrived
+function workspaceVersion(nodes: Node[]): string {
+  const hash = createHash('sha1');
+  for (const node of nodes) {
+    hash
+      .update(node.id)
+      .update('\0')
+      .update(node.updatedAt ?? `${node.title}\0${node.content}`)
+      .update(node.embedding?.length ? '\1' : '\0');
+  }
+  return hash.digest('hex');
+}
+
+function vectorIndex(scope: string, nodes: Node[]): VectorStore {
+  const cached = cacheGet(indexCache, scope);
+  if (cached) return cached;
+  const embedded = nodes.filter((node) => node.embedding && node.embedding.length > 0);
+  const index = VectorStore.from(embedded, {
+    quantization: embedded.length > QUANTIZE_ABOVE ? 'int8' : 'none',
+  });
+  cacheSet(indexCache, scope, index, INDEX_CACHE_SIZE);
+  return index;
+}
+
+async function noteEmbedding(content: string, contentHash: string): Promise<number[] | null> {
+  const cached = cacheGet(embeddingCache, contentHash);
+  if (cached) return cached;
+  try {
+    const response = await openai.embeddings.create({
+      model: 'text-embedding-3-small',
+      input: content.substring(0, 8000),
+    });
+    const embedding = response.data[0].embedding;
+    cacheSet(embeddingCache, contentHash, embedding, EMBEDDING_CACHE_SIZE);
+    return embedding;
+  } catch (error) {
+    console.error('OpenAI embedding error, retrieving by keywords only:', error);
+    return null;
+  }
+}
+
+// Stage 1: nearest nodes by embedding, then keyword matches among nodes without one
+async function retrieveCandidates(
   content: string,
-  existingNodes: Node[]
+  contentHash: string,
+  nodes: Node[],
+  scope: string,
+  count: number
 ): Promise<ConnectionSuggestion[]> {
-  // If no OpenAI API key, return simple keyword-based suggestions
-  if (!process.env.OPENAI_API_KEY) {
-    return suggestConnectionsSimple(content, existingNodes);
+  const candidates: ConnectionSuggestion[] = [];
+  // Node embeddings are only comparable with an OpenAI embedding of the note
+  const index = process.env.OPENAI_API_KEY ? vectorIndex(scope, nodes) : null;
+  const embedding = index && index.size > 0 ? await noteEmbedding(content, contentHash) : null;
+
+  if (index && embedding) {
+    for (const match of index.search(embedding, count)) {
+      candidates.push({
+        nodeId: match.id,
+        reason: `Semantically similar (${Math.round(match.similarity * 100)}%)`,
+        confidence: Math.max(0, Math.min(match.similarity, 1)),
+      });
+    }
   }
 
-  try {
-    const nodeSummaries = existingNodes
-      .slice(0, 50) // Limit to prevent token overflow
-      .map((node) => `ID: ${node.id}\nTitle: ${node.title}\nContent: ${node.content.substring(0, 200)}`)
-      .join('\n\n---\n\n');
+  // Without a note embedding every node competes on keywords
+  if (candidates.length < count) {
+    const rest = index && embedding ? nodes.filter((node) => !index.has(node.id)) : nodes;
+    candidates.push(...keywordMatches(content, rest).slice(0, count - candidates.length));
+  }
+  return candidates;
+}
 
-    const prompt = `Given a new note with the following content:
+// Stage 2: one batched chat call ranks the candidates; ids in the answer that aren't
+// candidates are dropped
+async function rerankCandidates(
+  content: string,
+  candidates: ConnectionSuggestion[],
+  nodesById: Map<string, Node>
+): Promise<ConnectionSuggestion[]> {
+  const candidateNodes = new Map<string, Node>();
+  for (const { nodeId } of candidates) {
+    const node = nodesById.get(nodeId);
+    if (node) candidateNodes.set(nodeId, node);
+  }
+  if (candidateNodes.size === 0) return [];
+
+  const summaries = [...candidateNodes.values()]
+    .map((node, i) => `[${i + 1}] ID: ${node.id}\nTitle: ${node.title}\nContent: ${(node.content || '').substring(0, 300)}`)
+    .join('\n\n');
+
+  const prompt = `Given a new note with the following content:
 
 "${content.substring(0, 1000)}"
 
-And these existing notes:
-${nodeSummaries}
+And these candidate notes:
+${summaries}
 
-Identify up to 5 existing notes that are most related to this new note. For each, provide:
+Pick up to ${MAX_SUGGESTIONS} candidates that are genuinely related to the new note. For each, provide:
 1. The node ID
 2. A brief reason for the connection
 3. A confidence score from 0 to 1
 
-Return as JSON array: [{"nodeId": "...", "reason": "...", "confidence": 0.8}]`;
-
-    const completion = await openai.chat.completions.create({
-      model: 'gpt-3.5-turbo',
-      messages: [
-        {
-          role: 'system',
-          content: 'You are a knowledge graph assistant that identifies connections between ideas. Always return valid JSON.',
-        },
-        { role: 'user', content: prompt },
-      ],
-      temperature: 0.3,
-    });
+Return JSON: {"suggestions": [{"nodeId": "...", "reason": "...", "confidence": 0.8}]}`;
 
-    const response = completion.choices[0]?.message?.content || '[]';
-    const suggestions = JSON.parse(response) as ConnectionSuggestion[];
-    return suggestions.filter((s) => s.confidence > 0.3);
-  } catch (error) {
-    console.error('OpenAI API error, falling back to simple suggestions:', error);
-    return suggestConnectionsSimple(content, existingNodes);
+  const completion = await openai.chat.completions.create({
+    model: 'gpt-3.5-turbo',
+    messages: [
+      {
+        role: 'system',
+        content: 'You are a knowledge graph assistant that identifies connections between ideas. Always return valid JSON.',
+      },
+      { role: 'user', content: prompt },
+    ],
+    response_format: { type: 'json_object' },
+    temperature: 0.3,
+  });
+
+  const response = JSON.parse(completion.choices[0]?.message?.content || '{}');
+  const suggestions: ConnectionSuggestion[] = Array.isArray(response.suggestions) ? response.suggestions : [];
+  return suggestions
+    .filter((s) => candidateNodes.has(s.nodeId) && typeof s.confidence === 'number')
+    .slice(0, MAX_SUGGESTIONS);
+}
+
+// Suggest connections for a new node based on existing nodes
+export async function suggestConnections(
+  content: string,
+  existingNodes: Node[],
+  options: SuggestConnectionsOptions = {}
+): Promise<{ suggestions: ConnectionSuggestion[]; cached: boolean }> {
+  const version = options.workspaceVersion ?? workspaceVersion(existingNodes);
+  const scope = `${nodeSetHash(existingNodes)}:${version}`;
+  const contentHash = hashText(content);
+  const count = Math.min(Math.max(options.candidates ?? CANDIDATE_COUNT, MAX_SUGGESTIONS), MAX_CANDIDATES);
+  const cacheKey = `${contentHash}:${scope}:${count}`;
+  const cached = cacheGet(suggestionCache, cacheKey);
+  if (cached) return { suggestions: cached, cached: true };
+
+  const candidates = await retrieveCandidates(content, contentHash, existingNodes, scope, count);
+
+  let suggestions = candidates.slice(0, MAX_SUGGESTIONS);
+  if (process.env.OPENAI_API_KEY && candidates.length > 0) {
+    try {
+      const nodesById = new Map(existingNodes.map((node) => [node.id, node]));
+      const reranked = await rerankCandidates(content, candidates, nodesById);
+      suggestions = reranked.filter((s) => s.confidence > MIN_CONFIDENCE);
+    } catch (error) {
+      // Not cached - the next request retries the rerank
+      console.error('OpenAI API error, returning retrieval order:', error);
+      return { suggestions, cached: false };
+    }
   }
+
+  cacheSet(suggestionCache, cacheKey, suggestions, SUGGESTION_CACHE_SIZE);
+  return { suggestions, cached: false };
 }
 
-// Simple keyword-based connection suggestion (fallback)
-function suggestConnectionsSimple(
+// Keyword overlap with the note, best first (candidates for nodes without an embedding)
+function keywordMatches(
   content: string,
   existingNodes: Node[]
 ): ConnectionSuggestion[] {
@@ -97,9 +265,7 @@ function suggestConnectionsSimple(
     }
   }
 
-  return suggestions
-    .sort((a, b) => b.confidence - a.confidence)
-    .slice(0, 5);
+  return suggestions.sort((a, b) => b.confidence - a.confidence);
 }
 
 // Generate embedding for semantic similarity
@@ -0,0 +1,293 @@
+import { createHash } from 'crypto';
+
+// Graph analytics over a compressed sparse row (CSR) adjacency
+// - node ids are mapped to dense indices once; neighbours of node i are
+//   targets[offsets[i] .. offsets[i + 1]), so every pass is a walk over two typed arrays
+// - edges are treated as undirected (similarity links are stored in canonical id order,
+//   so their direction carries no meaning)
+// - results are cached per graph version: a hash of the node ids and edge endpoints, so
+//   edits to titles, content or positions reuse the cached metrics
+
+export interface AnalyticsEdge {
+  source: string;
+  target: string;
+}
+
+export interface CsrGraph {
+  ids: string[];
+  offsets: Int32Array;
+  targets: Int32Array;
+}
+
+export interface NodeMetrics {
+  // Normalized to [0, 1] by the largest value in the graph
+  pagerank: number;
+  betweenness: number;
+  // Connected component index; 0 is the largest component
+  component: number;
+}
+
+export interface GraphAnalytics {
+  version: string;
+  metrics: Record<string, NodeMetrics>;
+  componentCount: number;
+}
+
+const PAGERANK_DAMPING = 0.85;
+const PAGERANK_TOLERANCE = 1e-6;
+const PAGERANK_MAX_ITERATIONS = 100;
+// Brandes from this many sampled sources; exact below it
+const BETWEENNESS_SAMPLES = 64;
+const CACHE_SIZE = 64;
+
+/**
+ * Build an undirected CSR graph; edges to unknown nodes, self-loops and duplicate
+ * pairs are dropped
+ */
+export function buildCsr(nodeIds: string[], edges: AnalyticsEdge[]): CsrGraph {
+  const index = new Map<string, number>();
+  const ids: string[] = [];
+  for (const id of nodeIds) {
+    if (!index.has(id)) {
+      index.set(id, ids.length);
+      ids.push(id);
+    }
+  }
+  const n = ids.length;
+
+  // Deduplicate undirected pairs
+  const pairs: number[] = [];
+  const seen = new Set<number>();
+  for (const edge of edges) {
+    const a = index.get(edge.source);
+    const b = index.get(edge.target);
+    if (a === undefined || b === undefined || a === b) continue;
+    const lo = Math.min(a, b);
+    const hi = Math.max(a, b);
+    const key = lo * n + hi;
+    if (seen.has(key)) continue;
+    seen.add(key);
+    pairs.push(lo, hi);
+  }
+
+  const degree = new Int32Array(n);
+  for (let i = 0; i < pairs.length; i++) degree[pairs[i]]++;
+
+  const offsets = new Int32Array(n + 1);
+  for (let i = 0; i < n; i++) offsets[i + 1] = offsets[i] + degree[i];
+
+  const targets = new Int32Array(offsets[n]);
+  const fill = offsets.slice(0, n);
+  for (let i = 0; i < pairs.length; i += 2) {
+    const a = pairs[i];
+    const b = pairs[i + 1];
+    targets[fill[a]++] = b;
+    targets[fill[b]++] = a;
+  }
+
+  return { ids, offsets, targets };
+}
+
+/**
+ * PageRank by power iteration; isolated nodes spread their rank uniformly
+ */
+export function pageRank(graph: CsrGraph): Float64Array {
+  const n = graph.ids.length;
+  const { offsets, targets } = graph;
+  let rank = new Float64Array(n).fill(n > 0 ? 1 / n : 0);
+  let next = new Float64Array(n);
+  if (n === 0) return rank;
+
+  for (let iteration = 0; iteration < PAGERANK_MAX_ITERATIONS; iteration++) {
+    let dangling = 0;
+    next.fill(0);
+    for (let i = 0; i < n; i++) {
+      const degree = offsets[i + 1] - offsets[i];
+      if (degree === 0) {
+        dangling += rank[i];
+        continue;
+      }
+      const share = rank[i] / degree;
+      for (let e = offsets[i]; e < offsets[i + 1]; e++) next[targets[e]] += share;
+    }
+
+    const base = (1 - PAGERANK_DAMPING) / n + (PAGERANK_DAMPING * dangling) / n;
+    let delta = 0;
+    for (let i = 0; i < n; i++) {
+      const value = base + PAGERANK_DAMPING * next[i];
+      delta += Math.abs(value - rank[i]);
+      next[i] = value;
+    }
+
+    [rank, next] = [next, rank];
+    if (delta < PAGERANK_TOLERANCE) break;
+  }
+
+  return rank;
+}
+
+/**
+ * Betweenness centrality (Brandes), estimated from evenly spaced sample sources when the
+ * graph has more than `samples` nodes
+ */
+export function approximateBetweenness(graph: CsrGraph, samples: number = BETWEENNESS_SAMPLES): Float64Array {
+  const n = graph.ids.length;
+  const { offsets, targets } = graph;
+  const centrality = new Float64Array(n);
+  if (n < 3) return centrality;
+
+  const sourceCount = Math.min(n, samples);
+  const step = n / sourceCount;
+
+  const sigma = new Float64Array(n);
+  const distance = new Int32Array(n);
+  const delta = new Float64Array(n);
+  const order = new Int32Array(n);
+
+  for (let s = 0; s < sourceCount; s++) {
+    const source = Math.floor(s * step);
+    sigma.fill(0);
+    distance.fill(-1);
+    delta.fill(0);
+
+    sigma[source] = 1;
+    distance[source] = 0;
+    // BFS order doubles as the queue and, reversed, as the dependency accumulation order
+    let head = 0;
+    let tail = 0;
+    order[tail++] = source;
+    while (head < tail) {
+      const v = order[head++];
+      for (let e = offsets[v]; e < offsets[v + 1]; e++) {
+        const w = targets[e];
+        if (distance[w] < 0) {
+          distance[w] = distance[v] + 1;
+          order[tail++] = w;
+        }
+        if (distance[w] === distance[v] + 1) sigma[w] += sigma[v];
+      }
+    }
+
+    for (let i = tail - 1; i > 0; i--) {
+      const w = order[i];
+      for (let e = offsets[w]; e < offsets[w + 1]; e++) {
+        const v = targets[e];
+        if (distance[v] === distance[w] - 1) {
+          delta[v] += (sigma[v] / sigma[w]) * (1 + delta[w]);
+        }
+      }
+      centrality[w] += delta[w];
+    }
+  }
+
+  // Scale sampled sums up to the full source set
+  const scale = n / sourceCount;
+  for (let i = 0; i < n; i++) centrality[i] *= scale;
+  return centrality;
+}
+
+/**
+ * Connected components; labels are ordered by component size, largest first
+ */
+export function connectedComponents(graph: CsrGraph): { labels: Int32Array; count: number } {
+  const n = graph.ids.length;
+  const { offsets, targets } = graph;
+  const labels = new Int32Array(n).fill(-1);
+  const sizes: number[] = [];
+  const stack = new Int32Array(n);
+
+  for (let start = 0; start < n; start++) {
+    if (labels[start] >= 0) continue;
+    const label = sizes.length;
+    let size = 0;
+    let top = 0;
+    stack[top++] = start;
+    labels[start] = label;
+    while (top > 0) {
+      const v = stack[--top];
+      size++;
+      for (let e = offsets[v]; e < offsets[v + 1]; e++) {
+        const w = targets[e];
+        if (labels[w] < 0) {
+          labels[w] = label;
+          stack[top++] = w;
+        }
+      }
+    }
+    sizes.push(size);
+  }
+
+  const bySize = sizes.map((_, i) => i).sort((a, b) => sizes[b] - sizes[a]);
+  const rankOf = new Int32Array(sizes.length);
+  bySize.forEach((label, rank) => {
+    rankOf[label] = rank;
+  });
+  for (let i = 0; i < n; i++) labels[i] = rankOf[labels[i]];
+
+  return { labels, count: sizes.length };
+}
+
+// Loop instead of Math.max(...values), which overflows the call stack on large graphs
+function maxOf(values: ArrayLike<number>): number {
+  let max = 0;
+  for (let i = 0; i < values.length; i++) if (values[i] > max) max = values[i];
+  return max;
+}
+
+/**
+ * Version key for a graph's topology - same ids and endpoints, same key
+ */
+export function graphVersion(nodeIds: string[], edges: AnalyticsEdge[]): string {
+  const hash = createHash('sha1');
+  for (const id of [...nodeIds].sort()) hash.update(id).update('\0');
+  hash.update('\x01');
+  const pairs = edges.map((edge) =>
+    edge.source < edge.target ? `${edge.source}\0${edge.target}` : `${edge.target}\0${edge.source}`
+  );
+  for (const pair of pairs.sort()) hash.update(pair).update('\x02');
+  return hash.digest('hex');
+}
+
+export function analyzeGraph(nodeIds: string[], edges: AnalyticsEdge[], version: string): GraphAnalytics {
+  const graph = buildCsr(nodeIds, edges);
+  const rank = pageRank(graph);
+  const betweenness = approximateBetweenness(graph);
+  const { labels, count } = connectedComponents(graph);
+
+  const maxRank = maxOf(rank) || 1;
+  const maxBetweenness = maxOf(betweenness) || 1;
+  const metrics: Record<string, NodeMetrics> = {};
+  graph.ids.forEach((id, i) => {
+    metrics[id] = {
+      pagerank: rank[i] / maxRank,
+      betweenness: betweenness[i] / maxBetweenness,
+      component: labels[i],
+    };
+  });
+
+  return { version, metrics, componentCount: count };
+}
+
+// Least recently used first
+const cache = new Map<string, GraphAnalytics>();
+
+/**
+ * Analytics for a graph, computed once per graph version
+ */
+export function getGraphAnalytics(
+  nodeIds: string[],
+  edges: AnalyticsEdge[]
+): { analytics: GraphAnalytics; cached: boolean } {
+  const version = graphVersion(nodeIds, edges);
+  const hit = cache.get(version);
+  if (hit) {
+    cache.delete(version);
+    cache.set(version, hit);
+    return { analytics: hit, cached: true };
+  }
+
+  const analytics = analyzeGraph(nodeIds, edges, version);
+  cache.set(version, analytics);
+  if (cache.size > CACHE_SIZE) cache.delete(cache.keys().next().value!);
+  return { analytics, cached: false };
+}
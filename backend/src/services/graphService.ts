@@ -1,3 +1,8 @@
+import { createHash } from 'crypto';
+import { VectorStore, normalizeVector } from '../shared/vectorStore.js';
+import { defaultClusterCount, kMeans, nearestCentroid } from '../shared/clustering.js';
+import { getGraphAnalytics } from './graphAnalytics.js';
+
 interface Node {
   id: string;
   title: string;
@@ -21,141 +26,138 @@ interface Cluster {
   label: string;
 }
 
-// Cluster nodes using K-means-like algorithm on embeddings
+// Cluster nodes by embedding: spherical k-means (k-means++ seeding, mini-batch on large
+// inputs) over the packed rows of a VectorStore. Results are cached by a hash of the ids and
+// embeddings, so repeated /cluster requests for unchanged nodes skip the run.
+const CLUSTER_CACHE_SIZE = 16;
+const clusterCache = new Map<string, Cluster[]>();
+
+function clusterCacheKey(store: VectorStore, ids: string[], unembedded: string[]): string {
+  const hash = createHash('sha1');
+  for (const id of ids) {
+    const row = store.get(id)!;
+    hash.update(id).update(new Uint8Array(row.buffer, row.byteOffset, row.byteLength));
+  }
+  hash.update('\0');
+  for (const id of unembedded) hash.update(id).update('\0');
+  return hash.digest('hex');
+}
+
 export function clusterNodes(nodes: Node[]): Cluster[] {
   if (nodes.length === 0) return [];
 
+  const store = VectorStore.from(nodes);
+  const embeddedIds = store.keys();
+
   // If nodes don't have embeddings, use simple text-based clustering
-  const nodesWithEmbeddings = nodes.filter((n) => n.embedding);
-  if (nodesWithEmbeddings.length < 2) {
+  if (embeddedIds.length < 2) {
     return [{ id: 'cluster-1', nodes: nodes.map((n) => n.id), centroid: [], label: 'All Nodes' }];
   }
 
-  // Simple K-means clustering (K = sqrt(n/2))
-  const k = Math.max(2, Math.floor(Math.sqrt(nodesWithEmbeddings.length / 2)));
-  const clusters: Cluster[] = [];
-
-  // Initialize centroids randomly
-  const centroids: number[][] = [];
-  for (let i = 0; i < k; i++) {
-    const randomNode = nodesWithEmbeddings[Math.floor(Math.random() * nodesWithEmbeddings.length)];
-    centroids.push([...randomNode.embedding!]);
+  const nodesWithoutEmbeddings = nodes.filter((n) => !store.has(n.id)).map((n) => n.id);
+  const key = clusterCacheKey(store, embeddedIds, nodesWithoutEmbeddings);
+  const cached = clusterCache.get(key);
+  if (cached) {
+    clusterCache.delete(key);
+    clusterCache.set(key, cached);
+    return cached;
   }
 
-  // Iterate to find clusters
-  for (let iter = 0; iter < 10; iter++) {
-    const assignments: string[][] = new Array(k).fill(null).map(() => []);
-
-    // Assign nodes to nearest centroid
-    for (const node of nodesWithEmbeddings) {
-      let minDist = Infinity;
-      let nearestCluster = 0;
-
-      for (let i = 0; i < k; i++) {
-        const dist = cosineDistance(node.embedding!, centroids[i]);
-        if (dist < minDist) {
-          minDist = dist;
-          nearestCluster = i;
-        }
-      }
-
-      assignments[nearestCluster].push(node.id);
-    }
-
-    // Update centroids
-    for (let i = 0; i < k; i++) {
-      if (assignments[i].length > 0) {
-        const clusterNodes = nodesWithEmbeddings.filter((n) => assignments[i].includes(n.id));
-        const dim = clusterNodes[0].embedding!.length;
-        centroids[i] = new Array(dim).fill(0);
-
-        for (const node of clusterNodes) {
-          for (let j = 0; j < dim; j++) {
-            centroids[i][j] += node.embedding![j];
-          }
-        }
-
-        for (let j = 0; j < dim; j++) {
-          centroids[i][j] /= clusterNodes.length;
-        }
-      }
+  // Pack the normalized rows contiguously for the clustering passes
+  const dim = store.dimension;
+  const rows = new Float32Array(embeddedIds.length * dim);
+  embeddedIds.forEach((id, i) => rows.set(store.get(id)!, i * dim));
+
+  const result = kMeans(rows, embeddedIds.length, dim, { k: defaultClusterCount(embeddedIds.length) });
+  const titleById = new Map(nodes.map((n) => [n.id, n.title]));
+
+  const members: string[][] = Array.from({ length: result.k }, () => []);
+  // Label each cluster after the member closest to its centroid
+  const representative = new Int32Array(result.k).fill(-1);
+  embeddedIds.forEach((id, i) => {
+    const c = result.assignments[i];
+    members[c].push(id);
+    if (representative[c] < 0 || result.similarities[i] > result.similarities[representative[c]]) {
+      representative[c] = i;
     }
+  });
 
-    // Create cluster objects
-    clusters.length = 0;
-    for (let i = 0; i < k; i++) {
-      if (assignments[i].length > 0) {
-        const clusterNodes = nodesWithEmbeddings.filter((n) => assignments[i].includes(n.id));
-        const label = clusterNodes[0]?.title || `Cluster ${i + 1}`;
-        clusters.push({
-          id: `cluster-${i}`,
-          nodes: assignments[i],
-          centroid: centroids[i],
-          label,
-        });
-      }
+  // Create cluster objects
+  const clusters: Cluster[] = [];
+  for (let i = 0; i < result.k; i++) {
+    if (members[i].length > 0) {
+      clusters.push({
+        id: `cluster-${i}`,
+        nodes: members[i],
+        centroid: Array.from(result.centroids.subarray(i * dim, (i + 1) * dim)),
+        label: titleById.get(embeddedIds[representative[i]]) || `Cluster ${i + 1}`,
+      });
     }
   }
+  clusters.sort((a, b) => b.nodes.length - a.nodes.length);
 
   // Add nodes without embeddings to the largest cluster
-  const nodesWithoutEmbeddings = nodes.filter((n) => !n.embedding);
   if (nodesWithoutEmbeddings.length > 0 && clusters.length > 0) {
-    clusters[0].nodes.push(...nodesWithoutEmbeddings.map((n) => n.id));
+    clusters[0].nodes.push(...nodesWithoutEmbeddings);
   }
 
+  clusterCache.set(key, clusters);
+  if (clusterCache.size > CLUSTER_CACHE_SIZE) clusterCache.delete(clusterCache.keys().next().value!);
   return clusters;
 }
 
-// Calculate node importance based on connectivity and recency
-export function calculateNodeImportance(nodes: Node[], edges: Edge[]): Record<string, number> {
-  const importance: Record<string, number> = {};
+/**
+ * Assign nodes to the nearest of previously computed clusters without reclustering
+ * Nodes without a usable embedding are left out
+ */
+export function assignToClusters(nodes: Node[], clusters: Cluster[]): Record<string, string> {
+  const withCentroids = clusters.filter((c) => c.centroid.length > 0);
+  const assignments: Record<string, string> = {};
+  if (withCentroids.length === 0) return assignments;
+
+  const dim = withCentroids[0].centroid.length;
+  const centroids = new Float32Array(withCentroids.length * dim);
+  withCentroids.forEach((cluster, i) => {
+    const normalized = cluster.centroid.length === dim ? normalizeVector(cluster.centroid) : null;
+    if (normalized) centroids.set(normalized, i * dim);
+  });
 
-  // Count connections per node
-  const connectionCount: Record<string, number> = {};
   for (const node of nodes) {
-    connectionCount[node.id] = 0;
+    if (!node.embedding || node.embedding.length !== dim) continue;
+    const vector = normalizeVector(node.embedding);
+    if (!vector) continue;
+    assignments[node.id] = withCentroids[nearestCentroid(vector, centroids, withCentroids.length, dim).index].id;
   }
+  return assignments;
+}
 
-  for (const edge of edges) {
-    connectionCount[edge.source] = (connectionCount[edge.source] || 0) + 1;
-    connectionCount[edge.target] = (connectionCount[edge.target] || 0) + 1;
-  }
+// Calculate node importance from graph centrality and recency
+// PageRank and betweenness come from the cached analytics for this topology, so repeated
+// requests for the same graph only redo the cheap recency term
+export function calculateNodeImportance(nodes: Node[], edges: Edge[]): Record<string, number> {
+  const importance: Record<string, number> = {};
+  if (nodes.length === 0) return importance;
 
-  // Calculate importance: connectivity (70%) + recency (30%)
-  const now = Date.now();
-  const maxConnections = Math.max(...Object.values(connectionCount), 1);
-  const maxAge = Math.max(
-    ...nodes.map((n) => now - new Date(n.updatedAt).getTime()),
-    1
+  const { analytics } = getGraphAnalytics(
+    nodes.map((n) => n.id),
+    edges
   );
 
-  for (const node of nodes) {
-    const connectivity = connectionCount[node.id] / maxConnections;
-    const age = now - new Date(node.updatedAt).getTime();
-    const recency = 1 - age / maxAge;
-
-    importance[node.id] = connectivity * 0.7 + recency * 0.3;
+  // Loop rather than Math.max(...ages), which overflows the call stack on large graphs
+  const now = Date.now();
+  const ages = nodes.map((n) => now - new Date(n.updatedAt).getTime());
+  let maxAge = 1;
+  for (const age of ages) {
+    if (age > maxAge) maxAge = age;
   }
 
-  return importance;
-}
-
-// Cosine distance between two vectors
-function cosineDistance(a: number[], b: number[]): number {
-  if (a.length !== b.length) return 1;
-
-  let dotProduct = 0;
-  let normA = 0;
-  let normB = 0;
-
-  for (let i = 0; i < a.length; i++) {
-    dotProduct += a[i] * b[i];
-    normA += a[i] * a[i];
-    normB += b[i] * b[i];
-  }
+  // Importance: PageRank (50%) + betweenness (20%) + recency (30%)
+  nodes.forEach((node, i) => {
+    const metrics = analytics.metrics[node.id];
+    const recency = 1 - ages[i] / maxAge;
+    importance[node.id] =
+      (metrics?.pagerank ?? 0) * 0.5 + (metrics?.betweenness ?? 0) * 0.2 + recency * 0.3;
+  });
 
-  const similarity = dotProduct / (Math.sqrt(normA) * Math.sqrt(normB));
-  return 1 - similarity; // Convert similarity to distance
+  return importance;
 }
-
-
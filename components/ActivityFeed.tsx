@@ -4,6 +4,7 @@ import { useEffect, useState } from 'react';
 import { Activity, User, FileText, Link2, Users, Settings } from 'lucide-react';
 // import { createClient } from '@/lib/supabase/client'; // Commented out - not used
 import { formatDistanceToNow } from 'date-fns';
+import { useCollabChannel } from '@/lib/collabClient';
 
 interface Activity {
   id: string;
@@ -22,6 +23,23 @@ interface Activity {
   };
 }
 
+// The activity API returns Prisma rows (camelCase)
+function toActivity(row: any): Activity {
+  return {
+    id: row.id,
+    workspace_id: row.workspace_id ?? row.workspaceId,
+    user_id: row.user_id ?? row.userId,
+    action: row.action,
+    entity_type: row.entity_type ?? row.entityType,
+    entity_id: row.entity_id ?? row.entityId ?? undefined,
+    details: row.details,
+    created_at: row.created_at ?? row.createdAt,
+    user: row.user
+      ? { ...row.user, avatar_url: row.user.avatar_url ?? row.user.avatarUrl }
+      : undefined,
+  };
+}
+
 interface ActivityFeedProps {
   workspaceId: string;
   limit?: number;
@@ -30,44 +48,63 @@ interface ActivityFeedProps {
 export default function ActivityFeed({ workspaceId, limit = 50 }: ActivityFeedProps) {
   const [activities, setActivities] = useState<Activity[]>([]);
   const [loading, setLoading] = useState(true);
-  // const supabase = createClient(); // Commented out - not used
+  const [nextCursor, setNextCursor] = useState<string | null>(null);
+  const [loadingMore, setLoadingMore] = useState(false);
+  const channel = useCollabChannel(workspaceId);
 
   useEffect(() => {
     loadActivities();
-    
-    // Subscribe to new activities - commented out until supabase client is properly configured
-    // const channel = supabase
-    //   .channel(`activity:${workspaceId}`)
-    //   .on(
-    //     'postgres_changes',
-    //     {
-    //       event: 'INSERT',
-    //       schema: 'public',
-    //       table: 'activity_log',
-    //       filter: `workspace_id=eq.${workspaceId}`,
-    //     },
-    //     () => {
-    //       loadActivities();
-    //     }
-    //   )
-    //   .subscribe();
-
-    // return () => {
-    //   channel.unsubscribe();
-    // };
   }, [workspaceId]);
 
-  const loadActivities = async () => {
-    const { data, error } = await fetch(
-      `/api/workspaces/${workspaceId}/activity?limit=${limit}`
-    ).then((res) => res.json());
+  // New entries are pushed on the workspace collaboration channel instead of polled
+  useEffect(() => {
+    if (!channel) return;
+    return channel.on('activity', ({ activities: incoming }) => {
+      const fresh = incoming.map(toActivity);
+      setActivities((current) => {
+        const seen = new Set(fresh.map((a) => a.id));
+        // Keep older pages the user already loaded
+        return [...fresh, ...current.filter((a) => !seen.has(a.id))].slice(0, Math.max(limit, current.length));
+      });
+    });
+  }, [channel, limit]);
 
-    if (!error && data.activities) {
-      setActivities(data.activities);
+  const loadActivities = async () => {
+    try {
+      const response = await fetch(`/api/workspaces/${workspaceId}/activity?limit=${limit}`);
+      if (response.ok) {
+        const data = await response.json();
+        setActivities((data.activities || []).map(toActivity));
+        setNextCursor(data.nextCursor ?? null);
+      }
+    } catch (error) {
+      console.error('Error loading activity:', error);
     }
     setLoading(false);
   };
 
+  const loadOlder = async () => {
+    if (!nextCursor || loadingMore) return;
+    setLoadingMore(true);
+    try {
+      const response = await fetch(
+        `/api/workspaces/${workspaceId}/activity?limit=${limit}&before=${encodeURIComponent(nextCursor)}`
+      );
+      if (response.ok) {
+        const data = await response.json();
+        const older = (data.activities || []).map(toActivity);
+        setActivities((current) => {
+          const seen = new Set(current.map((a) => a.id));
+          return [...current, ...older.filter((a: Activity) => !seen.has(a.id))];
+        });
+        setNextCursor(data.nextCursor ?? null);
+      }
+    } catch (error) {
+      console.error('Error loading older activity:', error);
+    }
+    setLoadingMore(false);
+  };
+
   const getActivityIcon = (action: string, entityType: string) => {
     if (entityType === 'node') return <FileText className="w-4 h-4" />;
     if (entityType === 'edge') return <Link2 className="w-4 h-4" />;
@@ -131,6 +168,15 @@ export default function ActivityFeed({ workspaceId, limit = 50 }: ActivityFeedPr
             </div>
           ))
         )}
+        {nextCursor && (
+          <button
+            onClick={loadOlder}
+            disabled={loadingMore}
+            className="w-full py-2 text-xs text-slate-400 hover:text-slate-200 transition-colors"
+          >
+            {loadingMore ? 'Loading…' : 'Load older activity'}
+          </button>
+        )}
       </div>
     </div>
   );
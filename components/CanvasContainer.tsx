@@ -1,6 +1,6 @@
 'use client';
 
-import { useCallback, useEffect, useState, useRef } from 'react';
+import { useCallback, useEffect, useMemo, useState, useRef } from 'react';
 import ReactFlow, {
   Background,
   Controls,
@@ -16,24 +16,75 @@ import ReactFlow, {
   ReactFlowInstance,
   BackgroundVariant,
   useReactFlow,
+  useStore,
 } from 'reactflow';
 import 'reactflow/dist/style.css';
 import { useCanvasStore } from '@/state/canvasStore';
-import { useWorkspaceStore } from '@/state/workspaceStore';
+import { useWorkspaceStore, selectWorkspaceNode } from '@/state/workspaceStore';
 import NodeComponent from './NodeComponent';
+import TileAggregateNode, { TILE_AGGREGATE_TYPE, tileAggregateDiameter } from './TileAggregateNode';
 import EdgeComponent from './EdgeComponent';
+import LodCanvasLayer from './LodCanvasLayer';
 import { useAutoOrganize } from '@/lib/useAutoOrganize';
+import { nodeUpdateQueue } from '@/lib/performance';
+import { useCollabChannel } from '@/lib/collabClient';
+import { relinkWorkspace, type RelinkProgress } from '@/lib/autoLink';
 import { getNodeColor } from '@/lib/nodeColors';
+import { useViewportTiles } from '@/lib/useViewportTiles';
+import { parseTileKey, tileRect, type TileSummary } from '@/lib/viewportTiles';
+import { TopK } from '@/lib/vectorStore';
+import { canvasNodeIndex, findDropTarget } from '@/lib/spatialIndex';
+import type { LodNode, LodRenderer } from '@/lib/lodRenderer';
 import EmptyState from './EmptyState';
 
 const nodeTypes: NodeTypes = {
   custom: NodeComponent,
+  [TILE_AGGREGATE_TYPE]: TileAggregateNode,
 };
 
+// Lightweight stand-in for a tile that isn't loaded (windowed workspaces)
+function toAggregateNode(summary: TileSummary): Node {
+  const diameter = tileAggregateDiameter(summary.count);
+  return {
+    id: `tile:${summary.key}`,
+    type: TILE_AGGREGATE_TYPE,
+    position: { x: summary.cx - diameter / 2, y: summary.cy - diameter / 2 },
+    data: { count: summary.count, tile: summary.key },
+    draggable: false,
+    selectable: false,
+    connectable: false,
+    zIndex: -1,
+  };
+}
+
+function sameElements<T>(a: T[], b: T[]): boolean {
+  return a.length === b.length && a.every((item, i) => item === b[i]);
+}
+
 const edgeTypes: EdgeTypes = {
   custom: EdgeComponent,
 };
 
+// Level of detail: zoomed out below LOD_ZOOM_THRESHOLD, maps of at least LOD_MIN_NODES draw
+// every node and edge in one canvas layer (LodCanvasLayer) and mount React components only
+// for the LOD_MOUNTED_NODES nodes nearest the view centre
+const LOD_ZOOM_THRESHOLD = 0.5;
+const LOD_MIN_NODES = 300;
+const LOD_MOUNTED_NODES = 60;
+// Size of a node React Flow has never measured (min-width of BaseNode/TextNode)
+const LOD_DEFAULT_WIDTH = 200;
+const LOD_DEFAULT_HEIGHT = 80;
+
+// React Flow class on the node a drag would connect to if dropped now
+const DROP_TARGET_CLASS = 'ring-2 ring-blue-400 ring-offset-2 rounded-lg';
+
+// Bounds of a React Flow node in flow coordinates, measured size once React Flow has one
+function flowNodeRect(node: Node) {
+  const width = node.width || node.data?.node?.width || LOD_DEFAULT_WIDTH;
+  const height = node.height || node.data?.node?.height || LOD_DEFAULT_HEIGHT;
+  return { minX: node.position.x, minY: node.position.y, maxX: node.position.x + width, maxY: node.position.y + height };
+}
+
 interface CanvasContainerProps {
   workspaceId: string;
   onCreateNode?: (position: { x: number; y: number }) => void;
@@ -41,49 +92,34 @@ interface CanvasContainerProps {
 
 function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
   const reactFlowInstance = useReactFlow();
-  const { 
-    nodes: canvasNodes, 
-    edges: canvasEdges,
-    setNodes: setCanvasNodes,
-    setEdges: setCanvasEdges,
-    selectedNodeId,
-    selectNode,
-    setViewport,
-    viewport,
-  } = useCanvasStore();
-
-  const {
-    nodes: workspaceNodes,
-    edges: workspaceEdges,
-    layout,
-    addEdge: addWorkspaceEdge,
-  } = useWorkspaceStore();
+  // Field selectors rather than whole-store destructuring - unrelated store updates
+  // (workspace metadata, graph version) don't re-render the canvas
+  const selectedNodeId = useCanvasStore((state) => state.selectedNodeId);
+  const selectNode = useCanvasStore((state) => state.selectNode);
+  const setViewport = useCanvasStore((state) => state.setViewport);
+  const viewport = useCanvasStore((state) => state.viewport);
+  // Viewport as of the last pan/zoom end (level-of-detail mounting)
+  const [settledViewport, setSettledViewport] = useState(() => useCanvasStore.getState().viewport);
+
+  const workspaceNodes = useWorkspaceStore((state) => state.nodes);
+  const workspaceEdges = useWorkspaceStore((state) => state.edges);
+  const addWorkspaceEdge = useWorkspaceStore((state) => state.addEdge);
+  const windowed = useWorkspaceStore((state) => state.windowed);
+  const tileSummaries = useWorkspaceStore((state) => state.tileSummaries);
+  const loadedTiles = useWorkspaceStore((state) => state.loadedTiles);
+
+  // Large workspaces: page tiles in around the viewport, aggregates stand in for the rest
+  const flowWidth = useStore((state) => state.width);
+  const flowHeight = useStore((state) => state.height);
+  useViewportTiles({ workspaceId, width: flowWidth, height: flowHeight });
+  // Re-renders only when the zoom crosses the threshold, not on every zoom step
+  const lodZoomedOut = useStore((state) => state.transform[2] < LOD_ZOOM_THRESHOLD);
+  const lodRendererRef = useRef<LodRenderer | null>(null);
 
   // Initialize React Flow state with empty arrays - we'll sync from workspace store
-  // Don't initialize from canvasNodes to avoid circular dependencies
   const [nodes, setNodes, onNodesChange] = useNodesState([]);
   const [edges, setEdges, onEdgesChange] = useEdgesState([]);
   
-  // Sync canvas store from React Flow state changes (user interactions only)
-  // This syncs the canvas store when React Flow state changes, but we prevent loops
-  // by only syncing when nodes/edges actually change
-  const lastSyncedCanvasNodesRef = useRef<string>('');
-  const lastSyncedCanvasEdgesRef = useRef<string>('');
-  
-  useEffect(() => {
-    const nodesHash = JSON.stringify(nodes.map(n => ({ id: n.id, position: n.position })));
-    const edgesHash = JSON.stringify(edges.map(e => ({ id: e.id, source: e.source, target: e.target })));
-    
-    // Only update canvas store if React Flow nodes actually changed
-    if (nodesHash !== lastSyncedCanvasNodesRef.current || edgesHash !== lastSyncedCanvasEdgesRef.current) {
-      lastSyncedCanvasNodesRef.current = nodesHash;
-      lastSyncedCanvasEdgesRef.current = edgesHash;
-      setCanvasNodes(nodes);
-      setCanvasEdges(edges);
-    }
-    // eslint-disable-next-line react-hooks/exhaustive-deps
-  }, [nodes, edges]); // Removed setCanvasNodes and setCanvasEdges from dependencies - they're stable Zustand setters
-  
   // Auto-organize state
   const [autoOrganize, setAutoOrganize] = useState(false);
   
@@ -92,25 +128,40 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
   const [showEmptyState, setShowEmptyState] = useState(nodes.length === 0 && !hasDismissedEmptyState);
   
   // Handle position updates from auto-organize animation
-  const handlePositionUpdate = useCallback(
-    (nodeId: string, position: { x: number; y: number }) => {
+  // One setNodes per animation frame for all moved nodes
+  const handlePositionsUpdate = useCallback(
+    (positions: Map<string, { x: number; y: number }>) => {
       setNodes((nds) =>
-        nds.map((node) =>
-          node.id === nodeId
-            ? { ...node, position }
-            : node
-        )
+        nds.map((node) => {
+          const position = positions.get(node.id);
+          return position ? { ...node, position } : node;
+        })
       );
     },
     [setNodes]
   );
 
+  // Persist final auto-organize positions as one batched update instead of one request per node
+  const handleOrganizeComplete = useCallback(
+    (positions: Map<string, { x: number; y: number }>) => {
+      setAutoOrganize(false);
+      const updates = Array.from(positions, ([id, position]) => ({ id, x: position.x, y: position.y }));
+      useWorkspaceStore.getState().updateNodePositions(updates);
+      nodeUpdateQueue.enqueueMany(
+        workspaceId,
+        updates.map((u) => ({ nodeId: u.id, x: u.x, y: u.y }))
+      );
+    },
+    [workspaceId]
+  );
+
   // Use auto-organize hook
   const { isAnimating } = useAutoOrganize({
-    nodes,
+    nodes: windowed ? nodes.filter((node) => node.type !== TILE_AGGREGATE_TYPE) : nodes,
     edges,
     enabled: autoOrganize,
-    onPositionUpdate: handlePositionUpdate,
+    onPositionsUpdate: handlePositionsUpdate,
+    onComplete: handleOrganizeComplete,
     width: 2000,
     height: 2000,
     duration: 2000,
@@ -133,68 +184,85 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
 
   // Manual trigger for auto-organize (can be called from a button)
   const triggerAutoOrganize = useCallback(() => {
+    // Switched off again by handleOrganizeComplete once the layout has settled
     setAutoOrganize(true);
-    setTimeout(() => setAutoOrganize(false), 2500);
   }, []);
 
+  // Workspace-wide relink - rebuilds similarity edges server-side, new edges arrive via delta sync
+  const [relinkProgress, setRelinkProgress] = useState<RelinkProgress | null>(null);
+  const triggerRelink = useCallback(async () => {
+    setRelinkProgress({ processed: 0, total: 0, created: 0 });
+    try {
+      await relinkWorkspace(workspaceId, setRelinkProgress);
+      window.dispatchEvent(new CustomEvent('refreshWorkspace'));
+    } catch (error) {
+      console.error('Error relinking workspace:', error);
+    } finally {
+      setRelinkProgress(null);
+    }
+  }, [workspaceId]);
+
   // Use ref to track current React Flow nodes for position preservation
   const nodesRef = useRef(nodes);
   const edgesRef = useRef(edges);
   
-  // Track last synced workspace nodes/edges to prevent unnecessary updates
-  const lastSyncedNodesRef = useRef<string>('');
-  const lastSyncedEdgesRef = useRef<string>('');
-  
   // Keep refs in sync with current state
   useEffect(() => {
     nodesRef.current = nodes;
     edgesRef.current = edges;
   }, [nodes, edges]);
 
-  // Sync workspace nodes/edges to canvas state
+  // Keep the spatial index (lib/spatialIndex.ts) in step with React Flow's nodes. Node objects
+  // React Flow didn't touch are skipped by identity, so a drag frame re-indexes only the
+  // dragged nodes
+  const indexedNodesRef = useRef(new Map<string, Node>());
   useEffect(() => {
-    // Create a stable hash of the workspace nodes/edges to detect actual changes
-    // Include content in hash to detect textSettings and other content changes
-    // Sort nodes/edges by ID for consistent hashing
-    const sortedNodes = [...workspaceNodes].sort((a, b) => a.id.localeCompare(b.id));
-    const sortedEdges = [...workspaceEdges].sort((a, b) => a.id.localeCompare(b.id));
-    
-    const nodesHash = JSON.stringify(sortedNodes.map(n => ({ 
-      id: n.id, 
-      x: n.x, 
-      y: n.y, 
-      title: n.title, 
-      tags: n.tags ? [...n.tags].sort() : [],
-      content: n.content ? JSON.stringify(n.content) : null,
-    })));
-    const edgesHash = JSON.stringify(sortedEdges.map(e => ({ id: e.id, source: e.source, target: e.target })));
-    
-    // Only sync if nodes or edges actually changed (by value, not reference)
-    if (nodesHash === lastSyncedNodesRef.current && edgesHash === lastSyncedEdgesRef.current) {
-      return; // No actual changes, skip sync
+    const indexed = indexedNodesRef.current;
+    let count = 0;
+    for (const node of nodes) {
+      if (node.type === TILE_AGGREGATE_TYPE) continue;
+      count++;
+      if (indexed.get(node.id) === node) continue;
+      indexed.set(node.id, node);
+      canvasNodeIndex.set(node.id, flowNodeRect(node));
     }
-    
-    // Update tracking refs
-    lastSyncedNodesRef.current = nodesHash;
-    lastSyncedEdgesRef.current = edgesHash;
-    
-    console.log('[CanvasContainer] Syncing workspace nodes to canvas:', {
-      workspaceNodesCount: workspaceNodes.length,
-      workspaceEdgesCount: workspaceEdges.length,
-      existingNodesCount: nodesRef.current.length,
-      existingEdgesCount: edgesRef.current.length,
+    if (indexed.size === count) return;
+    // Some nodes were removed
+    const current = new Set(nodes.map((node) => node.id));
+    indexed.forEach((_node, id) => {
+      if (current.has(id)) return;
+      indexed.delete(id);
+      canvasNodeIndex.delete(id);
     });
+  }, [nodes]);
+
+  useEffect(() => {
+    const indexed = indexedNodesRef.current;
+    return () => {
+      indexed.clear();
+      canvasNodeIndex.clear();
+    };
+  }, []);
+
+  // Sync workspace nodes/edges to canvas state
+  // The store shares structure - an edit replaces only the edited node objects - so a React
+  // Flow node whose store node is unchanged is kept as is. React Flow then re-renders just
+  // the nodes (and edges) that changed, and nothing is serialized to detect changes
+  useEffect(() => {
+    const existingNodes = nodesRef.current;
+    const existingById = new Map(existingNodes.map((n) => [n.id, n]));
 
     const reactFlowNodes: Node[] = workspaceNodes.map((node) => {
-      const isChart = node.tags?.some(tag => ['bar-chart', 'line-chart', 'pie-chart', 'area-chart'].includes(tag));
       // Check if this node already exists in React Flow state (using ref to avoid dependency)
-      const existingNode = nodesRef.current.find(n => n.id === node.id);
-      
-      // For new nodes or nodes being dragged, preserve React Flow position
-      // Otherwise use stored position from database
+      const existingNode = existingById.get(node.id);
+      if (existingNode && existingNode.data?.node === node) return existingNode;
+
+      const isChart = node.tags?.some(tag => ['bar-chart', 'line-chart', 'pie-chart', 'area-chart'].includes(tag));
+
+      // Nodes being dragged here keep their React Flow position; everything else follows
+      // the store, which local drops, delta sync and collaborators' moves all write to
       let position = { x: node.x || 0, y: node.y || 0 };
-      if (existingNode?.position && existingNode.position.x !== undefined && existingNode.position.y !== undefined) {
-        // Preserve position if node exists in React Flow (may be dragged)
+      if (existingNode?.dragging && existingNode.position) {
         position = existingNode.position;
       }
       
@@ -223,17 +291,45 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
         // Apply zIndex for layering
         zIndex,
         // Sync selected state with canvas store
-        selected: selectedNodeId === node.id,
+        selected: existingNode ? existingNode.selected : selectedNodeId === node.id,
+        // React Flow keeps dragging/measured state on its own node objects
+        ...(existingNode?.dragging && { dragging: true }),
       };
     });
 
-    const reactFlowEdges: Edge[] = workspaceEdges.map((edge) => {
-      const sourceNode = workspaceNodes.find(n => n.id === edge.source);
-      const targetNode = workspaceNodes.find(n => n.id === edge.target);
-      const sourceColor = sourceNode ? getNodeColor(sourceNode) : null;
-      const targetColor = targetNode ? getNodeColor(targetNode) : null;
-      
-      return {
+    if (windowed) {
+      for (const summary of tileSummaries) {
+        if (loadedTiles.has(summary.key)) continue;
+        const existingNode = existingById.get(`tile:${summary.key}`);
+        reactFlowNodes.push(
+          existingNode && existingNode.data?.count === summary.count ? existingNode : toAggregateNode(summary)
+        );
+      }
+    }
+
+    // Windowed workspaces hold edges whose other end is in a tile not loaded yet - skip those
+    const storeState = useWorkspaceStore.getState();
+    const existingEdgesById = new Map(edgesRef.current.map((e) => [e.id, e]));
+    const reactFlowEdges: Edge[] = [];
+    for (const edge of workspaceEdges) {
+      const sourceNode = selectWorkspaceNode(storeState, edge.source);
+      const targetNode = selectWorkspaceNode(storeState, edge.target);
+      if (!sourceNode || !targetNode) continue;
+      const sourceColor = getNodeColor(sourceNode);
+      const targetColor = getNodeColor(targetNode);
+
+      const existingEdge = existingEdgesById.get(edge.id);
+      if (
+        existingEdge &&
+        existingEdge.data?.edge === edge &&
+        existingEdge.data.sourceColor === sourceColor &&
+        existingEdge.data.targetColor === targetColor
+      ) {
+        reactFlowEdges.push(existingEdge);
+        continue;
+      }
+
+      reactFlowEdges.push({
         id: edge.id,
         source: edge.source,
         target: edge.target,
@@ -244,61 +340,75 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
           sourceColor,
           targetColor,
         },
-      };
-    });
-
-    // Compare React Flow nodes by value to prevent unnecessary updates
-    // Compare essential properties: id, position, label, selected state, and zIndex
-    const currentNodesHash = JSON.stringify(nodes.map(n => ({ 
-      id: n.id, 
-      position: n.position, 
-      label: n.data?.label,
-      selected: n.selected,
-      zIndex: n.zIndex
-    })));
-    const newNodesHash = JSON.stringify(reactFlowNodes.map(n => ({ 
-      id: n.id, 
-      position: n.position, 
-      label: n.data?.label,
-      selected: n.selected,
-      zIndex: n.zIndex
-    })));
-    const currentEdgesHash = JSON.stringify(edges.map(e => ({ 
-      id: e.id, 
-      source: e.source, 
-      target: e.target 
-    })));
-    const newEdgesHash = JSON.stringify(reactFlowEdges.map(e => ({ 
-      id: e.id, 
-      source: e.source, 
-      target: e.target 
-    })));
-    
-    // Only update React Flow state if nodes/edges actually changed
-    // This prevents unnecessary setState calls that trigger infinite loops
-    if (currentNodesHash !== newNodesHash || currentEdgesHash !== newEdgesHash) {
-      console.log('[CanvasContainer] Setting React Flow nodes:', {
-        nodeCount: reactFlowNodes.length,
-        edgeCount: reactFlowEdges.length,
-        firstNodeId: reactFlowNodes[0]?.id,
-        firstNodePosition: reactFlowNodes[0]?.position,
-        nodesChanged: currentNodesHash !== newNodesHash,
-        edgesChanged: currentEdgesHash !== newEdgesHash,
       });
-      
-      // Update React Flow state only if actually changed
-      if (currentNodesHash !== newNodesHash) {
-        setNodes(reactFlowNodes);
-      }
-      if (currentEdgesHash !== newEdgesHash) {
-        setEdges(reactFlowEdges);
-      }
-      
-      // Note: Don't update canvas store here - the effect that syncs canvas store 
-      // from React Flow state will handle it automatically
+    }
+
+    // Only hand React Flow a new array if some element actually changed
+    if (!sameElements(existingNodes, reactFlowNodes)) {
+      setNodes(reactFlowNodes);
+    }
+    if (!sameElements(edgesRef.current, reactFlowEdges)) {
+      setEdges(reactFlowEdges);
     }
     // eslint-disable-next-line react-hooks/exhaustive-deps
-  }, [workspaceNodes, workspaceEdges]); // Removed unstable setter dependencies
+  }, [workspaceNodes, workspaceEdges, windowed, tileSummaries, loadedTiles]); // Removed unstable setter dependencies
+
+  // Level of detail - which nodes stay mounted as React components, and what the canvas draws
+  // The mounted set follows the viewport where a pan or zoom ends, not every step of it
+  const lodActive = lodZoomedOut && nodes.length >= LOD_MIN_NODES;
+  const mountedIdsRef = useRef<{ key: string; ids: Set<string> } | null>(null);
+  const mountedIds = useMemo(() => {
+    if (!lodActive) return null;
+
+    const zoom = settledViewport?.zoom || LOD_ZOOM_THRESHOLD;
+    const centerX = (flowWidth / 2 - (settledViewport?.x || 0)) / zoom;
+    const centerY = (flowHeight / 2 - (settledViewport?.y || 0)) / zoom;
+    const nearest = new TopK(LOD_MOUNTED_NODES);
+    nodes.forEach((node, i) => {
+      if (node.type === TILE_AGGREGATE_TYPE) return;
+      const dx = node.position.x - centerX;
+      const dy = node.position.y - centerY;
+      nearest.push(i, -(dx * dx + dy * dy));
+    });
+
+    const ids = new Set(nearest.drain().map(({ item }) => nodes[item].id));
+    if (selectedNodeId) ids.add(selectedNodeId);
+    // Nodes being dragged or in the selection stay mounted wherever they are
+    nodes.forEach((node) => {
+      if (node.dragging || node.selected) ids.add(node.id);
+    });
+
+    // Same set as last time - keep the reference so React Flow gets the same node array
+    const key = Array.from(ids).sort().join(',');
+    if (mountedIdsRef.current?.key === key) return mountedIdsRef.current.ids;
+    mountedIdsRef.current = { key, ids };
+    return ids;
+  }, [lodActive, nodes, settledViewport, flowWidth, flowHeight, selectedNodeId]);
+
+  const renderedNodes = useMemo(
+    () =>
+      mountedIds
+        ? nodes.filter((node) => node.type === TILE_AGGREGATE_TYPE || mountedIds.has(node.id))
+        : nodes,
+    [nodes, mountedIds]
+  );
+  // The canvas layer draws every edge; React Flow's SVG edges are skipped while zoomed out
+  const renderedEdges = useMemo(() => (lodActive ? [] : edges), [edges, lodActive]);
+
+  // Every node; the mounted ones are hidden in the canvas layer by flag (hiddenIds)
+  const lodNodes = useMemo<LodNode[]>(() => {
+    if (!lodActive) return [];
+    return nodes
+      .filter((node) => node.type !== TILE_AGGREGATE_TYPE)
+      .map((node) => ({
+        id: node.id,
+        x: node.position.x,
+        y: node.position.y,
+        width: node.width || node.data?.node?.width || LOD_DEFAULT_WIDTH,
+        height: node.height || node.data?.node?.height || LOD_DEFAULT_HEIGHT,
+        color: getNodeColor(node.data?.node || {}).primary,
+      }));
+  }, [nodes, lodActive]);
 
   const onConnect = useCallback(
     async (params: Connection) => {
@@ -325,7 +435,6 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
       };
       const newEdges = addEdge(tempEdge, edges);
       setEdges(newEdges);
-      setCanvasEdges(newEdges);
 
       // Save to API
       try {
@@ -348,7 +457,6 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
             // Remove failed edge
             const failedEdges = edges.filter((e) => e.id !== tempEdge.id);
             setEdges(failedEdges);
-            setCanvasEdges(failedEdges);
             return;
           }
           
@@ -364,7 +472,6 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
           );
           
           setEdges(updatedEdges);
-          setCanvasEdges(updatedEdges);
           
           // Add to workspace store
           addWorkspaceEdge({
@@ -383,18 +490,16 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
           // Remove failed edge
           const failedEdges = edges.filter((e) => e.id !== tempEdge.id);
           setEdges(failedEdges);
-          setCanvasEdges(failedEdges);
           console.error('[CanvasContainer] Failed to create edge:', response.statusText);
         }
       } catch (error) {
         // Remove failed edge
         const failedEdges = edges.filter((e) => e.id !== tempEdge.id);
         setEdges(failedEdges);
-        setCanvasEdges(failedEdges);
         console.error('[CanvasContainer] Error creating edge:', error);
       }
     },
-    [edges, setEdges, setCanvasEdges, workspaceId, addWorkspaceEdge]
+    [edges, setEdges, workspaceId, addWorkspaceEdge]
   );
 
   // Listen for zIndex updates from layer controls
@@ -416,12 +521,25 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
 
   const onNodeClick = useCallback(
     (event: React.MouseEvent, node: Node) => {
+      // Aggregate bubble - zoom into its tile, which then loads
+      if (node.type === TILE_AGGREGATE_TYPE) {
+        const tile = parseTileKey(node.data.tile);
+        if (tile) {
+          const rect = tileRect(tile);
+          reactFlowInstance.fitBounds(
+            { x: rect.minX, y: rect.minY, width: rect.maxX - rect.minX, height: rect.maxY - rect.minY },
+            { duration: 300 }
+          );
+        }
+        return;
+      }
+
       // MIRO-LIKE: Always select node on single click
       // This ensures FloatingNodeEditor appears immediately
       // Inline editing will handle text input separately
       selectNode(node.id);
     },
-    [selectNode]
+    [selectNode, reactFlowInstance]
   );
 
   // Track dragging state for drag-to-connect
@@ -437,71 +555,59 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
     []
   );
 
+  // Node the current drag would connect to - highlighted while the drag is over it
+  const dropTargetRef = useRef<string | null>(null);
+  const setDropTarget = useCallback(
+    (targetId: string | null) => {
+      const previous = dropTargetRef.current;
+      if (previous === targetId) return;
+      dropTargetRef.current = targetId;
+      setNodes((nds) =>
+        nds.map((n) => {
+          if (n.id !== previous && n.id !== targetId) return n;
+          return { ...n, className: n.id === targetId ? DROP_TARGET_CLASS : undefined };
+        })
+      );
+    },
+    [setNodes]
+  );
+
+  const dropTargetFor = useCallback((node: Node, draggedNodes?: Node[]) => {
+    const exclude = new Set((draggedNodes && draggedNodes.length > 0 ? draggedNodes : [node]).map((n) => n.id));
+    return findDropTarget(canvasNodeIndex, flowNodeRect(node), exclude);
+  }, []);
+
+  // Live drag positions for other members (throttled); the drop itself goes through the store
+  const collabChannel = useCollabChannel(workspaceId);
+  const onNodeDrag = useCallback(
+    (_event: React.MouseEvent, node: Node, draggedNodes?: Node[]) => {
+      setDropTarget(dropTargetFor(node, draggedNodes));
+      if (!collabChannel) return;
+      (draggedNodes && draggedNodes.length > 0 ? draggedNodes : [node]).forEach((n) => {
+        collabChannel.sendDragMove(n.id, n.position.x, n.position.y);
+      });
+    },
+    [collabChannel, dropTargetFor, setDropTarget]
+  );
+
   // Handle node drag end - check if dropped on another node
   const onNodeDragStop = useCallback(
-    async (_event: React.MouseEvent, node: Node) => {
+    async (_event: React.MouseEvent, node: Node, draggedNodes?: Node[]) => {
       if (!draggedNodeId || !reactFlowInstance) {
+        setDropTarget(null);
         setDraggedNodeId(null);
         dragStartPosition.current = null;
         return;
       }
 
-      // Get the dragged node's position in flow coordinates
-      const draggedNodePosition = node.position;
-      
-      // Get node dimensions from the DOM element (works at any zoom level)
-      const draggedNodeElement = document.querySelector(`[data-id="${node.id}"]`) as HTMLElement;
-      let draggedNodeWidth = 100; // Default size for regular nodes
-      let draggedNodeHeight = 100;
-      
-      if (draggedNodeElement) {
-        const rect = draggedNodeElement.getBoundingClientRect();
-        // Convert screen dimensions to flow dimensions using zoom level
-        const viewport = reactFlowInstance.getViewport();
-        draggedNodeWidth = rect.width / viewport.zoom;
-        draggedNodeHeight = rect.height / viewport.zoom;
-      }
-
-      // Check if this node overlaps with any other node using distance-based detection
-      // This works at any zoom level because we're using flow coordinates
-      const overlappingNode = nodes.find((n) => {
-        if (n.id === node.id) return false;
-        
-        const otherPosition = n.position;
-        
-        // Get other node's dimensions from DOM
-        const otherNodeElement = document.querySelector(`[data-id="${n.id}"]`) as HTMLElement;
-        let otherNodeWidth = 100;
-        let otherNodeHeight = 100;
-        
-        if (otherNodeElement) {
-          const rect = otherNodeElement.getBoundingClientRect();
-          const viewport = reactFlowInstance.getViewport();
-          otherNodeWidth = rect.width / viewport.zoom;
-          otherNodeHeight = rect.height / viewport.zoom;
-        }
-        
-        // Calculate centers
-        const draggedCenterX = draggedNodePosition.x + draggedNodeWidth / 2;
-        const draggedCenterY = draggedNodePosition.y + draggedNodeHeight / 2;
-        const otherCenterX = otherPosition.x + otherNodeWidth / 2;
-        const otherCenterY = otherPosition.y + otherNodeHeight / 2;
-        
-        // Calculate distance between centers
-        const distanceX = Math.abs(draggedCenterX - otherCenterX);
-        const distanceY = Math.abs(draggedCenterY - otherCenterY);
-        
-        // Check if nodes overlap (centers are within combined half-widths/heights)
-        const maxDistanceX = (draggedNodeWidth + otherNodeWidth) / 2;
-        const maxDistanceY = (draggedNodeHeight + otherNodeHeight) / 2;
-        
-        return distanceX < maxDistanceX && distanceY < maxDistanceY;
-      });
+      // Node under the drop, from the spatial index - no DOM measurement per node
+      const dropTargetId = dropTargetFor(node, draggedNodes);
+      setDropTarget(null);
 
       // If dropped on another node, create a connection
-      if (overlappingNode) {
+      if (dropTargetId) {
         const sourceId = draggedNodeId;
-        const targetId = overlappingNode.id;
+        const targetId = dropTargetId;
 
         // Check if edge already exists
         const existingEdge = edges.find(
@@ -519,37 +625,24 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
         }
       }
 
-      // Persist node position to database
-      try {
-        const response = await fetch('/api/nodes/update', {
-          method: 'PUT',
-          headers: { 'Content-Type': 'application/json' },
-          body: JSON.stringify({
-            nodeId: node.id,
-            x: node.position.x,
-            y: node.position.y,
-          }),
-        });
-
-        if (response.ok) {
-          // Update workspace store with new position
-          const { updateNode } = useWorkspaceStore.getState();
-          updateNode(node.id, {
-            x: node.position.x,
-            y: node.position.y,
-          });
-        } else {
-          console.error('[CanvasContainer] Failed to update node position:', response.statusText);
-        }
-      } catch (error) {
-        console.error('[CanvasContainer] Error updating node position:', error);
-      }
+      // Persist node positions - multi-select drags move every selected node.
+      // Queued updates are coalesced and sent as one PUT /api/nodes/batch
+      const moved = (draggedNodes && draggedNodes.length > 0 ? draggedNodes : [node]).map((n) => ({
+        id: n.id,
+        x: n.position.x,
+        y: n.position.y,
+      }));
+      useWorkspaceStore.getState().updateNodePositions(moved);
+      nodeUpdateQueue.enqueueMany(
+        workspaceId,
+        moved.map((m) => ({ nodeId: m.id, x: m.x, y: m.y }))
+      );
 
       // Reset drag state
       setDraggedNodeId(null);
       dragStartPosition.current = null;
     },
-    [draggedNodeId, nodes, edges, onConnect, reactFlowInstance, workspaceNodes]
+    [draggedNodeId, edges, onConnect, reactFlowInstance, workspaceId, dropTargetFor, setDropTarget]
   );
 
   // Handle double-click to create node
@@ -625,6 +718,7 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
               typeof newViewport.zoom === 'number' && !isNaN(newViewport.zoom)
             ) {
               setViewport(newViewport);
+              setSettledViewport(newViewport);
             }
           }
         }, 350);
@@ -699,9 +793,22 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
     };
   }, [nodes, reactFlowInstance, selectNode, triggerAutoOrganize]);
 
-  const onPaneClick = useCallback(() => {
-    selectNode(null);
-  }, [selectNode]);
+  const onPaneClick = useCallback(
+    (event: React.MouseEvent) => {
+      // Zoomed out, most nodes only exist in the canvas layer - select the one under the click
+      const renderer = lodRendererRef.current;
+      if (renderer) {
+        const point = reactFlowInstance.screenToFlowPosition({ x: event.clientX, y: event.clientY });
+        const hit = renderer.hitTest(point.x, point.y, reactFlowInstance.getViewport().zoom);
+        if (hit) {
+          selectNode(hit);
+          return;
+        }
+      }
+      selectNode(null);
+    },
+    [selectNode, reactFlowInstance]
+  );
 
   const hasFittedView = useRef(false);
   
@@ -709,7 +816,22 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
     (instance: ReactFlowInstance) => {
       // Only fit view once on initial load when there are nodes
       // Don't force zoom if user has already interacted with canvas
-      if (!hasFittedView.current && workspaceNodes.length > 0) {
+      const { windowed: isWindowed, tileSummaries: summaries } = useWorkspaceStore.getState();
+      if (!hasFittedView.current && isWindowed && summaries.length > 0) {
+        // Windowed: start with the whole workspace as aggregates - tiles load as the user zooms in
+        hasFittedView.current = true;
+        let minX = Infinity, minY = Infinity, maxX = -Infinity, maxY = -Infinity;
+        for (const summary of summaries) {
+          const rect = tileRect(summary);
+          minX = Math.min(minX, rect.minX);
+          minY = Math.min(minY, rect.minY);
+          maxX = Math.max(maxX, rect.maxX);
+          maxY = Math.max(maxY, rect.maxY);
+        }
+        instance.fitBounds({ x: minX, y: minY, width: maxX - minX, height: maxY - minY }, { duration: 0 });
+        setViewport(instance.getViewport());
+        setSettledViewport(instance.getViewport());
+      } else if (!hasFittedView.current && workspaceNodes.length > 0) {
         hasFittedView.current = true;
         setTimeout(() => {
           if (instance) {
@@ -729,6 +851,7 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
                   typeof currentViewport.zoom === 'number' && !isNaN(currentViewport.zoom)
                 ) {
                   setViewport(currentViewport);
+                  setSettledViewport(currentViewport);
                 }
               }
             }, 450);
@@ -743,6 +866,7 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
       ) {
         // Restore previous viewport if available (on workspace switch)
         instance.setViewport(viewport, { duration: 0 });
+        setSettledViewport(viewport);
       }
     },
     [setViewport, workspaceNodes.length, viewport]
@@ -813,6 +937,7 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
       // Immediately update on move end for accurate final position
       lastViewportRef.current = newViewport;
       setViewport(newViewport);
+      setSettledViewport(newViewport);
     },
     [setViewport]
   );
@@ -907,15 +1032,19 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
             }
           }}
         >
+          {/* Zoomed-out maps: nodes and edges drawn in one canvas under the flow pane */}
+          {lodActive && <LodCanvasLayer nodes={lodNodes} edges={edges} hiddenIds={mountedIds} rendererRef={lodRendererRef} />}
+
           {/* Canvas - always visible and rendered, empty state is just an overlay */}
           <ReactFlow
-        nodes={nodes}
-        edges={edges}
+        nodes={renderedNodes}
+        edges={renderedEdges}
         onNodesChange={onNodesChange}
         onEdgesChange={onEdgesChange}
         onConnect={onConnect}
         onNodeClick={onNodeClick}
         onNodeDragStart={onNodeDragStart}
+        onNodeDrag={onNodeDrag}
         onNodeDragStop={onNodeDragStop}
         onPaneClick={onPaneClick}
         onInit={onInit}
@@ -933,7 +1062,7 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
         connectionLineStyle={{ stroke: '#3b82f6', strokeWidth: 2 }}
         fitView={false}
         attributionPosition="bottom-left"
-        className="bg-white"
+        className={lodActive ? 'bg-transparent' : 'bg-white'}
         minZoom={0.1}
         maxZoom={4}
         defaultViewport={
@@ -992,19 +1121,37 @@ function CanvasInner({ workspaceId, onCreateNode }: CanvasContainerProps) {
 
           {/* Minimal inline hint removed - no longer showing hint on empty canvas */}
 
-          {/* Auto-organize button - minimalistic, top-right, very subtle */}
+          {/* Relink + auto-organize buttons - minimalistic, top-right, very subtle */}
           {nodes.length > 0 && (
-            <button
-              onClick={triggerAutoOrganize}
-              disabled={isAnimating}
-              className="absolute top-4 right-4 z-10 px-3 py-1.5 bg-white/90 backdrop-blur-md text-xs text-gray-700 rounded-lg border border-gray-300 shadow-sm hover:bg-gray-100 hover:border-gray-400 hover:text-gray-900 transition-all duration-200 disabled:opacity-30 disabled:cursor-not-allowed"
-              style={{
-                fontSize: '11px',
-                letterSpacing: '0.5px',
-              }}
-            >
-              {isAnimating ? 'Organizing...' : 'Auto-Organize'}
-            </button>
+            <div className="absolute top-4 right-4 z-10 flex gap-2">
+              <button
+                onClick={triggerRelink}
+                disabled={relinkProgress !== null}
+                title="Rebuild similarity links for every node"
+                className="px-3 py-1.5 bg-white/90 backdrop-blur-md text-xs text-gray-700 rounded-lg border border-gray-300 shadow-sm hover:bg-gray-100 hover:border-gray-400 hover:text-gray-900 transition-all duration-200 disabled:opacity-30 disabled:cursor-not-allowed"
+                style={{
+                  fontSize: '11px',
+                  letterSpacing: '0.5px',
+                }}
+              >
+                {relinkProgress
+                  ? relinkProgress.total > 0
+                    ? `Relinking ${Math.round((relinkProgress.processed / relinkProgress.total) * 100)}%`
+                    : 'Relinking...'
+                  : 'Relink All'}
+              </button>
+              <button
+                onClick={triggerAutoOrganize}
+                disabled={isAnimating}
+                className="px-3 py-1.5 bg-white/90 backdrop-blur-md text-xs text-gray-700 rounded-lg border border-gray-300 shadow-sm hover:bg-gray-100 hover:border-gray-400 hover:text-gray-900 transition-all duration-200 disabled:opacity-30 disabled:cursor-not-allowed"
+                style={{
+                  fontSize: '11px',
+                  letterSpacing: '0.5px',
+                }}
+              >
+                {isAnimating ? 'Organizing...' : 'Auto-Organize'}
+              </button>
+            </div>
           )}
         </div>
       );
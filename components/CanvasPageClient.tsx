@@ -10,18 +10,34 @@ import CanvasSidebar from './CanvasSidebar';
 import ToolbarSettingsPanel from './ToolbarSettingsPanel';
 import EmojiPickerPopup from './EmojiPickerPopup';
 import CaptureModal from './CaptureModal';
-import { useWorkspaceStore } from '@/state/workspaceStore';
+import { useWorkspaceStore, selectWorkspaceNode } from '@/state/workspaceStore';
 import { useCanvasStore } from '@/state/canvasStore';
 import { useHistoryStore } from '@/state/historyStore';
+import { nodeUpdateQueue } from '@/lib/performance';
+import { ensureNodeContent } from '@/lib/nodeContentLoader';
+import { canvasNodeIndex, findOpenPosition } from '@/lib/spatialIndex';
 import type { Node } from '@/types/Node';
 
+// Footprint assumed for a node that hasn't been measured yet when looking for free space
+const NEW_NODE_WIDTH = 200;
+const NEW_NODE_HEIGHT = 80;
+
+// Requested flow position, moved to the nearest spot that doesn't overlap another node
+function openFlowPosition(requested: { x: number; y: number }, width = NEW_NODE_WIDTH, height = NEW_NODE_HEIGHT) {
+  return findOpenPosition(canvasNodeIndex, requested.x, requested.y, width, height);
+}
+
 interface CanvasPageClientProps {
   workspaceId: string;
 }
 
 export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps) {
-  const { nodes, addNode, updateNode } = useWorkspaceStore();
-  const { selectNode, selectedNodeId } = useCanvasStore();
+  // Actions only - handlers read nodes from the store when they run, so this page (and the
+  // floating editors it renders) doesn't re-render on every node edit or drag
+  const addNode = useWorkspaceStore((state) => state.addNode);
+  const updateNode = useWorkspaceStore((state) => state.updateNode);
+  const selectNode = useCanvasStore((state) => state.selectNode);
+  const selectedNodeId = useCanvasStore((state) => state.selectedNodeId);
   const { undo, redo, canUndo, canRedo } = useHistoryStore();
   const [isCreating, setIsCreating] = useState(false);
   const [toolbarPosition, setToolbarPosition] = useState<{ x: number; y: number } | null>(null);
@@ -45,7 +61,7 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
     async (imageUrl: string, cropArea: { x: number; y: number; width: number; height: number }) => {
       if (captureNodeId) {
         // Update existing capture node
-        const node = nodes.find(n => n.id === captureNodeId);
+        const node = selectWorkspaceNode(useWorkspaceStore.getState(), captureNodeId);
         if (node) {
           const currentContent = typeof node.content === 'object' && node.content?.type === 'live-capture'
             ? node.content
@@ -99,7 +115,7 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
         setCaptureNodeId(null);
       } else {
         // Create new capture node
-        const storedFlowPos = (window as any).lastFlowPosition || { x: 500, y: 400 };
+        const storedFlowPos = openFlowPosition((window as any).lastFlowPosition || { x: 500, y: 400 });
         
         try {
           const response = await fetch('/api/nodes/create', {
@@ -139,7 +155,7 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
         }
       }
     },
-    [captureNodeId, nodes, workspaceId, updateNode, addNode, selectNode]
+    [captureNodeId, workspaceId, updateNode, addNode, selectNode]
   );
 
   // Listen for capture node updates
@@ -226,7 +242,11 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
         };
 
         // Get flow position from CanvasContainer (stored globally)
-        const storedFlowPos = (window as any).lastFlowPosition || { x: 500, y: 400 };
+        const storedFlowPos = openFlowPosition(
+          (window as any).lastFlowPosition || { x: 500, y: 400 },
+          type.includes('chart') ? 400 : NEW_NODE_WIDTH,
+          type.includes('chart') ? 300 : NEW_NODE_HEIGHT
+        );
 
         // Create node in database
         const response = await fetch('/api/nodes/create', {
@@ -355,20 +375,28 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
   );
 
   const handleDuplicateNode = useCallback(async (nodeId: string) => {
-    const node = nodes.find(n => n.id === nodeId);
+    const node = selectWorkspaceNode(useWorkspaceStore.getState(), nodeId);
     if (!node) return;
+    const bounds = canvasNodeIndex.get(nodeId);
+    const position = openFlowPosition(
+      { x: node.x + 50, y: node.y + 50 },
+      bounds ? bounds.maxX - bounds.minX : NEW_NODE_WIDTH,
+      bounds ? bounds.maxY - bounds.minY : NEW_NODE_HEIGHT
+    );
 
     try {
+      // A skeleton node only holds placeholder content until its full content arrives
+      const content = await ensureNodeContent(workspaceId, nodeId);
       const response = await fetch('/api/nodes/create', {
         method: 'POST',
         headers: { 'Content-Type': 'application/json' },
         body: JSON.stringify({
           workspaceId,
           title: `${node.title} (Copy)`,
-          content: node.content,
+          content,
           tags: node.tags,
-          x: node.x + 50,
-          y: node.y + 50,
+          x: position.x,
+          y: position.y,
         }),
       });
 
@@ -383,7 +411,7 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
     } catch (error) {
       console.error('Error duplicating node:', error);
     }
-  }, [workspaceId, nodes, addNode, selectNode]);
+  }, [workspaceId, addNode, selectNode]);
 
   // Handle keyboard shortcuts
   useEffect(() => {
@@ -440,8 +468,10 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
       }
 
       // Layer controls: Ctrl+] Bring to Front, Ctrl+[ Send to Back, Ctrl+↑ Move Forward, Ctrl+↓ Move Backward
-      if ((e.metaKey || e.ctrlKey) && selectedNodeId && nodes.length > 0) {
-        const selectedNode = nodes.find(n => n.id === selectedNodeId);
+      if ((e.metaKey || e.ctrlKey) && selectedNodeId) {
+        const workspaceState = useWorkspaceStore.getState();
+        const nodes = workspaceState.nodes;
+        const selectedNode = selectWorkspaceNode(workspaceState, selectedNodeId);
         if (selectedNode) {
           const nodeMetadata = selectedNode.content && typeof selectedNode.content === 'object' && 'nodeMetadata' in selectedNode.content
             ? (selectedNode.content as any).nodeMetadata
@@ -471,17 +501,7 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
               nodeMetadata: { ...nodeMetadata, zIndex: maxZIndex + 1 },
             };
             updateNode(selectedNodeId, { content: newContent });
-            fetch('/api/nodes/update', {
-              method: 'PUT',
-              headers: { 'Content-Type': 'application/json' },
-              body: JSON.stringify({
-                nodeId: selectedNodeId,
-                content: newContent,
-              }),
-            }).catch((error) => {
-              console.error('Error updating layer:', error);
-            });
-            // DO NOT dispatch refreshWorkspace - it causes blocking data fetches
+            nodeUpdateQueue.enqueue(workspaceId, { nodeId: selectedNodeId, zIndex: newContent.nodeMetadata.zIndex });
             return;
           } else if (e.key === '[') {
             e.preventDefault();
@@ -506,17 +526,7 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
               nodeMetadata: { ...nodeMetadata, zIndex: minZIndex - 1 },
             };
             updateNode(selectedNodeId, { content: newContent });
-            fetch('/api/nodes/update', {
-              method: 'PUT',
-              headers: { 'Content-Type': 'application/json' },
-              body: JSON.stringify({
-                nodeId: selectedNodeId,
-                content: newContent,
-              }),
-            }).catch((error) => {
-              console.error('Error updating layer:', error);
-            });
-            // DO NOT dispatch refreshWorkspace - it causes blocking data fetches
+            nodeUpdateQueue.enqueue(workspaceId, { nodeId: selectedNodeId, zIndex: newContent.nodeMetadata.zIndex });
             return;
           } else if (e.key === 'ArrowUp') {
             e.preventDefault();
@@ -554,43 +564,16 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
                   nodeMetadata: { ...nextMeta, zIndex: currentZIndex },
                 },
               });
-              Promise.all([
-                fetch('/api/nodes/update', {
-                  method: 'PUT',
-                  headers: { 'Content-Type': 'application/json' },
-                  body: JSON.stringify({
-                    nodeId: selectedNodeId,
-                    content: { ...selectedNode.content, nodeMetadata: { ...nodeMetadata, zIndex: nextZIndex } },
-                  }),
-                }),
-                fetch('/api/nodes/update', {
-                  method: 'PUT',
-                  headers: { 'Content-Type': 'application/json' },
-                  body: JSON.stringify({
-                    nodeId: nextNode.id,
-                    content: { ...nextNode.content, nodeMetadata: { ...nextMeta, zIndex: currentZIndex } },
-                  }),
-                }),
-              ]).then(() => {
-                window.dispatchEvent(new CustomEvent('refreshWorkspace'));
-              });
+              // Both sides of the swap go out in the same batch
+              nodeUpdateQueue.enqueue(workspaceId, { nodeId: selectedNodeId, zIndex: nextZIndex });
+              nodeUpdateQueue.enqueue(workspaceId, { nodeId: nextNode.id, zIndex: currentZIndex });
             } else {
               const newContent = {
                 ...selectedNode.content,
                 nodeMetadata: { ...nodeMetadata, zIndex: currentZIndex + 1 },
               };
               updateNode(selectedNodeId, { content: newContent });
-              fetch('/api/nodes/update', {
-                method: 'PUT',
-                headers: { 'Content-Type': 'application/json' },
-                body: JSON.stringify({
-                  nodeId: selectedNodeId,
-                  content: newContent,
-                }),
-              }).catch((error) => {
-              console.error('Error updating layer:', error);
-            });
-            // DO NOT dispatch refreshWorkspace - it causes blocking data fetches
+              nodeUpdateQueue.enqueue(workspaceId, { nodeId: selectedNodeId, zIndex: newContent.nodeMetadata.zIndex });
             }
             return;
           } else if (e.key === 'ArrowDown') {
@@ -629,43 +612,16 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
                   nodeMetadata: { ...prevMeta, zIndex: currentZIndex },
                 },
               });
-              Promise.all([
-                fetch('/api/nodes/update', {
-                  method: 'PUT',
-                  headers: { 'Content-Type': 'application/json' },
-                  body: JSON.stringify({
-                    nodeId: selectedNodeId,
-                    content: { ...selectedNode.content, nodeMetadata: { ...nodeMetadata, zIndex: prevZIndex } },
-                  }),
-                }),
-                fetch('/api/nodes/update', {
-                  method: 'PUT',
-                  headers: { 'Content-Type': 'application/json' },
-                  body: JSON.stringify({
-                    nodeId: prevNode.id,
-                    content: { ...prevNode.content, nodeMetadata: { ...prevMeta, zIndex: currentZIndex } },
-                  }),
-                }),
-              ]).then(() => {
-                window.dispatchEvent(new CustomEvent('refreshWorkspace'));
-              });
+              // Both sides of the swap go out in the same batch
+              nodeUpdateQueue.enqueue(workspaceId, { nodeId: selectedNodeId, zIndex: prevZIndex });
+              nodeUpdateQueue.enqueue(workspaceId, { nodeId: prevNode.id, zIndex: currentZIndex });
             } else {
               const newContent = {
                 ...selectedNode.content,
                 nodeMetadata: { ...nodeMetadata, zIndex: currentZIndex - 1 },
               };
               updateNode(selectedNodeId, { content: newContent });
-              fetch('/api/nodes/update', {
-                method: 'PUT',
-                headers: { 'Content-Type': 'application/json' },
-                body: JSON.stringify({
-                  nodeId: selectedNodeId,
-                  content: newContent,
-                }),
-              }).catch((error) => {
-              console.error('Error updating layer:', error);
-            });
-            // DO NOT dispatch refreshWorkspace - it causes blocking data fetches
+              nodeUpdateQueue.enqueue(workspaceId, { nodeId: selectedNodeId, zIndex: newContent.nodeMetadata.zIndex });
             }
             return;
           }
@@ -710,6 +666,9 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
       if (!nodeId) return;
 
       try {
+        // Undo re-creates the node from the copy deleteNode records - it needs the full content
+        await ensureNodeContent(workspaceId, nodeId);
+
         const response = await fetch(`/api/nodes/${nodeId}`, {
           method: 'DELETE',
         });
@@ -726,13 +685,13 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
 
     window.addEventListener('deleteSelectedNode', handleDeleteNode as unknown as EventListener);
     return () => window.removeEventListener('deleteSelectedNode', handleDeleteNode as unknown as EventListener);
-  }, [selectNode]);
+  }, [workspaceId, selectNode]);
 
   // Listen for emoji picker open event
   useEffect(() => {
     const handleOpenEmojiPicker = (event: CustomEvent) => {
       const { nodeId, position } = event.detail;
-      const node = nodes.find(n => n.id === nodeId);
+      const node = selectWorkspaceNode(useWorkspaceStore.getState(), nodeId);
       if (node) {
         setEmojiPickerNode(node);
         // Center the popup on screen
@@ -747,7 +706,7 @@ export default function CanvasPageClient({ workspaceId }: CanvasPageClientProps)
 
     window.addEventListener('openEmojiPicker', handleOpenEmojiPicker as EventListener);
     return () => window.removeEventListener('openEmojiPicker', handleOpenEmojiPicker as EventListener);
-  }, [nodes, selectNode]);
+  }, [selectNode]);
 
   // Handle emoji selection
   const handleEmojiSelect = useCallback(async (emojiString: string) => {
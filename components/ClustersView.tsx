@@ -1,6 +1,6 @@
 'use client';
 
-import { useMemo } from 'react';
+import { useEffect, useMemo, useState } from 'react';
 import { useRouter } from 'next/navigation';
 import { Layers, Tag, ArrowRight } from 'lucide-react';
 import { useWorkspaceStore } from '@/state/workspaceStore';
@@ -11,13 +11,75 @@ interface ClustersViewProps {
   workspaceId: string;
 }
 
+// Semantic cluster from /api/workspaces/[id]/clusters (lib/clusterCache.ts)
+interface SemanticCluster {
+  index: number;
+  label: string;
+  nodeIds: string[];
+}
+
+// Last clusters per workspace, so reopening the view renders before the request returns
+const semanticClusterCache = new Map<string, SemanticCluster[]>();
+const PENDING_RETRY_MS = 5000;
+
 export default function ClustersView({ workspaceId }: ClustersViewProps) {
   const router = useRouter();
   const { nodes, edges } = useWorkspaceStore();
   const { selectNode } = useCanvasStore();
+  const [semanticClusters, setSemanticClusters] = useState<SemanticCluster[] | null>(
+    () => semanticClusterCache.get(workspaceId) ?? null
+  );
+  const [groupBy, setGroupBy] = useState<'topics' | 'tags'>('topics');
+
+  // Stored clusters are served as-is; a first run on a large workspace answers 202
+  useEffect(() => {
+    let active = true;
+    let retry: ReturnType<typeof setTimeout> | null = null;
+    setSemanticClusters(semanticClusterCache.get(workspaceId) ?? null);
+
+    const load = async () => {
+      try {
+        const response = await fetch(`/api/workspaces/${workspaceId}/clusters`);
+        if (!response.ok || !active) return;
+        const data = await response.json();
+        if (response.status === 202) {
+          retry = setTimeout(load, PENDING_RETRY_MS);
+          return;
+        }
+        semanticClusterCache.set(workspaceId, data.clusters || []);
+        setSemanticClusters(data.clusters || []);
+      } catch (error) {
+        console.error('Error loading clusters:', error);
+      }
+    };
+    load();
+
+    return () => {
+      active = false;
+      if (retry) clearTimeout(retry);
+    };
+  }, [workspaceId]);
 
-  // Group nodes by tags
+  const showTopics = groupBy === 'topics' && !!semanticClusters && semanticClusters.length > 0;
+
+  // Group nodes by semantic cluster, or by tags when no embeddings are clustered
   const clusters = useMemo(() => {
+    if (showTopics) {
+      const nodesById = new Map(nodes.map((node) => [node.id, node]));
+      return semanticClusters!
+        .map((cluster) => {
+          // Ids of nodes deleted since the last clustering run are skipped
+          const clusterNodes = cluster.nodeIds.flatMap((id) => nodesById.get(id) ?? []);
+          const nodeColor = clusterNodes[0] ? getNodeColor(clusterNodes[0]) : '#9CA3AF';
+          const colorString = typeof nodeColor === 'string'
+            ? nodeColor
+            : nodeColor?.primary || nodeColor?.secondary || '#9CA3AF';
+          return { key: `topic-${cluster.index}`, tag: cluster.label, nodes: clusterNodes, color: colorString };
+        })
+        .filter((cluster) => cluster.nodes.length > 0)
+        .sort((a, b) => b.nodes.length - a.nodes.length);
+    }
+
     const clustersMap = new Map<string, typeof nodes>();
 
     // Create clusters based on tags
@@ -49,13 +111,14 @@ export default function ClustersView({ workspaceId }: ClustersViewProps) {
           : nodeColor?.primary || nodeColor?.secondary || '#9CA3AF';
         
         return {
+          key: tag,
           tag: tag === '_untagged' ? 'Untagged' : tag,
           nodes: clusterNodes,
           color: colorString,
         };
       })
       .sort((a, b) => b.nodes.length - a.nodes.length);
-  }, [nodes]);
+  }, [nodes, showTopics, semanticClusters]);
 
   // Get connection count within cluster
   const getClusterConnectionCount = (clusterNodes: typeof nodes) => {
@@ -88,9 +151,24 @@ export default function ClustersView({ workspaceId }: ClustersViewProps) {
     <div className="h-full flex flex-col bg-white overflow-auto p-6">
       {/* Header */}
       <div className="mb-6">
-        <h2 className="text-2xl font-bold text-gray-900 mb-2">Clusters</h2>
+        <div className="flex items-center justify-between mb-2">
+          <h2 className="text-2xl font-bold text-gray-900">Clusters</h2>
+          {semanticClusters && semanticClusters.length > 0 && (
+            <div className="flex rounded-lg border border-gray-200 text-sm">
+              {(['topics', 'tags'] as const).map((option) => (
+                <button
+                  key={option}
+                  onClick={() => setGroupBy(option)}
+                  className={`px-3 py-1 capitalize ${groupBy === option ? 'bg-gray-100 font-medium text-gray-900' : 'text-gray-500'}`}
+                >
+                  {option}
+                </button>
+              ))}
+            </div>
+          )}
+        </div>
         <p className="text-sm text-gray-500">
-          Nodes grouped by tags • {clusters.length} clusters
+          Nodes grouped by {showTopics ? 'topic' : 'tags'} • {clusters.length} clusters
         </p>
       </div>
 
@@ -98,7 +176,7 @@ export default function ClustersView({ workspaceId }: ClustersViewProps) {
       <div className="grid grid-cols-1 md:grid-cols-2 lg:grid-cols-3 gap-6">
         {clusters.map((cluster) => (
           <div
-            key={cluster.tag}
+            key={cluster.key}
             className="bg-white border border-gray-200 rounded-lg p-6 hover:shadow-lg transition-shadow"
           >
             {/* Cluster Header */}
@@ -5,6 +5,7 @@ import { MessageSquare, Send, Trash2 } from 'lucide-react';
 // import { createClient } from '@/lib/supabase/client'; // Commented out - supabase client not properly configured
 import { motion, AnimatePresence } from 'framer-motion';
 import { formatDistanceToNow } from 'date-fns';
+import { useCollabChannel } from '@/lib/collabClient';
 
 interface Comment {
   id: string;
@@ -36,40 +37,40 @@ export default function CommentsPanel({
   const [newComment, setNewComment] = useState('');
   const [loading, setLoading] = useState(true);
   const [submitting, setSubmitting] = useState(false);
-  // const supabase = createClient(); // Commented out - supabase client not properly configured
+  const channel = useCollabChannel(workspaceId);
 
   useEffect(() => {
     loadComments();
-    
-    // Subscribe to new comments - commented out until supabase client is properly configured
-    // const channel = supabase
-    //   .channel(`comments:${nodeId}`)
-    //   .on(
-    //     'postgres_changes',
-    //     {
-    //       event: '*',
-    //       schema: 'public',
-    //       table: 'comments',
-    //       filter: `node_id=eq.${nodeId}`,
-    //     },
-    //     () => {
-    //       loadComments();
-    //     }
-    //   )
-    //   .subscribe();
-
-    // return () => {
-    //   channel.unsubscribe();
-    // };
   }, [nodeId]);
 
+  // Comments from other members show up as activity on the collaboration channel
+  useEffect(() => {
+    if (!channel) return;
+    return channel.on('activity', ({ activities }) => {
+      const touched = activities.some(
+        (activity) => activity.entityType === 'comment' && activity.details?.nodeId === nodeId
+      );
+      if (touched) loadComments();
+    });
+  }, [channel, nodeId]);
+
   const loadComments = async () => {
-    // TODO: Replace with API route when supabase client is properly configured
     try {
-      const response = await fetch(`/api/nodes/${nodeId}/comments`);
+      const response = await fetch(`/api/comments?nodeId=${encodeURIComponent(nodeId)}`);
       if (response.ok) {
         const data = await response.json();
-        setComments(data.comments || []);
+        // API rows are Prisma-shaped (camelCase, author under `user`)
+        setComments(
+          (data.comments || []).map((c: any) => ({
+            id: c.id,
+            node_id: c.node_id ?? c.nodeId,
+            user_id: c.user_id ?? c.userId,
+            content: c.content,
+            created_at: c.created_at ?? c.createdAt,
+            updated_at: c.updated_at ?? c.updatedAt,
+            profile: c.profile ?? c.user,
+          }))
+        );
       }
     } catch (error) {
       console.error('Error loading comments:', error);
@@ -82,12 +83,12 @@ export default function CommentsPanel({
     if (!newComment.trim()) return;
 
     setSubmitting(true);
-    // TODO: Replace with API route when supabase client is properly configured
     try {
-      const response = await fetch(`/api/nodes/${nodeId}/comments`, {
+      const response = await fetch('/api/comments', {
         method: 'POST',
         headers: { 'Content-Type': 'application/json' },
         body: JSON.stringify({
+          nodeId,
           content: newComment.trim(),
         }),
       });
@@ -105,9 +106,8 @@ export default function CommentsPanel({
   const handleDeleteComment = async (commentId: string, userId: string) => {
     if (!confirm('Delete this comment?')) return;
 
-    // TODO: Replace with API route when supabase client is properly configured
     try {
-      const response = await fetch(`/api/nodes/${nodeId}/comments/${commentId}`, {
+      const response = await fetch(`/api/comments/${commentId}`, {
         method: 'DELETE',
       });
 
@@ -1,13 +1,13 @@
 'use client';
 
-import { useState, useEffect, useRef, useCallback, useMemo } from 'react';
+import { useState, useEffect, useRef, useCallback } from 'react';
 import { 
   Type, FileText, Image, Link2, Square, Circle, ArrowRight,
   BarChart3, LineChart, PieChart, TrendingUp, 
   Edit, Trash2, Copy, X, Smile, Home, GripVertical, Camera
 } from 'lucide-react';
 import { useCanvasStore } from '@/state/canvasStore';
-import { useWorkspaceStore } from '@/state/workspaceStore';
+import { useWorkspaceNode } from '@/state/workspaceStore';
 
 interface FloatingHorizontalBarProps {
   onCreateNode: (type: string, position: { x: number; y: number }) => void;
@@ -42,8 +42,8 @@ export default function FloatingHorizontalBar({
   onDeleteNode,
   onDuplicateNode 
 }: FloatingHorizontalBarProps) {
-  const { selectedNodeId, selectNode } = useCanvasStore();
-  const { nodes } = useWorkspaceStore();
+  const selectedNodeId = useCanvasStore((state) => state.selectedNodeId);
+  const selectNode = useCanvasStore((state) => state.selectNode);
   const [clickPosition, setClickPosition] = useState<{ x: number; y: number } | null>(null);
   const [position, setPosition] = useState<{ x: number; y: number }>(getOriginalPosition());
   const [isDragging, setIsDragging] = useState(false);
@@ -51,12 +51,8 @@ export default function FloatingHorizontalBar({
   const barRef = useRef<HTMLDivElement>(null);
   const dragStartPos = useRef<{ x: number; y: number }>({ x: 0, y: 0 });
   
-  // Memoize selectedNode to prevent unnecessary re-renders when nodes array reference changes
-  // Only recompute when selectedNodeId or the actual node data changes
-  const selectedNode = useMemo(() => {
-    if (!selectedNodeId) return null;
-    return nodes.find(n => n.id === selectedNodeId) || null;
-  }, [selectedNodeId, nodes]);
+  // Subscribes to the selected node only - edits to other nodes don't re-render the bar
+  const selectedNode = useWorkspaceNode(selectedNodeId) ?? null;
 
   // Listen for canvas clicks to show creation toolbar
   useEffect(() => {
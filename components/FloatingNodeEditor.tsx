@@ -2,7 +2,7 @@
 
 import { useState, useRef, useEffect, useCallback } from 'react';
 import { useCanvasStore } from '@/state/canvasStore';
-import { useWorkspaceStore } from '@/state/workspaceStore';
+import { useWorkspaceStore, useWorkspaceNode, useLinkedNodes } from '@/state/workspaceStore';
 import { 
   X, Tag, Sparkles, ArrowRight, Link2, 
   Image as ImageIcon, Upload, Copy, 
@@ -14,6 +14,7 @@ import {
 import ChartEditorPanel from './ChartEditorPanel';
 import ImageSettingsPanel from './ImageSettingsPanel';
 import TextSettingsPanel from './TextSettingsPanel';
+import { nodeUpdateQueue } from '@/lib/performance';
 import type { Node } from '@/types/Node';
 import type { Edge } from '@/types/Edge';
 
@@ -50,15 +51,17 @@ function isEmojiNode(node: Node): boolean {
 }
 
 function FloatingNodeEditor() {
-  const { selectedNodeId } = useCanvasStore();
-  const { nodes, edges, updateNode } = useWorkspaceStore();
+  const selectedNodeId = useCanvasStore((state) => state.selectedNodeId);
+  // Only the selected node and its neighbours - edits and drags elsewhere don't re-render this
+  const selectedNode = useWorkspaceNode(selectedNodeId);
+  const linkedNodes = useLinkedNodes(selectedNodeId);
+  const edges = useWorkspaceStore((state) => state.edges);
+  const updateNode = useWorkspaceStore((state) => state.updateNode);
   const workspaceId = useWorkspaceStore((state) => state.currentWorkspace?.id);
   
-  const selectedNode = nodes.find((n) => n.id === selectedNodeId);
   const [title, setTitle] = useState('');
   const [tags, setTags] = useState<string[]>([]);
   const [newTag, setNewTag] = useState('');
-  const [linkedNodes, setLinkedNodes] = useState<Node[]>([]);
   const [isUpdating, setIsUpdating] = useState(false);
   
   // Dropdown states
@@ -156,24 +159,6 @@ function FloatingNodeEditor() {
       }
   }, [selectedNodeId, selectedNode]);
 
-  // Fetch linked nodes
-  useEffect(() => {
-    if (selectedNode && edges) {
-      const connectedEdges = edges.filter(
-        (edge) => edge.source === selectedNode.id || edge.target === selectedNode.id
-      );
-      
-      const linkedNodeIds = connectedEdges
-        .map((edge) => (edge.source === selectedNode.id ? edge.target : edge.source))
-        .filter((id) => id !== selectedNode.id);
-      
-      const linked = nodes.filter((node) => linkedNodeIds.includes(node.id));
-      setLinkedNodes(linked);
-    } else {
-      setLinkedNodes([]);
-    }
-  }, [selectedNode, edges, nodes]);
-
   // Cleanup timers
   useEffect(() => {
     return () => {
@@ -235,7 +220,7 @@ function FloatingNodeEditor() {
 
   // Layering functions
   const handleLayerAction = useCallback(async (action: 'bringToFront' | 'moveToBack' | 'moveForward' | 'moveBackward') => {
-    if (!selectedNode || !workspaceId || !nodes) return;
+    if (!selectedNode || !workspaceId) return;
 
     // Get current zIndex from nodeMetadata
     const nodeMetadata = selectedNode.content && typeof selectedNode.content === 'object' && 'nodeMetadata' in selectedNode.content
@@ -244,7 +229,7 @@ function FloatingNodeEditor() {
     const currentZIndex = nodeMetadata.zIndex || 0;
 
     // Get all nodes sorted by current zIndex
-    const allNodes = [...nodes];
+    const allNodes = [...useWorkspaceStore.getState().nodes];
     const sortedNodes = allNodes.sort((a, b) => {
       const aMetadata = a.content && typeof a.content === 'object' && 'nodeMetadata' in a.content
         ? (a.content as any).nodeMetadata
@@ -307,25 +292,9 @@ function FloatingNodeEditor() {
               nodeMetadata: { ...nextMeta, zIndex: currentZIndex },
             },
           });
-          // Update both in database
-          await Promise.all([
-            fetch('/api/nodes/update', {
-              method: 'PUT',
-              headers: { 'Content-Type': 'application/json' },
-              body: JSON.stringify({
-                nodeId: selectedNode.id,
-                content: { ...currentContent, nodeMetadata: { ...nodeMetadata, zIndex: nextZIndex } },
-              }),
-            }),
-            fetch('/api/nodes/update', {
-              method: 'PUT',
-              headers: { 'Content-Type': 'application/json' },
-              body: JSON.stringify({
-                nodeId: nextNode.id,
-                content: { ...nextContent, nodeMetadata: { ...nextMeta, zIndex: currentZIndex } },
-              }),
-            }),
-          ]);
+          // Update both in database (coalesced into one batch request)
+          nodeUpdateQueue.enqueue(workspaceId, { nodeId: selectedNode.id, zIndex: nextZIndex });
+          nodeUpdateQueue.enqueue(workspaceId, { nodeId: nextNode.id, zIndex: currentZIndex });
           // DO NOT dispatch refreshWorkspace - it causes blocking data fetches
           return;
         }
@@ -360,25 +329,9 @@ function FloatingNodeEditor() {
               nodeMetadata: { ...prevMeta, zIndex: currentZIndex },
             },
           });
-          // Update both in database
-          await Promise.all([
-            fetch('/api/nodes/update', {
-              method: 'PUT',
-              headers: { 'Content-Type': 'application/json' },
-              body: JSON.stringify({
-                nodeId: selectedNode.id,
-                content: { ...currentContent, nodeMetadata: { ...nodeMetadata, zIndex: prevZIndex } },
-              }),
-            }),
-            fetch('/api/nodes/update', {
-              method: 'PUT',
-              headers: { 'Content-Type': 'application/json' },
-              body: JSON.stringify({
-                nodeId: prevNode.id,
-                content: { ...prevContent, nodeMetadata: { ...prevMeta, zIndex: currentZIndex } },
-              }),
-            }),
-          ]);
+          // Update both in database (coalesced into one batch request)
+          nodeUpdateQueue.enqueue(workspaceId, { nodeId: selectedNode.id, zIndex: prevZIndex });
+          nodeUpdateQueue.enqueue(workspaceId, { nodeId: prevNode.id, zIndex: currentZIndex });
           // DO NOT dispatch refreshWorkspace - it causes blocking data fetches
           return;
         }
@@ -398,27 +351,16 @@ function FloatingNodeEditor() {
     updateNode(selectedNode.id, { content: newContent });
     
     if (workspaceId) {
-      try {
-        await fetch('/api/nodes/update', {
-          method: 'PUT',
-          headers: { 'Content-Type': 'application/json' },
-          body: JSON.stringify({
-            nodeId: selectedNode.id,
-            content: newContent,
-          }),
-        });
-        // DO NOT dispatch refreshWorkspace - it causes blocking data fetches
-        // React Flow will sync from workspace store automatically
-        
-        // Also trigger a custom event to update React Flow zIndex
-        window.dispatchEvent(new CustomEvent('update-node-zindex', {
-          detail: { nodeId: selectedNode.id, zIndex: newZIndex }
-        }));
-      } catch (error) {
-        console.error('Error updating layer:', error);
-      }
+      nodeUpdateQueue.enqueue(workspaceId, { nodeId: selectedNode.id, zIndex: newZIndex });
+      // DO NOT dispatch refreshWorkspace - it causes blocking data fetches
+      // React Flow will sync from workspace store automatically
+
+      // Also trigger a custom event to update React Flow zIndex
+      window.dispatchEvent(new CustomEvent('update-node-zindex', {
+        detail: { nodeId: selectedNode.id, zIndex: newZIndex }
+      }));
     }
-  }, [selectedNode, workspaceId, nodes, updateNode]);
+  }, [selectedNode, workspaceId, updateNode]);
 
   // Don't render if no node is selected
   if (!selectedNodeId) {
@@ -1212,8 +1154,7 @@ function FloatingNodeEditor() {
                                 if (response.ok) {
                                   // DO NOT dispatch refreshWorkspace - it causes blocking data fetches
                                   // Update linked nodes list
-                                  const updatedLinked = linkedNodes.filter(n => n.id !== linkedNode.id);
-                                  setLinkedNodes(updatedLinked);
+                                  useWorkspaceStore.getState().deleteEdge(connectingEdge.id);
                                 }
                               } catch (error) {
                                 console.error('Error deleting edge:', error);
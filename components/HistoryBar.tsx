@@ -7,20 +7,28 @@ import { useWorkspaceStore } from '@/state/workspaceStore';
 import { useCanvasStore } from '@/state/canvasStore';
 import type { HistoryEntry, HistoryAction } from '@/state/historyStore';
 import type { Node } from '@/types/Node';
-import type { Edge } from '@/types/Edge';
+import { nodeUpdateQueue } from '@/lib/performance';
+import { ensureNodeContent } from '@/lib/nodeContentLoader';
+import { isPartialContent } from '@/lib/graphPayload';
+import NodeRevisionHistory from './NodeRevisionHistory';
 
 export default function HistoryBar() {
   const { past, future, undo, redo, canUndo, canRedo, getHistory } = useHistoryStore();
-  const { nodes, edges, setNodes, setEdges, updateNode, addNode, deleteNode, addEdge, deleteEdge } = useWorkspaceStore();
+  const updateNode = useWorkspaceStore((state) => state.updateNode);
+  const addNode = useWorkspaceStore((state) => state.addNode);
+  const deleteNode = useWorkspaceStore((state) => state.deleteNode);
+  const addEdge = useWorkspaceStore((state) => state.addEdge);
+  const deleteEdge = useWorkspaceStore((state) => state.deleteEdge);
   const workspaceId = useWorkspaceStore((state) => state.currentWorkspace?.id);
-  const { selectNode } = useCanvasStore();
+  const selectedNodeId = useCanvasStore((state) => state.selectedNodeId);
+  const selectNode = useCanvasStore((state) => state.selectNode);
   
   const [isDragging, setIsDragging] = useState(false);
   const [position, setPosition] = useState({ x: 50, y: 100 });
   const [isHistoryOpen, setIsHistoryOpen] = useState(false);
   const [dragOffset, setDragOffset] = useState({ x: 0, y: 0 });
   const [isAttachedToSidebar, setIsAttachedToSidebar] = useState(false);
-  const [activeTab, setActiveTab] = useState<'nodes' | 'history'>('nodes');
+  const [activeTab, setActiveTab] = useState<'actions' | 'revisions'>('actions');
   const barRef = useRef<HTMLDivElement>(null);
 
   // Listen for detachment events from HistoryBarContent
@@ -40,6 +48,22 @@ export default function HistoryBar() {
     };
   }, []);
 
+  // "View Node History" in the command palette opens the revisions of that node
+  useEffect(() => {
+    const handleShowNodeHistory = (event: CustomEvent) => {
+      const nodeId = event.detail?.nodeId;
+      if (!nodeId) return;
+      selectNode(nodeId);
+      setActiveTab('revisions');
+      setIsHistoryOpen(true);
+    };
+
+    window.addEventListener('showNodeHistory', handleShowNodeHistory as EventListener);
+    return () => {
+      window.removeEventListener('showNodeHistory', handleShowNodeHistory as EventListener);
+    };
+  }, [selectNode]);
+
   // Load saved position and attachment state from localStorage
   useEffect(() => {
     const savedPosition = localStorage.getItem('historyBarPosition');
@@ -185,6 +209,15 @@ export default function HistoryBar() {
     };
   }, []);
 
+  // The recorded node is re-created on the server later (redo of a create, undo of a delete),
+  // so a skeleton's placeholder content is swapped for the real content while the node still
+  // exists. The entry object moves between past and future, so the fix sticks.
+  const resolveRecordedContent = async (node: Node) => {
+    if (workspaceId && isPartialContent(node.content)) {
+      node.content = await ensureNodeContent(workspaceId, node.id);
+    }
+  };
+
   const applyHistoryAction = async (action: HistoryAction, isUndo: boolean) => {
     const historyStore = useHistoryStore.getState();
     historyStore.setRecording(false); // Temporarily disable recording to avoid double-recording
@@ -195,6 +228,7 @@ export default function HistoryBar() {
           if (isUndo) {
             // Delete the node
             const nodeToDelete = action.node;
+            await resolveRecordedContent(nodeToDelete);
             deleteNode(nodeToDelete.id);
             if (workspaceId) {
               await fetch(`/api/nodes/${nodeToDelete.id}`, {
@@ -205,6 +239,10 @@ export default function HistoryBar() {
             }
           } else {
             // Re-create the node
+            if (isPartialContent(action.node.content)) {
+              console.error('[HistoryBar] Cannot re-create a node whose content never loaded');
+              break;
+            }
             addNode(action.node);
             if (workspaceId) {
               await fetch('/api/nodes/create', {
@@ -228,6 +266,10 @@ export default function HistoryBar() {
         case 'delete_node':
           if (isUndo) {
             // Restore the node
+            if (isPartialContent(action.node.content)) {
+              console.error('[HistoryBar] Cannot restore a node whose content never loaded');
+              break;
+            }
             addNode(action.node);
             if (workspaceId) {
               await fetch('/api/nodes/create', {
@@ -247,6 +289,7 @@ export default function HistoryBar() {
             }
           } else {
             // Delete again
+            await resolveRecordedContent(action.node);
             deleteNode(action.node.id);
             if (workspaceId) {
               await fetch(`/api/nodes/${action.node.id}`, {
@@ -339,25 +382,18 @@ export default function HistoryBar() {
           }
           break;
 
-        case 'update_nodes':
-          if (isUndo) {
-            // This is complex - we'd need to store the before state
-            // For now, just refresh
-            window.dispatchEvent(new CustomEvent('refreshWorkspace'));
-          } else {
-            setNodes(action.nodes);
-            window.dispatchEvent(new CustomEvent('refreshWorkspace'));
-          }
-          break;
-
-        case 'update_edges':
-          if (isUndo) {
-            window.dispatchEvent(new CustomEvent('refreshWorkspace'));
-          } else {
-            setEdges(action.edges);
-            window.dispatchEvent(new CustomEvent('refreshWorkspace'));
+        case 'move_nodes': {
+          const positions = isUndo ? action.before : action.after;
+          const moved = action.nodeIds.map((id, i) => ({ id, x: positions[i * 2], y: positions[i * 2 + 1] }));
+          useWorkspaceStore.getState().updateNodePositions(moved);
+          if (workspaceId) {
+            nodeUpdateQueue.enqueueMany(
+              workspaceId,
+              moved.map((m) => ({ nodeId: m.id, x: m.x, y: m.y }))
+            );
           }
           break;
+        }
       }
     } finally {
       historyStore.setRecording(true); // Re-enable recording
@@ -457,35 +493,56 @@ export default function HistoryBar() {
       {isHistoryOpen && (
         <div className="absolute top-full left-0 mt-1 bg-white rounded-lg shadow-xl border border-gray-200 w-80 max-h-96 overflow-y-auto z-50">
           <div className="p-2">
-            <div className="text-xs font-semibold text-gray-500 uppercase tracking-wider px-2 py-1 mb-2">
-              History ({totalHistoryCount})
-            </div>
-            {history.length === 0 ? (
-              <div className="px-2 py-4 text-sm text-gray-400 text-center">No history yet</div>
-            ) : (
-              <div className="space-y-1">
-                {history.map((entry) => {
-                  const isInFuture = future.some(f => f.id === entry.id);
-                  return (
-                    <div
-                      key={entry.id}
-                      className={`px-2 py-1.5 rounded text-sm transition-colors ${
-                        isInFuture
-                          ? 'text-gray-400 bg-gray-50'
-                          : 'text-gray-700 hover:bg-gray-50'
-                      }`}
-                    >
-                      <div className="flex items-center justify-between">
-                        <span className="flex-1 truncate">{entry.description}</span>
-                        <span className="text-xs text-gray-400 ml-2">
-                          {formatTime(entry.timestamp)}
-                        </span>
-                      </div>
-                    </div>
-                  );
-                })}
+            {selectedNodeId && (
+              <div className="flex gap-1 mb-2">
+                {(['actions', 'revisions'] as const).map((tab) => (
+                  <button
+                    key={tab}
+                    onClick={() => setActiveTab(tab)}
+                    className={`flex-1 px-2 py-1 rounded text-xs font-medium transition-colors ${
+                      activeTab === tab ? 'bg-gray-100 text-gray-900' : 'text-gray-500 hover:bg-gray-50'
+                    }`}
+                  >
+                    {tab === 'actions' ? 'Actions' : 'Node revisions'}
+                  </button>
+                ))}
               </div>
             )}
+            {selectedNodeId && activeTab === 'revisions' ? (
+              <NodeRevisionHistory nodeId={selectedNodeId} formatTime={formatTime} />
+            ) : (
+              <>
+                <div className="text-xs font-semibold text-gray-500 uppercase tracking-wider px-2 py-1 mb-2">
+                  History ({totalHistoryCount})
+                </div>
+                {history.length === 0 ? (
+                  <div className="px-2 py-4 text-sm text-gray-400 text-center">No history yet</div>
+                ) : (
+                  <div className="space-y-1">
+                    {history.map((entry) => {
+                      const isInFuture = future.some(f => f.id === entry.id);
+                      return (
+                        <div
+                          key={entry.id}
+                          className={`px-2 py-1.5 rounded text-sm transition-colors ${
+                            isInFuture
+                              ? 'text-gray-400 bg-gray-50'
+                              : 'text-gray-700 hover:bg-gray-50'
+                          }`}
+                        >
+                          <div className="flex items-center justify-between">
+                            <span className="flex-1 truncate">{entry.description}</span>
+                            <span className="text-xs text-gray-400 ml-2">
+                              {formatTime(entry.timestamp)}
+                            </span>
+                          </div>
+                        </div>
+                      );
+                    })}
+                  </div>
+                )}
+              </>
+            )}
           </div>
         </div>
       )}
@@ -0,0 +1,82 @@
+'use client';
+
+import { useEffect, useRef, type MutableRefObject } from 'react';
+import { useStoreApi } from 'reactflow';
+import { LodRenderer, type LodEdge, type LodNode } from '@/lib/lodRenderer';
+
+interface LodCanvasLayerProps {
+  nodes: LodNode[];
+  edges: LodEdge[];
+  // Nodes mounted as React components, which this layer leaves out
+  hiddenIds?: ReadonlySet<string> | null;
+  // Exposed for hit testing clicks on nodes that only exist in this layer
+  rendererRef?: MutableRefObject<LodRenderer | null>;
+}
+
+/**
+ * Zoomed-out stand-in for React Flow's node and edge layers
+ * Sits under the flow pane and follows its transform directly from the React Flow store, so
+ * panning and zooming redraw the canvas without re-rendering React.
+ */
+export default function LodCanvasLayer({ nodes, edges, hiddenIds, rendererRef }: LodCanvasLayerProps) {
+  const canvasRef = useRef<HTMLCanvasElement>(null);
+  const rendererInstance = useRef<LodRenderer | null>(null);
+  const frameRef = useRef<number | null>(null);
+  const store = useStoreApi();
+
+  // One draw per animation frame however many transform updates arrive
+  const scheduleRender = () => {
+    if (frameRef.current !== null) return;
+    frameRef.current = requestAnimationFrame(() => {
+      frameRef.current = null;
+      const { transform, width, height } = store.getState();
+      rendererInstance.current?.render(transform, width, height);
+    });
+  };
+
+  useEffect(() => {
+    if (!canvasRef.current) return;
+    const renderer = new LodRenderer(canvasRef.current);
+    rendererInstance.current = renderer;
+    if (rendererRef) rendererRef.current = renderer;
+
+    let last = store.getState();
+    const unsubscribe = store.subscribe((state) => {
+      if (state.transform !== last.transform || state.width !== last.width || state.height !== last.height) {
+        scheduleRender();
+      }
+      last = state;
+    });
+
+    return () => {
+      unsubscribe();
+      if (frameRef.current !== null) cancelAnimationFrame(frameRef.current);
+      frameRef.current = null;
+      renderer.destroy();
+      rendererInstance.current = null;
+      if (rendererRef) rendererRef.current = null;
+    };
+    // eslint-disable-next-line react-hooks/exhaustive-deps
+  }, [store]);
+
+  useEffect(() => {
+    rendererInstance.current?.setGraph(nodes, edges);
+    scheduleRender();
+    // eslint-disable-next-line react-hooks/exhaustive-deps
+  }, [nodes, edges]);
+
+  // A new mounted set only flips flags - the graph buffers stay as they are
+  useEffect(() => {
+    rendererInstance.current?.setHidden(hiddenIds ?? new Set());
+    scheduleRender();
+    // eslint-disable-next-line react-hooks/exhaustive-deps
+  }, [hiddenIds]);
+
+  return (
+    <canvas
+      ref={canvasRef}
+      className="absolute inset-0 w-full h-full pointer-events-none"
+      aria-hidden="true"
+    />
+  );
+}
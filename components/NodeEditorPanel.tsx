@@ -1,11 +1,13 @@
 'use client';
 
-import { useEffect, useState, useRef, useCallback, useMemo } from 'react';
+import { useEffect, useState, useRef, useCallback } from 'react';
 import { useEditor, EditorContent } from '@tiptap/react';
 import StarterKit from '@tiptap/starter-kit';
 import Placeholder from '@tiptap/extension-placeholder';
+import Collaboration from '@tiptap/extension-collaboration';
+import { ySyncPluginKey } from 'y-prosemirror';
 import { useCanvasStore } from '@/state/canvasStore';
-import { useWorkspaceStore } from '@/state/workspaceStore';
+import { useWorkspaceStore, useWorkspaceNode, useLinkedNodes } from '@/state/workspaceStore';
 import { X, Tag, Sparkles, ArrowRight, Link2, Image as ImageIcon, Upload, Copy, Camera } from 'lucide-react';
 import FloatingFormatToolbar from './FloatingFormatToolbar';
 import SlashCommandMenu from './SlashCommandMenu';
@@ -18,6 +20,7 @@ import NodeTransformPanel from './NodeTransformPanel';
 import type { Node } from '@/types/Node';
 import type { Edge } from '@/types/Edge';
 import { getNodeType, hasEditableText, isChartNode, isShapeNode, isMediaNode } from '@/lib/nodeTypes';
+import { useNodeDocument } from '@/lib/nodeDocClient';
 
 // Type-based helper functions using the new registry
 function isChartNodeType(node: Node): boolean {
@@ -53,20 +56,17 @@ function isEmojiNodeType(node: Node): boolean {
 }
 
 export default function NodeEditorPanel() {
-  const { selectedNodeId } = useCanvasStore();
-  const { nodes, edges, updateNode } = useWorkspaceStore();
+  const selectedNodeId = useCanvasStore((state) => state.selectedNodeId);
+  // Only the selected node and its neighbours - edits and drags elsewhere don't re-render this
+  const selectedNode = useWorkspaceNode(selectedNodeId) ?? null;
+  const linkedNodes = useLinkedNodes(selectedNodeId);
+  const updateNode = useWorkspaceStore((state) => state.updateNode);
   const workspaceId = useWorkspaceStore((state) => state.currentWorkspace?.id);
   const [emojiPickerOpen, setEmojiPickerOpen] = useState(false);
   
-  // Use useMemo to find selectedNode to avoid unnecessary re-renders
-  const selectedNode = useMemo(() => {
-    return selectedNodeId ? nodes.find((n) => n.id === selectedNodeId) : null;
-  }, [selectedNodeId, nodes]);
-  
   const [title, setTitle] = useState('');
   const [tags, setTags] = useState<string[]>([]);
   const [newTag, setNewTag] = useState('');
-  const [linkedNodes, setLinkedNodes] = useState<Node[]>([]);
   const [isUpdating, setIsUpdating] = useState(false);
   const [imageUrl, setImageUrl] = useState<string>('');
   const [imageSize, setImageSize] = useState<'small' | 'medium' | 'large' | 'full'>('medium');
@@ -127,26 +127,45 @@ export default function NodeEditorPanel() {
     [workspaceId, updateNode]
   );
 
+  // Rich text is edited as a shared Yjs document when the server provides one; until it
+  // has loaded the editor is read-only, and without one it falls back to saving plain content
+  const { doc: nodeDoc, status: nodeDocStatus } = useNodeDocument(
+    workspaceId,
+    selectedNode && hasEditableText(selectedNode) ? selectedNode.id : null
+  );
+
   const editor = useEditor({
     extensions: [
-      StarterKit,
+      // Collaboration keeps its own (Yjs) undo history
+      StarterKit.configure(nodeDoc ? { history: false } : {}),
       Placeholder.configure({
         placeholder: 'Start typing your thoughts...',
       }),
+      ...(nodeDoc ? [Collaboration.configure({ document: nodeDoc })] : []),
     ],
-    // Only initialize with content if node has editable text (using type-based check)
-    content: selectedNode && hasEditableText(selectedNode)
+    // Only initialize with content if node has editable text (using type-based check);
+    // a collaborative editor takes its content from the document
+    content: nodeDoc ? undefined : selectedNode && hasEditableText(selectedNode)
       ? (typeof selectedNode.content === 'string' 
           ? selectedNode.content 
           : (selectedNode.content && typeof selectedNode.content === 'object' && selectedNode.content.type === 'doc'
               ? selectedNode.content
               : ''))
       : '',
-    onUpdate: ({ editor }) => {
+    onUpdate: ({ editor, transaction }) => {
       // Don't trigger update if we're currently syncing content from node (prevents infinite loop)
       if (isSyncingContentRef.current) {
         return;
       }
+
+      if (nodeDoc && selectedNode) {
+        // Other editors' changes - their own clients record them
+        if (transaction.getMeta(ySyncPluginKey)?.isChangeOrigin) return;
+        // Only mirror into the store for the canvas; the text itself is already on its way as
+        // a Yjs update, and the server snapshots it into nodes.content
+        updateNode(selectedNode.id, { content: editor.getJSON() }, { broadcast: false });
+        return;
+      }
       
       // Only update content for nodes with editable text (using type-based check)
       if (selectedNode && hasEditableText(selectedNode)) {
@@ -170,29 +189,8 @@ export default function NodeEditorPanel() {
       }
     },
     // Enable editor only for nodes with editable text (using type-based check)
-    editable: !selectedNode || hasEditableText(selectedNode),
-  });
-
-  // Fetch linked nodes when selected node changes
-  useEffect(() => {
-    if (selectedNode && edges) {
-      // Find all edges connected to this node (both source and target)
-      const connectedEdges = edges.filter(
-        (edge) => edge.source === selectedNode.id || edge.target === selectedNode.id
-      );
-      
-      // Get all linked node IDs (exclude the selected node itself)
-      const linkedNodeIds = connectedEdges
-        .map((edge) => (edge.source === selectedNode.id ? edge.target : edge.source))
-        .filter((id) => id !== selectedNode.id);
-      
-      // Get the actual node objects
-      const linked = nodes.filter((node) => linkedNodeIds.includes(node.id));
-      setLinkedNodes(linked);
-    } else {
-      setLinkedNodes([]);
-    }
-  }, [selectedNode, edges, nodes]);
+    editable: !selectedNode || (hasEditableText(selectedNode) && nodeDocStatus !== 'loading'),
+  }, [nodeDoc]);
 
   // Cleanup timers on unmount
   useEffect(() => {
@@ -229,8 +227,10 @@ export default function NodeEditorPanel() {
         }
       }
       
-      // Only set editor content for nodes with editable text
-      if (editor && hasEditableText(selectedNode)) {
+      // Only set editor content for nodes with editable text - never into a collaborative
+      // editor, which would write it into the shared document
+      const isCollaborative = editor?.extensionManager.extensions.some((ext) => ext.name === 'collaboration');
+      if (editor && hasEditableText(selectedNode) && !isCollaborative) {
         // Get current editor content to avoid unnecessary updates
         const currentContent = editor.getJSON();
         const nodeContent = selectedNode.content;
@@ -270,7 +270,8 @@ export default function NodeEditorPanel() {
       setTitle('');
       setTags([]);
       isTitleFocusedRef.current = false;
-      if (editor) {
+      const isCollaborative = editor?.extensionManager.extensions.some((ext) => ext.name === 'collaboration');
+      if (editor && !isCollaborative) {
         // Only clear if there's content
         const currentContent = editor.getJSON();
         const isEmpty = !currentContent || (currentContent.type === 'doc' && (!currentContent.content || currentContent.content.length === 0));
@@ -0,0 +1,159 @@
+'use client';
+
+import { useState, useEffect, useCallback } from 'react';
+import { RotateCcw, ChevronRight, Loader2 } from 'lucide-react';
+import { useWorkspaceStore, useWorkspaceNode } from '@/state/workspaceStore';
+
+interface RevisionSummary {
+  revision: number;
+  keyframe: boolean;
+  createdBy: string | null;
+  createdAt: string;
+}
+
+interface RevisionDetail extends RevisionSummary {
+  title: string;
+  content: unknown;
+  tags: string[];
+}
+
+const REVISIONS_PAGE_SIZE = 20;
+
+interface NodeRevisionHistoryProps {
+  nodeId: string;
+  formatTime: (date: Date) => string;
+}
+
+// Saved revisions of one node, newest first - pages in with the server's cursor, and a
+// revision's content is only fetched when it is expanded
+export default function NodeRevisionHistory({ nodeId, formatTime }: NodeRevisionHistoryProps) {
+  const node = useWorkspaceNode(nodeId);
+  const [revisions, setRevisions] = useState<RevisionSummary[]>([]);
+  const [nextCursor, setNextCursor] = useState<number | null>(null);
+  const [loading, setLoading] = useState(false);
+  const [expanded, setExpanded] = useState<number | null>(null);
+  const [details, setDetails] = useState<Record<number, RevisionDetail>>({});
+
+  const loadPage = useCallback(async (before: number | null) => {
+    setLoading(true);
+    try {
+      const params = new URLSearchParams({ limit: String(REVISIONS_PAGE_SIZE) });
+      if (before !== null) params.set('before', String(before));
+      const response = await fetch(`/api/nodes/${nodeId}/history?${params}`);
+      if (!response.ok) throw new Error(`Failed to load revisions (${response.status})`);
+      const page = await response.json();
+      setRevisions((current) => (before === null ? page.revisions : [...current, ...page.revisions]));
+      setNextCursor(page.nextCursor);
+    } catch (error) {
+      console.error('Error loading node revisions:', error);
+    } finally {
+      setLoading(false);
+    }
+  }, [nodeId]);
+
+  useEffect(() => {
+    setRevisions([]);
+    setNextCursor(null);
+    setExpanded(null);
+    setDetails({});
+    loadPage(null);
+  }, [loadPage]);
+
+  const toggleRevision = async (revision: number) => {
+    if (expanded === revision) {
+      setExpanded(null);
+      return;
+    }
+    setExpanded(revision);
+    if (details[revision]) return;
+    try {
+      const response = await fetch(`/api/nodes/${nodeId}/history/${revision}`);
+      if (!response.ok) throw new Error(`Failed to load revision (${response.status})`);
+      const { revision: detail } = await response.json();
+      setDetails((current) => ({ ...current, [revision]: detail }));
+    } catch (error) {
+      console.error('Error loading node revision:', error);
+    }
+  };
+
+  const restoreRevision = async (detail: RevisionDetail) => {
+    const updates = { title: detail.title, content: detail.content as any, tags: detail.tags };
+    useWorkspaceStore.getState().updateNode(nodeId, updates);
+    try {
+      const response = await fetch('/api/nodes/update', {
+        method: 'PUT',
+        headers: { 'Content-Type': 'application/json' },
+        body: JSON.stringify({ nodeId, ...updates }),
+      });
+      if (!response.ok) throw new Error(`Failed to restore revision (${response.status})`);
+      // The restore is itself saved as the newest revision
+      loadPage(null);
+    } catch (error) {
+      console.error('Error restoring node revision:', error);
+    }
+  };
+
+  return (
+    <div>
+      <div className="text-xs font-semibold text-gray-500 uppercase tracking-wider px-2 py-1 mb-2 truncate">
+        Revisions of {node?.title || 'node'}
+      </div>
+      {revisions.length === 0 && !loading ? (
+        <div className="px-2 py-4 text-sm text-gray-400 text-center">No saved revisions</div>
+      ) : (
+        <div className="space-y-1">
+          {revisions.map((entry) => {
+            const detail = details[entry.revision];
+            const isExpanded = expanded === entry.revision;
+            return (
+              <div key={entry.revision} className="rounded text-sm text-gray-700">
+                <button
+                  onClick={() => toggleRevision(entry.revision)}
+                  className="w-full flex items-center justify-between px-2 py-1.5 rounded hover:bg-gray-50 transition-colors"
+                >
+                  <span className="flex items-center gap-1 flex-1 truncate">
+                    <ChevronRight className={`w-3 h-3 transition-transform ${isExpanded ? 'rotate-90' : ''}`} />
+                    Revision {entry.revision}
+                  </span>
+                  <span className="text-xs text-gray-400 ml-2">
+                    {formatTime(new Date(entry.createdAt))}
+                  </span>
+                </button>
+                {isExpanded && (
+                  <div className="mx-2 mb-1 px-2 py-1.5 bg-gray-50 rounded">
+                    {detail ? (
+                      <>
+                        <div className="font-medium truncate">{detail.title || 'Untitled'}</div>
+                        {detail.tags.length > 0 && (
+                          <div className="text-xs text-gray-500 truncate">{detail.tags.join(', ')}</div>
+                        )}
+                        <button
+                          onClick={() => restoreRevision(detail)}
+                          className="mt-1 flex items-center gap-1 text-xs text-blue-600 hover:text-blue-700"
+                        >
+                          <RotateCcw className="w-3 h-3" />
+                          Restore this revision
+                        </button>
+                      </>
+                    ) : (
+                      <Loader2 className="w-3 h-3 animate-spin text-gray-400" />
+                    )}
+                  </div>
+                )}
+              </div>
+            );
+          })}
+        </div>
+      )}
+      {(loading || nextCursor !== null) && (
+        <button
+          onClick={() => nextCursor !== null && loadPage(nextCursor)}
+          disabled={loading}
+          className="w-full mt-1 px-2 py-1.5 text-xs text-gray-500 hover:bg-gray-50 rounded transition-colors"
+        >
+          {loading ? 'Loading…' : 'Load older revisions'}
+        </button>
+      )}
+    </div>
+  );
+}
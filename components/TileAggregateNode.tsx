@@ -0,0 +1,39 @@
+/**
+ * Tile Aggregate Node - stand-in for a tile whose nodes are not loaded
+ * Windowed workspaces only (lib/viewportTiles.ts); clicking it zooms into the tile
+ */
+
+'use client';
+
+import { memo } from 'react';
+import { NodeProps } from 'reactflow';
+
+export const TILE_AGGREGATE_TYPE = 'tileAggregate';
+
+// Flow-space diameter range - grows with the log of the node count
+const MIN_DIAMETER = 80;
+const MAX_DIAMETER = 400;
+
+export function tileAggregateDiameter(count: number): number {
+  return Math.min(MAX_DIAMETER, MIN_DIAMETER + Math.log2(Math.max(count, 1)) * 30);
+}
+
+interface TileAggregateData {
+  count: number;
+}
+
+function TileAggregateNode({ data }: NodeProps<TileAggregateData>) {
+  const diameter = tileAggregateDiameter(data.count);
+
+  return (
+    <div
+      className="flex items-center justify-center rounded-full bg-blue-500/15 border border-blue-400/40 text-blue-700 cursor-zoom-in select-none"
+      style={{ width: diameter, height: diameter, fontSize: Math.max(14, diameter / 5) }}
+      title={`${data.count} nodes - click to zoom in`}
+    >
+      {data.count}
+    </div>
+  );
+}
+
+export default memo(TileAggregateNode);
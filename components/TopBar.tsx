@@ -11,7 +11,9 @@ interface TopBarProps {
 }
 
 export default function TopBar({ workspaceId, onCreateNode }: TopBarProps) {
-  const { currentWorkspace, layout, setLayout, nodes } = useWorkspaceStore();
+  const currentWorkspace = useWorkspaceStore((state) => state.currentWorkspace);
+  const layout = useWorkspaceStore((state) => state.layout);
+  const setLayout = useWorkspaceStore((state) => state.setLayout);
   const { selectNode } = useCanvasStore();
   const [searchQuery, setSearchQuery] = useState('');
   const [searchResults, setSearchResults] = useState<any[]>([]);
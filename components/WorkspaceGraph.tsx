@@ -239,8 +239,10 @@ export default function WorkspaceGraph({ workspaces, searchQuery = '' }: Props)
       .attr('pointer-events', 'none')
       .style('opacity', (d) => (highlightedNodeId === d.id ? 1 : 0.7));
 
-    // Update positions on simulation tick
-    simulation.on('tick', () => {
+    // Update positions on simulation tick - at most one DOM write per animation frame
+    let renderFrame: number | null = null;
+    const render = () => {
+      renderFrame = null;
       link
         .attr('x1', (d) => (d.source as GraphNode).x!)
         .attr('y1', (d) => (d.source as GraphNode).y!)
@@ -248,6 +250,9 @@ export default function WorkspaceGraph({ workspaces, searchQuery = '' }: Props)
         .attr('y2', (d) => (d.target as GraphNode).y!);
 
       node.attr('transform', (d) => `translate(${d.x},${d.y})`);
+    };
+    simulation.on('tick', () => {
+      if (renderFrame === null) renderFrame = requestAnimationFrame(render);
     });
 
     // Stop simulation after it stabilizes
@@ -264,10 +269,12 @@ export default function WorkspaceGraph({ workspaces, searchQuery = '' }: Props)
     const handleResize = () => {
       const container = svgRef.current?.parentElement;
       if (container) {
-        setDimensions({
-          width: container.clientWidth,
-          height: 500,
-        });
+        // Same size must not produce a new object - dimensions rebuilds the graph
+        setDimensions((current) =>
+          current.width === container.clientWidth && current.height === 500
+            ? current
+            : { width: container.clientWidth, height: 500 }
+        );
       }
     };
 
@@ -286,8 +293,11 @@ export default function WorkspaceGraph({ workspaces, searchQuery = '' }: Props)
     return () => {
       window.removeEventListener('resize', handleResize);
       simulation.stop();
+      if (renderFrame !== null) cancelAnimationFrame(renderFrame);
     };
-  }, [nodes, links, dimensions, highlightedNodeId, router, searchQuery]);
+    // highlightedNodeId is restyled by the effect below - hovering must not rebuild the graph
+    // eslint-disable-next-line react-hooks/exhaustive-deps
+  }, [nodes, links, dimensions, router, searchQuery]);
 
   // Update highlighted node and search highlighting
   useEffect(() => {
@@ -319,6 +329,10 @@ export default function WorkspaceGraph({ workspaces, searchQuery = '' }: Props)
           ? `drop-shadow(0 0 8px #f59e0b)`
           : 'drop-shadow(0 2px 4px rgba(0,0,0,0.2))';
       });
+
+    svg
+      .selectAll<SVGTextElement, GraphNode>('text[dy="35"]')
+      .style('opacity', (d) => (highlightedNodeId === d.id ? 1 : 0.7));
   }, [highlightedNodeId, searchQuery]);
 
   if (filteredWorkspaces.length === 0) {
@@ -1,10 +1,18 @@
 'use client';
 
-import { useEffect, useState } from 'react';
+import { useEffect, useRef, useState } from 'react';
 import { useWorkspaceStore } from '@/state/workspaceStore';
-import type { Workspace } from '@/types/Workspace';
+import { useCollabChannel } from '@/lib/collabClient';
+import type { Workspace, WorkspaceGraphDelta } from '@/types/Workspace';
 import type { Node } from '@/types/Node';
 import type { Edge } from '@/types/Edge';
+import { decodeGraphPayload, GRAPH_PAYLOAD_CONTENT_TYPE, isPartialContent } from '@/lib/graphPayload';
+import { loadPendingNodeContents } from '@/lib/nodeContentLoader';
+
+// While the collaboration stream is up it announces every version bump, so polling is only
+// a safety net; without it we poll every POLL_INTERVAL_MS
+const POLL_INTERVAL_MS = 5000;
+const CONNECTED_POLL_INTERVAL_MS = 30000;
 
 interface WorkspaceProviderProps {
   workspaceId: string;
@@ -12,15 +20,34 @@ interface WorkspaceProviderProps {
 }
 
 export default function WorkspaceProvider({ workspaceId, children }: WorkspaceProviderProps) {
-  // Only get setters from store - don't subscribe to nodes/edges to avoid unnecessary re-renders
-  const { setWorkspace, setNodes, setEdges } = useWorkspaceStore();
+  // One selector per action - actions never change, so store updates (remote ops, drags)
+  // don't re-render the provider
+  const setWorkspace = useWorkspaceStore((state) => state.setWorkspace);
+  const setNodes = useWorkspaceStore((state) => state.setNodes);
+  const setEdges = useWorkspaceStore((state) => state.setEdges);
+  const setGraphVersion = useWorkspaceStore((state) => state.setGraphVersion);
+  const applyGraphDelta = useWorkspaceStore((state) => state.applyGraphDelta);
+  const setWindowedGraph = useWorkspaceStore((state) => state.setWindowedGraph);
   const [isLoading, setIsLoading] = useState(true);
 
+  // Push channel: version notices trigger an immediate delta sync, ops from other members
+  // are applied straight away
+  const channel = useCollabChannel(workspaceId);
+  const channelRef = useRef(channel);
+  channelRef.current = channel;
+  const syncRef = useRef<(() => Promise<void>) | null>(null);
+  const lastSyncRef = useRef(0);
+
   // Load workspace data - single effect with polling (fixed reload loop)
   useEffect(() => {
     let isMounted = true;
     let pollInterval: NodeJS.Timeout | null = null;
     let isLoadingRef = false; // Prevent multiple simultaneous loads
+    // Lazy content fetch for the binary skeleton - aborted on reload, switch or unmount
+    let contentAbort: AbortController | null = null;
+
+    // Graph version belongs to the previous workspace - force a full load first
+    setGraphVersion(null);
 
     // Helper to create a stable hash of nodes/edges for comparison
     function createNodesHash(nodes: Node[]): string {
@@ -55,12 +82,29 @@ export default function WorkspaceProvider({ workspaceId, children }: WorkspacePr
       );
     }
 
+    // Skeleton nodes whose row hasn't changed keep the full content already in the store,
+    // so a reload doesn't send them back to the content loader
+    function decodeSkeleton(buffer: ArrayBuffer) {
+      const { header, nodes, edges } = decodeGraphPayload(buffer);
+      const { nodes: currentNodes, nodeIndex } = useWorkspaceStore.getState();
+      for (const node of nodes) {
+        const index = nodeIndex.get(node.id);
+        const current = index === undefined ? undefined : currentNodes[index];
+        if (current && current.updatedAt === node.updatedAt && !isPartialContent(current.content)) {
+          node.content = current.content;
+        }
+      }
+      return { workspace: header.extra?.workspace, version: header.version, nodes, edges };
+    }
+
     async function loadWorkspace(setLoading: boolean = true) {
       if (!isMounted || isLoadingRef) return; // Prevent concurrent loads
       isLoadingRef = true;
 
       try {
-        const response = await fetch(`/api/workspaces/${workspaceId}/data`);
+        // Large workspaces answer with tile aggregates only; the canvas pages tiles in (useViewportTiles).
+        // Otherwise nodes and edges come as a binary skeleton and content follows lazily
+        const response = await fetch(`/api/workspaces/${workspaceId}/data?windowed=1&format=binary`);
 
         if (!response.ok) {
           const errorData = await response.json().catch(() => ({}));
@@ -76,7 +120,10 @@ export default function WorkspaceProvider({ workspaceId, children }: WorkspacePr
           return;
         }
 
-        const data = await response.json();
+        const isBinary = response.headers.get('Content-Type')?.startsWith(GRAPH_PAYLOAD_CONTENT_TYPE);
+        const data = isBinary
+          ? decodeSkeleton(await response.arrayBuffer())
+          : await response.json();
 
         if (!isMounted) {
           isLoadingRef = false;
@@ -99,6 +146,16 @@ export default function WorkspaceProvider({ workspaceId, children }: WorkspacePr
           }
         }
 
+        if (data.windowed) {
+          console.log('[WorkspaceProvider] Large workspace, loading windowed', {
+            nodeCount: data.nodeCount,
+            tiles: data.summaries?.length || 0,
+          });
+          setWindowedGraph(data.summaries || []);
+        } else {
+          setWindowedGraph(null);
+        }
+
         // Only update nodes if they actually changed (by value, not reference)
         if (data.nodes) {
           const newNodesHash = createNodesHash(data.nodes);
@@ -129,6 +186,17 @@ export default function WorkspaceProvider({ workspaceId, children }: WorkspacePr
           }
         }
 
+        if (typeof data.version === 'number') {
+          setGraphVersion(data.version);
+        }
+
+        if (isBinary) {
+          contentAbort?.abort();
+          const controller = new AbortController();
+          contentAbort = controller;
+          void loadPendingNodeContents(workspaceId, controller.signal);
+        }
+
         if (setLoading && isMounted) {
           setIsLoading(false);
         }
@@ -140,6 +208,54 @@ export default function WorkspaceProvider({ workspaceId, children }: WorkspacePr
       }
     }
 
+    // Incremental refresh - only fetches nodes/edges changed since the version we have.
+    // Falls back to a full load when we have no version yet or the server asks for a reset
+    async function syncWorkspace() {
+      lastSyncRef.current = Date.now();
+      const since = useWorkspaceStore.getState().graphVersion;
+      if (since === null) {
+        return loadWorkspace(false);
+      }
+      if (!isMounted || isLoadingRef) return;
+      isLoadingRef = true;
+
+      let needsFullLoad = false;
+      try {
+        const response = await fetch(`/api/workspaces/${workspaceId}/graph?since=${since}`);
+        if (!response.ok) {
+          console.error('Failed to sync workspace:', {
+            status: response.status,
+            statusText: response.statusText,
+            workspaceId,
+          });
+          return;
+        }
+
+        const delta: WorkspaceGraphDelta = await response.json();
+        if (!isMounted) return;
+
+        // Another sync or full load moved us on while this request was in flight
+        if (useWorkspaceStore.getState().graphVersion !== since) return;
+
+        if (delta.reset) {
+          needsFullLoad = true;
+        } else if (delta.version !== since) {
+          applyGraphDelta(delta);
+        }
+      } catch (error) {
+        console.error('Error syncing workspace:', error);
+      } finally {
+        isLoadingRef = false;
+      }
+
+      if (needsFullLoad) {
+        console.log('[WorkspaceProvider] Graph version too old, doing full reload');
+        await loadWorkspace(false);
+      }
+    }
+
+    syncRef.current = syncWorkspace;
+
     // Initial load
     loadWorkspace(true);
 
@@ -148,8 +264,10 @@ export default function WorkspaceProvider({ workspaceId, children }: WorkspacePr
       if (pollInterval) clearInterval(pollInterval);
       
       pollInterval = setInterval(() => {
-        loadWorkspace(false); // Don't set loading state during polling
-      }, 5000);
+        const interval = channelRef.current?.connected ? CONNECTED_POLL_INTERVAL_MS : POLL_INTERVAL_MS;
+        if (Date.now() - lastSyncRef.current < interval) return;
+        syncWorkspace(); // Delta only - don't set loading state during polling
+      }, POLL_INTERVAL_MS);
     }, 1000); // Wait 1 second after initial load before starting polling
 
     // Listen for refresh events (e.g., after node creation/deletion - major operations only)
@@ -176,7 +294,7 @@ export default function WorkspaceProvider({ workspaceId, children }: WorkspacePr
       // Add a significant delay to batch multiple refresh events
       refreshTimeout = setTimeout(() => {
         lastRefreshTime = Date.now();
-        loadWorkspace(false);
+        syncWorkspace();
         refreshTimeout = null;
       }, 5000); // 5 second debounce
     };
@@ -184,6 +302,8 @@ export default function WorkspaceProvider({ workspaceId, children }: WorkspacePr
 
     return () => {
       isMounted = false;
+      syncRef.current = null;
+      contentAbort?.abort();
       if (pollInterval) clearInterval(pollInterval);
       clearTimeout(timeoutId);
       if (refreshTimeout) clearTimeout(refreshTimeout);
@@ -192,6 +312,25 @@ export default function WorkspaceProvider({ workspaceId, children }: WorkspacePr
     // eslint-disable-next-line react-hooks/exhaustive-deps
   }, [workspaceId]); // Only depend on workspaceId - no reload loop
 
+  useEffect(() => {
+    if (!channel) return;
+
+    const syncIfBehind = (version: number | null) => {
+      const current = useWorkspaceStore.getState().graphVersion;
+      // No version yet means the initial load is still running
+      if (current === null || (version !== null && version <= current)) return;
+      void syncRef.current?.();
+    };
+
+    const unsubscribers = [
+      channel.on('ops', ({ ops }) => useWorkspaceStore.getState().applyRemoteOps(ops)),
+      channel.on('version', ({ version }) => syncIfBehind(version)),
+      // (Re)connected - catch up on anything missed while the stream was down
+      channel.on('hello', ({ version }) => syncIfBehind(version)),
+    ];
+    return () => unsubscribers.forEach((unsubscribe) => unsubscribe());
+  }, [channel]);
+
   if (isLoading) {
     return (
       <div className="flex items-center justify-center h-screen">
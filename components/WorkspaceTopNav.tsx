@@ -5,6 +5,8 @@ import { useRouter } from 'next/navigation';
 import { signOut, useSession } from 'next-auth/react';
 import { Search, User, Edit2, Check, X, CreditCard, LogOut, Tag } from 'lucide-react';
 import { useCanvasStore } from '@/state/canvasStore';
+import { useWorkspaceStore } from '@/state/workspaceStore';
+import { NodeSearchIndex } from '@/lib/search';
 import MeshFlowLogo from '@/components/MeshFlowLogo';
 import Link from 'next/link';
 
@@ -77,6 +79,9 @@ export default function WorkspaceTopNav({ workspaceId, workspaceName }: Workspac
   const [showResults, setShowResults] = useState(false);
   const [showProfileMenu, setShowProfileMenu] = useState(false);
   const searchTimeoutRef = useRef<NodeJS.Timeout>();
+  // Local fuzzy index over the loaded nodes - kept in sync incrementally, never rebuilt
+  const searchIndexRef = useRef<NodeSearchIndex | null>(null);
+  const latestQueryRef = useRef('');
 
   const handleSearch = async (query: string) => {
     setSearchQuery(query);
@@ -86,23 +91,44 @@ export default function WorkspaceTopNav({ workspaceId, workspaceName }: Workspac
       clearTimeout(searchTimeoutRef.current);
     }
 
+    latestQueryRef.current = query;
+
     if (!query.trim()) {
       setSearchResults([]);
       setShowResults(false);
       return;
     }
 
+    // Instant results from the local index; the ranked server search replaces them
+    const nodes = useWorkspaceStore.getState().nodes;
+    if (!searchIndexRef.current) {
+      searchIndexRef.current = new NodeSearchIndex(nodes);
+    } else {
+      searchIndexRef.current.sync(nodes);
+    }
+    const localResults = searchIndexRef.current.search(query, 10).map((result) => ({
+      node: {
+        id: result.node.id,
+        title: result.node.title,
+        tags: result.node.tags || [],
+      },
+    }));
+    setSearchResults(localResults);
+    setShowResults(localResults.length > 0);
+
     // Debounce search and use API
     searchTimeoutRef.current = setTimeout(async () => {
       try {
         const response = await fetch(
-          `/api/nodes/search?q=${encodeURIComponent(query)}&workspaceId=${workspaceId}`
+          `/api/nodes/search?q=${encodeURIComponent(query)}&workspaceId=${workspaceId}&limit=10`
         );
+
+        // A newer keystroke has already moved on - drop this response
+        if (latestQueryRef.current !== query) return;
         
         if (!response.ok) {
+          // Keep the local results on screen
           console.error('Search failed:', response.statusText);
-          setSearchResults([]);
-          setShowResults(false);
           return;
         }
 
@@ -121,9 +147,8 @@ export default function WorkspaceTopNav({ workspaceId, workspaceName }: Workspac
         setSearchResults(formattedResults);
         setShowResults(formattedResults.length > 0);
       } catch (error) {
+        // Keep the local results on screen
         console.error('Error searching:', error);
-        setSearchResults([]);
-        setShowResults(false);
       }
     }, 300);
   };
@@ -7,23 +7,65 @@ export function useNodeFiltering() {
   const { nodes, edges, filterOptions, searchQuery, explodedNodeId } = useMeshStore();
   const [importanceScores, setImportanceScores] = useState<Record<string, number>>({});
 
-  // Calculate importance scores
+  // Graph topology: analytics only need refetching when ids or edge endpoints change
+  const topology = useMemo(() => {
+    const nodeIds = nodes.map((node) => node.id);
+    const pairs: [string, string][] = edges.map((edge) => [
+      typeof edge.source === 'string' ? edge.source : edge.source.id,
+      typeof edge.target === 'string' ? edge.target : edge.target.id,
+    ]);
+    // FNV-1a over ids and endpoints - a cheap change key, not a security hash
+    let hash = 0x811c9dc5;
+    const mix = (value: string) => {
+      for (let i = 0; i < value.length; i++) {
+        hash ^= value.charCodeAt(i);
+        hash = Math.imul(hash, 0x01000193);
+      }
+      // Separator, so ["ab", "c"] and ["a", "bc"] differ
+      hash = Math.imul(hash ^ 0xff, 0x01000193);
+    };
+    nodeIds.forEach(mix);
+    pairs.forEach(([source, target]) => {
+      mix(source);
+      mix(target);
+    });
+    return { nodeIds, pairs, key: `${nodeIds.length}:${pairs.length}:${hash >>> 0}` };
+  }, [nodes, edges]);
+
+  // Calculate importance scores: PageRank (50%) + betweenness (20%) + recency (30%)
   useEffect(() => {
-    if (nodes.length > 0) {
-      graphService
-        .calculateImportance(nodes, edges)
-        .then((scores) => {
-          setImportanceScores(scores);
-          // Update nodes with importance scores
-          nodes.forEach((node) => {
-            if (scores[node.id] !== undefined) {
-              useMeshStore.getState().updateNode(node.id, { importance: scores[node.id] });
-            }
-          });
-        })
-        .catch(console.error);
-    }
-  }, [nodes.length, edges.length]);
+    if (topology.nodeIds.length === 0) return;
+    let active = true;
+
+    graphService
+      .getAnalytics(topology.nodeIds, topology.pairs)
+      .then(({ metrics }) => {
+        if (!active) return;
+        const { nodes: current } = useMeshStore.getState();
+        const now = Date.now();
+        let maxAge = 1;
+        for (const node of current) {
+          const age = now - new Date(node.updatedAt).getTime();
+          if (age > maxAge) maxAge = age;
+        }
+
+        const scores: Record<string, number> = {};
+        for (const node of current) {
+          const metric = metrics[node.id];
+          if (!metric) continue;
+          const recency = 1 - (now - new Date(node.updatedAt).getTime()) / maxAge;
+          scores[node.id] = metric.pagerank * 0.5 + metric.betweenness * 0.2 + recency * 0.3;
+        }
+
+        setImportanceScores(scores);
+        useMeshStore.getState().setNodeImportance(scores);
+      })
+      .catch(console.error);
+
+    return () => {
+      active = false;
+    };
+  }, [topology.key]);
 
   const filteredNodes = useMemo(() => {
     let filtered = [...nodes];
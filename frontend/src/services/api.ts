@@ -1,5 +1,5 @@
 import axios from 'axios';
-import type { Node, Edge } from '../types';
+import type { Node, Edge, GraphAnalytics } from '../types';
 
 const api = axios.create({
   baseURL: '/api',
@@ -42,6 +42,12 @@ export const graphService = {
     });
     return response.data.importanceScores;
   },
+
+  // Topology only: ids and [source, target] pairs
+  getAnalytics: async (nodeIds: string[], edges: [string, string][]) => {
+    const response = await api.post<GraphAnalytics>('/graph/analytics', { nodeIds, edges });
+    return response.data;
+  },
 };
 
 
@@ -16,6 +16,7 @@ interface MeshState {
   // Actions
   addNode: (node: Node) => void;
   updateNode: (id: string, updates: Partial<Node>) => void;
+  setNodeImportance: (scores: Record<string, number>) => void;
   deleteNode: (id: string) => void;
   addEdge: (edge: Edge) => void;
   deleteEdge: (id: string) => void;
@@ -66,6 +67,16 @@ export const useMeshStore = create<MeshState>()(
           ),
         })),
 
+      // Computed scores, applied in one update; not an edit, so updatedAt is left alone
+      setNodeImportance: (scores) =>
+        set((state) => ({
+          nodes: state.nodes.map((node) =>
+            scores[node.id] !== undefined && scores[node.id] !== node.importance
+              ? { ...node, importance: scores[node.id] }
+              : node
+          ),
+        })),
+
       deleteNode: (id) =>
         set((state) => ({
           nodes: state.nodes.filter((node) => node.id !== id),
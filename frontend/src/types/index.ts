@@ -26,6 +26,19 @@ export interface Edge {
   label?: string;
 }
 
+export interface NodeMetrics {
+  pagerank: number;
+  betweenness: number;
+  component: number;
+}
+
+export interface GraphAnalytics {
+  version: string;
+  metrics: Record<string, NodeMetrics>;
+  componentCount: number;
+  cached: boolean;
+}
+
 export interface Cluster {
   id: string;
   nodes: string[];
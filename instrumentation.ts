@@ -0,0 +1,26 @@
+// Next.js server startup hook
+export async function register() {
+  // Resume queued background jobs (embeddings, auto-link) left over from a previous run
+  if (process.env.NEXT_RUNTIME === 'nodejs') {
+    const { startNodeJobWorker } = await import('./lib/nodeJobs');
+    // Register the remaining job handlers before the worker claims anything
+    await import('./lib/layoutCache');
+    await import('./lib/nodeDocuments');
+    await import('./lib/clusterCache');
+    await import('./lib/nodeRevisions');
+    startNodeJobWorker();
+
+    // Probe pgvector support once up front instead of on the first similarity query
+    const { warmVectorSupport } = await import('./lib/db-server');
+    void warmVectorSupport();
+
+    // Activity rows are buffered for up to a second (lib/activityLog.ts) - write them out
+    // before the server exits
+    const { flushActivityLog } = await import('./lib/activityLog');
+    const flushOnExit = (signal: NodeJS.Signals) => {
+      void flushActivityLog().finally(() => process.kill(process.pid, signal));
+    };
+    process.once('SIGTERM', flushOnExit);
+    process.once('SIGINT', flushOnExit);
+  }
+}
@@ -0,0 +1,162 @@
+import { Prisma } from '@prisma/client';
+import { prisma } from './db';
+import { getUserSummaries, type UserSummary } from './api-helpers';
+
+// Server-only activity feed (activity_log)
+// - logActivity() queues a row and returns; queued rows go out in one createMany every
+//   FLUSH_INTERVAL_MS (or as soon as FLUSH_BATCH_SIZE are waiting), and once more on
+//   shutdown (instrumentation.ts, scripts/job-worker.ts)
+// - created_at is stamped when a batch is inserted, so a row can commit after newer ones
+//   (another instance's batch, a slower transaction, clock skew); the collaboration watcher
+//   (lib/collabHub.ts) rescans a window behind its cursor to pick those up
+// - pages are keyset on (created_at, id), newest first, on the
+//   (workspace_id, created_at DESC, id DESC) index; authors come from one batched lookup
+
+const FLUSH_INTERVAL_MS = 1000;
+const FLUSH_BATCH_SIZE = 200;
+// Rows beyond this (database unreachable for a while) are dropped, oldest first
+const MAX_BUFFERED = 10_000;
+
+export const MAX_ACTIVITY_PAGE = 100;
+
+export interface ActivityEntry {
+  workspaceId: string;
+  userId: string;
+  action: string;
+  entityType: string;
+  entityId?: string | null;
+  details?: Prisma.InputJsonValue;
+}
+
+export type ActivityRow = Prisma.ActivityLogGetPayload<{}> & { user: UserSummary | null };
+
+// Kept on globalThis so dev hot reloads don't lose (or double-flush) queued rows
+const globalForActivity = globalThis as unknown as {
+  activityBuffer: { entries: ActivityEntry[]; timer: NodeJS.Timeout | null; flushing: Promise<void> | null } | undefined;
+};
+
+const buffer = globalForActivity.activityBuffer ?? { entries: [], timer: null, flushing: null };
+globalForActivity.activityBuffer = buffer;
+
+/**
+ * Record an activity row without waiting for the insert
+ * Never throws - a failed batch is logged and dropped, like the inline inserts were
+ */
+export function logActivity(entry: ActivityEntry) {
+  buffer.entries.push(entry);
+  if (buffer.entries.length > MAX_BUFFERED) {
+    buffer.entries.splice(0, buffer.entries.length - MAX_BUFFERED);
+  }
+
+  if (buffer.entries.length >= FLUSH_BATCH_SIZE) {
+    void flushActivityLog();
+  } else if (!buffer.timer) {
+    buffer.timer = setTimeout(() => void flushActivityLog(), FLUSH_INTERVAL_MS);
+    buffer.timer.unref?.();
+  }
+}
+
+/**
+ * Insert everything queued so far (also called on server and worker shutdown)
+ */
+export async function flushActivityLog(): Promise<void> {
+  if (buffer.timer) {
+    clearTimeout(buffer.timer);
+    buffer.timer = null;
+  }
+  // One flush at a time - rows queued meanwhile go in the next one
+  while (buffer.flushing) await buffer.flushing;
+  if (buffer.entries.length === 0) return;
+
+  const entries = buffer.entries.splice(0, buffer.entries.length);
+  buffer.flushing = (async () => {
+    for (let start = 0; start < entries.length; start += FLUSH_BATCH_SIZE) {
+      try {
+        await prisma.activityLog.createMany({ data: entries.slice(start, start + FLUSH_BATCH_SIZE) });
+      } catch (error: any) {
+        console.warn('[activityLog] Failed to write activity (dropped):', error?.message);
+      }
+    }
+  })();
+
+  try {
+    await buffer.flushing;
+  } finally {
+    buffer.flushing = null;
+  }
+}
+
+function encodeCursor(row: { createdAt: Date; id: string }): string {
+  return `${row.createdAt.getTime()}_${row.id}`;
+}
+
+function decodeCursor(cursor: string): { createdAt: Date; id: string } | null {
+  const separator = cursor.indexOf('_');
+  const createdAt = new Date(Number(cursor.slice(0, separator)));
+  if (separator <= 0 || Number.isNaN(createdAt.getTime())) return null;
+  return { createdAt, id: cursor.slice(separator + 1) };
+}
+
+async function withUsers(rows: Prisma.ActivityLogGetPayload<{}>[]): Promise<ActivityRow[]> {
+  const users = await getUserSummaries(rows.map((row) => row.userId));
+  return rows.map((row) => ({ ...row, user: users.get(row.userId) ?? null }));
+}
+
+/**
+ * One page of a workspace's activity, newest first
+ * Pass nextCursor back as `before` for the next page; a malformed cursor throws
+ */
+export async function listActivity(
+  workspaceId: string,
+  options: { before?: string; limit?: number } = {}
+): Promise<{ activities: ActivityRow[]; nextCursor: string | null }> {
+  const limit = Math.min(Math.max(options.limit ?? 50, 1), MAX_ACTIVITY_PAGE);
+
+  let where: Prisma.ActivityLogWhereInput = { workspaceId };
+  if (options.before) {
+    const cursor = decodeCursor(options.before);
+    if (!cursor) throw new Error('Invalid cursor');
+    where = {
+      workspaceId,
+      OR: [
+        { createdAt: { lt: cursor.createdAt } },
+        { createdAt: cursor.createdAt, id: { lt: cursor.id } },
+      ],
+    };
+  }
+
+  const rows = await prisma.activityLog.findMany({
+    where,
+    orderBy: [{ createdAt: 'desc' }, { id: 'desc' }],
+    take: limit + 1,
+  });
+  const page = rows.slice(0, limit);
+
+  return {
+    activities: await withUsers(page),
+    nextCursor: rows.length > limit ? encodeCursor(page[page.length - 1]) : null,
+  };
+}
+
+/**
+ * Activity after the (createdAt, id) position `after`, oldest first, on the same index
+ * (the collaboration watcher's scan; pass the last row back as `after` for the next page)
+ */
+export async function listActivitySince(
+  workspaceId: string,
+  after: { createdAt: Date; id: string },
+  limit: number
+): Promise<ActivityRow[]> {
+  const rows = await prisma.activityLog.findMany({
+    where: {
+      workspaceId,
+      OR: [
+        { createdAt: { gt: after.createdAt } },
+        { createdAt: after.createdAt, id: { gt: after.id } },
+      ],
+    },
+    orderBy: [{ createdAt: 'asc' }, { id: 'asc' }],
+    take: limit,
+  });
+  return withUsers(rows);
+}
@@ -1,46 +1,194 @@
 /**
  * API helper functions for authentication and authorization
+ *
+ * Lookups are cached so a route pays for them once, not once per check:
+ * - the session user is memoized per request (keyed by the request's headers object)
+ * - users and (user, workspace) roles are cached for a few seconds per process; routes
+ *   that change them evict explicitly (invalidateUser / invalidateWorkspaceAccess), other
+ *   instances catch up when the entry expires
  */
 
+import { headers } from 'next/headers';
 import { getServerSession } from 'next-auth/next';
 import { authOptions } from './auth';
 import { prisma } from './db';
+import { withSpan } from './tracing';
 
-/**
- * Get current user from session
- */
-export async function getCurrentUser() {
+type WorkspaceRole = 'owner' | 'editor' | 'viewer';
+type WorkspaceAccess = { hasAccess: boolean; role?: WorkspaceRole };
+
+const USER_CACHE_TTL_MS = 15_000;
+const ACCESS_CACHE_TTL_MS = 15_000;
+const MAX_CACHE_ENTRIES = 10_000;
+
+// Promises are cached, so concurrent lookups for the same key share one query
+class TtlCache<V> {
+  private entries = new Map<string, { value: Promise<V>; expiresAt: number }>();
+
+  constructor(private ttlMs: number) {}
+
+  get(key: string, load: () => Promise<V>): Promise<V> {
+    const entry = this.entries.get(key);
+    if (entry && entry.expiresAt > Date.now()) return entry.value;
+
+    const value = load();
+    this.entries.delete(key);
+    if (this.entries.size >= MAX_CACHE_ENTRIES) {
+      // Oldest insertion first
+      this.entries.delete(this.entries.keys().next().value!);
+    }
+    this.entries.set(key, { value, expiresAt: Date.now() + this.ttlMs });
+    // Errors are not cached
+    value.catch(() => {
+      if (this.entries.get(key)?.value === value) this.entries.delete(key);
+    });
+    return value;
+  }
+
+  delete(predicate: (key: string) => boolean) {
+    for (const key of this.entries.keys()) {
+      if (predicate(key)) this.entries.delete(key);
+    }
+  }
+}
+
+type SessionUser = Awaited<ReturnType<typeof loadUser>>;
+
+// Kept on globalThis so dev hot reloads don't start from an empty cache each time
+const globalForAccess = globalThis as unknown as {
+  userCache: TtlCache<SessionUser> | undefined;
+  accessCache: TtlCache<WorkspaceAccess> | undefined;
+};
+
+const userCache = globalForAccess.userCache ?? new TtlCache<SessionUser>(USER_CACHE_TTL_MS);
+const accessCache = globalForAccess.accessCache ?? new TtlCache<WorkspaceAccess>(ACCESS_CACHE_TTL_MS);
+globalForAccess.userCache = userCache;
+globalForAccess.accessCache = accessCache;
+
+// Session user per request
+const requestUsers = new WeakMap<object, Promise<SessionUser>>();
+
+const userSelect = {
+  id: true,
+  email: true,
+  name: true,
+  avatarUrl: true,
+  plan: true,
+} as const;
+
+function loadUser(userId: string) {
+  return prisma.user.findUnique({
+    where: { id: userId },
+    select: userSelect,
+  });
+}
+
+async function loadSessionUser(): Promise<SessionUser> {
   const session = await getServerSession(authOptions);
-  
+
   const userId = (session?.user as any)?.id;
   if (!userId) {
     return null;
   }
 
-  const user = await prisma.user.findUnique({
-    where: { id: userId },
-    select: {
-      id: true,
-      email: true,
-      name: true,
-      avatarUrl: true,
-      plan: true,
-    },
-  });
+  return userCache.get(userId, () => loadUser(userId));
+}
 
+/**
+ * Get current user from session
+ */
+export async function getCurrentUser() {
+  let requestHeaders: object | null = null;
+  try {
+    requestHeaders = await headers();
+  } catch {
+    // Outside a request scope (scripts, jobs) - nothing to memoize on
+  }
+  if (!requestHeaders) return loadSessionUser();
+
+  let user = requestUsers.get(requestHeaders);
+  if (!user) {
+    user = loadSessionUser();
+    requestUsers.set(requestHeaders, user);
+  }
   return user;
 }
 
+export type UserSummary = { id: string; email: string; name: string | null; avatarUrl: string | null };
+
+/**
+ * Look up the authors of a page of rows (activity, comments) - one query for every user
+ * not already in the user cache, instead of a join repeated on each row
+ */
+export async function getUserSummaries(userIds: string[]): Promise<Map<string, UserSummary>> {
+  const ids = Array.from(new Set(userIds));
+  const missing: string[] = [];
+  let settle!: { resolve: (users: Map<string, SessionUser>) => void; reject: (error: unknown) => void };
+  const batch = new Promise<Map<string, SessionUser>>((resolve, reject) => {
+    settle = { resolve, reject };
+  });
+
+  // Loaders run synchronously inside get(), so `missing` is complete after this map
+  const lookups = ids.map((id) =>
+    userCache.get(id, () => {
+      missing.push(id);
+      return batch.then((users) => users.get(id) ?? null);
+    })
+  );
+
+  if (missing.length > 0) {
+    prisma.user
+      .findMany({ where: { id: { in: missing } }, select: userSelect })
+      .then((users) => settle.resolve(new Map(users.map((user) => [user.id, user]))), settle.reject);
+  }
+
+  const summaries = new Map<string, UserSummary>();
+  (await Promise.all(lookups)).forEach((user) => {
+    if (user) {
+      summaries.set(user.id, { id: user.id, email: user.email, name: user.name, avatarUrl: user.avatarUrl });
+    }
+  });
+  return summaries;
+}
+
+/**
+ * Drop cached copies of a user after it was updated or deleted
+ */
+export function invalidateUser(userId: string) {
+  userCache.delete((key) => key === userId);
+  accessCache.delete((key) => key.startsWith(`${userId}:`));
+}
+
+/**
+ * Drop cached roles for a workspace after membership or ownership changes
+ * Pass userId to evict just that member
+ */
+export function invalidateWorkspaceAccess(workspaceId: string, userId?: string) {
+  if (userId) {
+    accessCache.delete((key) => key === `${userId}:${workspaceId}`);
+  } else {
+    accessCache.delete((key) => key.endsWith(`:${workspaceId}`));
+  }
+}
+
 /**
  * Check if user has access to workspace
  */
 export async function hasWorkspaceAccess(
   userId: string,
   workspaceId: string
-): Promise<{ hasAccess: boolean; role?: 'owner' | 'editor' | 'viewer' }> {
+): Promise<WorkspaceAccess> {
+  return accessCache.get(`${userId}:${workspaceId}`, () => loadWorkspaceAccess(userId, workspaceId));
+}
+
+async function loadWorkspaceAccess(userId: string, workspaceId: string): Promise<WorkspaceAccess> {
+  // Owner and membership in one round trip
   const workspace = await prisma.workspace.findUnique({
     where: { id: workspaceId },
-    select: { ownerId: true },
+    select: {
+      ownerId: true,
+      members: { where: { userId }, select: { role: true }, take: 1 },
+    },
   });
 
   if (!workspace) {
@@ -51,16 +199,7 @@ export async function hasWorkspaceAccess(
     return { hasAccess: true, role: 'owner' };
   }
 
-  const member = await prisma.workspaceMember.findUnique({
-    where: {
-      workspaceId_userId: {
-        workspaceId,
-        userId,
-      },
-    },
-    select: { role: true },
-  });
-
+  const member = workspace.members[0];
   if (member) {
     return { hasAccess: true, role: member.role };
   }
@@ -88,7 +227,7 @@ export async function canEditWorkspace(
  * Require authentication helper
  */
 export async function requireAuth() {
-  const user = await getCurrentUser();
+  const user = await withSpan('auth.session', getCurrentUser);
   
   if (!user) {
     throw new Error('Unauthorized');
@@ -106,7 +245,7 @@ export async function requireWorkspaceAccess(
 ) {
   const user = await requireAuth();
   
-  const { hasAccess, role } = await hasWorkspaceAccess(user.id, workspaceId);
+  const { hasAccess, role } = await withSpan('auth.workspace', () => hasWorkspaceAccess(user.id, workspaceId));
 
   if (!hasAccess) {
     throw new Error('Forbidden: No access to workspace');
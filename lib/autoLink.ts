@@ -1,37 +1,47 @@
 import type { Node } from '@/types/Node';
 import type { Edge } from '@/types/Edge';
-import { cosineSimilarity, SIMILARITY_THRESHOLDS } from './similarity';
+import { SIMILARITY_THRESHOLDS } from './similarity';
+import { VectorStore } from './vectorStore';
 
 interface SimilarityResult {
   node: Node;
   similarity: number;
 }
 
+// Vector stores are cached per node array - the zustand stores replace arrays on change,
+// so repeated queries against the same nodes reuse the normalized rows
+const vectorStoreCache = new WeakMap<Node[], { store: VectorStore; nodesById: Map<string, Node> }>();
+
+function getNodeVectorStore(allNodes: Node[]) {
+  let cached = vectorStoreCache.get(allNodes);
+  if (!cached) {
+    cached = {
+      store: VectorStore.from(allNodes),
+      nodesById: new Map(allNodes.map((node) => [node.id, node])),
+    };
+    vectorStoreCache.set(allNodes, cached);
+  }
+  return cached;
+}
+
 /**
- * Find nodes similar to the given embedding
+ * Find nodes similar to the given embedding (sorted by similarity, highest first)
+ * Pass `limit` to keep only the top matches - a bounded heap instead of a full sort
  */
 export function getSimilarNodes(
   embedding: number[],
   allNodes: Node[],
-  excludeNodeId?: string
+  excludeNodeId?: string,
+  limit: number = Infinity
 ): SimilarityResult[] {
-  const results: SimilarityResult[] = [];
-
-  for (const node of allNodes) {
-    if (excludeNodeId && node.id === excludeNodeId) continue;
-    if (!node.embedding || node.embedding.length === 0) continue;
+  const { store, nodesById } = getNodeVectorStore(allNodes);
 
-    const similarity = cosineSimilarity(embedding, node.embedding);
-    
-    if (similarity >= SIMILARITY_THRESHOLDS.SUGGEST_LINK) {
-      results.push({ node, similarity });
-    }
-  }
-
-  // Sort by similarity descending
-  results.sort((a, b) => b.similarity - a.similarity);
-
-  return results;
+  return store
+    .search(embedding, limit, {
+      minSimilarity: SIMILARITY_THRESHOLDS.SUGGEST_LINK,
+      exclude: excludeNodeId,
+    })
+    .map(({ id, similarity }) => ({ node: nodesById.get(id)!, similarity }));
 }
 
 /**
@@ -81,3 +91,56 @@ export function createAutoEdges(
     similarity: 1, // Will be calculated separately
   }));
 }
+
+export interface RelinkProgress {
+  processed: number;
+  total: number;
+  created: number;
+}
+
+/**
+ * Rebuild similarity edges for a whole workspace (POST /api/workspaces/[id]/auto-link)
+ * Reads the NDJSON progress stream; resolves with the number of edges created
+ */
+export async function relinkWorkspace(
+  workspaceId: string,
+  onProgress?: (progress: RelinkProgress) => void
+): Promise<number> {
+  const response = await fetch(`/api/workspaces/${workspaceId}/auto-link`, {
+    method: 'POST',
+    headers: { 'Content-Type': 'application/json' },
+    body: JSON.stringify({ stream: true }),
+  });
+
+  if (!response.ok || !response.body) {
+    const data = await response.json().catch(() => ({}));
+    throw new Error(data.error || `Relink failed (${response.status})`);
+  }
+
+  const reader = response.body.getReader();
+  const decoder = new TextDecoder();
+  let buffered = '';
+
+  while (true) {
+    const { done, value } = await reader.read();
+    if (done) break;
+
+    buffered += decoder.decode(value, { stream: true });
+    const lines = buffered.split('\n');
+    buffered = lines.pop() || '';
+
+    for (const line of lines) {
+      if (!line.trim()) continue;
+      const message = JSON.parse(line);
+      if (message.type === 'progress') {
+        onProgress?.(message);
+      } else if (message.type === 'done') {
+        return message.created;
+      } else if (message.type === 'error') {
+        throw new Error(message.error);
+      }
+    }
+  }
+
+  throw new Error('Relink stream ended unexpectedly');
+}
@@ -0,0 +1,301 @@
+import { Prisma } from '@prisma/client';
+import { prisma } from './db';
+import { hasEmbeddingColumn, readVectorInto } from './db-server';
+import { enqueueJob, registerJobHandler } from './jobQueue';
+import { defaultClusterCount, kMeans, nearestCentroid } from './clustering';
+import { normalizeVector } from './vectorStore';
+
+// Server-only semantic clusters, stored as one workspace_clusterings row per workspace
+// - full runs (k-means in lib/clustering.ts) go through the job queue; embeddings are read
+//   page by page straight into one packed Float32Array
+// - nodes embedded between runs are assigned to their nearest stored centroid and appended
+//   to the row, so ClustersView reads current clusters without waiting for a run
+// - a full run is queued once appended entries reach REFRESH_SHARE of the clustered nodes.
+//   Deleted nodes stay in the row until the next run; readers drop ids they don't have
+
+export interface WorkspaceCluster {
+  index: number;
+  label: string;
+  nodeIds: string[];
+}
+
+export interface StoredClusters {
+  k: number;
+  computedAt: Date;
+  clusters: WorkspaceCluster[];
+}
+
+// Requests cluster up to this many embedded nodes inline; larger workspaces are queued
+export const INLINE_CLUSTER_MAX_NODES = 5000;
+
+const CLUSTER_JOB = 'cluster_workspace';
+// Bursts of embeddings (imports, auto-organize) coalesce into one run
+const CLUSTER_DEBOUNCE_MS = 10_000;
+const REFRESH_SHARE = 0.2;
+const REFRESH_MIN_ASSIGNED = 20;
+const PAGE_SIZE = 2000;
+
+interface ClusterWorkspacePayload {
+  workspaceId: string;
+}
+
+registerJobHandler(CLUSTER_JOB, async (payload: ClusterWorkspacePayload) => {
+  await computeClusters(payload.workspaceId);
+});
+
+function encodeFloat32(values: Float32Array): Buffer {
+  const buffer = Buffer.allocUnsafe(values.length * 4);
+  for (let i = 0; i < values.length; i++) buffer.writeFloatLE(values[i], i * 4);
+  return buffer;
+}
+
+function decodeFloat32(bytes: Uint8Array): Float32Array {
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const values = new Float32Array(Math.floor(bytes.byteLength / 4));
+  for (let i = 0; i < values.length; i++) values[i] = view.getFloat32(i * 4, true);
+  return values;
+}
+
+function encodeAssignments(assignments: ArrayLike<number>): Buffer {
+  const buffer = Buffer.allocUnsafe(assignments.length * 2);
+  for (let i = 0; i < assignments.length; i++) buffer.writeUInt16LE(assignments[i], i * 2);
+  return buffer;
+}
+
+interface EmbeddingMatrix {
+  ids: string[];
+  titles: string[];
+  tags: string[][];
+  dimension: number;
+  rows: Float32Array;
+}
+
+// Every embedded node of a workspace as normalized rows; rows of another dimension
+// (model change mid-workspace) and zero vectors are skipped
+async function loadEmbeddingMatrix(workspaceId: string): Promise<EmbeddingMatrix> {
+  const matrix: EmbeddingMatrix = { ids: [], titles: [], tags: [], dimension: 0, rows: new Float32Array(0) };
+  if (!(await hasEmbeddingColumn())) return matrix;
+
+  let cursor: string | null = null;
+  while (true) {
+    const page: Array<{ id: string; title: string; tags: string[]; embedding: Uint8Array }> =
+      await prisma.$queryRaw`
+        SELECT id, title, tags, vector_send(embedding) AS embedding
+        FROM nodes
+        WHERE workspace_id = ${workspaceId}
+          AND embedding IS NOT NULL
+          ${cursor ? Prisma.sql`AND id > ${cursor}` : Prisma.empty}
+        ORDER BY id
+        LIMIT ${PAGE_SIZE}
+      `;
+    if (page.length === 0) break;
+
+    for (const row of page) {
+      if (matrix.dimension === 0) {
+        // The first row fixes the dimension (pgvector header: uint16 dimensions)
+        if (row.embedding.byteLength < 4) continue;
+        matrix.dimension = new DataView(row.embedding.buffer, row.embedding.byteOffset, 4).getUint16(0);
+        matrix.rows = new Float32Array(page.length * matrix.dimension);
+      }
+      const dim = matrix.dimension;
+      const offset = matrix.ids.length * dim;
+      if (offset + dim > matrix.rows.length) {
+        const grown = new Float32Array(Math.max(matrix.rows.length * 2, offset + dim));
+        grown.set(matrix.rows);
+        matrix.rows = grown;
+      }
+
+      if (readVectorInto(row.embedding, matrix.rows, offset) !== dim) continue;
+      const normalized = normalizeVector(matrix.rows.subarray(offset, offset + dim));
+      if (!normalized) continue;
+      matrix.rows.set(normalized, offset);
+
+      matrix.ids.push(row.id);
+      matrix.titles.push(row.title);
+      matrix.tags.push(row.tags);
+    }
+
+    if (page.length < PAGE_SIZE) break;
+    cursor = page[page.length - 1].id;
+  }
+
+  return matrix;
+}
+
+// A tag most members share, otherwise the title of the member closest to the centroid
+function clusterLabels(matrix: EmbeddingMatrix, k: number, assignments: Int32Array, similarities: Float32Array) {
+  const tagCounts = Array.from({ length: k }, () => new Map<string, number>());
+  const sizes = new Int32Array(k);
+  const representative = new Int32Array(k).fill(-1);
+
+  for (let i = 0; i < matrix.ids.length; i++) {
+    const c = assignments[i];
+    sizes[c]++;
+    for (const tag of matrix.tags[i]) tagCounts[c].set(tag, (tagCounts[c].get(tag) || 0) + 1);
+    if (representative[c] < 0 || similarities[i] > similarities[representative[c]]) representative[c] = i;
+  }
+
+  return Array.from({ length: k }, (_, c) => {
+    let bestTag = '';
+    let bestCount = 0;
+    tagCounts[c].forEach((count, tag) => {
+      if (count > bestCount) {
+        bestTag = tag;
+        bestCount = count;
+      }
+    });
+    if (bestCount * 2 >= sizes[c] && bestTag) return bestTag;
+    return representative[c] >= 0 ? matrix.titles[representative[c]] || 'Untitled' : `Cluster ${c + 1}`;
+  });
+}
+
+/**
+ * Recluster every embedded node of a workspace and store the result
+ * Returns null (and drops any stored clusters) when fewer than two nodes are embedded
+ */
+export async function computeClusters(workspaceId: string): Promise<StoredClusters | null> {
+  const matrix = await loadEmbeddingMatrix(workspaceId);
+  const count = matrix.ids.length;
+  if (count < 2) {
+    await prisma.workspaceClustering.deleteMany({ where: { workspaceId } });
+    return null;
+  }
+
+  const result = kMeans(matrix.rows, count, matrix.dimension, { k: defaultClusterCount(count) });
+  const labels = clusterLabels(matrix, result.k, result.assignments, result.similarities);
+  const computedAt = new Date();
+
+  const data = {
+    k: result.k,
+    dimension: matrix.dimension,
+    centroids: encodeFloat32(result.centroids),
+    labels,
+    nodeIds: matrix.ids,
+    assignments: encodeAssignments(result.assignments),
+    assignedSinceRun: 0,
+    computedAt,
+  };
+  try {
+    await prisma.workspaceClustering.upsert({
+      where: { workspaceId },
+      create: { workspaceId, ...data },
+      update: data,
+    });
+  } catch (error: any) {
+    // Workspace deleted while clustering
+    if (error?.code !== 'P2003' && error?.code !== 'P2025') throw error;
+    return null;
+  }
+
+  const members = Array.from({ length: result.k }, () => [] as string[]);
+  matrix.ids.forEach((id, i) => members[result.assignments[i]].push(id));
+  return {
+    k: result.k,
+    computedAt,
+    clusters: members
+      .map((nodeIds, index) => ({ index, label: labels[index], nodeIds }))
+      .filter((cluster) => cluster.nodeIds.length > 0),
+  };
+}
+
+/**
+ * Stored clusters for a workspace (null if none have been computed)
+ */
+export async function getStoredClusters(workspaceId: string): Promise<StoredClusters | null> {
+  const row = await prisma.workspaceClustering.findUnique({
+    where: { workspaceId },
+    select: { k: true, labels: true, nodeIds: true, assignments: true, computedAt: true },
+  });
+  if (!row) return null;
+
+  const view = new DataView(row.assignments.buffer, row.assignments.byteOffset, row.assignments.byteLength);
+  const assignment = new Map<string, number>();
+  const entries = Math.min(row.nodeIds.length, Math.floor(row.assignments.byteLength / 2));
+  for (let i = 0; i < entries; i++) {
+    // Later entries (re-embedded nodes) replace earlier ones
+    assignment.set(row.nodeIds[i], view.getUint16(i * 2, true));
+  }
+
+  const labels = Array.isArray(row.labels) ? (row.labels as string[]) : [];
+  const members = Array.from({ length: row.k }, () => [] as string[]);
+  assignment.forEach((c, id) => {
+    if (c < row.k) members[c].push(id);
+  });
+
+  return {
+    k: row.k,
+    computedAt: row.computedAt,
+    clusters: members
+      .map((nodeIds, index) => ({ index, label: labels[index] || `Cluster ${index + 1}`, nodeIds }))
+      .filter((cluster) => cluster.nodeIds.length > 0),
+  };
+}
+
+/**
+ * Queue a full clustering run (coalesces per workspace)
+ */
+export async function enqueueClusterComputation(workspaceId: string): Promise<boolean> {
+  const payload: ClusterWorkspacePayload = { workspaceId };
+  try {
+    return await enqueueJob(CLUSTER_JOB, `${CLUSTER_JOB}:${workspaceId}`, payload, {
+      delayMs: CLUSTER_DEBOUNCE_MS,
+    });
+  } catch (error: any) {
+    console.warn('[clusterCache] Failed to enqueue clustering job (continuing):', error?.message);
+    return false;
+  }
+}
+
+/**
+ * Assign freshly embedded nodes to their nearest stored centroid
+ * Queues a full run instead when nothing is stored yet or enough nodes have been assigned
+ * this way since the last one. Never throws - clustering must not fail indexing.
+ */
+export async function assignNodesToClusters(
+  workspaceId: string,
+  entries: Array<{ id: string; embedding: ArrayLike<number> }>
+): Promise<void> {
+  if (entries.length === 0) return;
+
+  try {
+    const row = await prisma.workspaceClustering.findUnique({
+      where: { workspaceId },
+      select: { k: true, dimension: true, centroids: true, computedAt: true },
+    });
+    if (!row) {
+      await enqueueClusterComputation(workspaceId);
+      return;
+    }
+
+    const centroids = decodeFloat32(row.centroids);
+    const ids: string[] = [];
+    const assignments: number[] = [];
+    for (const entry of entries) {
+      if (entry.embedding.length !== row.dimension) continue;
+      const vector = normalizeVector(entry.embedding);
+      if (!vector) continue;
+      ids.push(entry.id);
+      assignments.push(nearestCentroid(vector, centroids, row.k, row.dimension).index);
+    }
+    if (ids.length === 0) return;
+
+    // Appends only onto the run the centroids came from - a newer run already has these nodes
+    const [updated] = await prisma.$queryRaw<Array<{ assigned: number; total: number }>>`
+      UPDATE workspace_clusterings
+      SET node_ids = node_ids || ${ids}::text[],
+          assignments = assignments || ${encodeAssignments(assignments)},
+          assigned_since_run = assigned_since_run + ${ids.length},
+          updated_at = NOW()
+      WHERE workspace_id = ${workspaceId} AND computed_at = ${row.computedAt}
+      RETURNING assigned_since_run AS assigned, cardinality(node_ids) AS total
+    `;
+    if (!updated) return;
+
+    const clustered = updated.total - updated.assigned;
+    if (updated.assigned >= Math.max(REFRESH_MIN_ASSIGNED, clustered * REFRESH_SHARE)) {
+      await enqueueClusterComputation(workspaceId);
+    }
+  } catch (error: any) {
+    console.warn('[clusterCache] Failed to assign nodes to clusters (continuing):', error?.message);
+  }
+}
@@ -0,0 +1,288 @@
+import { dotRow } from './vectorStore';
+
+// Spherical k-means over packed embeddings (client and server safe - no Node APIs)
+// - rows are L2-normalized and stored back to back in one Float32Array, so similarity to a
+//   centroid is a dot product over contiguous memory
+// - k-means++ seeding (on a sample for large inputs) instead of random picks: fewer
+//   iterations and no near-duplicate starting centroids
+// - full Lloyd iterations until assignments settle on small inputs; mini-batch updates
+//   (Sculley 2010) above MINI_BATCH_MIN_ROWS, where a full pass per iteration is too slow
+// - seeded RNG, so the same embeddings give the same clusters
+//
+// Rows and centroids are unit vectors throughout; callers normalize (normalizeVector).
+// Shared with backend/ like lib/vectorStore.ts.
+
+export interface KMeansOptions {
+  k: number;
+  maxIterations?: number;
+  batchSize?: number;
+  seed?: number;
+}
+
+export interface KMeansResult {
+  k: number;
+  dimension: number;
+  // k x dimension, L2-normalized
+  centroids: Float32Array;
+  // Cluster index per row
+  assignments: Int32Array;
+  // Similarity of each row to its centroid
+  similarities: Float32Array;
+  sizes: Int32Array;
+  iterations: number;
+}
+
+export const MAX_CLUSTERS = 64;
+export const MINI_BATCH_MIN_ROWS = 10_000;
+const DEFAULT_MAX_ITERATIONS = 50;
+const DEFAULT_BATCH_SIZE = 1024;
+const MINI_BATCH_ITERATIONS = 100;
+// Mini-batch stops early once no centroid moves further than this (1 - cosine)
+const MINI_BATCH_TOLERANCE = 1e-4;
+const SEED_SAMPLE_SIZE = 5000;
+
+/**
+ * Default cluster count for n embedded nodes - sqrt(n / 2), between 2 and MAX_CLUSTERS
+ */
+export function defaultClusterCount(n: number): number {
+  return Math.min(MAX_CLUSTERS, Math.max(2, Math.floor(Math.sqrt(n / 2))));
+}
+
+// mulberry32 - small, fast and good enough for seeding
+function createRandom(seed: number): () => number {
+  let state = seed >>> 0;
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+function normalizeInPlace(values: Float32Array, offset: number, dim: number): boolean {
+  let norm = 0;
+  for (let j = 0; j < dim; j++) norm += values[offset + j] * values[offset + j];
+  if (!(norm > 0)) return false;
+  const inv = 1 / Math.sqrt(norm);
+  for (let j = 0; j < dim; j++) values[offset + j] *= inv;
+  return true;
+}
+
+/**
+ * Nearest centroid to a normalized vector
+ */
+export function nearestCentroid(
+  vector: Float32Array,
+  centroids: Float32Array,
+  k: number,
+  dim: number
+): { index: number; similarity: number } {
+  let index = 0;
+  let similarity = -Infinity;
+  for (let c = 0; c < k; c++) {
+    const s = dotRow(vector, centroids, c * dim, dim);
+    if (s > similarity) {
+      similarity = s;
+      index = c;
+    }
+  }
+  return { index, similarity };
+}
+
+// k-means++ seeding: each new centroid is drawn with probability proportional to the
+// squared distance (1 - cosine) from the nearest centroid chosen so far
+function seedCentroids(
+  rows: Float32Array,
+  count: number,
+  dim: number,
+  k: number,
+  random: () => number
+): Float32Array {
+  const sample: number[] = [];
+  if (count <= SEED_SAMPLE_SIZE) {
+    for (let i = 0; i < count; i++) sample.push(i);
+  } else {
+    const step = count / SEED_SAMPLE_SIZE;
+    for (let i = 0; i < SEED_SAMPLE_SIZE; i++) sample.push(Math.floor(i * step + random() * step));
+  }
+
+  const centroids = new Float32Array(k * dim);
+  const distance = new Float64Array(sample.length).fill(Infinity);
+  let chosen = sample[Math.floor(random() * sample.length)];
+
+  for (let c = 0; c < k; c++) {
+    centroids.set(rows.subarray(chosen * dim, (chosen + 1) * dim), c * dim);
+    if (c === k - 1) break;
+
+    const centroid = centroids.subarray(c * dim, (c + 1) * dim);
+    let total = 0;
+    for (let s = 0; s < sample.length; s++) {
+      const d = Math.max(0, 1 - dotRow(centroid, rows, sample[s] * dim, dim));
+      if (d * d < distance[s]) distance[s] = d * d;
+      total += distance[s];
+    }
+
+    // Every sample coincides with a centroid - fall back to a uniform pick
+    if (!(total > 0)) {
+      chosen = sample[Math.floor(random() * sample.length)];
+      continue;
+    }
+    let target = random() * total;
+    let pick = sample.length - 1;
+    for (let s = 0; s < sample.length; s++) {
+      target -= distance[s];
+      if (target <= 0) {
+        pick = s;
+        break;
+      }
+    }
+    chosen = sample[pick];
+  }
+
+  return centroids;
+}
+
+// Assign every row to its nearest centroid; returns how many assignments changed
+function assignAll(
+  rows: Float32Array,
+  count: number,
+  dim: number,
+  centroids: Float32Array,
+  k: number,
+  assignments: Int32Array,
+  similarities: Float32Array
+): number {
+  let changed = 0;
+  for (let i = 0; i < count; i++) {
+    const { index, similarity } = nearestCentroid(rows.subarray(i * dim, (i + 1) * dim), centroids, k, dim);
+    if (assignments[i] !== index) {
+      assignments[i] = index;
+      changed++;
+    }
+    similarities[i] = similarity;
+  }
+  return changed;
+}
+
+// Centroids as normalized means of their rows; an empty cluster takes over the row that
+// fits its current cluster worst
+function updateCentroids(
+  rows: Float32Array,
+  count: number,
+  dim: number,
+  centroids: Float32Array,
+  k: number,
+  assignments: Int32Array,
+  similarities: Float32Array
+) {
+  centroids.fill(0);
+  const sizes = new Int32Array(k);
+  for (let i = 0; i < count; i++) {
+    const c = assignments[i];
+    sizes[c]++;
+    const offset = c * dim;
+    const rowOffset = i * dim;
+    for (let j = 0; j < dim; j++) centroids[offset + j] += rows[rowOffset + j];
+  }
+
+  for (let c = 0; c < k; c++) {
+    if (sizes[c] > 0 && normalizeInPlace(centroids, c * dim, dim)) continue;
+
+    let worst = 0;
+    for (let i = 1; i < count; i++) {
+      if (similarities[i] < similarities[worst]) worst = i;
+    }
+    centroids.set(rows.subarray(worst * dim, (worst + 1) * dim), c * dim);
+    similarities[worst] = 1;
+  }
+}
+
+function miniBatch(
+  rows: Float32Array,
+  count: number,
+  dim: number,
+  centroids: Float32Array,
+  k: number,
+  batchSize: number,
+  maxIterations: number,
+  random: () => number
+): number {
+  // Per-centroid learning rate 1 / (points seen so far); the seed counts as one point
+  const seen = new Float64Array(k).fill(1);
+  const previous = new Float32Array(centroids.length);
+  const batch = new Int32Array(batchSize);
+  const nearest = new Int32Array(batchSize);
+
+  let iteration = 0;
+  while (iteration < maxIterations) {
+    iteration++;
+    previous.set(centroids);
+
+    for (let b = 0; b < batchSize; b++) {
+      batch[b] = Math.floor(random() * count);
+      nearest[b] = nearestCentroid(rows.subarray(batch[b] * dim, (batch[b] + 1) * dim), centroids, k, dim).index;
+    }
+
+    for (let b = 0; b < batchSize; b++) {
+      const c = nearest[b];
+      seen[c]++;
+      const rate = 1 / seen[c];
+      const offset = c * dim;
+      const rowOffset = batch[b] * dim;
+      for (let j = 0; j < dim; j++) {
+        centroids[offset + j] += rate * (rows[rowOffset + j] - centroids[offset + j]);
+      }
+    }
+
+    let shift = 0;
+    for (let c = 0; c < k; c++) {
+      normalizeInPlace(centroids, c * dim, dim);
+      const previousCentroid = previous.subarray(c * dim, (c + 1) * dim);
+      shift = Math.max(shift, 1 - dotRow(previousCentroid, centroids, c * dim, dim));
+    }
+    if (shift < MINI_BATCH_TOLERANCE) break;
+  }
+
+  return iteration;
+}
+
+/**
+ * Cluster `count` normalized rows of dimension `dim` packed in `rows`
+ */
+export function kMeans(rows: Float32Array, count: number, dim: number, options: KMeansOptions): KMeansResult {
+  const k = Math.max(1, Math.min(options.k, count));
+  const random = createRandom(options.seed ?? 1);
+  const assignments = new Int32Array(count).fill(-1);
+  const similarities = new Float32Array(count);
+
+  const centroids = count > 0 ? seedCentroids(rows, count, dim, k, random) : new Float32Array(k * dim);
+  let iterations = 0;
+
+  if (count > 0 && count >= MINI_BATCH_MIN_ROWS) {
+    iterations = miniBatch(
+      rows,
+      count,
+      dim,
+      centroids,
+      k,
+      options.batchSize ?? DEFAULT_BATCH_SIZE,
+      options.maxIterations ?? MINI_BATCH_ITERATIONS,
+      random
+    );
+    assignAll(rows, count, dim, centroids, k, assignments, similarities);
+  } else if (count > 0) {
+    const maxIterations = options.maxIterations ?? DEFAULT_MAX_ITERATIONS;
+    let changed = assignAll(rows, count, dim, centroids, k, assignments, similarities);
+    while (changed > 0 && iterations < maxIterations) {
+      iterations++;
+      updateCentroids(rows, count, dim, centroids, k, assignments, similarities);
+      changed = assignAll(rows, count, dim, centroids, k, assignments, similarities);
+    }
+  }
+
+  const sizes = new Int32Array(k);
+  for (let i = 0; i < count; i++) sizes[assignments[i]]++;
+
+  return { k, dimension: dim, centroids, assignments, similarities, sizes, iterations };
+}
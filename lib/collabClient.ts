@@ -0,0 +1,186 @@
+import { useEffect, useState } from 'react';
+import {
+  MAX_OPS_PER_MESSAGE,
+  coalesceOps,
+  setGraphOpSink,
+  type GraphOp,
+  type OpsMessage,
+} from './collabOps';
+
+// Browser side of the workspace collaboration channel (app/api/workspaces/[id]/collab)
+// - one EventSource per open workspace, shared by every component that subscribes
+// - outgoing ops are coalesced per animation frame, with at most one POST in flight;
+//   whatever queues up meanwhile goes out, coalesced, in the next one
+// - drag moves are throttled to one send per DRAG_THROTTLE_MS
+
+const DRAG_THROTTLE_MS = 50;
+
+export interface CollabEvents {
+  hello: { version: number | null };
+  ops: OpsMessage;
+  doc: { from: string; nodeId: string; update: string };
+  version: { version: number };
+  activity: { activities: any[] };
+}
+
+type EventName = keyof CollabEvents;
+const EVENT_NAMES: EventName[] = ['hello', 'ops', 'doc', 'version', 'activity'];
+
+function createClientId(): string {
+  if (typeof crypto !== 'undefined' && typeof crypto.randomUUID === 'function') {
+    return crypto.randomUUID();
+  }
+  return `${Date.now().toString(36)}-${Math.random().toString(36).slice(2)}`;
+}
+
+export class CollabChannel {
+  readonly clientId = createClientId();
+  private source: EventSource | null = null;
+  private listeners = new Map<EventName, Set<(data: any) => void>>();
+  private outbox: GraphOp[] = [];
+  private frame: number | null = null;
+  private sending = false;
+  private dragMoves = new Map<string, { x: number; y: number }>();
+  private dragTimer: ReturnType<typeof setTimeout> | null = null;
+  private closed = false;
+
+  constructor(readonly workspaceId: string) {
+    this.source = new EventSource(`/api/workspaces/${workspaceId}/collab`);
+    EVENT_NAMES.forEach((name) => {
+      this.source!.addEventListener(name, (event) => {
+        let data: any;
+        try {
+          data = JSON.parse((event as MessageEvent).data);
+        } catch {
+          return;
+        }
+        // Our own ops and document updates come back through the hub - already applied here
+        if ((name === 'ops' || name === 'doc') && data.from === this.clientId) return;
+        this.listeners.get(name)?.forEach((listener) => listener(data));
+      });
+    });
+  }
+
+  // Stream is open (EventSource reconnects by itself after errors)
+  get connected(): boolean {
+    return this.source?.readyState === EventSource.OPEN;
+  }
+
+  on<E extends EventName>(name: E, listener: (data: CollabEvents[E]) => void): () => void {
+    let set = this.listeners.get(name);
+    if (!set) {
+      set = new Set();
+      this.listeners.set(name, set);
+    }
+    set.add(listener);
+    return () => {
+      set!.delete(listener);
+    };
+  }
+
+  send(ops: GraphOp[]) {
+    if (this.closed || ops.length === 0) return;
+    this.outbox.push(...ops);
+    this.scheduleFlush();
+  }
+
+  // Live position while dragging - the final position is sent by the store on drop
+  sendDragMove(id: string, x: number, y: number) {
+    if (this.closed) return;
+    this.dragMoves.set(id, { x, y });
+    if (this.dragTimer) return;
+    this.dragTimer = setTimeout(() => {
+      this.dragTimer = null;
+      const moves = Array.from(this.dragMoves, ([moveId, p]) => ({ op: 'move' as const, id: moveId, ...p }));
+      this.dragMoves.clear();
+      this.send(moves);
+    }, DRAG_THROTTLE_MS);
+  }
+
+  close() {
+    this.closed = true;
+    this.source?.close();
+    this.source = null;
+    if (this.frame !== null) cancelAnimationFrame(this.frame);
+    if (this.dragTimer) clearTimeout(this.dragTimer);
+    this.listeners.clear();
+  }
+
+  private scheduleFlush() {
+    if (this.frame !== null || this.sending) return;
+    this.frame = requestAnimationFrame(() => {
+      this.frame = null;
+      void this.flush();
+    });
+  }
+
+  private async flush() {
+    if (this.sending || this.outbox.length === 0 || this.closed) return;
+    this.sending = true;
+
+    const ops = coalesceOps(this.outbox.splice(0));
+    try {
+      for (let i = 0; i < ops.length; i += MAX_OPS_PER_MESSAGE) {
+        const response = await fetch(`/api/workspaces/${this.workspaceId}/collab`, {
+          method: 'POST',
+          headers: { 'Content-Type': 'application/json' },
+          body: JSON.stringify({ from: this.clientId, ops: ops.slice(i, i + MAX_OPS_PER_MESSAGE) }),
+        });
+        // Viewers cannot publish; their edits are rejected by the write routes anyway
+        if (response.status === 403) break;
+      }
+    } catch (error) {
+      // Ops are advisory - delta sync delivers the persisted state regardless
+      console.warn('[collabClient] Failed to send ops:', error);
+    } finally {
+      this.sending = false;
+    }
+
+    if (this.outbox.length > 0) this.scheduleFlush();
+  }
+}
+
+// Shared channels, reference counted by the components using them
+const channels = new Map<string, { channel: CollabChannel; refs: number }>();
+
+function acquireChannel(workspaceId: string): CollabChannel {
+  let entry = channels.get(workspaceId);
+  if (!entry) {
+    entry = { channel: new CollabChannel(workspaceId), refs: 0 };
+    channels.set(workspaceId, entry);
+  }
+  entry.refs++;
+
+  // Local store edits go out on the most recently opened workspace
+  const channel = entry.channel;
+  setGraphOpSink((ops) => channel.send(ops));
+  return channel;
+}
+
+function releaseChannel(workspaceId: string) {
+  const entry = channels.get(workspaceId);
+  if (!entry || --entry.refs > 0) return;
+  entry.channel.close();
+  channels.delete(workspaceId);
+  setGraphOpSink(null);
+  const remaining = Array.from(channels.values()).pop();
+  if (remaining) setGraphOpSink((ops) => remaining.channel.send(ops));
+}
+
+/**
+ * The workspace's collaboration channel (null during SSR and the first render)
+ */
+export function useCollabChannel(workspaceId: string | null | undefined): CollabChannel | null {
+  const [channel, setChannel] = useState<CollabChannel | null>(null);
+
+  useEffect(() => {
+    if (!workspaceId || typeof EventSource === 'undefined') return;
+    setChannel(acquireChannel(workspaceId));
+    return () => {
+      setChannel(null);
+      releaseChannel(workspaceId);
+    };
+  }, [workspaceId]);
+
+  return channel;
+}
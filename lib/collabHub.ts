@@ -0,0 +1,170 @@
+import { prisma } from './db';
+import type { OpsMessage } from './collabOps';
+import { listActivitySince, type ActivityRow } from './activityLog';
+
+// Server-only fan-out for the workspace collaboration channel (GET/POST .../collab)
+// - ops posted by one member are pushed to every other connection on this process at once
+// - while a workspace has listeners, one watcher per process polls its graph_version and
+//   activity_log, so writes from anywhere else (other instances, background jobs, plain API
+//   routes) still arrive: as a version notice that clients answer with a delta sync, and as
+//   the new activity rows themselves
+
+export type CollabEvent =
+  | { event: 'ops'; data: OpsMessage }
+  // Yjs update for a node's rich text (base64), see lib/nodeDocuments.ts
+  | { event: 'doc'; data: { from: string; nodeId: string; update: string } }
+  | { event: 'version'; data: { version: number } }
+  | { event: 'activity'; data: { activities: any[] } };
+
+type Subscriber = (event: CollabEvent) => void;
+
+const WATCH_INTERVAL_MS = 500;
+// Activity scan page; a tick keeps paging until it reaches the end
+const ACTIVITY_PAGE_SIZE = 200;
+// Each tick rescans this far behind the newest row pushed, for rows that committed late
+// (see lib/activityLog.ts); rows stamped further back only show up when clients refetch
+const ACTIVITY_LOOKBACK_MS = 10_000;
+
+interface Channel {
+  subscribers: Set<Subscriber>;
+  // Watcher loop is scheduled or mid-query
+  watching: boolean;
+  timer: NodeJS.Timeout | null;
+  version: number | null;
+  // Newest createdAt pushed, and the ids pushed inside the lookback window behind it
+  activityCursor: Date | null;
+  activitySeen: Map<string, number>;
+}
+
+// Kept on globalThis so dev hot reloads don't orphan open connections
+const globalForCollab = globalThis as unknown as {
+  collabChannels: Map<string, Channel> | undefined;
+};
+
+const channels = globalForCollab.collabChannels ?? new Map<string, Channel>();
+globalForCollab.collabChannels = channels;
+
+function broadcast(channel: Channel, event: CollabEvent) {
+  channel.subscribers.forEach((subscriber) => {
+    try {
+      subscriber(event);
+    } catch (error: any) {
+      // Closed stream - its abort handler unsubscribes it
+      console.warn('[collabHub] Dropping event for subscriber:', error?.message);
+    }
+  });
+}
+
+// Rows not pushed yet, oldest first: ascending (createdAt, id) keyset from the lookback
+// window to the end
+async function scanActivity(workspaceId: string, channel: Channel) {
+  const fresh: ActivityRow[] = [];
+  let after = { createdAt: new Date(channel.activityCursor!.getTime() - ACTIVITY_LOOKBACK_MS), id: '' };
+  for (;;) {
+    const rows = await listActivitySince(workspaceId, after, ACTIVITY_PAGE_SIZE);
+    for (const row of rows) {
+      if (channel.activitySeen.has(row.id)) continue;
+      channel.activitySeen.set(row.id, row.createdAt.getTime());
+      fresh.push(row);
+      if (row.createdAt > channel.activityCursor!) channel.activityCursor = row.createdAt;
+    }
+    if (rows.length < ACTIVITY_PAGE_SIZE) break;
+    const last = rows[rows.length - 1];
+    after = { createdAt: last.createdAt, id: last.id };
+  }
+
+  const horizon = channel.activityCursor!.getTime() - ACTIVITY_LOOKBACK_MS;
+  for (const [id, createdAt] of channel.activitySeen) {
+    if (createdAt < horizon) channel.activitySeen.delete(id);
+  }
+  return fresh;
+}
+
+async function watch(workspaceId: string, channel: Channel) {
+  try {
+    const workspace = await prisma.workspace.findUnique({
+      where: { id: workspaceId },
+      select: { graphVersion: true },
+    });
+    if (workspace) {
+      if (channel.version !== null && workspace.graphVersion > channel.version) {
+        broadcast(channel, { event: 'version', data: { version: workspace.graphVersion } });
+      }
+      channel.version = workspace.graphVersion;
+    }
+
+    if (channel.activityCursor === null) {
+      const latest = await prisma.activityLog.findFirst({
+        where: { workspaceId },
+        orderBy: { createdAt: 'desc' },
+        select: { createdAt: true },
+      });
+      channel.activityCursor = latest?.createdAt ?? new Date(0);
+      // Existing rows in the window were loaded with the page - mark them pushed
+      await scanActivity(workspaceId, channel);
+    } else {
+      const activities = await scanActivity(workspaceId, channel);
+      if (activities.length > 0) {
+        // Newest first, like the activity API
+        broadcast(channel, { event: 'activity', data: { activities: activities.reverse() } });
+      }
+    }
+  } catch (error: any) {
+    console.warn('[collabHub] Watch failed (retrying):', error?.message);
+  }
+
+  // Last subscriber may have left while the queries ran
+  if (channel.subscribers.size > 0 && channels.get(workspaceId) === channel) {
+    channel.timer = setTimeout(() => void watch(workspaceId, channel), WATCH_INTERVAL_MS);
+  } else {
+    channel.timer = null;
+    channel.watching = false;
+  }
+}
+
+/**
+ * Listen to a workspace; returns the unsubscribe function
+ */
+export function subscribeWorkspace(workspaceId: string, subscriber: Subscriber): () => void {
+  let channel = channels.get(workspaceId);
+  if (!channel) {
+    channel = { subscribers: new Set(), watching: false, timer: null, version: null, activityCursor: null, activitySeen: new Map() };
+    channels.set(workspaceId, channel);
+  }
+
+  channel.subscribers.add(subscriber);
+  if (!channel.watching) {
+    channel.watching = true;
+    void watch(workspaceId, channel);
+  }
+
+  const joined = channel;
+  return () => {
+    joined.subscribers.delete(subscriber);
+    if (joined.subscribers.size > 0) return;
+    if (joined.timer) clearTimeout(joined.timer);
+    joined.timer = null;
+    joined.watching = false;
+    if (channels.get(workspaceId) === joined) channels.delete(workspaceId);
+  };
+}
+
+/**
+ * Push client ops to everyone listening on this process (the sender filters its own echo)
+ */
+export function publishOps(workspaceId: string, message: OpsMessage) {
+  const channel = channels.get(workspaceId);
+  if (channel) broadcast(channel, { event: 'ops', data: message });
+}
+
+/**
+ * Push a node document update to everyone listening on this process
+ */
+export function publishDocUpdate(workspaceId: string, from: string, nodeId: string, update: Uint8Array) {
+  const channel = channels.get(workspaceId);
+  if (!channel) return;
+  broadcast(channel, {
+    event: 'doc',
+    data: { from, nodeId, update: Buffer.from(update).toString('base64') },
+  });
+}
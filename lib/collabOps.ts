@@ -0,0 +1,108 @@
+import type { Node } from '@/types/Node';
+import type { Edge } from '@/types/Edge';
+
+// Graph operations broadcast on the workspace collaboration channel
+// (lib/collabClient.ts <-> app/api/workspaces/[id]/collab). Ops are advisory: they show
+// other members an edit right away, while writes still persist through the normal API
+// routes and delta sync (/graph?since=) reconciles every client against the database.
+
+export type GraphOp =
+  | { op: 'move'; id: string; x: number; y: number }
+  // Create, or edit with only the changed fields
+  | { op: 'node'; node: Partial<Node> & { id: string } }
+  | { op: 'delete_node'; id: string }
+  | { op: 'edge'; edge: Edge }
+  | { op: 'delete_edge'; id: string };
+
+export interface OpsMessage {
+  // Sending connection, so it can skip its own echo
+  from: string;
+  ops: GraphOp[];
+}
+
+export const MAX_OPS_PER_MESSAGE = 500;
+
+/**
+ * Collapse a batch to the last state per entity, keeping first-touch order
+ * Moves fold into a pending create/edit, edits merge, and a delete drops everything
+ * queued for that node before it.
+ */
+export function coalesceOps(ops: GraphOp[]): GraphOp[] {
+  const byKey = new Map<string, GraphOp>();
+
+  for (const op of ops) {
+    switch (op.op) {
+      case 'move': {
+        const key = `n:${op.id}`;
+        const current = byKey.get(key);
+        if (current?.op === 'delete_node') break;
+        if (current?.op === 'node') {
+          byKey.set(key, { op: 'node', node: { ...current.node, x: op.x, y: op.y } });
+        } else {
+          byKey.set(key, op);
+        }
+        break;
+      }
+      case 'node': {
+        const key = `n:${op.node.id}`;
+        const current = byKey.get(key);
+        if (current?.op === 'node') {
+          byKey.set(key, { op: 'node', node: { ...current.node, ...op.node } });
+        } else if (current?.op === 'move') {
+          byKey.set(key, { op: 'node', node: { x: current.x, y: current.y, ...op.node } });
+        } else {
+          byKey.set(key, op);
+        }
+        break;
+      }
+      case 'delete_node':
+        byKey.delete(`n:${op.id}`);
+        byKey.set(`n:${op.id}`, op);
+        break;
+      case 'edge':
+        byKey.set(`e:${op.edge.id}`, op);
+        break;
+      case 'delete_edge':
+        byKey.set(`e:${op.id}`, op);
+        break;
+    }
+  }
+
+  return Array.from(byKey.values());
+}
+
+function isId(value: unknown): value is string {
+  return typeof value === 'string' && value.length > 0 && value.length <= 200;
+}
+
+/**
+ * Shape check for ops arriving from clients (the server relays, it does not interpret)
+ */
+export function isGraphOp(value: any): value is GraphOp {
+  if (!value || typeof value !== 'object') return false;
+  switch (value.op) {
+    case 'move':
+      return isId(value.id) && Number.isFinite(value.x) && Number.isFinite(value.y);
+    case 'node':
+      return !!value.node && typeof value.node === 'object' && isId(value.node.id);
+    case 'edge':
+      return !!value.edge && isId(value.edge.id) && isId(value.edge.source) && isId(value.edge.target);
+    case 'delete_node':
+    case 'delete_edge':
+      return isId(value.id);
+    default:
+      return false;
+  }
+}
+
+// Local edit sink - workspaceStore reports its own mutations here and the open channel
+// (if any) sends them. Kept apart from collabClient so the store does not import it.
+let sink: ((ops: GraphOp[]) => void) | null = null;
+
+export function setGraphOpSink(next: ((ops: GraphOp[]) => void) | null) {
+  sink = next;
+}
+
+export function emitGraphOps(ops: GraphOp[]) {
+  if (sink && ops.length > 0) sink(ops);
+}
@@ -1,41 +1,136 @@
 import { prisma } from './db';
 import { Prisma } from '@prisma/client';
+import { SIMILARITY_THRESHOLDS } from './similarity';
+import { withSpan } from './tracing';
 
 // Server-only utilities for vector operations
 // These use Node.js Buffer API and should only be imported in server contexts
+//
+// Wire format: embeddings never travel as '[0.0123,...]' text literals.
+// - writes bind a float array parameter and cast it: ${embedding}::real[]::vector
+// - reads select vector_send(embedding), pgvector's binary form, and decode it here
+
+// pgvector binary format (vector_send / vector_recv), network byte order:
+// dimensions (uint16), unused (uint16), data (float32[])
+const VECTOR_HEADER_BYTES = 4;
 
 // Helper function to convert embedding array to PostgreSQL vector format
-// pgvector stores as: dimensions (uint32), unused (uint16), unused (uint16), data (float32[])
-export function arrayToVector(embedding: number[]): Buffer {
-  // pgvector binary format
+export function arrayToVector(embedding: ArrayLike<number>): Buffer {
   const dimensions = embedding.length;
-  const buffer = Buffer.allocUnsafe(4 + 2 + 2 + dimensions * 4);
-  
-  buffer.writeUInt32LE(dimensions, 0);
-  buffer.writeUInt16LE(0, 4); // unused
-  buffer.writeUInt16LE(0, 6); // unused
-  
+  const buffer = Buffer.allocUnsafe(VECTOR_HEADER_BYTES + dimensions * 4);
+
+  buffer.writeUInt16BE(dimensions, 0);
+  buffer.writeUInt16BE(0, 2); // unused
+
   for (let i = 0; i < dimensions; i++) {
-    buffer.writeFloatLE(embedding[i], 8 + i * 4);
+    buffer.writeFloatBE(embedding[i], VECTOR_HEADER_BYTES + i * 4);
   }
-  
+
   return buffer;
 }
 
 // Helper function to convert PostgreSQL vector to array
-export function vectorToArray(vector: Buffer | null): number[] | null {
-  if (!vector || vector.length === 0) return null;
-  
-  const dimensions = vector.readUInt32LE(0);
-  const array: number[] = [];
-  
+export function vectorToArray(vector: Uint8Array | null): number[] | null {
+  if (!vector || vector.length < VECTOR_HEADER_BYTES) return null;
+
+  const view = new DataView(vector.buffer, vector.byteOffset, vector.byteLength);
+  const dimensions = view.getUint16(0);
+  if (vector.length < VECTOR_HEADER_BYTES + dimensions * 4) return null;
+
+  const array: number[] = new Array(dimensions);
   for (let i = 0; i < dimensions; i++) {
-    array.push(vector.readFloatLE(8 + i * 4));
+    array[i] = view.getFloat32(VECTOR_HEADER_BYTES + i * 4);
   }
-  
+
   return array;
 }
 
+// Decode a vector into a packed matrix at `offset` instead of allocating a number[]
+// Returns the dimensions written, or 0 if the bytes are malformed or don't fit
+export function readVectorInto(vector: Uint8Array, out: Float32Array, offset: number): number {
+  if (vector.length < VECTOR_HEADER_BYTES) return 0;
+
+  const view = new DataView(vector.buffer, vector.byteOffset, vector.byteLength);
+  const dimensions = view.getUint16(0);
+  if (vector.length < VECTOR_HEADER_BYTES + dimensions * 4 || offset + dimensions > out.length) return 0;
+
+  for (let i = 0; i < dimensions; i++) {
+    out[offset + i] = view.getFloat32(VECTOR_HEADER_BYTES + i * 4);
+  }
+  return dimensions;
+}
+
+// Bind-parameter form of an embedding - Prisma sends number[] as a Postgres array
+function toVectorParam(embedding: ArrayLike<number>): number[] {
+  return Array.from(embedding);
+}
+
+// Schema probes, run once per process (warmed at startup from instrumentation.ts)
+// Failures (e.g. database briefly unreachable) are not cached, so the next call retries
+let embeddingColumnPromise: Promise<boolean> | null = null;
+let vectorVersionPromise: Promise<[number, number] | null> | null = null;
+
+/**
+ * Whether nodes.embedding exists (pgvector installed and schema applied)
+ */
+export function hasEmbeddingColumn(): Promise<boolean> {
+  if (!embeddingColumnPromise) {
+    embeddingColumnPromise = prisma
+      .$queryRaw<Array<{ present: boolean }>>`
+        SELECT EXISTS (
+          SELECT 1 FROM information_schema.columns
+          WHERE table_schema = current_schema() AND table_name = 'nodes' AND column_name = 'embedding'
+        ) AS present
+      `
+      .then((rows) => rows[0]?.present === true)
+      .catch((error: any) => {
+        embeddingColumnPromise = null;
+        console.warn('[db-server] Failed to check for embedding column:', error?.message);
+        return false;
+      });
+  }
+  return embeddingColumnPromise;
+}
+
+// Postgres errors for a missing embedding column, vector type or <=> operator
+const MISSING_VECTOR_CODES = new Set(['42703', '42704', '42883']);
+
+/**
+ * Whether a raw query failed because pgvector / nodes.embedding isn't there (dropped or
+ * never installed after the probe above ran), as opposed to any other database error
+ */
+function isMissingVectorError(error: any): boolean {
+  const code = error?.meta?.code ?? error?.code;
+  if (typeof code === 'string' && MISSING_VECTOR_CODES.has(code)) return true;
+  const message = String(error?.message ?? '');
+  return /column "embedding"|type "vector"|operator does not exist: .*vector/.test(message);
+}
+
+// Installed pgvector version as [major, minor]
+function getVectorExtensionVersion(): Promise<[number, number] | null> {
+  if (!vectorVersionPromise) {
+    vectorVersionPromise = prisma
+      .$queryRaw<Array<{ extversion: string }>>`SELECT extversion FROM pg_extension WHERE extname = 'vector'`
+      .then((rows) => {
+        if (!rows[0]) return null;
+        const [major, minor] = rows[0].extversion.split('.').map(Number);
+        return [major || 0, minor || 0] as [number, number];
+      })
+      .catch(() => {
+        vectorVersionPromise = null;
+        return null;
+      });
+  }
+  return vectorVersionPromise;
+}
+
+/**
+ * Warm the schema probes so the first request doesn't pay for them
+ */
+export async function warmVectorSupport(): Promise<void> {
+  await Promise.all([hasEmbeddingColumn(), getVectorExtensionVersion()]);
+}
+
 // Raw SQL helper for vector similarity search using pgvector
 // Gracefully handles case where embedding column doesn't exist
 export async function findSimilarNodes(
@@ -46,76 +141,29 @@ export async function findSimilarNodes(
   limit: number = 10
 ): Promise<Array<{ id: string; similarity: number }>> {
   try {
-    // Check if embedding column exists first by attempting a simple query
-    // If it fails with column not found error, return empty array silently
-    try {
-      await prisma.$queryRaw`SELECT embedding FROM nodes LIMIT 0`.catch(() => {});
-    } catch (columnCheckError: any) {
-      // Silently return if embedding column doesn't exist
-      if (columnCheckError?.code === '42703' || columnCheckError?.message?.includes('does not exist') || columnCheckError?.message?.includes('column "embedding"')) {
-        return [];
-      }
-      // If it's a different error, continue and let it fail below
-    }
-    
-    // If OPENAI_API_KEY is not set, don't try to do similarity search
-    if (!process.env.OPENAI_API_KEY) {
-      return [];
-    }
-    
-    // Use text format for vector instead of binary hex to avoid pattern matching issues
-    const vectorText = `[${embedding.join(',')}]`;
-    
-    // Validate UUID format
-    const uuidPattern = /^[0-9a-f]{8}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{12}$/i;
-    if (!uuidPattern.test(workspaceId)) {
-      console.error('[findSimilarNodes] Invalid workspaceId UUID format:', workspaceId);
-      return [];
-    }
-    if (excludeNodeId && !uuidPattern.test(excludeNodeId)) {
-      console.error('[findSimilarNodes] Invalid excludeNodeId UUID format:', excludeNodeId);
+    if (!(await hasEmbeddingColumn())) {
       return [];
     }
-    
-    // Use Prisma.sql for safe parameter binding
-    let sqlQuery: Prisma.Sql;
-    
-    if (excludeNodeId) {
-      sqlQuery = Prisma.sql`
-        SELECT 
-          id,
-          1 - (embedding <=> ${vectorText}::vector) as similarity
-        FROM nodes
-        WHERE workspace_id = ${workspaceId}::uuid
-          AND embedding IS NOT NULL
-          AND id != ${excludeNodeId}::uuid
-          AND 1 - (embedding <=> ${vectorText}::vector) >= ${threshold}
-        ORDER BY embedding <=> ${vectorText}::vector
-        LIMIT ${limit}
-      `;
-    } else {
-      sqlQuery = Prisma.sql`
-        SELECT 
-          id,
-          1 - (embedding <=> ${vectorText}::vector) as similarity
-        FROM nodes
-        WHERE workspace_id = ${workspaceId}::uuid
-          AND embedding IS NOT NULL
-          AND 1 - (embedding <=> ${vectorText}::vector) >= ${threshold}
-        ORDER BY embedding <=> ${vectorText}::vector
-        LIMIT ${limit}
-      `;
-    }
-    
-    const results = await prisma.$queryRaw<any[]>(sqlQuery);
-    
-    return (results || []).map((row: any) => ({
+
+    // The query vector is bound once and reused through the CTE
+    const results = await withSpan('vector.similar', () => prisma.$queryRaw<Array<{ id: string; similarity: number }>>`
+      WITH q AS (SELECT ${toVectorParam(embedding)}::real[]::vector AS v)
+      SELECT n.id, 1 - (n.embedding <=> q.v) AS similarity
+      FROM nodes n, q
+      WHERE n.workspace_id = ${workspaceId}
+        AND n.embedding IS NOT NULL
+        ${excludeNodeId ? Prisma.sql`AND n.id <> ${excludeNodeId}` : Prisma.empty}
+        AND 1 - (n.embedding <=> q.v) >= ${threshold}
+      ORDER BY n.embedding <=> q.v
+      LIMIT ${limit}
+    `);
+
+    return results.map((row) => ({
       id: row.id,
-      similarity: parseFloat(row.similarity?.toString() || '0'),
+      similarity: Number(row.similarity),
     }));
   } catch (error: any) {
-    console.error('Error in findSimilarNodes:', error);
-    console.error('Error details:', {
+    console.error('Error in findSimilarNodes:', {
       message: error.message,
       code: error.code,
       workspaceId,
@@ -130,3 +178,223 @@ export async function findSimilarNodes(
   }
 }
 
+/**
+ * Read stored embeddings in binary form (vector_send), keyed by node id
+ * Pass nodeIds to restrict the read; nodes without an embedding are omitted
+ */
+export async function loadNodeEmbeddings(
+  workspaceId: string,
+  nodeIds?: string[]
+): Promise<Map<string, number[]>> {
+  const embeddings = new Map<string, number[]>();
+  if (!(await hasEmbeddingColumn())) return embeddings;
+  if (nodeIds && nodeIds.length === 0) return embeddings;
+
+  const rows = await prisma.$queryRaw<Array<{ id: string; embedding: Uint8Array }>>`
+    SELECT id, vector_send(embedding) AS embedding
+    FROM nodes
+    WHERE workspace_id = ${workspaceId}
+      AND embedding IS NOT NULL
+      ${nodeIds ? Prisma.sql`AND id IN (${Prisma.join(nodeIds)})` : Prisma.empty}
+  `;
+
+  for (const row of rows) {
+    const embedding = vectorToArray(row.embedding);
+    if (embedding) embeddings.set(row.id, embedding);
+  }
+  return embeddings;
+}
+
+// Write many node embeddings with one UPDATE per chunk instead of one per node
+// Returns the number of rows updated; returns 0 if the embedding column doesn't exist
+export async function storeNodeEmbeddings(
+  entries: Array<{ id: string; embedding: ArrayLike<number> }>,
+  chunkSize: number = 100
+): Promise<number> {
+  if (entries.length === 0 || !(await hasEmbeddingColumn())) return 0;
+
+  let stored = 0;
+
+  for (let i = 0; i < entries.length; i += chunkSize) {
+    const rows = entries
+      .slice(i, i + chunkSize)
+      .map((entry) => Prisma.sql`(${entry.id}, ${toVectorParam(entry.embedding)}::real[])`);
+
+    try {
+      stored += await prisma.$executeRaw`
+        UPDATE nodes AS n
+        SET embedding = v.embedding::vector
+        FROM (VALUES ${Prisma.join(rows)}) AS v(id, embedding)
+        WHERE n.id = v.id
+      `;
+    } catch (error: any) {
+      console.warn('[storeNodeEmbeddings] Failed to store embeddings (continuing):', error?.message);
+      break;
+    }
+  }
+
+  return stored;
+}
+
+// Source nodes per statement in bulk auto-link - bounds statement time on large workspaces
+const AUTO_LINK_CHUNK_SIZE = 200;
+const AUTO_LINK_CHUNK_TIMEOUT_MS = 60_000;
+
+// HNSW scans filter by workspace after the index search, so a small workspace in a large
+// database can get fewer than k results. Widen the candidate list and, on pgvector 0.8+,
+// let the scan keep going until k rows pass the filter.
+async function hnswScanSettings(): Promise<string[]> {
+  const version = await getVectorExtensionVersion();
+  if (!version) return [];
+  const [major, minor] = version;
+  const settings: string[] = [];
+  if (major > 0 || minor >= 5) settings.push('SET LOCAL hnsw.ef_search = 100');
+  if (major > 0 || minor >= 8) settings.push("SET LOCAL hnsw.iterative_scan = 'strict_order'");
+  return settings;
+}
+
+export interface AutoLinkEdge {
+  id: string;
+  source: string;
+  target: string;
+  similarity: number;
+}
+
+/**
+ * Link nodes to their most similar neighbours, set-based
+ * Each chunk is one statement: a pgvector top-k LATERAL query per source node feeding
+ * a single INSERT ... ON CONFLICT DO NOTHING. Similarity edges are undirected, so they are
+ * stored canonically (source < target) - the unique (workspace_id, source, target) index then
+ * rejects duplicates, and the reverse-direction check for older/manual edges is one index probe.
+ * Pass nodeIds = null to relink the whole workspace (a kNN graph over every node, built in
+ * one pass over the HNSW index). `onProgress` is called after each chunk.
+ * Returns the edges actually created; throws on any failure other than pgvector missing.
+ */
+export async function autoLinkNodes(
+  workspaceId: string,
+  nodeIds: string[] | null,
+  threshold: number = SIMILARITY_THRESHOLDS.AUTO_LINK,
+  limit: number = 10,
+  onProgress?: (progress: { processed: number; total: number; created: number }) => void
+): Promise<AutoLinkEdge[]> {
+  if (!(await hasEmbeddingColumn())) return [];
+
+  let ids = nodeIds;
+  if (!ids) {
+    const rows = await prisma.node.findMany({ where: { workspaceId }, select: { id: true } });
+    ids = rows.map((row) => row.id);
+  }
+
+  const created: AutoLinkEdge[] = [];
+  const scanSettings = await hnswScanSettings();
+
+  for (let i = 0; i < ids.length; i += AUTO_LINK_CHUNK_SIZE) {
+    const chunk = ids.slice(i, i + AUTO_LINK_CHUNK_SIZE);
+
+    try {
+      const rows = await withSpan('vector.autolink', () => prisma.$transaction(async (tx) => {
+        for (const setting of scanSettings) {
+          await tx.$executeRawUnsafe(setting);
+        }
+        return tx.$queryRaw<AutoLinkEdge[]>`
+          WITH src AS (
+            SELECT id, embedding FROM nodes
+            WHERE workspace_id = ${workspaceId}
+              AND id IN (${Prisma.join(chunk)})
+              AND embedding IS NOT NULL
+          ),
+          candidates AS (
+            SELECT LEAST(src.id, c.id) AS source,
+                   GREATEST(src.id, c.id) AS target,
+                   MAX(c.similarity) AS similarity
+            FROM src
+            CROSS JOIN LATERAL (
+              SELECT n.id, 1 - (n.embedding <=> src.embedding) AS similarity
+              FROM nodes n
+              WHERE n.workspace_id = ${workspaceId}
+                AND n.embedding IS NOT NULL
+                AND n.id <> src.id
+              ORDER BY n.embedding <=> src.embedding
+              LIMIT ${limit}
+            ) c
+            WHERE c.similarity >= ${threshold}
+            GROUP BY 1, 2
+          )
+          INSERT INTO edges (id, workspace_id, source, target, similarity, created_at)
+          SELECT gen_random_uuid()::text, ${workspaceId}, c.source, c.target, c.similarity, NOW()
+          FROM candidates c
+          WHERE NOT EXISTS (
+            SELECT 1 FROM edges e
+            WHERE e.workspace_id = ${workspaceId} AND e.source = c.target AND e.target = c.source
+          )
+          ON CONFLICT (workspace_id, source, target) DO NOTHING
+          RETURNING id, source, target, similarity
+        `;
+      }, { timeout: AUTO_LINK_CHUNK_TIMEOUT_MS }), { nodes: chunk.length });
+      created.push(...rows);
+    } catch (error: any) {
+      // Embedding column / pgvector missing - nothing can be linked; anything else (timeout,
+      // connection loss) is the caller's failure to report
+      if (!isMissingVectorError(error)) throw error;
+      embeddingColumnPromise = null;
+      console.warn('[autoLinkNodes] Vector support missing, skipping auto-link:', error?.message);
+      break;
+    }
+
+    onProgress?.({
+      processed: Math.min(i + AUTO_LINK_CHUNK_SIZE, ids.length),
+      total: ids.length,
+      created: created.length,
+    });
+  }
+
+  return created;
+}
+
+/**
+ * Link one node to its most similar neighbours (uses the node's stored embedding)
+ */
+export async function autoLinkNode(
+  workspaceId: string,
+  nodeId: string,
+  threshold: number = SIMILARITY_THRESHOLDS.AUTO_LINK,
+  limit: number = 10
+): Promise<AutoLinkEdge[]> {
+  return autoLinkNodes(workspaceId, [nodeId], threshold, limit);
+}
+
+/**
+ * Rank a workspace's nodes by similarity to a query embedding (semantic search)
+ * `filter` is an extra SQL condition on the nodes alias `n` (tags, dates)
+ */
+export async function searchNodesByEmbedding(
+  workspaceId: string,
+  embedding: number[],
+  limit: number,
+  minSimilarity: number,
+  filter: Prisma.Sql = Prisma.empty
+): Promise<Array<{ id: string; similarity: number }>> {
+  if (!(await hasEmbeddingColumn())) return [];
+
+  const scanSettings = await hnswScanSettings();
+  const rows = await withSpan('vector.search', () => prisma.$transaction(async (tx) => {
+    for (const setting of scanSettings) {
+      await tx.$executeRawUnsafe(setting);
+    }
+    return tx.$queryRaw<Array<{ id: string; similarity: number }>>`
+      WITH q AS (SELECT ${toVectorParam(embedding)}::real[]::vector AS v)
+      SELECT ranked.id, ranked.similarity FROM (
+        SELECT n.id, 1 - (n.embedding <=> q.v) AS similarity
+        FROM nodes n, q
+        WHERE n.workspace_id = ${workspaceId}
+          AND n.embedding IS NOT NULL
+          ${filter}
+        ORDER BY n.embedding <=> q.v
+        LIMIT ${limit}
+      ) ranked
+      WHERE ranked.similarity >= ${minSimilarity}
+    `;
+  }));
+
+  return rows.map((row) => ({ id: row.id, similarity: Number(row.similarity) }));
+}
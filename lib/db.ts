@@ -1,16 +1,24 @@
 import { PrismaClient } from '@prisma/client';
+import { withSpan } from './tracing';
 
 const globalForPrisma = globalThis as unknown as {
   prisma: PrismaClient | undefined;
 };
 
-export const prisma =
-  globalForPrisma.prisma ??
-  new PrismaClient({
+function createPrismaClient() {
+  const client = new PrismaClient({
     log: process.env.NODE_ENV === 'development' ? ['error', 'warn'] : ['error'],
   });
+  // Every query is a span of the current request ("db.Node.findMany", "db.queryRaw")
+  client.$use((params, next) =>
+    withSpan(params.model ? `db.${params.model}.${params.action}` : `db.${params.action}`, () => next(params))
+  );
+  return client;
+}
+
+export const prisma = globalForPrisma.prisma ?? createPrismaClient();
 
 if (process.env.NODE_ENV !== 'production') globalForPrisma.prisma = prisma;
 
 // Type exports
-export type PrismaClientType = PrismaClient;
\ No newline at end of file
+export type PrismaClientType = PrismaClient;
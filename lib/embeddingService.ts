@@ -0,0 +1,218 @@
+import { createHash } from 'crypto';
+import OpenAI from 'openai';
+import { prisma } from './db';
+import { embeddingCache } from './performance';
+import { withSpan } from './tracing';
+
+// Server-only batched embedding service
+// - packs many inputs into each OpenAI request, with a bounded number of requests in flight
+// - dedups on a hash of the normalized text, so unchanged text is never re-embedded
+// - caches results in Postgres (embedding_cache) behind the in-process embeddingCache,
+//   so the cache survives restarts and is shared across server instances
+
+export const EMBEDDING_MODEL = 'text-embedding-3-small';
+export const EMBEDDING_DIMENSION = 1536;
+
+const MAX_INPUTS_PER_REQUEST = 128;
+const MAX_CHARS_PER_REQUEST = 200_000; // ~50k tokens, far below the per-request limit
+const MAX_CHARS_PER_INPUT = 24_000; // Stay under the ~8k token per-input limit
+const MAX_CONCURRENT_REQUESTS = 4;
+const CACHE_READ_CHUNK = 1000;
+
+let openaiClient: OpenAI | null = null;
+
+// Initialize OpenAI lazily to avoid errors when API key is missing
+function getOpenAIClient(): OpenAI | null {
+  if (!process.env.OPENAI_API_KEY) {
+    return null;
+  }
+  if (!openaiClient) {
+    openaiClient = new OpenAI({ apiKey: process.env.OPENAI_API_KEY });
+  }
+  return openaiClient;
+}
+
+/**
+ * Normalize text before hashing/embedding - whitespace and Unicode form changes
+ * should not count as a content change
+ */
+export function normalizeEmbeddingText(text: string): string {
+  return text.normalize('NFC').replace(/\s+/g, ' ').trim().slice(0, MAX_CHARS_PER_INPUT);
+}
+
+/**
+ * Cache key for normalized text - includes the model so a model change never
+ * serves stale vectors
+ */
+export function embeddingHash(normalizedText: string): string {
+  return createHash('sha256')
+    .update(`${EMBEDDING_MODEL}:${EMBEDDING_DIMENSION}:${normalizedText}`)
+    .digest('hex');
+}
+
+// Compact storage: 1536 float32 = 6 KB instead of ~20 KB of JSON text
+function encodeEmbedding(embedding: number[]): Buffer {
+  return Buffer.from(new Float32Array(embedding).buffer);
+}
+
+function decodeEmbedding(bytes: Uint8Array): number[] {
+  // Copy into a fresh, 4-byte aligned buffer before viewing as float32
+  return Array.from(new Float32Array(new Uint8Array(bytes).buffer));
+}
+
+// Run async tasks with at most `limit` in flight
+async function runWithConcurrency<T>(tasks: Array<() => Promise<T>>, limit: number): Promise<T[]> {
+  const results: T[] = new Array(tasks.length);
+  let next = 0;
+
+  async function worker() {
+    while (next < tasks.length) {
+      const index = next++;
+      results[index] = await tasks[index]();
+    }
+  }
+
+  await Promise.all(Array.from({ length: Math.min(limit, tasks.length) }, worker));
+  return results;
+}
+
+// Split texts into requests bounded by input count and total characters
+function packRequests(items: Array<{ hash: string; text: string }>) {
+  const batches: Array<Array<{ hash: string; text: string }>> = [];
+  let current: Array<{ hash: string; text: string }> = [];
+  let currentChars = 0;
+
+  for (const item of items) {
+    if (
+      current.length > 0 &&
+      (current.length >= MAX_INPUTS_PER_REQUEST || currentChars + item.text.length > MAX_CHARS_PER_REQUEST)
+    ) {
+      batches.push(current);
+      current = [];
+      currentChars = 0;
+    }
+    current.push(item);
+    currentChars += item.text.length;
+  }
+
+  if (current.length > 0) batches.push(current);
+  return batches;
+}
+
+async function readPersistentCache(hashes: string[]): Promise<Map<string, number[]>> {
+  const found = new Map<string, number[]>();
+
+  for (let i = 0; i < hashes.length; i += CACHE_READ_CHUNK) {
+    const chunk = hashes.slice(i, i + CACHE_READ_CHUNK);
+    try {
+      const rows = await prisma.embeddingCache.findMany({
+        where: { contentHash: { in: chunk } },
+        select: { contentHash: true, embedding: true },
+      });
+      for (const row of rows) {
+        found.set(row.contentHash, decodeEmbedding(row.embedding));
+      }
+    } catch (error: any) {
+      // Cache table missing or DB hiccup - fall through to the API
+      console.warn('[embeddings] Failed to read embedding cache (continuing):', error?.message);
+      break;
+    }
+  }
+
+  return found;
+}
+
+async function writePersistentCache(entries: Array<{ hash: string; embedding: number[] }>) {
+  if (entries.length === 0) return;
+  try {
+    await prisma.embeddingCache.createMany({
+      data: entries.map((entry) => ({
+        contentHash: entry.hash,
+        model: EMBEDDING_MODEL,
+        embedding: encodeEmbedding(entry.embedding),
+      })),
+      skipDuplicates: true, // Another instance may have embedded the same text concurrently
+    });
+  } catch (error: any) {
+    console.warn('[embeddings] Failed to write embedding cache (continuing):', error?.message);
+  }
+}
+
+/**
+ * Embed many texts at once
+ * Returns one entry per input (same order); null where the text is empty, the API key
+ * is not set, or the request failed. Failures are never cached.
+ */
+export async function embedTexts(texts: string[]): Promise<Array<number[] | null>> {
+  const hashes = texts.map((text) => {
+    const normalized = normalizeEmbeddingText(text || '');
+    return normalized ? { hash: embeddingHash(normalized), text: normalized } : null;
+  });
+
+  const resolved = new Map<string, number[]>();
+
+  // Level 1: in-process cache
+  const unique = new Map<string, string>();
+  for (const entry of hashes) {
+    if (!entry || unique.has(entry.hash)) continue;
+    const cached = embeddingCache.get(entry.hash);
+    if (cached) {
+      resolved.set(entry.hash, cached);
+    } else {
+      unique.set(entry.hash, entry.text);
+    }
+  }
+
+  // Level 2: Postgres cache
+  if (unique.size > 0) {
+    const persisted = await readPersistentCache(Array.from(unique.keys()));
+    persisted.forEach((embedding, hash) => {
+      resolved.set(hash, embedding);
+      embeddingCache.set(hash, embedding);
+      unique.delete(hash);
+    });
+  }
+
+  // Level 3: OpenAI, batched
+  const openai = unique.size > 0 ? getOpenAIClient() : null;
+  if (unique.size > 0 && !openai) {
+    console.warn('[embeddings] OPENAI_API_KEY is not set, skipping', unique.size, 'embedding(s)');
+  }
+
+  if (openai && unique.size > 0) {
+    const batches = packRequests(Array.from(unique, ([hash, text]) => ({ hash, text })));
+
+    const batchResults = await runWithConcurrency(
+      batches.map((batch) => async () => {
+        try {
+          const response = await withSpan('embed.openai', () =>
+            openai.embeddings.create({
+              model: EMBEDDING_MODEL,
+              input: batch.map((item) => item.text),
+              dimensions: EMBEDDING_DIMENSION,
+            }),
+            { inputs: batch.length }
+          );
+          // Results carry the input index - don't rely on response ordering
+          return response.data.map((d) => ({ hash: batch[d.index].hash, embedding: d.embedding }));
+        } catch (error: any) {
+          console.error('[embeddings] Error generating embedding batch:', {
+            message: error?.message,
+            inputs: batch.length,
+          });
+          return [];
+        }
+      }),
+      MAX_CONCURRENT_REQUESTS
+    );
+
+    const fresh = batchResults.flat();
+    for (const { hash, embedding } of fresh) {
+      resolved.set(hash, embedding);
+      embeddingCache.set(hash, embedding);
+    }
+    await writePersistentCache(fresh);
+  }
+
+  return hashes.map((entry) => (entry ? resolved.get(entry.hash) ?? null : null));
+}
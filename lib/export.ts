@@ -26,10 +26,7 @@ export function exportAsJSON(data: ExportData): string {
  * Export workspace as Markdown
  */
 export function exportAsMarkdown(data: ExportData): string {
-  let markdown = `# ${data.workspace.name}\n\n`;
-  markdown += `**Exported:** ${new Date(data.exported_at).toLocaleString()}\n\n`;
-  markdown += `**Nodes:** ${data.nodes.length} | **Connections:** ${data.edges.length}\n\n`;
-  markdown += `---\n\n`;
+  let markdown = markdownHeader(data.workspace.name, data.exported_at, data.nodes.length, data.edges.length);
 
   // Group nodes by tags
   const nodesByTag = new Map<string, Node[]>();
@@ -48,26 +45,49 @@ export function exportAsMarkdown(data: ExportData): string {
     }
   });
 
+  const connectionCount = (node: Node) =>
+    data.edges.filter((e) => e.source === node.id || e.target === node.id).length;
+
   // Write nodes by tag
   nodesByTag.forEach((nodes, tag) => {
-    markdown += `## 📁 ${tag}\n\n`;
+    markdown += markdownTagHeading(tag);
     nodes.forEach((node) => {
-      markdown += writeNodeMarkdown(node, data.edges);
+      markdown += markdownNode(node, connectionCount(node));
     });
   });
 
   // Write untagged nodes
   if (untaggedNodes.length > 0) {
-    markdown += `## 📄 Uncategorized\n\n`;
+    markdown += markdownTagHeading(null);
     untaggedNodes.forEach((node) => {
-      markdown += writeNodeMarkdown(node, data.edges);
+      markdown += markdownNode(node, connectionCount(node));
     });
   }
 
   return markdown;
 }
 
-function writeNodeMarkdown(node: Node, edges: Edge[]): string {
+// Markdown building blocks, shared with the streaming export (lib/exportStream.ts)
+
+export function markdownHeader(
+  workspaceName: string,
+  exportedAt: string,
+  nodeCount: number,
+  edgeCount: number
+): string {
+  let md = `# ${workspaceName}\n\n`;
+  md += `**Exported:** ${new Date(exportedAt).toLocaleString()}\n\n`;
+  md += `**Nodes:** ${nodeCount} | **Connections:** ${edgeCount}\n\n`;
+  md += `---\n\n`;
+  return md;
+}
+
+// null = untagged nodes
+export function markdownTagHeading(tag: string | null): string {
+  return tag === null ? `## 📄 Uncategorized\n\n` : `## 📁 ${tag}\n\n`;
+}
+
+export function markdownNode(node: Pick<Node, 'title' | 'content'>, connectionCount: number): string {
   let md = `### ${node.title}\n\n`;
 
   // Extract text from JSONB content
@@ -77,11 +97,8 @@ function writeNodeMarkdown(node: Node, edges: Edge[]): string {
   }
 
   // Add connections
-  const connections = edges.filter(
-    (e) => e.source === node.id || e.target === node.id
-  );
-  if (connections.length > 0) {
-    md += `**Connections:** ${connections.length}\n\n`;
+  if (connectionCount > 0) {
+    md += `**Connections:** ${connectionCount}\n\n`;
   }
 
   md += `---\n\n`;
@@ -0,0 +1,257 @@
+import { Prisma } from '@prisma/client';
+import { prisma } from './db';
+import { markdownHeader, markdownNode, markdownTagHeading } from './export';
+
+// Server-only streaming workspace export (GET /api/workspaces/[id]/export)
+// Rows are read in id-cursor pages and encoded straight into the response stream, so
+// memory stays at one page whatever the workspace size, and the first bytes go out
+// before the last page is read. The stream pauses reading while the client is slow
+// (pull-based ReadableStream).
+
+export const EXPORT_FORMATS = ['json', 'ndjson', 'markdown'] as const;
+export type ExportFormat = (typeof EXPORT_FORMATS)[number];
+
+export function isExportFormat(value: unknown): value is ExportFormat {
+  return typeof value === 'string' && (EXPORT_FORMATS as readonly string[]).includes(value);
+}
+
+const PAGE_SIZE = 500;
+
+export interface ExportWorkspace {
+  id: string;
+  name: string;
+  ownerId: string;
+  createdAt: Date;
+  updatedAt: Date;
+}
+
+const nodeSelect = {
+  id: true,
+  workspaceId: true,
+  title: true,
+  content: true,
+  tags: true,
+  x: true,
+  y: true,
+  createdAt: true,
+  updatedAt: true,
+} satisfies Prisma.NodeSelect;
+
+const edgeSelect = {
+  id: true,
+  workspaceId: true,
+  source: true,
+  target: true,
+  label: true,
+  similarity: true,
+  createdAt: true,
+} satisfies Prisma.EdgeSelect;
+
+type ExportNode = Prisma.NodeGetPayload<{ select: typeof nodeSelect }>;
+type ExportEdge = Prisma.EdgeGetPayload<{ select: typeof edgeSelect }>;
+
+async function* nodePages(where: Prisma.NodeWhereInput): AsyncGenerator<ExportNode[]> {
+  let cursor: string | undefined;
+  while (true) {
+    const page = await prisma.node.findMany({
+      where,
+      select: nodeSelect,
+      orderBy: { id: 'asc' },
+      take: PAGE_SIZE,
+      ...(cursor ? { cursor: { id: cursor }, skip: 1 } : {}),
+    });
+    if (page.length === 0) return;
+    yield page;
+    if (page.length < PAGE_SIZE) return;
+    cursor = page[page.length - 1].id;
+  }
+}
+
+async function* edgePages(workspaceId: string): AsyncGenerator<ExportEdge[]> {
+  let cursor: string | undefined;
+  while (true) {
+    const page = await prisma.edge.findMany({
+      where: { workspaceId },
+      select: edgeSelect,
+      orderBy: { id: 'asc' },
+      take: PAGE_SIZE,
+      ...(cursor ? { cursor: { id: cursor }, skip: 1 } : {}),
+    });
+    if (page.length === 0) return;
+    yield page;
+    if (page.length < PAGE_SIZE) return;
+    cursor = page[page.length - 1].id;
+  }
+}
+
+async function loadMembers(workspaceId: string) {
+  const members = await prisma.workspaceMember.findMany({
+    where: { workspaceId },
+    include: { user: { select: { id: true, email: true, name: true } } },
+  });
+  return members.map((m) => ({
+    userId: m.userId,
+    role: m.role,
+    email: m.user.email,
+    name: m.user.name,
+    createdAt: m.createdAt.toISOString(),
+  }));
+}
+
+function serializeWorkspace(workspace: ExportWorkspace) {
+  return {
+    ...workspace,
+    createdAt: workspace.createdAt.toISOString(),
+    updatedAt: workspace.updatedAt.toISOString(),
+  };
+}
+
+function serializeNode(node: ExportNode) {
+  return { ...node, createdAt: node.createdAt.toISOString(), updatedAt: node.updatedAt.toISOString() };
+}
+
+function serializeEdge(edge: ExportEdge) {
+  return { ...edge, createdAt: edge.createdAt.toISOString() };
+}
+
+// Same document as the old buffered export: { workspace, nodes, edges, members }
+async function* jsonChunks(workspace: ExportWorkspace): AsyncGenerator<string> {
+  yield `{"workspace":${JSON.stringify(serializeWorkspace(workspace))},"nodes":[`;
+
+  let separator = '';
+  for await (const page of nodePages({ workspaceId: workspace.id })) {
+    yield separator + page.map((node) => JSON.stringify(serializeNode(node))).join(',');
+    separator = ',';
+  }
+
+  yield '],"edges":[';
+  separator = '';
+  for await (const page of edgePages(workspace.id)) {
+    yield separator + page.map((edge) => JSON.stringify(serializeEdge(edge))).join(',');
+    separator = ',';
+  }
+
+  yield `],"members":${JSON.stringify(await loadMembers(workspace.id))}}`;
+}
+
+// One JSON object per line: workspace, nodes, edges, members, then an end record with
+// counts so consumers can tell a complete export from a truncated one
+async function* ndjsonChunks(workspace: ExportWorkspace, userId: string): AsyncGenerator<string> {
+  yield JSON.stringify({
+    type: 'workspace',
+    ...serializeWorkspace(workspace),
+    exportedAt: new Date().toISOString(),
+    exportedBy: userId,
+  }) + '\n';
+
+  let nodeCount = 0;
+  for await (const page of nodePages({ workspaceId: workspace.id })) {
+    nodeCount += page.length;
+    yield page.map((node) => JSON.stringify({ type: 'node', ...serializeNode(node) }) + '\n').join('');
+  }
+
+  let edgeCount = 0;
+  for await (const page of edgePages(workspace.id)) {
+    edgeCount += page.length;
+    yield page.map((edge) => JSON.stringify({ type: 'edge', ...serializeEdge(edge) }) + '\n').join('');
+  }
+
+  const members = await loadMembers(workspace.id);
+  yield members.map((member) => JSON.stringify({ type: 'member', ...member }) + '\n').join('');
+
+  yield JSON.stringify({ type: 'end', nodes: nodeCount, edges: edgeCount, members: members.length }) + '\n';
+}
+
+async function connectionCounts(workspaceId: string, nodeIds: string[]): Promise<Map<string, number>> {
+  const counts = new Map<string, number>();
+  const [bySource, byTarget] = await Promise.all([
+    prisma.edge.groupBy({
+      by: ['source'],
+      where: { workspaceId, source: { in: nodeIds } },
+      _count: { _all: true },
+    }),
+    prisma.edge.groupBy({
+      by: ['target'],
+      where: { workspaceId, target: { in: nodeIds } },
+      _count: { _all: true },
+    }),
+  ]);
+  bySource.forEach((row) => counts.set(row.source, (counts.get(row.source) || 0) + row._count._all));
+  byTarget.forEach((row) => counts.set(row.target, (counts.get(row.target) || 0) + row._count._all));
+  return counts;
+}
+
+// Same layout as exportAsMarkdown: one section per tag (alphabetical), then untagged nodes.
+// A node with several tags appears under each of them.
+async function* markdownChunks(workspace: ExportWorkspace): AsyncGenerator<string> {
+  const [nodeCount, edgeCount, tagRows] = await Promise.all([
+    prisma.node.count({ where: { workspaceId: workspace.id } }),
+    prisma.edge.count({ where: { workspaceId: workspace.id } }),
+    prisma.$queryRaw<{ tag: string }[]>`
+      SELECT DISTINCT unnest(tags) AS tag FROM nodes WHERE workspace_id = ${workspace.id} ORDER BY tag
+    `,
+  ]);
+
+  yield markdownHeader(workspace.name, new Date().toISOString(), nodeCount, edgeCount);
+
+  const sections: { tag: string | null; where: Prisma.NodeWhereInput }[] = [
+    ...tagRows.map(({ tag }) => ({ tag, where: { workspaceId: workspace.id, tags: { has: tag } } })),
+    { tag: null, where: { workspaceId: workspace.id, tags: { isEmpty: true } } },
+  ];
+
+  for (const { tag, where } of sections) {
+    let headed = false;
+    for await (const page of nodePages(where)) {
+      const counts = await connectionCounts(workspace.id, page.map((node) => node.id));
+      let chunk = headed ? '' : markdownTagHeading(tag);
+      headed = true;
+      page.forEach((node) => {
+        chunk += markdownNode(node, counts.get(node.id) || 0);
+      });
+      yield chunk;
+    }
+  }
+}
+
+/**
+ * Export a workspace as a byte stream in the given format
+ */
+export function streamWorkspaceExport(
+  workspace: ExportWorkspace,
+  format: ExportFormat,
+  userId: string
+): ReadableStream<Uint8Array> {
+  const chunks =
+    format === 'ndjson'
+      ? ndjsonChunks(workspace, userId)
+      : format === 'markdown'
+        ? markdownChunks(workspace)
+        : jsonChunks(workspace);
+  const encoder = new TextEncoder();
+
+  return new ReadableStream<Uint8Array>({
+    async pull(controller) {
+      try {
+        // Skip empty chunks so every pull delivers bytes or ends the stream
+        while (true) {
+          const { value, done } = await chunks.next();
+          if (done) {
+            controller.close();
+            return;
+          }
+          if (value) {
+            controller.enqueue(encoder.encode(value));
+            return;
+          }
+        }
+      } catch (error: any) {
+        // Headers are already sent - all we can do is cut the stream short
+        console.error('[exportStream] Export failed mid-stream:', error?.message);
+        controller.error(error);
+      }
+    },
+    async cancel() {
+      await chunks.return(undefined);
+    },
+  });
+}
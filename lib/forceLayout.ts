@@ -0,0 +1,778 @@
+// Force-directed layout engine over flat typed arrays - no DOM, no d3
+// Runs unchanged on the server (lib/layout.ts), in the layout worker (lib/layout.worker.ts)
+// and synchronously for small graphs (lib/layoutEngine.ts).
+//
+// Same model as the d3-force setup it replaces (link springs, many-body repulsion,
+// collision, centering, alpha cooling), but:
+// - many-body uses a Barnes-Hut quadtree built into typed arrays: O(n log n) per tick
+// - collision uses a uniform grid: O(n) per tick for evenly spread nodes
+// - positions live in one Float32Array [x0, y0, x1, y1, ...] that can be transferred
+//   to/from a worker without copying
+// - work is done in caller-sized steps, so callers can report progress and cancel
+// - large graphs are coarsened (heavy-edge matching) and laid out coarse-to-fine, which
+//   converges in far fewer fine-level iterations
+
+export interface LayoutGraph {
+  count: number;
+  positions: Float32Array; // 2 * count, updated in place
+  edges: Uint32Array; // Node index pairs [s0, t0, s1, t1, ...]
+  fixed?: Uint8Array; // 1 = pinned at its current position
+}
+
+export interface ForceLayoutOptions {
+  iterations?: number;
+  linkDistance?: number;
+  linkStrength?: number;
+  charge?: number; // Negative repels
+  theta?: number; // Barnes-Hut accuracy - larger is faster and coarser
+  collideRadius?: number;
+  centerX?: number;
+  centerY?: number;
+  velocityDecay?: number;
+  // Starting temperature: 1 lays out from scratch, lower values refine a settled layout
+  alpha?: number;
+  alphaMin?: number;
+  // Coarse-to-fine layout: true, false, or 'auto' (on above MULTILEVEL_THRESHOLD nodes)
+  multilevel?: boolean | 'auto';
+}
+
+type ResolvedOptions = Required<ForceLayoutOptions>;
+
+const DEFAULT_OPTIONS: ResolvedOptions = {
+  iterations: 300,
+  linkDistance: 150,
+  linkStrength: 0.5,
+  charge: -300,
+  theta: 0.9,
+  collideRadius: 50,
+  centerX: 500,
+  centerY: 400,
+  velocityDecay: 0.4,
+  alpha: 1,
+  alphaMin: 0.001,
+  multilevel: 'auto',
+};
+
+export const MULTILEVEL_THRESHOLD = 1000;
+
+// Coarsening stops at this size, or when a pass no longer shrinks the graph by 10%
+const COARSEST_SIZE = 200;
+const MAX_LEVELS = 12;
+// Fine levels start from a good prolonged layout - they only need a short, cool refinement
+const REFINE_ITERATION_SHARE = 0.3;
+const REFINE_MIN_ITERATIONS = 30;
+const REFINE_START_ALPHA = 0.3;
+
+const QUADTREE_MAX_DEPTH = 24;
+const DISTANCE_MIN2 = 1;
+
+interface Level {
+  count: number;
+  positions: Float32Array;
+  velocities: Float32Array;
+  edges: Uint32Array;
+  fixed: Uint8Array | null;
+  weight: Float32Array; // Member count - scales charge and collision radius
+  // Index of each node's coarse parent in the next level (undefined for the coarsest)
+  parent?: Int32Array;
+}
+
+interface Stage {
+  level: number;
+  iterations: number;
+  startAlpha: number;
+}
+
+/**
+ * Resumable force layout - call step() until it returns true
+ * Results are written to graph.positions as the finest level progresses.
+ */
+export class ForceLayout {
+  private options: ResolvedOptions;
+  private levels: Level[];
+  private stages: Stage[];
+  private stageIndex = 0;
+  private tickInStage = 0;
+  private alpha = 1;
+  private alphaDecay = 0;
+  private ticksDone = 0;
+  private ticksTotal: number;
+  private scratch: BarnesHutScratch;
+
+  constructor(private graph: LayoutGraph, options: ForceLayoutOptions = {}) {
+    this.options = { ...DEFAULT_OPTIONS, ...options };
+
+    const finest: Level = {
+      count: graph.count,
+      positions: graph.positions,
+      velocities: new Float32Array(graph.count * 2),
+      edges: graph.edges,
+      fixed: graph.fixed ?? null,
+      weight: new Float32Array(graph.count).fill(1),
+    };
+
+    const hasFixed = !!graph.fixed && graph.fixed.some((f) => f === 1);
+    const multilevel = this.options.multilevel === 'auto'
+      ? graph.count > MULTILEVEL_THRESHOLD && !hasFixed
+      : this.options.multilevel && !hasFixed;
+
+    this.levels = multilevel ? buildLevels(finest) : [finest];
+    this.stages = [];
+    for (let level = this.levels.length - 1; level >= 0; level--) {
+      const coarsest = level === this.levels.length - 1;
+      this.stages.push({
+        level,
+        iterations: coarsest
+          ? this.options.iterations
+          : Math.max(REFINE_MIN_ITERATIONS, Math.round(this.options.iterations * REFINE_ITERATION_SHARE)),
+        startAlpha: coarsest ? this.options.alpha : REFINE_START_ALPHA,
+      });
+    }
+    this.ticksTotal = this.stages.reduce((sum, stage) => sum + stage.iterations, 0);
+    this.scratch = new BarnesHutScratch(this.levels[this.levels.length - 1].count);
+    this.beginStage();
+  }
+
+  /** Fraction of the total work done, 0..1 */
+  get progress(): number {
+    return this.ticksTotal === 0 ? 1 : this.ticksDone / this.ticksTotal;
+  }
+
+  get done(): boolean {
+    return this.stageIndex >= this.stages.length;
+  }
+
+  /** Current positions for every node of the input graph */
+  get positions(): Float32Array {
+    return this.graph.positions;
+  }
+
+  /**
+   * Run up to `ticks` iterations. Returns true once the layout has finished
+   */
+  step(ticks: number): boolean {
+    for (let i = 0; i < ticks && !this.done; i++) {
+      const stage = this.stages[this.stageIndex];
+      tick(this.levels[stage.level], this.alpha, this.options, this.scratch);
+      this.alpha += (0 - this.alpha) * this.alphaDecay;
+      this.tickInStage++;
+      this.ticksDone++;
+
+      if (this.tickInStage >= stage.iterations) {
+        this.stageIndex++;
+        if (!this.done) {
+          const next = this.stages[this.stageIndex];
+          prolong(this.levels[next.level + 1], this.levels[next.level], this.options.linkDistance);
+          this.beginStage();
+        }
+      }
+    }
+
+    // While still on a coarse level, show the coarse layout on the real nodes
+    if (!this.done && this.stages[this.stageIndex].level > 0) {
+      this.projectToFinest(this.stages[this.stageIndex].level);
+    }
+
+    return this.done;
+  }
+
+  private beginStage() {
+    const stage = this.stages[this.stageIndex];
+    this.tickInStage = 0;
+    this.alpha = stage.startAlpha;
+    // d3's schedule: reach alphaMin after `iterations` ticks
+    this.alphaDecay = 1 - Math.pow(this.options.alphaMin / stage.startAlpha, 1 / Math.max(stage.iterations, 1));
+    this.scratch.ensure(this.levels[stage.level].count);
+  }
+
+  private projectToFinest(level: number) {
+    const finest = this.levels[0];
+    const coarse = this.levels[level];
+    for (let i = 0; i < finest.count; i++) {
+      let node = i;
+      for (let l = 0; l < level; l++) node = this.levels[l].parent![node];
+      finest.positions[i * 2] = coarse.positions[node * 2];
+      finest.positions[i * 2 + 1] = coarse.positions[node * 2 + 1];
+    }
+  }
+}
+
+/**
+ * Run a layout to completion on the calling thread
+ */
+export function runForceLayoutSync(graph: LayoutGraph, options: ForceLayoutOptions = {}): Float32Array {
+  const layout = new ForceLayout(graph, options);
+  while (!layout.step(1000)) {
+    // Keep stepping
+  }
+  return layout.positions;
+}
+
+/**
+ * Pack id-based nodes/edges into a LayoutGraph
+ * Nodes without a usable position (missing, or exactly 0,0 as the old layouts treated it)
+ * start at a random point around the center. Edges to unknown ids are dropped.
+ */
+export function toLayoutGraph(
+  nodes: Array<{ id: string; x?: number | null; y?: number | null }>,
+  edges: Array<{ source: string; target: string }>,
+  options: { centerX?: number; centerY?: number; spread?: number; fixedIds?: Set<string> } = {}
+): { graph: LayoutGraph; ids: string[] } {
+  const centerX = options.centerX ?? DEFAULT_OPTIONS.centerX;
+  const centerY = options.centerY ?? DEFAULT_OPTIONS.centerY;
+  const spread = options.spread ?? 400;
+
+  const ids = nodes.map((node) => node.id);
+  const index = new Map(ids.map((id, i) => [id, i]));
+  const positions = new Float32Array(nodes.length * 2);
+  nodes.forEach((node, i) => {
+    positions[i * 2] = node.x || centerX + (Math.random() - 0.5) * spread;
+    positions[i * 2 + 1] = node.y || centerY + (Math.random() - 0.5) * spread;
+  });
+
+  const pairs: number[] = [];
+  for (const edge of edges) {
+    const s = index.get(edge.source);
+    const t = index.get(edge.target);
+    if (s !== undefined && t !== undefined && s !== t) pairs.push(s, t);
+  }
+
+  let fixed: Uint8Array | undefined;
+  if (options.fixedIds && options.fixedIds.size > 0) {
+    fixed = new Uint8Array(nodes.length);
+    ids.forEach((id, i) => {
+      if (options.fixedIds!.has(id)) fixed![i] = 1;
+    });
+  }
+
+  return {
+    graph: { count: nodes.length, positions, edges: Uint32Array.from(pairs), fixed },
+    ids,
+  };
+}
+
+/**
+ * Unpack positions back into an id-keyed map
+ */
+export function positionsToMap(ids: string[], positions: Float32Array): Map<string, { x: number; y: number }> {
+  const map = new Map<string, { x: number; y: number }>();
+  ids.forEach((id, i) => {
+    map.set(id, { x: positions[i * 2], y: positions[i * 2 + 1] });
+  });
+  return map;
+}
+
+// ---------------------------------------------------------------------------
+// One simulation tick (velocity Verlet, as d3-force)
+
+function tick(level: Level, alpha: number, options: ResolvedOptions, scratch: BarnesHutScratch) {
+  const { count, positions: p, velocities: v, fixed } = level;
+  if (count === 0) return;
+
+  applyLinks(level, alpha, options);
+  scratch.applyManyBody(level, alpha, options.charge, options.theta);
+  applyCollision(level, options.collideRadius);
+
+  const decay = 1 - options.velocityDecay;
+  for (let i = 0; i < count; i++) {
+    if (fixed && fixed[i]) {
+      v[i * 2] = 0;
+      v[i * 2 + 1] = 0;
+      continue;
+    }
+    v[i * 2] *= decay;
+    v[i * 2 + 1] *= decay;
+    p[i * 2] += v[i * 2];
+    p[i * 2 + 1] += v[i * 2 + 1];
+  }
+
+  // Centering would drag pinned nodes along with everything else
+  if (!fixed) applyCenter(level, options.centerX, options.centerY);
+}
+
+function applyLinks(level: Level, alpha: number, options: ResolvedOptions) {
+  const { positions: p, velocities: v, edges, count } = level;
+  const m = edges.length / 2;
+  if (m === 0) return;
+
+  // Cached per level - degrees only change if the level is rebuilt
+  const degree = degreesOf(level, count);
+
+  for (let e = 0; e < m; e++) {
+    const s = edges[e * 2];
+    const t = edges[e * 2 + 1];
+    let dx = p[t * 2] + v[t * 2] - p[s * 2] - v[s * 2] || jiggle();
+    let dy = p[t * 2 + 1] + v[t * 2 + 1] - p[s * 2 + 1] - v[s * 2 + 1] || jiggle();
+    let l = Math.sqrt(dx * dx + dy * dy);
+    l = ((l - options.linkDistance) / l) * alpha * options.linkStrength;
+    dx *= l;
+    dy *= l;
+    const bias = degree[s] / (degree[s] + degree[t]);
+    v[t * 2] -= dx * bias;
+    v[t * 2 + 1] -= dy * bias;
+    v[s * 2] += dx * (1 - bias);
+    v[s * 2 + 1] += dy * (1 - bias);
+  }
+}
+
+const degreeCache = new WeakMap<Level, Uint32Array>();
+
+function degreesOf(level: Level, count: number): Uint32Array {
+  let degree = degreeCache.get(level);
+  if (!degree) {
+    degree = new Uint32Array(count);
+    for (let e = 0; e < level.edges.length; e++) degree[level.edges[e]]++;
+    degreeCache.set(level, degree);
+  }
+  return degree;
+}
+
+function applyCenter(level: Level, centerX: number, centerY: number) {
+  const { positions: p, count } = level;
+  let sx = 0;
+  let sy = 0;
+  for (let i = 0; i < count; i++) {
+    sx += p[i * 2];
+    sy += p[i * 2 + 1];
+  }
+  const dx = sx / count - centerX;
+  const dy = sy / count - centerY;
+  for (let i = 0; i < count; i++) {
+    p[i * 2] -= dx;
+    p[i * 2 + 1] -= dy;
+  }
+}
+
+/**
+ * Collision on a uniform grid of cells one max-diameter wide: each node only checks the
+ * 3x3 block of cells around it. Radii scale with sqrt(weight) on coarse levels.
+ */
+function applyCollision(level: Level, baseRadius: number) {
+  const { positions: p, velocities: v, weight, count } = level;
+  if (baseRadius <= 0 || count < 2) return;
+
+  let maxWeight = 1;
+  for (let i = 0; i < count; i++) if (weight[i] > maxWeight) maxWeight = weight[i];
+  const cellSize = 2 * baseRadius * Math.sqrt(maxWeight);
+
+  const heads = new Map<number, number>();
+  const next = new Int32Array(count);
+  const cellX = new Int32Array(count);
+  const cellY = new Int32Array(count);
+
+  for (let i = 0; i < count; i++) {
+    const cx = Math.floor((p[i * 2] + v[i * 2]) / cellSize);
+    const cy = Math.floor((p[i * 2 + 1] + v[i * 2 + 1]) / cellSize);
+    cellX[i] = cx;
+    cellY[i] = cy;
+    const key = cellKey(cx, cy);
+    next[i] = heads.get(key) ?? -1;
+    heads.set(key, i);
+  }
+
+  for (let i = 0; i < count; i++) {
+    const ri = baseRadius * Math.sqrt(weight[i]);
+    const xi = p[i * 2] + v[i * 2];
+    const yi = p[i * 2 + 1] + v[i * 2 + 1];
+
+    for (let ox = -1; ox <= 1; ox++) {
+      for (let oy = -1; oy <= 1; oy++) {
+        let j = heads.get(cellKey(cellX[i] + ox, cellY[i] + oy)) ?? -1;
+        for (; j !== -1; j = next[j]) {
+          if (j <= i) continue; // Each pair once
+          const rj = baseRadius * Math.sqrt(weight[j]);
+          const r = ri + rj;
+          let dx = xi - p[j * 2] - v[j * 2];
+          let dy = yi - p[j * 2 + 1] - v[j * 2 + 1];
+          let l = dx * dx + dy * dy;
+          if (l >= r * r) continue;
+          if (dx === 0) {
+            dx = jiggle();
+            l += dx * dx;
+          }
+          if (dy === 0) {
+            dy = jiggle();
+            l += dy * dy;
+          }
+          l = Math.sqrt(l);
+          l = (r - l) / l;
+          dx *= l;
+          dy *= l;
+          // Bigger nodes move less
+          const share = (rj * rj) / (ri * ri + rj * rj);
+          v[i * 2] += dx * share;
+          v[i * 2 + 1] += dy * share;
+          v[j * 2] -= dx * (1 - share);
+          v[j * 2 + 1] -= dy * (1 - share);
+        }
+      }
+    }
+  }
+}
+
+function cellKey(cx: number, cy: number): number {
+  // Kept below 2^30 so keys stay small integers (fast Map hashing). Cells 32768 apart
+  // share a key, which only costs a few extra distance checks
+  return (cx & 0x7fff) * 0x8000 + (cy & 0x7fff);
+}
+
+/**
+ * Barnes-Hut many-body force. The quadtree lives in preallocated typed arrays that are
+ * reused across ticks; cells are created parent-first, so one reverse pass aggregates
+ * charge and centroids bottom-up.
+ */
+class BarnesHutScratch {
+  private capacity = 0;
+  private x0 = new Float64Array(0);
+  private y0 = new Float64Array(0);
+  private size = new Float64Array(0);
+  private child = new Int32Array(0); // 4 per cell, -1 = none
+  private head = new Int32Array(0); // First point of a leaf's chain, -1 = none
+  private charge = new Float64Array(0);
+  private cx = new Float64Array(0);
+  private cy = new Float64Array(0);
+  private depth = new Uint8Array(0);
+  private isLeaf = new Uint8Array(0);
+  private nextPoint = new Int32Array(0);
+  private stack = new Int32Array(0);
+  private cells = 0;
+
+  constructor(nodeCount: number) {
+    this.ensure(nodeCount);
+  }
+
+  ensure(nodeCount: number) {
+    // Each insert splits at most QUADTREE_MAX_DEPTH cells; in practice ~2n cells suffice,
+    // and allocCell() grows the arrays if a pathological input needs more
+    const needed = Math.max(16, nodeCount * 4);
+    if (needed > this.capacity) this.grow(needed);
+    if (this.nextPoint.length < nodeCount) {
+      this.nextPoint = new Int32Array(nodeCount);
+    }
+  }
+
+  private grow(capacity: number) {
+    const copy = <T extends Float64Array | Int32Array | Uint8Array>(old: T, make: (n: number) => T, per = 1) => {
+      const next = make(capacity * per);
+      next.set(old);
+      return next;
+    };
+    this.x0 = copy(this.x0, (n) => new Float64Array(n));
+    this.y0 = copy(this.y0, (n) => new Float64Array(n));
+    this.size = copy(this.size, (n) => new Float64Array(n));
+    this.child = copy(this.child, (n) => new Int32Array(n), 4);
+    this.head = copy(this.head, (n) => new Int32Array(n));
+    this.charge = copy(this.charge, (n) => new Float64Array(n));
+    this.cx = copy(this.cx, (n) => new Float64Array(n));
+    this.cy = copy(this.cy, (n) => new Float64Array(n));
+    this.depth = copy(this.depth, (n) => new Uint8Array(n));
+    this.isLeaf = copy(this.isLeaf, (n) => new Uint8Array(n));
+    this.stack = new Int32Array(capacity);
+    this.capacity = capacity;
+  }
+
+  private allocCell(x0: number, y0: number, size: number, depth: number): number {
+    if (this.cells >= this.capacity) this.grow(this.capacity * 2);
+    const c = this.cells++;
+    this.x0[c] = x0;
+    this.y0[c] = y0;
+    this.size[c] = size;
+    this.depth[c] = depth;
+    this.isLeaf[c] = 1;
+    this.head[c] = -1;
+    this.child[c * 4] = this.child[c * 4 + 1] = this.child[c * 4 + 2] = this.child[c * 4 + 3] = -1;
+    return c;
+  }
+
+  private quadrant(c: number, x: number, y: number): number {
+    const half = this.size[c] / 2;
+    return (x >= this.x0[c] + half ? 1 : 0) | (y >= this.y0[c] + half ? 2 : 0);
+  }
+
+  private childCell(c: number, q: number): number {
+    let k = this.child[c * 4 + q];
+    if (k === -1) {
+      const half = this.size[c] / 2;
+      k = this.allocCell(
+        this.x0[c] + (q & 1 ? half : 0),
+        this.y0[c] + (q & 2 ? half : 0),
+        half,
+        this.depth[c] + 1
+      );
+      this.child[c * 4 + q] = k;
+    }
+    return k;
+  }
+
+  private build(p: Float32Array, count: number) {
+    let minX = Infinity;
+    let minY = Infinity;
+    let maxX = -Infinity;
+    let maxY = -Infinity;
+    for (let i = 0; i < count; i++) {
+      const x = p[i * 2];
+      const y = p[i * 2 + 1];
+      if (x < minX) minX = x;
+      if (x > maxX) maxX = x;
+      if (y < minY) minY = y;
+      if (y > maxY) maxY = y;
+    }
+    const extent = Math.max(maxX - minX, maxY - minY, 1) * 1.0001;
+
+    this.cells = 0;
+    this.allocCell(minX, minY, extent, 0);
+
+    for (let i = 0; i < count; i++) {
+      const x = p[i * 2];
+      const y = p[i * 2 + 1];
+      let c = 0;
+      for (;;) {
+        if (!this.isLeaf[c]) {
+          c = this.childCell(c, this.quadrant(c, x, y));
+          continue;
+        }
+        const j = this.head[c];
+        // Empty leaf, max depth, or a point at the exact same spot: chain it here
+        if (j === -1 || this.depth[c] >= QUADTREE_MAX_DEPTH || (p[j * 2] === x && p[j * 2 + 1] === y)) {
+          this.nextPoint[i] = j;
+          this.head[c] = i;
+          break;
+        }
+        // Split: push the existing chain down one level, then retry this point from here
+        this.isLeaf[c] = 0;
+        this.head[c] = -1;
+        const k = this.childCell(c, this.quadrant(c, p[j * 2], p[j * 2 + 1]));
+        this.head[k] = j; // The whole chain shares one position
+      }
+    }
+  }
+
+  private aggregate(p: Float32Array, weight: Float32Array, strength: number) {
+    for (let c = this.cells - 1; c >= 0; c--) {
+      let q = 0;
+      let sx = 0;
+      let sy = 0;
+      if (this.isLeaf[c]) {
+        for (let j = this.head[c]; j !== -1; j = this.nextPoint[j]) {
+          const w = strength * weight[j];
+          q += w;
+          sx += w * p[j * 2];
+          sy += w * p[j * 2 + 1];
+        }
+      } else {
+        for (let k = 0; k < 4; k++) {
+          const d = this.child[c * 4 + k];
+          if (d === -1) continue;
+          q += this.charge[d];
+          sx += this.charge[d] * this.cx[d];
+          sy += this.charge[d] * this.cy[d];
+        }
+      }
+      this.charge[c] = q;
+      this.cx[c] = q !== 0 ? sx / q : 0;
+      this.cy[c] = q !== 0 ? sy / q : 0;
+    }
+  }
+
+  applyManyBody(level: Level, alpha: number, strength: number, theta: number) {
+    const { positions: p, velocities: v, weight, count } = level;
+    if (count < 2 || strength === 0) return;
+
+    this.build(p, count);
+    this.aggregate(p, weight, strength);
+    const theta2 = theta * theta;
+
+    // Locals rather than this.* in the hot loop
+    const { charge, cx, cy, size, isLeaf, child, head, nextPoint, stack } = this;
+
+    for (let i = 0; i < count; i++) {
+      const xi = p[i * 2];
+      const yi = p[i * 2 + 1];
+      let fx = 0;
+      let fy = 0;
+      let top = 0;
+      stack[top++] = 0;
+
+      while (top > 0) {
+        const c = stack[--top];
+        if (charge[c] === 0) continue;
+
+        let dx = cx[c] - xi;
+        let dy = cy[c] - yi;
+        let l = dx * dx + dy * dy;
+        const w = size[c];
+
+        // Far enough away: treat the whole cell as one body
+        if (!isLeaf[c] && (w * w) / theta2 < l) {
+          if (l < DISTANCE_MIN2) l = Math.sqrt(DISTANCE_MIN2 * l);
+          const f = (charge[c] * alpha) / l;
+          fx += dx * f;
+          fy += dy * f;
+          continue;
+        }
+
+        if (!isLeaf[c]) {
+          for (let k = 0; k < 4; k++) {
+            const d = child[c * 4 + k];
+            if (d !== -1) stack[top++] = d;
+          }
+          continue;
+        }
+
+        for (let j = head[c]; j !== -1; j = nextPoint[j]) {
+          if (j === i) continue;
+          dx = p[j * 2] - xi;
+          dy = p[j * 2 + 1] - yi;
+          if (dx === 0) dx = jiggle();
+          if (dy === 0) dy = jiggle();
+          l = dx * dx + dy * dy;
+          if (l < DISTANCE_MIN2) l = Math.sqrt(DISTANCE_MIN2 * l);
+          const f = (strength * weight[j] * alpha) / l;
+          fx += dx * f;
+          fy += dy * f;
+        }
+      }
+
+      v[i * 2] += fx;
+      v[i * 2 + 1] += fy;
+    }
+  }
+}
+
+// Tiny random offset to separate coincident nodes (d3's jiggle)
+function jiggle(): number {
+  return (Math.random() - 0.5) * 1e-6;
+}
+
+// ---------------------------------------------------------------------------
+// Multilevel coarsening
+
+function buildLevels(finest: Level): Level[] {
+  const levels = [finest];
+  while (levels.length < MAX_LEVELS) {
+    const current = levels[levels.length - 1];
+    if (current.count <= COARSEST_SIZE) break;
+    const coarse = coarsen(current);
+    if (coarse.count > current.count * 0.9) {
+      delete current.parent;
+      break;
+    }
+    levels.push(coarse);
+  }
+  return levels;
+}
+
+/**
+ * Heavy-edge matching: each unmatched node merges with the unmatched neighbour it shares
+ * the most edges with. Nodes left without a partner pair up with the next leftover node in
+ * spatial order, so edge-sparse graphs still shrink.
+ */
+function coarsen(level: Level): Level {
+  const { count, edges, positions, weight } = level;
+  const m = edges.length / 2;
+
+  // CSR adjacency
+  const offsets = new Uint32Array(count + 1);
+  for (let e = 0; e < edges.length; e++) offsets[edges[e] + 1]++;
+  for (let i = 0; i < count; i++) offsets[i + 1] += offsets[i];
+  const cursor = offsets.slice(0, count);
+  const adjacency = new Uint32Array(m * 2);
+  for (let e = 0; e < m; e++) {
+    const s = edges[e * 2];
+    const t = edges[e * 2 + 1];
+    adjacency[cursor[s]++] = t;
+    adjacency[cursor[t]++] = s;
+  }
+
+  const parent = new Int32Array(count).fill(-1);
+  let coarseCount = 0;
+
+  // Low-degree nodes first, so hubs don't swallow every neighbour's best match
+  const order = Array.from({ length: count }, (_, i) => i).sort(
+    (a, b) => offsets[a + 1] - offsets[a] - (offsets[b + 1] - offsets[b])
+  );
+
+  const leftovers: number[] = [];
+  const tally = new Map<number, number>();
+
+  for (const u of order) {
+    if (parent[u] !== -1) continue;
+    tally.clear();
+    let best = -1;
+    let bestWeight = 0;
+    for (let k = offsets[u]; k < offsets[u + 1]; k++) {
+      const w = adjacency[k];
+      if (w === u || parent[w] !== -1) continue;
+      const total = (tally.get(w) ?? 0) + 1;
+      tally.set(w, total);
+      // Prefer light partners on ties, keeping coarse weights balanced
+      if (total > bestWeight || (total === bestWeight && weight[w] < weight[best])) {
+        best = w;
+        bestWeight = total;
+      }
+    }
+    if (best === -1) {
+      leftovers.push(u);
+      continue;
+    }
+    parent[u] = parent[best] = coarseCount++;
+  }
+
+  leftovers.sort((a, b) => positions[a * 2] - positions[b * 2] || positions[a * 2 + 1] - positions[b * 2 + 1]);
+  for (let i = 0; i < leftovers.length; i += 2) {
+    const c = coarseCount++;
+    parent[leftovers[i]] = c;
+    if (i + 1 < leftovers.length) parent[leftovers[i + 1]] = c;
+  }
+
+  const coarsePositions = new Float32Array(coarseCount * 2);
+  const coarseWeight = new Float32Array(coarseCount);
+  for (let i = 0; i < count; i++) {
+    const c = parent[i];
+    coarseWeight[c] += weight[i];
+    coarsePositions[c * 2] += positions[i * 2] * weight[i];
+    coarsePositions[c * 2 + 1] += positions[i * 2 + 1] * weight[i];
+  }
+  for (let c = 0; c < coarseCount; c++) {
+    coarsePositions[c * 2] /= coarseWeight[c];
+    coarsePositions[c * 2 + 1] /= coarseWeight[c];
+  }
+
+  // Collapse edges onto coarse nodes, dropping self-loops and duplicates
+  const seen = new Set<number>();
+  const coarseEdges: number[] = [];
+  for (let e = 0; e < m; e++) {
+    let a = parent[edges[e * 2]];
+    let b = parent[edges[e * 2 + 1]];
+    if (a === b) continue;
+    if (a > b) [a, b] = [b, a];
+    const key = a * coarseCount + b;
+    if (seen.has(key)) continue;
+    seen.add(key);
+    coarseEdges.push(a, b);
+  }
+
+  level.parent = parent;
+  return {
+    count: coarseCount,
+    positions: coarsePositions,
+    velocities: new Float32Array(coarseCount * 2),
+    edges: Uint32Array.from(coarseEdges),
+    fixed: null,
+    weight: coarseWeight,
+  };
+}
+
+/**
+ * Start each fine node at its coarse parent's position, spread slightly so siblings separate
+ */
+function prolong(coarse: Level, fine: Level, linkDistance: number) {
+  const spread = linkDistance * 0.25;
+  for (let i = 0; i < fine.count; i++) {
+    const c = fine.parent![i];
+    fine.positions[i * 2] = coarse.positions[c * 2] + (Math.random() - 0.5) * spread;
+    fine.positions[i * 2 + 1] = coarse.positions[c * 2 + 1] + (Math.random() - 0.5) * spread;
+    fine.velocities[i * 2] = 0;
+    fine.velocities[i * 2 + 1] = 0;
+  }
+}
@@ -0,0 +1,305 @@
+import type { Node } from '@/types/Node';
+import type { Edge } from '@/types/Edge';
+
+// Columnar binary "skeleton" of a workspace graph (client and server safe)
+// GET /api/workspaces/[id]/data?format=binary and /graph?format=binary answer with this instead
+// of JSON: one header, then one typed array per field, so decoding is a few array views
+// rather than parsing an object per row. Node content is left out except `type` and
+// `nodeMetadata` (what the canvas needs to draw the node); the rest is fetched afterwards
+// with POST /api/workspaces/[id]/content (lib/nodeContentLoader.ts). Until then a node's
+// content carries PARTIAL_CONTENT_KEY, and a content write built on it is merged into the
+// stored content instead of replacing it (PUT /api/nodes/update).
+//
+// Layout (little-endian, every section starts on an 8-byte boundary):
+//   u32 magic 'MFG1', u32 header byte length, header JSON (GraphPayloadHeader)
+//   nodes: ids, titles (string tables), x, y (f32), createdAt, updatedAt (f64 epoch ms),
+//          type (u32 index into header.types, NO_INDEX = none),
+//          tag offsets (u32, n + 1), tag indices (u32 into header.tags)
+//   edges: ids (string table), source, target (u32 index into the node id table),
+//          similarity (f32, NaN = none), labels (string table, '' = none), createdAt (f64)
+// String table: u32 count + 1 offsets (UTF-16 units) then the UTF-8 bytes of all strings
+// joined, prefixed by its u32 byte length - decoded with one TextDecoder call.
+
+export const GRAPH_PAYLOAD_CONTENT_TYPE = 'application/vnd.meshflow.graph';
+export const PARTIAL_CONTENT_KEY = '__partial';
+// Ids per POST /api/workspaces/[id]/content request
+export const MAX_CONTENT_NODES_PER_REQUEST = 500;
+
+const MAGIC = 0x3147464d; // 'MFG1'
+const NO_INDEX = 0xffffffff;
+
+export interface GraphPayloadHeader {
+  workspaceId: string;
+  version: number;
+  nodeCount: number;
+  edgeCount: number;
+  types: string[];
+  tags: string[];
+  // nodeMetadata by node index, only for nodes that have it
+  metadata: Record<number, unknown>;
+  // Anything else the route wants to send along (the /data workspace info)
+  extra?: Record<string, unknown>;
+}
+
+export interface SkeletonNodeRow {
+  id: string;
+  title: string;
+  tags: string[];
+  x: number;
+  y: number;
+  type: string | null;
+  nodeMetadata: unknown;
+  createdAt: Date;
+  updatedAt: Date;
+}
+
+export interface SkeletonEdgeRow {
+  id: string;
+  source: string;
+  target: string;
+  label: string | null;
+  similarity: number | null;
+  createdAt: Date;
+}
+
+class PayloadWriter {
+  private chunks: Uint8Array[] = [];
+  length = 0;
+
+  private push(bytes: Uint8Array) {
+    this.chunks.push(bytes);
+    this.length += bytes.byteLength;
+    const padding = (8 - (this.length % 8)) % 8;
+    if (padding) {
+      this.chunks.push(new Uint8Array(padding));
+      this.length += padding;
+    }
+  }
+
+  u32(values: ArrayLike<number>) {
+    this.push(new Uint8Array(Uint32Array.from(values).buffer));
+  }
+
+  f32(values: ArrayLike<number>) {
+    this.push(new Uint8Array(Float32Array.from(values).buffer));
+  }
+
+  f64(values: ArrayLike<number>) {
+    this.push(new Uint8Array(Float64Array.from(values).buffer));
+  }
+
+  strings(values: string[]) {
+    const offsets = new Uint32Array(values.length + 1);
+    for (let i = 0; i < values.length; i++) offsets[i + 1] = offsets[i] + values[i].length;
+    const bytes = new TextEncoder().encode(values.join(''));
+    this.push(new Uint8Array(offsets.buffer));
+    this.u32([bytes.byteLength]);
+    this.push(bytes);
+  }
+
+  bytes(value: Uint8Array) {
+    this.push(value);
+  }
+
+  finish(): Uint8Array {
+    const out = new Uint8Array(this.length);
+    let offset = 0;
+    for (const chunk of this.chunks) {
+      out.set(chunk, offset);
+      offset += chunk.byteLength;
+    }
+    return out;
+  }
+}
+
+/**
+ * Encode a graph skeleton. Edges whose endpoints aren't among `nodes` are dropped (rows read
+ * while a node was being added - the next delta sync brings both).
+ * Typed arrays are written in the platform's byte order; every supported platform is
+ * little-endian.
+ */
+export function encodeGraphPayload(
+  payload: { workspaceId: string; version: number; nodes: SkeletonNodeRow[]; edges: SkeletonEdgeRow[] },
+  extra?: Record<string, unknown>
+): Uint8Array {
+  const { nodes } = payload;
+  const index = new Map<string, number>();
+  nodes.forEach((node, i) => index.set(node.id, i));
+  const edges = payload.edges.filter((edge) => index.has(edge.source) && index.has(edge.target));
+
+  const types: string[] = [];
+  const typeIndex = new Map<string, number>();
+  const tags: string[] = [];
+  const tagIndex = new Map<string, number>();
+  const intern = (value: string, list: string[], lookup: Map<string, number>) => {
+    let i = lookup.get(value);
+    if (i === undefined) {
+      i = list.length;
+      list.push(value);
+      lookup.set(value, i);
+    }
+    return i;
+  };
+
+  const nodeTypes = new Uint32Array(nodes.length);
+  const tagOffsets = new Uint32Array(nodes.length + 1);
+  const tagIndices: number[] = [];
+  const metadata: Record<number, unknown> = {};
+  nodes.forEach((node, i) => {
+    nodeTypes[i] = node.type ? intern(node.type, types, typeIndex) : NO_INDEX;
+    for (const tag of node.tags || []) tagIndices.push(intern(tag, tags, tagIndex));
+    tagOffsets[i + 1] = tagIndices.length;
+    if (node.nodeMetadata !== null && node.nodeMetadata !== undefined) metadata[i] = node.nodeMetadata;
+  });
+
+  const header: GraphPayloadHeader = {
+    workspaceId: payload.workspaceId,
+    version: payload.version,
+    nodeCount: nodes.length,
+    edgeCount: edges.length,
+    types,
+    tags,
+    metadata,
+    ...(extra ? { extra } : {}),
+  };
+  const headerBytes = new TextEncoder().encode(JSON.stringify(header));
+
+  const writer = new PayloadWriter();
+  writer.u32([MAGIC, headerBytes.byteLength]);
+  writer.bytes(headerBytes);
+
+  writer.strings(nodes.map((node) => node.id));
+  writer.strings(nodes.map((node) => node.title || ''));
+  writer.f32(nodes.map((node) => node.x ?? 0));
+  writer.f32(nodes.map((node) => node.y ?? 0));
+  writer.f64(nodes.map((node) => node.createdAt.getTime()));
+  writer.f64(nodes.map((node) => node.updatedAt.getTime()));
+  writer.u32(nodeTypes);
+  writer.u32(tagOffsets);
+  writer.u32(tagIndices);
+
+  writer.strings(edges.map((edge) => edge.id));
+  writer.u32(edges.map((edge) => index.get(edge.source)!));
+  writer.u32(edges.map((edge) => index.get(edge.target)!));
+  writer.f32(edges.map((edge) => edge.similarity ?? NaN));
+  writer.strings(edges.map((edge) => edge.label || ''));
+  writer.f64(edges.map((edge) => edge.createdAt.getTime()));
+
+  return writer.finish();
+}
+
+class PayloadReader {
+  private offset = 0;
+
+  constructor(private buffer: ArrayBuffer, private byteOffset: number, private byteLength: number) {}
+
+  private take(bytes: number): number {
+    const start = this.offset;
+    if (start + bytes > this.byteLength) throw new Error('Truncated graph payload');
+    this.offset = start + bytes + ((8 - (bytes % 8)) % 8);
+    return this.byteOffset + start;
+  }
+
+  u32(count: number): Uint32Array {
+    return new Uint32Array(this.buffer, this.take(count * 4), count);
+  }
+
+  f32(count: number): Float32Array {
+    return new Float32Array(this.buffer, this.take(count * 4), count);
+  }
+
+  f64(count: number): Float64Array {
+    return new Float64Array(this.buffer, this.take(count * 8), count);
+  }
+
+  bytes(count: number): Uint8Array {
+    return new Uint8Array(this.buffer, this.take(count), count);
+  }
+
+  strings(count: number): string[] {
+    const offsets = this.u32(count + 1);
+    const [byteLength] = this.u32(1);
+    const joined = new TextDecoder().decode(this.bytes(byteLength));
+    const values = new Array<string>(count);
+    for (let i = 0; i < count; i++) values[i] = joined.slice(offsets[i], offsets[i + 1]);
+    return values;
+  }
+}
+
+/**
+ * Decode a graph skeleton into store nodes and edges; node content is partial (see above)
+ */
+export function decodeGraphPayload(data: ArrayBuffer | Uint8Array): {
+  header: GraphPayloadHeader;
+  nodes: Node[];
+  edges: Edge[];
+} {
+  // Typed array views need 4/8-byte aligned offsets - copy if the view isn't
+  const bytes = data instanceof Uint8Array ? data : new Uint8Array(data);
+  const aligned = bytes.byteOffset % 8 === 0 ? bytes : bytes.slice();
+  const reader = new PayloadReader(aligned.buffer as ArrayBuffer, aligned.byteOffset, aligned.byteLength);
+
+  const [magic, headerLength] = reader.u32(2);
+  if (magic !== MAGIC) throw new Error('Not a graph payload');
+  const header: GraphPayloadHeader = JSON.parse(new TextDecoder().decode(reader.bytes(headerLength)));
+  const { nodeCount: n, edgeCount: m, workspaceId } = header;
+
+  const ids = reader.strings(n);
+  const titles = reader.strings(n);
+  const xs = reader.f32(n);
+  const ys = reader.f32(n);
+  const created = reader.f64(n);
+  const updated = reader.f64(n);
+  const types = reader.u32(n);
+  const tagOffsets = reader.u32(n + 1);
+  const tagIndices = reader.u32(tagOffsets[n]);
+
+  const nodes = new Array<Node>(n);
+  for (let i = 0; i < n; i++) {
+    const content: Record<string, unknown> = { [PARTIAL_CONTENT_KEY]: true };
+    if (types[i] !== NO_INDEX) content.type = header.types[types[i]];
+    if (header.metadata[i] !== undefined) content.nodeMetadata = header.metadata[i];
+    const tags: string[] = [];
+    for (let t = tagOffsets[i]; t < tagOffsets[i + 1]; t++) tags.push(header.tags[tagIndices[t]]);
+    nodes[i] = {
+      id: ids[i],
+      workspaceId,
+      title: titles[i],
+      content,
+      tags,
+      x: xs[i],
+      y: ys[i],
+      createdAt: new Date(created[i]).toISOString(),
+      updatedAt: new Date(updated[i]).toISOString(),
+    };
+  }
+
+  const edgeIds = reader.strings(m);
+  const sources = reader.u32(m);
+  const targets = reader.u32(m);
+  const similarities = reader.f32(m);
+  const labels = reader.strings(m);
+  const edgeCreated = reader.f64(m);
+
+  const edges = new Array<Edge>(m);
+  for (let i = 0; i < m; i++) {
+    edges[i] = {
+      id: edgeIds[i],
+      workspaceId,
+      source: ids[sources[i]],
+      target: ids[targets[i]],
+      label: labels[i] || undefined,
+      similarity: Number.isNaN(similarities[i]) ? undefined : similarities[i],
+      createdAt: new Date(edgeCreated[i]).toISOString(),
+    };
+  }
+
+  return { header, nodes, edges };
+}
+
+/**
+ * True while a node's content is still the skeleton's partial copy
+ */
+export function isPartialContent(content: unknown): boolean {
+  return typeof content === 'object' && content !== null && (content as Record<string, unknown>)[PARTIAL_CONTENT_KEY] === true;
+}
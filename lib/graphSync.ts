@@ -0,0 +1,197 @@
+import { prisma } from './db';
+import { Prisma } from '@prisma/client';
+import type { Node } from '@/types/Node';
+import type { Edge } from '@/types/Edge';
+import type { WorkspaceGraphDelta } from '@/types/Workspace';
+import type { SkeletonEdgeRow, SkeletonNodeRow } from './graphPayload';
+
+// Server-only helpers for versioned graph sync
+// Versions are maintained by the triggers in prisma/sql/graph_versioning.sql
+
+// Tombstones older than this are pruned; clients further behind get `reset: true`
+const TOMBSTONE_RETENTION_MS = 7 * 24 * 60 * 60 * 1000;
+
+export const nodeSyncSelect = {
+  id: true,
+  workspaceId: true,
+  title: true,
+  content: true,
+  tags: true,
+  x: true,
+  y: true,
+  createdAt: true,
+  updatedAt: true,
+} satisfies Prisma.NodeSelect;
+
+export const edgeSyncSelect = {
+  id: true,
+  workspaceId: true,
+  source: true,
+  target: true,
+  label: true,
+  similarity: true,
+  createdAt: true,
+} satisfies Prisma.EdgeSelect;
+
+type SyncNodeRow = Prisma.NodeGetPayload<{ select: typeof nodeSyncSelect }>;
+type SyncEdgeRow = Prisma.EdgeGetPayload<{ select: typeof edgeSyncSelect }>;
+
+// Prisma already returns content as plain JSON - no need to re-serialize it
+export function serializeNode(node: SyncNodeRow): Node {
+  return {
+    id: node.id,
+    workspaceId: node.workspaceId,
+    title: node.title || '',
+    content: node.content ?? {},
+    tags: node.tags || [],
+    x: node.x ?? 0,
+    y: node.y ?? 0,
+    createdAt: node.createdAt.toISOString(),
+    updatedAt: node.updatedAt.toISOString(),
+  };
+}
+
+export function serializeEdge(edge: SyncEdgeRow): Edge {
+  return {
+    id: edge.id,
+    workspaceId: edge.workspaceId,
+    source: edge.source,
+    target: edge.target,
+    label: edge.label ?? undefined,
+    similarity: edge.similarity ?? undefined,
+    createdAt: edge.createdAt.toISOString(),
+  };
+}
+
+/**
+ * Read a whole workspace graph for the binary skeleton (lib/graphPayload.ts)
+ * Only content.type and content.nodeMetadata leave the database - the rest of the
+ * content is what makes the JSON load heavy, and the client fetches it lazily
+ */
+export async function getGraphSkeleton(
+  workspaceId: string
+): Promise<{ nodes: SkeletonNodeRow[]; edges: SkeletonEdgeRow[] }> {
+  const [nodes, edges] = await Promise.all([
+    prisma.$queryRaw<SkeletonNodeRow[]>`
+      SELECT id, title, tags, x, y,
+             content->>'type' AS "type",
+             content->'nodeMetadata' AS "nodeMetadata",
+             created_at AS "createdAt", updated_at AS "updatedAt"
+      FROM nodes
+      WHERE workspace_id = ${workspaceId}
+      ORDER BY created_at DESC
+    `,
+    prisma.edge.findMany({
+      where: { workspaceId },
+      select: { id: true, source: true, target: true, label: true, similarity: true, createdAt: true },
+    }),
+  ]);
+  return { nodes, edges };
+}
+
+/**
+ * Get everything that changed in a workspace graph after `since`
+ * Runs in a REPEATABLE READ transaction so the version and the rows come from one snapshot
+ */
+export async function getGraphDelta(
+  workspaceId: string,
+  since: number
+): Promise<WorkspaceGraphDelta | null> {
+  return prisma.$transaction(
+    async (tx) => {
+      const workspace = await tx.workspace.findUnique({
+        where: { id: workspaceId },
+        select: { graphVersion: true, tombstoneFloor: true },
+      });
+
+      if (!workspace) return null;
+
+      const version = workspace.graphVersion;
+
+      // Client is ahead of us (database reset) or behind pruned tombstones
+      if (since > version || since < workspace.tombstoneFloor) {
+        return {
+          version,
+          since,
+          reset: true,
+          nodes: [],
+          edges: [],
+          deletedNodeIds: [],
+          deletedEdgeIds: [],
+        };
+      }
+
+      if (since === version) {
+        return {
+          version,
+          since,
+          reset: false,
+          nodes: [],
+          edges: [],
+          deletedNodeIds: [],
+          deletedEdgeIds: [],
+        };
+      }
+
+      const [nodes, edges, tombstones] = await Promise.all([
+        tx.node.findMany({
+          where: { workspaceId, version: { gt: since } },
+          select: nodeSyncSelect,
+        }),
+        tx.edge.findMany({
+          where: { workspaceId, version: { gt: since } },
+          select: edgeSyncSelect,
+        }),
+        tx.graphTombstone.findMany({
+          where: { workspaceId, version: { gt: since } },
+          select: { entityType: true, entityId: true },
+        }),
+      ]);
+
+      // A node/edge deleted and re-created with the same id is still present - don't delete it
+      const liveNodeIds = new Set(nodes.map((n) => n.id));
+      const liveEdgeIds = new Set(edges.map((e) => e.id));
+
+      return {
+        version,
+        since,
+        reset: false,
+        nodes: nodes.map(serializeNode),
+        edges: edges.map(serializeEdge),
+        deletedNodeIds: tombstones
+          .filter((t) => t.entityType === 'node' && !liveNodeIds.has(t.entityId))
+          .map((t) => t.entityId),
+        deletedEdgeIds: tombstones
+          .filter((t) => t.entityType === 'edge' && !liveEdgeIds.has(t.entityId))
+          .map((t) => t.entityId),
+      };
+    },
+    { isolationLevel: Prisma.TransactionIsolationLevel.RepeatableRead }
+  );
+}
+
+/**
+ * Drop old tombstones and raise the workspace floor so stale delta clients resync
+ * Cheap no-op when there is nothing to prune - safe to call on full loads
+ */
+export async function pruneGraphTombstones(workspaceId: string): Promise<void> {
+  const cutoff = new Date(Date.now() - TOMBSTONE_RETENTION_MS);
+
+  const newest = await prisma.graphTombstone.findFirst({
+    where: { workspaceId, createdAt: { lt: cutoff } },
+    orderBy: { version: 'desc' },
+    select: { version: true },
+  });
+
+  if (!newest) return;
+
+  await prisma.$transaction([
+    prisma.graphTombstone.deleteMany({
+      where: { workspaceId, version: { lte: newest.version } },
+    }),
+    prisma.workspace.update({
+      where: { id: workspaceId },
+      data: { tombstoneFloor: newest.version },
+    }),
+  ]);
+}
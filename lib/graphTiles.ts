@@ -0,0 +1,77 @@
+import { prisma } from './db';
+import type { Node } from '@/types/Node';
+import type { Edge } from '@/types/Edge';
+import { edgeSyncSelect, nodeSyncSelect, serializeEdge, serializeNode } from './graphSync';
+import { TILE_SIZE, tileKey, tileRect, type TileCoord, type TileSummary } from './viewportTiles';
+
+// Server-only spatial queries over the tile grid (lib/viewportTiles.ts)
+// Backed by the (workspace_id, x, y) index on nodes: a tile is one index range scan
+
+/**
+ * Node count and centroid of every non-empty tile in a workspace
+ */
+export async function getTileSummaries(workspaceId: string): Promise<TileSummary[]> {
+  const rows = await prisma.$queryRaw<
+    Array<{ tx: number; ty: number; count: number; cx: number; cy: number }>
+  >`
+    SELECT floor(x / ${TILE_SIZE})::int AS tx,
+           floor(y / ${TILE_SIZE})::int AS ty,
+           COUNT(*)::int AS count,
+           AVG(x) AS cx,
+           AVG(y) AS cy
+    FROM nodes
+    WHERE workspace_id = ${workspaceId}
+    GROUP BY 1, 2
+  `;
+
+  return rows.map((row) => ({
+    key: tileKey(row.tx, row.ty),
+    tx: row.tx,
+    ty: row.ty,
+    count: Number(row.count),
+    cx: Number(row.cx),
+    cy: Number(row.cy),
+  }));
+}
+
+/**
+ * Nodes inside the given tiles, and every edge touching one of them
+ * Edges may point at nodes in tiles the client has not loaded; it keeps them and only
+ * renders an edge once both ends are present
+ */
+export async function getTileGraph(
+  workspaceId: string,
+  tiles: TileCoord[]
+): Promise<{ nodes: Node[]; edges: Edge[] }> {
+  if (tiles.length === 0) return { nodes: [], edges: [] };
+
+  const nodes = await prisma.node.findMany({
+    where: {
+      workspaceId,
+      OR: tiles.map((tile) => {
+        const rect = tileRect(tile);
+        return {
+          x: { gte: rect.minX, lt: rect.maxX },
+          y: { gte: rect.minY, lt: rect.maxY },
+        };
+      }),
+    },
+    select: nodeSyncSelect,
+  });
+
+  if (nodes.length === 0) return { nodes: [], edges: [] };
+
+  const ids = nodes.map((node) => node.id);
+  const edges = await prisma.edge.findMany({
+    where: {
+      workspaceId,
+      OR: [{ source: { in: ids } }, { target: { in: ids } }],
+    },
+    select: edgeSyncSelect,
+  });
+
+  return {
+    nodes: nodes.map(serializeNode),
+    edges: edges.map(serializeEdge),
+  };
+}
@@ -0,0 +1,302 @@
+import { randomUUID } from 'crypto';
+import { hostname } from 'os';
+import { prisma } from './db';
+
+// Server-only durable job queue backed by the background_jobs table
+// - jobs survive restarts and are shared by every server instance / worker process
+// - claims use FOR UPDATE SKIP LOCKED, so concurrent workers never run the same job
+// - a running job re-stamps its lock every HEARTBEAT_MS; a job whose lock goes stale
+//   (worker crashed) is claimed again, and each claim gets a new lock token so a slow
+//   first run that finishes afterwards can't complete or fail the new one
+// - one row per dedupe key: repeated enqueues coalesce into a single pending job
+// - failures retry with exponential backoff up to maxAttempts
+// - enqueue refuses new keys once the backlog passes MAX_BACKLOG (backpressure)
+
+export type JobHandler = (payload: any, job: ClaimedJob) => Promise<void>;
+
+export interface ClaimedJob {
+  id: string;
+  type: string;
+  payload: any;
+  attempts: number;
+  maxAttempts: number;
+  lockToken: string;
+}
+
+export interface EnqueueOptions {
+  // Delay before the job may run - repeated enqueues push it back (debounce),
+  // but never further than MAX_COALESCE_DELAY_MS after the job was first queued
+  delayMs?: number;
+  maxAttempts?: number;
+}
+
+const MAX_BACKLOG = Number(process.env.JOB_QUEUE_MAX_BACKLOG) || 5000;
+const MAX_COALESCE_DELAY_MS = 30_000;
+const BACKLOG_CACHE_MS = 5000;
+const STALE_LOCK_MS = 5 * 60 * 1000; // Running jobs not re-stamped for this long are assumed crashed
+const HEARTBEAT_MS = 60 * 1000;
+const BASE_RETRY_DELAY_MS = 5000;
+const MAX_RETRY_DELAY_MS = 10 * 60 * 1000;
+
+const WORKER_CONCURRENCY = Number(process.env.JOB_WORKER_CONCURRENCY) || 4;
+const IDLE_POLL_MS = 2000;
+
+const handlers = new Map<string, JobHandler>();
+
+export function registerJobHandler(type: string, handler: JobHandler) {
+  handlers.set(type, handler);
+}
+
+// Approximate pending count, refreshed at most every BACKLOG_CACHE_MS
+let backlog = { count: 0, checkedAt: 0 };
+
+async function getBacklog(): Promise<number> {
+  if (Date.now() - backlog.checkedAt < BACKLOG_CACHE_MS) return backlog.count;
+  const count = await prisma.backgroundJob.count({ where: { status: 'pending' } });
+  backlog = { count, checkedAt: Date.now() };
+  return count;
+}
+
+/**
+ * Enqueue (or coalesce into) the job for `dedupeKey`
+ * If the job is pending its payload is replaced; if it is running it is marked dirty
+ * and runs again after the current attempt. Returns false when the queue is saturated
+ * and the key has no job yet - callers should treat the work as skipped, not failed.
+ */
+export async function enqueueJob(
+  type: string,
+  dedupeKey: string,
+  payload: Record<string, any>,
+  options: EnqueueOptions = {}
+): Promise<boolean> {
+  const delayMs = Math.min(options.delayMs ?? 0, MAX_COALESCE_DELAY_MS);
+  const runAt = new Date(Date.now() + delayMs);
+  const payloadJson = JSON.stringify(payload);
+
+  if ((await getBacklog()) >= MAX_BACKLOG) {
+    // Coalescing into an existing job adds no work, so it is always allowed
+    const coalesced = await prisma.$executeRaw`
+      UPDATE background_jobs
+      SET payload = ${payloadJson}::jsonb,
+          dirty = (status = 'running'),
+          updated_at = NOW()
+      WHERE dedupe_key = ${dedupeKey} AND status <> 'failed'
+    `;
+    if (coalesced === 0) {
+      console.warn('[jobQueue] Backlog full, dropping job:', { type, dedupeKey });
+    }
+    return coalesced > 0;
+  }
+
+  await prisma.$executeRaw`
+    INSERT INTO background_jobs
+      (id, type, dedupe_key, payload, status, max_attempts, run_at, created_at, updated_at)
+    VALUES
+      (${randomUUID()}, ${type}, ${dedupeKey}, ${payloadJson}::jsonb, 'pending',
+       ${options.maxAttempts ?? 5}, ${runAt}, NOW(), NOW())
+    ON CONFLICT (dedupe_key) DO UPDATE SET
+      type = EXCLUDED.type,
+      payload = EXCLUDED.payload,
+      dirty = (background_jobs.status = 'running'),
+      status = CASE WHEN background_jobs.status = 'running' THEN 'running' ELSE 'pending' END,
+      attempts = CASE WHEN background_jobs.status = 'failed' THEN 0 ELSE background_jobs.attempts END,
+      run_at = CASE
+        WHEN background_jobs.status = 'running' THEN background_jobs.run_at
+        WHEN background_jobs.status = 'failed' THEN EXCLUDED.run_at
+        ELSE LEAST(EXCLUDED.run_at, background_jobs.created_at + make_interval(secs => ${MAX_COALESCE_DELAY_MS / 1000}))
+      END,
+      last_error = CASE WHEN background_jobs.status = 'failed' THEN NULL ELSE background_jobs.last_error END,
+      updated_at = NOW()
+  `;
+
+  if (backlog.checkedAt > 0) backlog.count++;
+  startJobWorker();
+  wakeJobWorker();
+  return true;
+}
+
+/**
+ * Claim up to `limit` runnable jobs (pending and due, or running with a stale lock)
+ */
+export async function claimJobs(limit: number): Promise<ClaimedJob[]> {
+  const staleBefore = new Date(Date.now() - STALE_LOCK_MS);
+
+  const rows = await prisma.$queryRaw<Array<{
+    id: string;
+    type: string;
+    payload: any;
+    attempts: number;
+    max_attempts: number;
+    lock_token: string;
+  }>>`
+    UPDATE background_jobs AS j
+    SET status = 'running',
+        locked_at = NOW(),
+        lock_token = gen_random_uuid()::text,
+        attempts = j.attempts + 1,
+        dirty = false,
+        updated_at = NOW()
+    WHERE j.id IN (
+      SELECT id FROM background_jobs
+      WHERE (status = 'pending' AND run_at <= NOW())
+         OR (status = 'running' AND locked_at < ${staleBefore})
+      ORDER BY run_at
+      LIMIT ${limit}
+      FOR UPDATE SKIP LOCKED
+    )
+    RETURNING j.id, j.type, j.payload, j.attempts, j.max_attempts, j.lock_token
+  `;
+
+  return rows.map((row) => ({
+    id: row.id,
+    type: row.type,
+    payload: row.payload,
+    attempts: row.attempts,
+    maxAttempts: row.max_attempts,
+    lockToken: row.lock_token,
+  }));
+}
+
+// Keep a long-running job's lock fresh; returns the function that stops it
+function startHeartbeat(job: ClaimedJob): () => void {
+  const timer = setInterval(() => {
+    prisma.$executeRaw`
+      UPDATE background_jobs SET locked_at = NOW()
+      WHERE id = ${job.id} AND lock_token = ${job.lockToken}
+    `
+      .then((stamped) => {
+        if (stamped === 0) console.warn('[jobQueue] Lost lock on running job:', { id: job.id, type: job.type });
+      })
+      .catch((error: any) => console.warn('[jobQueue] Heartbeat failed:', error?.message));
+  }, HEARTBEAT_MS);
+  timer.unref?.();
+  return () => clearInterval(timer);
+}
+
+async function completeJob(job: ClaimedJob) {
+  const deleted = await prisma.$executeRaw`
+    DELETE FROM background_jobs
+    WHERE id = ${job.id} AND lock_token = ${job.lockToken} AND NOT dirty
+  `;
+  if (deleted > 0) return;
+
+  // Re-enqueued while running - run again with the latest payload
+  await prisma.$executeRaw`
+    UPDATE background_jobs
+    SET status = 'pending', attempts = 0, dirty = false, locked_at = NULL, lock_token = NULL,
+        run_at = NOW(), updated_at = NOW()
+    WHERE id = ${job.id} AND lock_token = ${job.lockToken}
+  `;
+}
+
+async function failJob(job: ClaimedJob, error: any) {
+  const message = String(error?.message || error).slice(0, 2000);
+  const delayMs = Math.min(BASE_RETRY_DELAY_MS * 2 ** (job.attempts - 1), MAX_RETRY_DELAY_MS);
+  const retryAt = new Date(Date.now() + delayMs);
+
+  // A dirty job has a newer payload, so it gets a fresh set of attempts
+  await prisma.$executeRaw`
+    UPDATE background_jobs
+    SET status = CASE WHEN attempts >= max_attempts AND NOT dirty THEN 'failed' ELSE 'pending' END,
+        attempts = CASE WHEN dirty THEN 0 ELSE attempts END,
+        dirty = false,
+        run_at = CASE WHEN dirty THEN NOW() ELSE ${retryAt} END,
+        locked_at = NULL,
+        lock_token = NULL,
+        last_error = ${message},
+        updated_at = NOW()
+    WHERE id = ${job.id} AND lock_token = ${job.lockToken}
+  `;
+}
+
+async function runJob(job: ClaimedJob) {
+  const handler = handlers.get(job.type);
+  const stopHeartbeat = startHeartbeat(job);
+
+  try {
+    if (!handler) {
+      throw new Error(`No handler registered for job type "${job.type}"`);
+    }
+    await handler(job.payload, job);
+    stopHeartbeat();
+    await completeJob(job);
+  } catch (error: any) {
+    stopHeartbeat();
+    console.warn('[jobQueue] Job failed:', {
+      id: job.id,
+      type: job.type,
+      attempt: job.attempts,
+      message: error?.message,
+    });
+    await failJob(job, error).catch((failError: any) => {
+      // The stale-lock reclaim picks the job up again later
+      console.error('[jobQueue] Failed to record job failure:', failError?.message);
+    });
+  }
+}
+
+/**
+ * Claim and run one round of jobs; returns how many ran
+ */
+export async function runJobsOnce(limit: number = WORKER_CONCURRENCY): Promise<number> {
+  const jobs = await claimJobs(limit);
+  await Promise.all(jobs.map(runJob));
+  return jobs.length;
+}
+
+// Worker loop - one per process, kept on globalThis so dev hot reloads don't start more
+const globalForJobs = globalThis as unknown as {
+  jobWorker: { running: boolean; wake: (() => void) | null } | undefined;
+};
+
+function wakeJobWorker() {
+  globalForJobs.jobWorker?.wake?.();
+}
+
+/**
+ * Start the in-process worker loop (idempotent)
+ * Set JOB_WORKER=off to disable it when jobs are run by scripts/job-worker.ts instead
+ */
+export function startJobWorker(): void {
+  if (globalForJobs.jobWorker) return;
+  if (process.env.JOB_WORKER === 'off') return;
+
+  const worker: { running: boolean; wake: (() => void) | null } = { running: true, wake: null };
+  globalForJobs.jobWorker = worker;
+  const workerId = `${hostname()}:${process.pid}`;
+
+  const loop = async () => {
+    console.log('[jobQueue] Worker started:', workerId);
+    while (worker.running) {
+      let ran = 0;
+      try {
+        ran = await runJobsOnce();
+      } catch (error: any) {
+        // Table missing or DB unavailable - back off and try again
+        console.warn('[jobQueue] Failed to claim jobs:', error?.message);
+      }
+
+      if (ran > 0) continue; // Keep draining while there is work
+
+      await new Promise<void>((resolve) => {
+        const timer = setTimeout(done, IDLE_POLL_MS);
+        function done() {
+          clearTimeout(timer);
+          worker.wake = null;
+          resolve();
+        }
+        worker.wake = done;
+      });
+    }
+  };
+
+  void loop();
+}
+
+export function stopJobWorker(): void {
+  const worker = globalForJobs.jobWorker;
+  if (!worker) return;
+  worker.running = false;
+  worker.wake?.();
+  globalForJobs.jobWorker = undefined;
+}
@@ -0,0 +1,89 @@
+// Minimal RFC 6902 JSON Patch - diff and apply for plain JSON values (client and server safe)
+// Only add / remove / replace are produced. Objects are diffed key by key; arrays of the same
+// length element by element, otherwise replaced whole (node content arrays are short, and a
+// shifted array would diff into as many ops as it has elements anyway).
+
+export type JsonPatchOp =
+  | { op: 'add'; path: string; value: unknown }
+  | { op: 'remove'; path: string }
+  | { op: 'replace'; path: string; value: unknown };
+
+function escapeToken(token: string): string {
+  return token.replace(/~/g, '~0').replace(/\//g, '~1');
+}
+
+function unescapeToken(token: string): string {
+  return token.replace(/~1/g, '/').replace(/~0/g, '~');
+}
+
+function isObject(value: unknown): value is Record<string, unknown> {
+  return typeof value === 'object' && value !== null && !Array.isArray(value);
+}
+
+function diffInto(before: unknown, after: unknown, path: string, ops: JsonPatchOp[]) {
+  if (before === after) return;
+
+  if (isObject(before) && isObject(after)) {
+    for (const key of Object.keys(before)) {
+      if (!(key in after)) ops.push({ op: 'remove', path: `${path}/${escapeToken(key)}` });
+    }
+    for (const key of Object.keys(after)) {
+      const childPath = `${path}/${escapeToken(key)}`;
+      if (!(key in before)) ops.push({ op: 'add', path: childPath, value: after[key] });
+      else diffInto(before[key], after[key], childPath, ops);
+    }
+    return;
+  }
+
+  if (Array.isArray(before) && Array.isArray(after) && before.length === after.length) {
+    for (let i = 0; i < after.length; i++) diffInto(before[i], after[i], `${path}/${i}`, ops);
+    return;
+  }
+
+  // Changed scalars, mismatched types and resized arrays are replaced whole
+  ops.push({ op: 'replace', path, value: after });
+}
+
+/**
+ * Ops that turn `before` into `after` (both plain JSON)
+ */
+export function diffJson(before: unknown, after: unknown): JsonPatchOp[] {
+  const ops: JsonPatchOp[] = [];
+  diffInto(before, after, '', ops);
+  return ops;
+}
+
+/**
+ * Apply ops to a JSON value; returns a new value and leaves `doc` untouched
+ */
+export function applyJsonPatch<T>(doc: T, ops: JsonPatchOp[]): T {
+  let root: unknown = structuredClone(doc);
+
+  for (const op of ops) {
+    if (op.path === '') {
+      root = op.op === 'remove' ? undefined : structuredClone(op.value);
+      continue;
+    }
+
+    const tokens = op.path.slice(1).split('/').map(unescapeToken);
+    const last = tokens.pop()!;
+    let parent: any = root;
+    for (const token of tokens) {
+      parent = Array.isArray(parent) ? parent[Number(token)] : parent?.[token];
+      if (parent === undefined || parent === null) throw new Error(`Invalid patch path: ${op.path}`);
+    }
+
+    if (Array.isArray(parent)) {
+      const index = last === '-' ? parent.length : Number(last);
+      if (op.op === 'add') parent.splice(index, 0, structuredClone(op.value));
+      else if (op.op === 'remove') parent.splice(index, 1);
+      else parent[index] = structuredClone(op.value);
+    } else if (op.op === 'remove') {
+      delete parent[last];
+    } else {
+      parent[last] = structuredClone(op.value);
+    }
+  }
+
+  return root as T;
+}
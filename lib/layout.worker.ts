@@ -0,0 +1,54 @@
+// Layout worker - runs lib/forceLayout.ts off the main thread
+// Protocol (see lib/layoutWorkerClient.ts):
+//   in:  { type: 'run', id, graph, options, progressEvery }   (position/edge buffers transferred)
+//        { type: 'cancel', id }
+//   out: { type: 'progress', id, positions, progress }        (a copy, transferred)
+//        { type: 'done', id, positions }                      (the input buffer, transferred back)
+//        { type: 'cancelled', id } | { type: 'error', id, error }
+
+import { ForceLayout, type ForceLayoutOptions, type LayoutGraph } from './forceLayout';
+
+interface WorkerScope {
+  onmessage: ((event: MessageEvent) => void) | null;
+  postMessage(message: any, transfer?: Transferable[]): void;
+}
+
+const ctx = self as unknown as WorkerScope;
+const cancelled = new Set<number>();
+
+// Yield to the event loop so 'cancel' messages are seen between chunks
+const yieldToEventLoop = () => new Promise<void>((resolve) => setTimeout(resolve, 0));
+
+async function run(id: number, graph: LayoutGraph, options: ForceLayoutOptions, progressEvery: number) {
+  try {
+    const layout = new ForceLayout(graph, options);
+
+    while (!layout.step(progressEvery)) {
+      const snapshot = layout.positions.slice();
+      ctx.postMessage({ type: 'progress', id, positions: snapshot, progress: layout.progress }, [
+        snapshot.buffer,
+      ]);
+
+      await yieldToEventLoop();
+      if (cancelled.has(id)) {
+        cancelled.delete(id);
+        ctx.postMessage({ type: 'cancelled', id });
+        return;
+      }
+    }
+
+    const positions = layout.positions;
+    ctx.postMessage({ type: 'done', id, positions }, [positions.buffer]);
+  } catch (error: any) {
+    ctx.postMessage({ type: 'error', id, error: error?.message || 'Layout failed' });
+  }
+}
+
+ctx.onmessage = (event: MessageEvent) => {
+  const message = event.data;
+  if (message?.type === 'run') {
+    run(message.id, message.graph, message.options || {}, message.progressEvery || 25);
+  } else if (message?.type === 'cancel') {
+    cancelled.add(message.id);
+  }
+};
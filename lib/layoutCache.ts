@@ -0,0 +1,364 @@
+import { randomUUID } from 'crypto';
+import { Prisma } from '@prisma/client';
+import { prisma } from './db';
+import { enqueueJob, registerJobHandler } from './jobQueue';
+import { runForceLayoutSync, toLayoutGraph } from './forceLayout';
+import {
+  INCREMENTAL_MAX_NEW_SHARE,
+  INCREMENTAL_RUN_OPTIONS,
+  hierarchicalLayout,
+  incrementalLayout,
+  radialLayout,
+} from './layoutEngine';
+
+// Server-only cache of computed layouts, stored as layout_presets rows
+// - one cached row per (workspace, layout type), keyed by workspaces.topology_version:
+//   moving nodes does not invalidate a layout, adding/removing nodes or edges does
+// - positions are packed little-endian float32 pairs in node_ids order
+// - force layouts recompute incrementally (incrementalLayout in lib/layoutEngine.ts):
+//   only new nodes and their neighbourhood move, the rest keep their cached positions;
+//   an edge-only change relaxes the cached layout instead of reusing it as is
+// - requests compute small graphs inline; larger ones run as a compute_layout job
+
+export const LAYOUT_TYPES = ['force', 'radial', 'hierarchical'] as const;
+export type LayoutType = (typeof LAYOUT_TYPES)[number];
+
+export function isLayoutType(value: unknown): value is LayoutType {
+  return typeof value === 'string' && (LAYOUT_TYPES as readonly string[]).includes(value);
+}
+
+export interface LayoutConfig {
+  // Center (radial) or root (hierarchical) node; defaults to the highest-degree node
+  rootId?: string;
+}
+
+export interface ComputedLayout {
+  type: LayoutType;
+  topologyVersion: number;
+  config: LayoutConfig;
+  nodeIds: string[];
+  positions: Float32Array;
+}
+
+// Same canvas as runForceLayout in lib/layout.ts
+const LAYOUT_WIDTH = 1200;
+const LAYOUT_HEIGHT = 800;
+
+// Requests compute layouts up to this size inline; larger ones go to the job queue
+export const INLINE_LAYOUT_MAX_NODES = 300;
+
+// Rows per statement when writing positions back to nodes
+const APPLY_CHUNK_SIZE = 500;
+
+const LAYOUT_JOB = 'compute_layout';
+
+interface ComputeLayoutPayload {
+  workspaceId: string;
+  userId: string;
+  type: LayoutType;
+  config: LayoutConfig;
+  // Write the positions to the nodes once computed (POST .../layout on a large graph)
+  apply?: boolean;
+}
+
+registerJobHandler(LAYOUT_JOB, async (payload: ComputeLayoutPayload) => {
+  const layout = await computeLayout(payload.workspaceId, payload.userId, payload.type, payload.config);
+  if (payload.apply && layout.nodeIds.length > 0) {
+    await applyLayout(payload.workspaceId, layout);
+  }
+});
+
+export function encodePositions(positions: Float32Array): Buffer {
+  const buffer = Buffer.allocUnsafe(positions.length * 4);
+  for (let i = 0; i < positions.length; i++) {
+    buffer.writeFloatLE(positions[i], i * 4);
+  }
+  return buffer;
+}
+
+export function decodePositions(bytes: Uint8Array): Float32Array {
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const positions = new Float32Array(Math.floor(bytes.byteLength / 4));
+  for (let i = 0; i < positions.length; i++) {
+    positions[i] = view.getFloat32(i * 4, true);
+  }
+  return positions;
+}
+
+function sameConfig(a: LayoutConfig, b: LayoutConfig): boolean {
+  return (a.rootId || null) === (b.rootId || null);
+}
+
+async function findCachedPreset(workspaceId: string, type: LayoutType) {
+  return prisma.layoutPreset.findFirst({
+    where: { workspaceId, layoutType: type, topologyVersion: { not: null } },
+    select: { topologyVersion: true, config: true, nodeIds: true, positions: true },
+  });
+}
+
+function presetToLayout(
+  type: LayoutType,
+  preset: NonNullable<Awaited<ReturnType<typeof findCachedPreset>>>
+): ComputedLayout | null {
+  if (!preset.positions || preset.topologyVersion === null) return null;
+  const positions = decodePositions(preset.positions);
+  if (positions.length !== preset.nodeIds.length * 2) return null;
+
+  return {
+    type,
+    topologyVersion: preset.topologyVersion,
+    config: (preset.config || {}) as LayoutConfig,
+    nodeIds: preset.nodeIds,
+    positions,
+  };
+}
+
+/**
+ * Cached layout for a workspace, and whether it matches the current graph topology
+ * Returns null when nothing (usable) is cached for this type and config
+ */
+export async function getCachedLayout(
+  workspaceId: string,
+  type: LayoutType,
+  config: LayoutConfig = {}
+): Promise<{ layout: ComputedLayout; fresh: boolean } | null> {
+  const [workspace, preset] = await Promise.all([
+    prisma.workspace.findUnique({ where: { id: workspaceId }, select: { topologyVersion: true } }),
+    findCachedPreset(workspaceId, type),
+  ]);
+  if (!workspace || !preset) return null;
+
+  const layout = presetToLayout(type, preset);
+  if (!layout || !sameConfig(layout.config, config)) return null;
+
+  return { layout, fresh: layout.topologyVersion === workspace.topologyVersion };
+}
+
+/**
+ * Compute a layout for the current graph and store it as the cached layout
+ * Force layouts reuse the previous cached positions when few nodes were added.
+ */
+export async function computeLayout(
+  workspaceId: string,
+  userId: string,
+  type: LayoutType,
+  config: LayoutConfig = {}
+): Promise<ComputedLayout & { incremental: boolean }> {
+  // Read the version before the graph: a change in between leaves the row stale, never wrong
+  const workspace = await prisma.workspace.findUnique({
+    where: { id: workspaceId },
+    select: { topologyVersion: true },
+  });
+  if (!workspace) throw new Error('Workspace not found');
+
+  const [nodes, edges, preset] = await Promise.all([
+    prisma.node.findMany({ where: { workspaceId }, select: { id: true, x: true, y: true } }),
+    prisma.edge.findMany({ where: { workspaceId }, select: { source: true, target: true } }),
+    findCachedPreset(workspaceId, type),
+  ]);
+
+  const previous = preset ? presetToLayout(type, preset) : null;
+  let positions: Float32Array;
+  let incremental = false;
+
+  if (type === 'force') {
+    const result = computeForceLayout(nodes, edges, previous);
+    positions = result.positions;
+    incremental = result.incremental;
+  } else {
+    const root = pickRoot(nodes, edges, config.rootId);
+    const map = !root
+      ? new Map<string, { x: number; y: number }>()
+      : type === 'radial'
+        ? radialLayout(root, nodes)
+        : hierarchicalLayout(nodes, edges, root.id, LAYOUT_WIDTH, LAYOUT_HEIGHT);
+
+    positions = new Float32Array(nodes.length * 2);
+    nodes.forEach((node, i) => {
+      const position = map.get(node.id) || node;
+      positions[i * 2] = position.x;
+      positions[i * 2 + 1] = position.y;
+    });
+  }
+
+  const layout: ComputedLayout = {
+    type,
+    topologyVersion: workspace.topologyVersion,
+    config,
+    nodeIds: nodes.map((node) => node.id),
+    positions,
+  };
+
+  await storeLayout(workspaceId, userId, layout);
+  return { ...layout, incremental };
+}
+
+function computeForceLayout(
+  nodes: Array<{ id: string; x: number; y: number }>,
+  edges: Array<{ source: string; target: string }>,
+  previous: ComputedLayout | null
+): { positions: Float32Array; incremental: boolean } {
+  const center = { centerX: LAYOUT_WIDTH / 2, centerY: LAYOUT_HEIGHT / 2 };
+
+  const cached = new Map<string, { x: number; y: number }>();
+  previous?.nodeIds.forEach((id, i) => {
+    cached.set(id, { x: previous.positions[i * 2], y: previous.positions[i * 2 + 1] });
+  });
+
+  const known = nodes.filter((node) => cached.has(node.id)).length;
+  const added = nodes.length - known;
+  const removed = previous ? previous.nodeIds.length - known : 0;
+
+  if (known === 0 || added > nodes.length * INCREMENTAL_MAX_NEW_SHARE) {
+    const { graph } = toLayoutGraph(nodes, edges, center);
+    return { positions: runForceLayoutSync(graph, center), incremental: false };
+  }
+
+  if (added === 0 && removed === 0) {
+    // Same nodes, so the topology change was edges: a short cool run from the cached
+    // positions pulls newly linked nodes together without redoing the whole layout
+    const warm = nodes.map((node) => ({ id: node.id, ...cached.get(node.id)! }));
+    const { graph } = toLayoutGraph(warm, edges, center);
+    return { positions: runForceLayoutSync(graph, { ...INCREMENTAL_RUN_OPTIONS, ...center }), incremental: true };
+  }
+
+  if (added === 0) {
+    // Only removals (their edges went with them) - the remaining nodes keep their positions
+    const positions = new Float32Array(nodes.length * 2);
+    nodes.forEach((node, i) => {
+      const position = cached.get(node.id)!;
+      positions[i * 2] = position.x;
+      positions[i * 2 + 1] = position.y;
+    });
+    return { positions, incremental: true };
+  }
+
+  // Relax the new nodes and their neighbourhood around the pinned cached layout
+  const merged = nodes.map((node) => ({ id: node.id, ...(cached.get(node.id) || node) }));
+  const moved = incrementalLayout(
+    merged,
+    edges,
+    new Set(nodes.filter((node) => !cached.has(node.id)).map((node) => node.id)),
+    center
+  );
+
+  const positions = new Float32Array(nodes.length * 2);
+  merged.forEach((node, i) => {
+    const position = moved.get(node.id) || node;
+    positions[i * 2] = position.x;
+    positions[i * 2 + 1] = position.y;
+  });
+  return { positions, incremental: true };
+}
+
+// Requested node if present, otherwise the best-connected one
+function pickRoot<T extends { id: string }>(
+  nodes: T[],
+  edges: Array<{ source: string; target: string }>,
+  rootId?: string
+): T | undefined {
+  if (rootId) {
+    const root = nodes.find((node) => node.id === rootId);
+    if (root) return root;
+  }
+
+  const degree = new Map<string, number>();
+  for (const edge of edges) {
+    degree.set(edge.source, (degree.get(edge.source) || 0) + 1);
+    degree.set(edge.target, (degree.get(edge.target) || 0) + 1);
+  }
+
+  let best = nodes[0];
+  let bestDegree = -1;
+  for (const node of nodes) {
+    const d = degree.get(node.id) || 0;
+    if (d > bestDegree) {
+      best = node;
+      bestDegree = d;
+    }
+  }
+  return best;
+}
+
+// Upsert into the partial unique index; an older result never replaces a newer one
+async function storeLayout(workspaceId: string, userId: string, layout: ComputedLayout) {
+  await prisma.$executeRaw`
+    INSERT INTO layout_presets
+      (id, workspace_id, user_id, name, layout_type, config, topology_version, node_ids, positions,
+       created_at, updated_at)
+    VALUES
+      (${randomUUID()}, ${workspaceId}, ${userId}, ${`Computed ${layout.type} layout`}, ${layout.type},
+       ${JSON.stringify(layout.config)}::jsonb, ${layout.topologyVersion}, ${layout.nodeIds}::text[],
+       ${encodePositions(layout.positions)}, NOW(), NOW())
+    ON CONFLICT (workspace_id, layout_type) WHERE topology_version IS NOT NULL DO UPDATE SET
+      user_id = EXCLUDED.user_id,
+      config = EXCLUDED.config,
+      topology_version = EXCLUDED.topology_version,
+      node_ids = EXCLUDED.node_ids,
+      positions = EXCLUDED.positions,
+      updated_at = NOW()
+    WHERE layout_presets.topology_version <= EXCLUDED.topology_version
+  `;
+}
+
+/**
+ * Queue a layout computation (coalesces per workspace and type)
+ */
+export async function enqueueLayoutComputation(
+  workspaceId: string,
+  userId: string,
+  type: LayoutType,
+  config: LayoutConfig = {},
+  options: { apply?: boolean } = {}
+): Promise<boolean> {
+  const payload: ComputeLayoutPayload = { workspaceId, userId, type, config, apply: options.apply };
+  // Separate key for apply jobs, so a plain recompute can't replace one and drop the write
+  const dedupeKey = `${LAYOUT_JOB}:${workspaceId}:${type}${options.apply ? ':apply' : ''}`;
+  try {
+    return await enqueueJob(LAYOUT_JOB, dedupeKey, payload);
+  } catch (error: any) {
+    console.warn('[layoutCache] Failed to enqueue layout job (continuing):', error?.message);
+    return false;
+  }
+}
+
+/**
+ * Write layout positions to the nodes, skipping rows already in place
+ * Rows that no longer exist are ignored. Returns the number of nodes moved.
+ */
+export async function applyLayout(workspaceId: string, layout: ComputedLayout): Promise<number> {
+  let moved = 0;
+
+  for (let start = 0; start < layout.nodeIds.length; start += APPLY_CHUNK_SIZE) {
+    const end = Math.min(start + APPLY_CHUNK_SIZE, layout.nodeIds.length);
+    const rows: Prisma.Sql[] = [];
+    for (let i = start; i < end; i++) {
+      rows.push(
+        Prisma.sql`(${layout.nodeIds[i]}, ${layout.positions[i * 2]}::float8, ${layout.positions[i * 2 + 1]}::float8)`
+      );
+    }
+
+    moved += await prisma.$executeRaw`
+      UPDATE nodes AS n
+      SET x = v.x, y = v.y, updated_at = NOW()
+      FROM (VALUES ${Prisma.join(rows)}) AS v(id, x, y)
+      WHERE n.id = v.id
+        AND n.workspace_id = ${workspaceId}
+        AND (n.x, n.y) IS DISTINCT FROM (v.x, v.y)
+    `;
+  }
+
+  return moved;
+}
+
+/**
+ * JSON form for API responses - positions as base64 of the packed float32 bytes
+ */
+export function serializeLayout(layout: ComputedLayout) {
+  return {
+    type: layout.type,
+    topologyVersion: layout.topologyVersion,
+    nodeIds: layout.nodeIds,
+    positions: encodePositions(layout.positions).toString('base64'),
+  };
+}
@@ -1,80 +1,208 @@
 import type { Node } from '@/types/Node';
 import type { Edge } from '@/types/Edge';
-import * as d3 from 'd3-force';
+import {
+  positionsToMap,
+  runForceLayoutSync,
+  toLayoutGraph,
+  type ForceLayoutOptions,
+  type LayoutGraph,
+} from './forceLayout';
 
 interface Position {
   x: number;
   y: number;
 }
 
-interface LayoutNode extends d3.SimulationNodeDatum {
-  id: string;
-  x: number;
-  y: number;
-}
+// Layouts only read ids, positions and endpoints - callers can pass lean rows
+type LayoutInputNode = Pick<Node, 'id' | 'x' | 'y'>;
+type LayoutInputEdge = Pick<Edge, 'source' | 'target'>;
 
 /**
- * Force-directed layout using D3
+ * Force-directed layout (Barnes-Hut engine in lib/forceLayout.ts)
+ * Runs on the calling thread - prefer runLayout from lib/layoutWorkerClient.ts in the browser
  */
 export function forceDirectedLayout(
-  nodes: Node[],
-  edges: Edge[],
+  nodes: LayoutInputNode[],
+  edges: LayoutInputEdge[],
   width: number = 1000,
   height: number = 800,
   iterations: number = 300
 ): Map<string, Position> {
-  const nodeMap = new Map<string, LayoutNode>();
-
-  // Initialize nodes
-  nodes.forEach(node => {
-    nodeMap.set(node.id, {
-      id: node.id,
-      x: node.x || width / 2 + (Math.random() - 0.5) * 400,
-      y: node.y || height / 2 + (Math.random() - 0.5) * 400,
-      vx: 0,
-      vy: 0,
-    });
+  const { graph, ids } = toLayoutGraph(nodes, edges, { centerX: width / 2, centerY: height / 2 });
+  const positions = runForceLayoutSync(graph, {
+    iterations,
+    centerX: width / 2,
+    centerY: height / 2,
   });
+  return positionsToMap(ids, positions);
+}
+
+export interface IncrementalLayoutOptions extends ForceLayoutOptions {
+  // Existing nodes within this many edges of a new node are relaxed too
+  hops?: number;
+  // Pinned nodes within this distance of the relaxed region take part in repulsion/collision
+  margin?: number;
+}
+
+const INCREMENTAL_DEFAULTS = { hops: 1, margin: 300 };
+
+// Beyond this share of new nodes a full layout beats fitting them into the old one
+export const INCREMENTAL_MAX_NEW_SHARE = 0.3;
 
-  // Create D3 simulation
-  const simulation = d3
-    .forceSimulation(Array.from(nodeMap.values()))
-    .force(
-      'link',
-      d3
-        .forceLink(edges.map(e => ({ source: e.source, target: e.target })))
-        .id((d: any) => d.id)
-        .distance(150)
-        .strength(0.5)
-    )
-    .force('charge', d3.forceManyBody().strength(-300))
-    .force('center', d3.forceCenter(width / 2, height / 2))
-    .force('collision', d3.forceCollide().radius(50))
-    .stop();
-
-  // Run simulation
-  for (let i = 0; i < iterations; i++) {
-    simulation.tick();
+// Short, cool run - the rest of the graph is already settled
+export const INCREMENTAL_RUN_OPTIONS: ForceLayoutOptions = { iterations: 120, alpha: 0.3, multilevel: false };
+// New nodes placed beside their neighbours are spread by up to this much
+const SEED_JITTER = 100;
+
+/**
+ * Pack the local subgraph an incremental layout simulates
+ * Movable: the new nodes and their `hops`-neighbourhood. Pinned (fixed): the nodes one
+ * step further out, and everything else near the movable region. The rest of the graph
+ * is left out entirely, so the cost follows the size of the change, not the workspace.
+ * New nodes without a position start at the centre of their already placed neighbours.
+ * Returns null when no node is new.
+ */
+export function buildIncrementalGraph(
+  nodes: LayoutInputNode[],
+  edges: LayoutInputEdge[],
+  newIds: Set<string>,
+  options: IncrementalLayoutOptions = {}
+): { graph: LayoutGraph; ids: string[]; movable: Set<string> } | null {
+  const { hops, margin } = { ...INCREMENTAL_DEFAULTS, ...options };
+
+  const byId = new Map(nodes.map((node) => [node.id, node]));
+  const fresh = new Set(Array.from(newIds).filter((id) => byId.has(id)));
+  if (fresh.size === 0) return null;
+
+  const adjacency = new Map<string, string[]>();
+  const link = (a: string, b: string) => {
+    const list = adjacency.get(a);
+    if (list) list.push(b);
+    else adjacency.set(a, [b]);
+  };
+  for (const edge of edges) {
+    if (edge.source === edge.target || !byId.has(edge.source) || !byId.has(edge.target)) continue;
+    link(edge.source, edge.target);
+    link(edge.target, edge.source);
   }
 
-  // Extract positions
-  const positions = new Map<string, Position>();
-  nodeMap.forEach((node, id) => {
-    positions.set(id, {
-      x: node.x || width / 2,
-      y: node.y || height / 2,
+  // BFS out from the new nodes: `hops` rings are movable, the next ring anchors them
+  const movable = new Set(fresh);
+  const anchors = new Set<string>();
+  let frontier = Array.from(fresh);
+  for (let hop = 0; hop <= hops && frontier.length > 0; hop++) {
+    const next: string[] = [];
+    for (const id of frontier) {
+      for (const neighbour of adjacency.get(id) || []) {
+        if (movable.has(neighbour) || anchors.has(neighbour)) continue;
+        if (hop < hops) {
+          movable.add(neighbour);
+          next.push(neighbour);
+        } else {
+          anchors.add(neighbour);
+        }
+      }
+    }
+    frontier = next;
+  }
+
+  // Start positions: new nodes without one go beside their placed neighbours
+  const start = new Map<string, Position>();
+  const placed = nodes.filter((node) => !fresh.has(node.id));
+  const centroid = placed.length > 0
+    ? {
+        x: placed.reduce((sum, node) => sum + (node.x || 0), 0) / placed.length,
+        y: placed.reduce((sum, node) => sum + (node.y || 0), 0) / placed.length,
+      }
+    : { x: options.centerX ?? 500, y: options.centerY ?? 400 };
+
+  for (const id of movable) {
+    const node = byId.get(id)!;
+    if (!fresh.has(id) || node.x || node.y) {
+      start.set(id, { x: node.x, y: node.y });
+      continue;
+    }
+    const neighbours = (adjacency.get(id) || []).filter((other) => !fresh.has(other));
+    const base = neighbours.length > 0
+      ? {
+          x: neighbours.reduce((sum, other) => sum + byId.get(other)!.x, 0) / neighbours.length,
+          y: neighbours.reduce((sum, other) => sum + byId.get(other)!.y, 0) / neighbours.length,
+        }
+      : centroid;
+    start.set(id, {
+      x: base.x + (Math.random() - 0.5) * SEED_JITTER,
+      y: base.y + (Math.random() - 0.5) * SEED_JITTER,
     });
+  }
+
+  // Pinned context: anchors, plus any other node inside the movable region's bounds
+  let minX = Infinity;
+  let minY = Infinity;
+  let maxX = -Infinity;
+  let maxY = -Infinity;
+  start.forEach(({ x, y }) => {
+    minX = Math.min(minX, x);
+    minY = Math.min(minY, y);
+    maxX = Math.max(maxX, x);
+    maxY = Math.max(maxY, y);
   });
+  minX -= margin;
+  minY -= margin;
+  maxX += margin;
+  maxY += margin;
+
+  const pinned = new Set(anchors);
+  for (const node of placed) {
+    if (movable.has(node.id) || pinned.has(node.id)) continue;
+    if (node.x >= minX && node.x <= maxX && node.y >= minY && node.y <= maxY) pinned.add(node.id);
+  }
 
-  return positions;
+  const local = [
+    ...Array.from(movable, (id) => ({ id, ...start.get(id)! })),
+    ...Array.from(pinned, (id) => byId.get(id)!),
+  ];
+  const localIds = new Set(local.map((node) => node.id));
+  const localEdges = edges.filter((edge) => localIds.has(edge.source) && localIds.has(edge.target));
+
+  const { graph, ids } = toLayoutGraph(local, localEdges, {
+    centerX: centroid.x,
+    centerY: centroid.y,
+    fixedIds: pinned,
+  });
+  return { graph, ids, movable };
+}
+
+/**
+ * Place new nodes without re-simulating the whole graph
+ * Existing nodes keep their positions except within `hops` of a new node.
+ * Returns positions for the moved nodes only.
+ */
+export function incrementalLayout(
+  nodes: LayoutInputNode[],
+  edges: LayoutInputEdge[],
+  newIds: Set<string>,
+  options: IncrementalLayoutOptions = {}
+): Map<string, Position> {
+  const local = buildIncrementalGraph(nodes, edges, newIds, options);
+  if (!local) return new Map();
+
+  const { hops, margin, ...layoutOptions } = options;
+  const positions = positionsToMap(
+    local.ids,
+    runForceLayoutSync(local.graph, { ...INCREMENTAL_RUN_OPTIONS, ...layoutOptions, multilevel: false })
+  );
+
+  const moved = new Map<string, Position>();
+  local.movable.forEach((id) => moved.set(id, positions.get(id)!));
+  return moved;
 }
 
 /**
  * Radial layout around a center node
  */
 export function radialLayout(
-  centerNode: Node,
-  nodes: Node[],
+  centerNode: LayoutInputNode,
+  nodes: LayoutInputNode[],
   radius: number = 300
 ): Map<string, Position> {
   const positions = new Map<string, Position>();
@@ -104,8 +232,8 @@ export function radialLayout(
  * Hierarchical layout (tree-like)
  */
 export function hierarchicalLayout(
-  nodes: Node[],
-  edges: Edge[],
+  nodes: LayoutInputNode[],
+  edges: LayoutInputEdge[],
   rootNodeId: string,
   width: number = 1000,
   height: number = 800
@@ -130,8 +258,9 @@ export function hierarchicalLayout(
   const root = nodes.find(n => n.id === rootNodeId) || nodes[0];
   queue.push({ nodeId: root.id, level: 0, x: width / 2, y: 100 });
 
-  while (queue.length > 0) {
-    const { nodeId, level, x, y } = queue.shift()!;
+  // Read from a head index - shift() is O(n) per dequeue on large trees
+  for (let head = 0; head < queue.length; head++) {
+    const { nodeId, level, x, y } = queue[head];
     
     if (visited.has(nodeId)) continue;
     visited.add(nodeId);
@@ -0,0 +1,144 @@
+import { ForceLayout, type ForceLayoutOptions, type LayoutGraph } from './forceLayout';
+
+// Client side of lib/layout.worker.ts - one shared worker, many concurrent layout runs
+// Falls back to time-sliced stepping on the main thread where workers are unavailable
+
+export interface LayoutRun {
+  // Final positions, or null if cancelled
+  result: Promise<Float32Array | null>;
+  cancel: () => void;
+}
+
+export interface LayoutRunOptions {
+  // Called with partial positions every `progressEvery` ticks
+  onProgress?: (positions: Float32Array, progress: number) => void;
+  progressEvery?: number;
+}
+
+// Main-thread fallback: ticks per slice, sized to stay well inside one frame for mid-size graphs
+const FALLBACK_TICKS_PER_SLICE = 5;
+
+interface PendingRun {
+  resolve: (positions: Float32Array | null) => void;
+  reject: (error: Error) => void;
+  onProgress?: LayoutRunOptions['onProgress'];
+}
+
+let worker: Worker | null = null;
+let workerFailed = false;
+let nextRunId = 1;
+const pending = new Map<number, PendingRun>();
+
+function getWorker(): Worker | null {
+  if (worker || workerFailed) return worker;
+  if (typeof window === 'undefined' || typeof Worker === 'undefined') return null;
+
+  try {
+    worker = new Worker(new URL('./layout.worker.ts', import.meta.url));
+  } catch (error) {
+    console.warn('[layoutWorker] Could not start layout worker, running on main thread:', error);
+    workerFailed = true;
+    return null;
+  }
+
+  worker.onmessage = (event: MessageEvent) => {
+    const message = event.data;
+    const run = pending.get(message?.id);
+    if (!run) return;
+
+    switch (message.type) {
+      case 'progress':
+        run.onProgress?.(message.positions, message.progress);
+        break;
+      case 'done':
+        pending.delete(message.id);
+        run.resolve(message.positions);
+        break;
+      case 'cancelled':
+        pending.delete(message.id);
+        run.resolve(null);
+        break;
+      case 'error':
+        pending.delete(message.id);
+        run.reject(new Error(message.error));
+        break;
+    }
+  };
+
+  worker.onerror = (event) => {
+    console.error('[layoutWorker] Worker error:', event.message);
+    pending.forEach((run) => run.reject(new Error(event.message || 'Layout worker failed')));
+    pending.clear();
+    worker?.terminate();
+    worker = null;
+    workerFailed = true;
+  };
+
+  return worker;
+}
+
+/**
+ * Lay out a graph off the main thread
+ * graph.positions and graph.edges are transferred to the worker - don't use them afterwards
+ */
+export function runLayout(
+  graph: LayoutGraph,
+  options: ForceLayoutOptions = {},
+  { onProgress, progressEvery = 25 }: LayoutRunOptions = {}
+): LayoutRun {
+  const layoutWorker = getWorker();
+  if (!layoutWorker) return runOnMainThread(graph, options, onProgress, progressEvery);
+
+  const id = nextRunId++;
+  const result = new Promise<Float32Array | null>((resolve, reject) => {
+    pending.set(id, { resolve, reject, onProgress });
+  });
+
+  const transfer: Transferable[] = [graph.positions.buffer, graph.edges.buffer];
+  if (graph.fixed) transfer.push(graph.fixed.buffer);
+  layoutWorker.postMessage({ type: 'run', id, graph, options, progressEvery }, transfer);
+
+  return {
+    result,
+    cancel: () => {
+      if (pending.has(id)) layoutWorker.postMessage({ type: 'cancel', id });
+    },
+  };
+}
+
+function runOnMainThread(
+  graph: LayoutGraph,
+  options: ForceLayoutOptions,
+  onProgress: LayoutRunOptions['onProgress'],
+  progressEvery: number
+): LayoutRun {
+  let cancelled = false;
+
+  const result = new Promise<Float32Array | null>((resolve, reject) => {
+    const layout = new ForceLayout(graph, options);
+    let sinceProgress = 0;
+
+    const slice = () => {
+      if (cancelled) return resolve(null);
+      try {
+        if (layout.step(FALLBACK_TICKS_PER_SLICE)) return resolve(layout.positions);
+        sinceProgress += FALLBACK_TICKS_PER_SLICE;
+        if (sinceProgress >= progressEvery) {
+          sinceProgress = 0;
+          onProgress?.(layout.positions.slice(), layout.progress);
+        }
+        setTimeout(slice, 0);
+      } catch (error: any) {
+        reject(error);
+      }
+    };
+    setTimeout(slice, 0);
+  });
+
+  return {
+    result,
+    cancel: () => {
+      cancelled = true;
+    },
+  };
+}
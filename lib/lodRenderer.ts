@@ -0,0 +1,439 @@
+// Level-of-detail renderer for zoomed-out canvases (browser only)
+// - every node is one instanced quad and every edge one line segment; WebGL2 draws each set
+//   with a single call from packed Float32Array buffers. Canvas 2D is the fallback when
+//   WebGL2 is unavailable
+// - buffers are rebuilt only when the graph changes (setGraph); pans and zooms only update
+//   the transform uniform and redraw
+// - nodes mounted as React components are hidden through a one-byte-per-instance flag
+//   buffer (setHidden), so changing the mounted set touches only the flags that flip
+// - coordinates are React Flow's: flow space, transform = [translateX, translateY, zoom]
+
+export interface LodNode {
+  id: string;
+  x: number;
+  y: number;
+  width: number;
+  height: number;
+  color: string;
+}
+
+export interface LodEdge {
+  source: string;
+  target: string;
+}
+
+export type LodTransform = [number, number, number];
+
+// Nodes never shrink below this many screen pixels, so distant maps stay readable
+const MIN_NODE_PIXELS = 2;
+const EDGE_COLOR: [number, number, number, number] = [0.58, 0.64, 0.72, 0.45];
+const NODE_ALPHA = 0.9;
+// Floats per node instance: x, y, width, height, r, g, b, a
+const NODE_STRIDE = 8;
+
+const NODE_VERTEX_SHADER = `#version 300 es
+layout(location = 0) in vec2 a_corner;
+layout(location = 1) in vec4 a_rect;
+layout(location = 2) in vec4 a_color;
+// 1 for nodes mounted as React components - collapsed to an empty quad
+layout(location = 3) in float a_hidden;
+uniform vec3 u_transform;
+uniform vec2 u_resolution;
+uniform float u_minSize;
+out vec4 v_color;
+void main() {
+  vec2 size = max(a_rect.zw * u_transform.z, vec2(u_minSize)) * (1.0 - a_hidden);
+  vec2 screen = a_rect.xy * u_transform.z + u_transform.xy + a_corner * size;
+  vec2 clip = screen / u_resolution * 2.0 - 1.0;
+  gl_Position = vec4(clip.x, -clip.y, 0.0, 1.0);
+  v_color = a_color;
+}`;
+
+const EDGE_VERTEX_SHADER = `#version 300 es
+layout(location = 0) in vec2 a_position;
+uniform vec3 u_transform;
+uniform vec2 u_resolution;
+void main() {
+  vec2 screen = a_position * u_transform.z + u_transform.xy;
+  vec2 clip = screen / u_resolution * 2.0 - 1.0;
+  gl_Position = vec4(clip.x, -clip.y, 0.0, 1.0);
+}`;
+
+const NODE_FRAGMENT_SHADER = `#version 300 es
+precision mediump float;
+in vec4 v_color;
+out vec4 outColor;
+void main() {
+  outColor = v_color;
+}`;
+
+const EDGE_FRAGMENT_SHADER = `#version 300 es
+precision mediump float;
+uniform vec4 u_color;
+out vec4 outColor;
+void main() {
+  outColor = u_color;
+}`;
+
+const colorCache = new Map<string, [number, number, number]>();
+
+// '#rgb' / '#rrggbb' to 0..1 channels; anything else renders grey
+function parseColor(color: string): [number, number, number] {
+  let rgb = colorCache.get(color);
+  if (rgb) return rgb;
+  let hex = color.startsWith('#') ? color.slice(1) : '';
+  if (hex.length === 3) hex = hex.split('').map((c) => c + c).join('');
+  const value = hex.length === 6 ? parseInt(hex, 16) : NaN;
+  rgb = Number.isNaN(value)
+    ? [0.61, 0.64, 0.69]
+    : [((value >> 16) & 0xff) / 255, ((value >> 8) & 0xff) / 255, (value & 0xff) / 255];
+  colorCache.set(color, rgb);
+  return rgb;
+}
+
+interface GlState {
+  gl: WebGL2RenderingContext;
+  nodeProgram: WebGLProgram;
+  edgeProgram: WebGLProgram;
+  nodeVao: WebGLVertexArrayObject;
+  edgeVao: WebGLVertexArrayObject;
+  instanceBuffer: WebGLBuffer;
+  hiddenBuffer: WebGLBuffer;
+  lineBuffer: WebGLBuffer;
+  nodeUniforms: { transform: WebGLUniformLocation | null; resolution: WebGLUniformLocation | null; minSize: WebGLUniformLocation | null };
+  edgeUniforms: { transform: WebGLUniformLocation | null; resolution: WebGLUniformLocation | null; color: WebGLUniformLocation | null };
+}
+
+function compileProgram(gl: WebGL2RenderingContext, vertexSource: string, fragmentSource: string): WebGLProgram {
+  const compile = (type: number, source: string) => {
+    const shader = gl.createShader(type)!;
+    gl.shaderSource(shader, source);
+    gl.compileShader(shader);
+    if (!gl.getShaderParameter(shader, gl.COMPILE_STATUS)) {
+      throw new Error(`Shader compile failed: ${gl.getShaderInfoLog(shader)}`);
+    }
+    return shader;
+  };
+  const program = gl.createProgram()!;
+  gl.attachShader(program, compile(gl.VERTEX_SHADER, vertexSource));
+  gl.attachShader(program, compile(gl.FRAGMENT_SHADER, fragmentSource));
+  gl.linkProgram(program);
+  if (!gl.getProgramParameter(program, gl.LINK_STATUS)) {
+    throw new Error(`Program link failed: ${gl.getProgramInfoLog(program)}`);
+  }
+  return program;
+}
+
+function createGlState(canvas: HTMLCanvasElement): GlState | null {
+  const gl = canvas.getContext('webgl2', { antialias: true, premultipliedAlpha: false });
+  if (!gl) return null;
+
+  try {
+    const nodeProgram = compileProgram(gl, NODE_VERTEX_SHADER, NODE_FRAGMENT_SHADER);
+    const edgeProgram = compileProgram(gl, EDGE_VERTEX_SHADER, EDGE_FRAGMENT_SHADER);
+
+    // Nodes: a unit quad (triangle strip) per instance, scaled and placed by a_rect
+    const nodeVao = gl.createVertexArray()!;
+    gl.bindVertexArray(nodeVao);
+    const cornerBuffer = gl.createBuffer();
+    gl.bindBuffer(gl.ARRAY_BUFFER, cornerBuffer);
+    gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([0, 0, 1, 0, 0, 1, 1, 1]), gl.STATIC_DRAW);
+    gl.enableVertexAttribArray(0);
+    gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0);
+
+    const instanceBuffer = gl.createBuffer()!;
+    gl.bindBuffer(gl.ARRAY_BUFFER, instanceBuffer);
+    gl.enableVertexAttribArray(1);
+    gl.vertexAttribPointer(1, 4, gl.FLOAT, false, NODE_STRIDE * 4, 0);
+    gl.vertexAttribDivisor(1, 1);
+    gl.enableVertexAttribArray(2);
+    gl.vertexAttribPointer(2, 4, gl.FLOAT, false, NODE_STRIDE * 4, 16);
+    gl.vertexAttribDivisor(2, 1);
+
+    const hiddenBuffer = gl.createBuffer()!;
+    gl.bindBuffer(gl.ARRAY_BUFFER, hiddenBuffer);
+    gl.enableVertexAttribArray(3);
+    gl.vertexAttribPointer(3, 1, gl.UNSIGNED_BYTE, false, 0, 0);
+    gl.vertexAttribDivisor(3, 1);
+
+    // Edges: plain line segments, two vertices each
+    const edgeVao = gl.createVertexArray()!;
+    gl.bindVertexArray(edgeVao);
+    const lineBuffer = gl.createBuffer()!;
+    gl.bindBuffer(gl.ARRAY_BUFFER, lineBuffer);
+    gl.enableVertexAttribArray(0);
+    gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0);
+    gl.bindVertexArray(null);
+
+    gl.enable(gl.BLEND);
+    gl.blendFunc(gl.SRC_ALPHA, gl.ONE_MINUS_SRC_ALPHA);
+
+    return {
+      gl,
+      nodeProgram,
+      edgeProgram,
+      nodeVao,
+      edgeVao,
+      instanceBuffer,
+      hiddenBuffer,
+      lineBuffer,
+      nodeUniforms: {
+        transform: gl.getUniformLocation(nodeProgram, 'u_transform'),
+        resolution: gl.getUniformLocation(nodeProgram, 'u_resolution'),
+        minSize: gl.getUniformLocation(nodeProgram, 'u_minSize'),
+      },
+      edgeUniforms: {
+        transform: gl.getUniformLocation(edgeProgram, 'u_transform'),
+        resolution: gl.getUniformLocation(edgeProgram, 'u_resolution'),
+        color: gl.getUniformLocation(edgeProgram, 'u_color'),
+      },
+    };
+  } catch (error) {
+    console.warn('[lodRenderer] WebGL2 setup failed, using canvas 2D:', error);
+    return null;
+  }
+}
+
+export class LodRenderer {
+  private glState: GlState | null = null;
+  private ctx2d: CanvasRenderingContext2D | null = null;
+
+  // Nodes as packed instances, and edge segments as [x1, y1, x2, y2]
+  private instances = new Float32Array(0);
+  private instanceIds: string[] = [];
+  private instanceIndex = new Map<string, number>();
+  // 1 per instance mounted as a React component (not drawn, not hit-tested)
+  private hidden = new Uint8Array(0);
+  private hiddenIds: ReadonlySet<string> = new Set();
+  private hiddenUploaded = false;
+  // Canvas 2D fill style per instance
+  private instanceStyles: string[] = [];
+  private lines = new Float32Array(0);
+  private instanceCount = 0;
+  private lineCount = 0;
+  private uploaded = false;
+
+  constructor(private readonly canvas: HTMLCanvasElement) {
+    this.glState = createGlState(canvas);
+    if (!this.glState) this.ctx2d = canvas.getContext('2d');
+    canvas.addEventListener('webglcontextlost', this.handleContextLost);
+    canvas.addEventListener('webglcontextrestored', this.handleContextRestored);
+  }
+
+  get mode(): 'webgl2' | 'canvas2d' | 'none' {
+    return this.glState ? 'webgl2' : this.ctx2d ? 'canvas2d' : 'none';
+  }
+
+  private handleContextLost = (event: Event) => {
+    // Lets the browser restore the context instead of leaving the layer blank
+    event.preventDefault();
+    this.glState = null;
+  };
+
+  private handleContextRestored = () => {
+    this.glState = createGlState(this.canvas);
+    this.uploaded = false;
+  };
+
+  /**
+   * Replace the drawn graph; edges whose endpoints are not in `nodes` are skipped
+   * The hidden set from setHidden carries over to the new nodes.
+   */
+  setGraph(nodes: LodNode[], edges: LodEdge[]) {
+    if (this.instances.length < nodes.length * NODE_STRIDE) {
+      this.instances = new Float32Array(nodes.length * NODE_STRIDE);
+    }
+    if (this.hidden.length < nodes.length) {
+      this.hidden = new Uint8Array(nodes.length);
+    } else {
+      this.hidden.fill(0, 0, nodes.length);
+    }
+    this.instanceIds = new Array(nodes.length);
+    this.instanceStyles = new Array(nodes.length);
+    this.instanceIndex = new Map();
+    nodes.forEach((node, i) => {
+      const [r, g, b] = parseColor(node.color);
+      const offset = i * NODE_STRIDE;
+      this.instances[offset] = node.x;
+      this.instances[offset + 1] = node.y;
+      this.instances[offset + 2] = node.width;
+      this.instances[offset + 3] = node.height;
+      this.instances[offset + 4] = r;
+      this.instances[offset + 5] = g;
+      this.instances[offset + 6] = b;
+      this.instances[offset + 7] = NODE_ALPHA;
+      this.instanceIds[i] = node.id;
+      this.instanceStyles[i] = node.color;
+      this.instanceIndex.set(node.id, i);
+      if (this.hiddenIds.has(node.id)) this.hidden[i] = 1;
+    });
+    this.instanceCount = nodes.length;
+
+    // Edge endpoints sit at node centres (hidden nodes included)
+    const positions = new Float32Array(nodes.length * 2);
+    nodes.forEach((node, i) => {
+      positions[i * 2] = node.x + node.width / 2;
+      positions[i * 2 + 1] = node.y + node.height / 2;
+    });
+
+    if (this.lines.length < edges.length * 4) {
+      this.lines = new Float32Array(edges.length * 4);
+    }
+    let lineCount = 0;
+    for (const edge of edges) {
+      const a = this.instanceIndex.get(edge.source);
+      const b = this.instanceIndex.get(edge.target);
+      if (a === undefined || b === undefined) continue;
+      const offset = lineCount * 4;
+      this.lines[offset] = positions[a * 2];
+      this.lines[offset + 1] = positions[a * 2 + 1];
+      this.lines[offset + 2] = positions[b * 2];
+      this.lines[offset + 3] = positions[b * 2 + 1];
+      lineCount++;
+    }
+    this.lineCount = lineCount;
+    this.uploaded = false;
+  }
+
+  /**
+   * Nodes not to draw (mounted as React components) - their edges are still drawn
+   * Only the flags of nodes entering or leaving the set change.
+   */
+  setHidden(ids: ReadonlySet<string>) {
+    for (const id of this.hiddenIds) {
+      const i = this.instanceIndex.get(id);
+      if (i !== undefined) this.hidden[i] = 0;
+    }
+    for (const id of ids) {
+      const i = this.instanceIndex.get(id);
+      if (i !== undefined) this.hidden[i] = 1;
+    }
+    this.hiddenIds = ids;
+    this.hiddenUploaded = false;
+  }
+
+  /**
+   * Topmost drawn node containing a flow-space point, or null
+   */
+  hitTest(x: number, y: number, zoom: number): string | null {
+    const minSize = MIN_NODE_PIXELS / zoom;
+    for (let i = this.instanceCount - 1; i >= 0; i--) {
+      if (this.hidden[i]) continue;
+      const offset = i * NODE_STRIDE;
+      const left = this.instances[offset];
+      const top = this.instances[offset + 1];
+      const width = Math.max(this.instances[offset + 2], minSize);
+      const height = Math.max(this.instances[offset + 3], minSize);
+      if (x >= left && x <= left + width && y >= top && y <= top + height) return this.instanceIds[i];
+    }
+    return null;
+  }
+
+  /**
+   * Draw at the given transform; width and height are the canvas size in CSS pixels
+   */
+  render(transform: LodTransform, width: number, height: number) {
+    const dpr = window.devicePixelRatio || 1;
+    const pixelWidth = Math.max(1, Math.round(width * dpr));
+    const pixelHeight = Math.max(1, Math.round(height * dpr));
+    if (this.canvas.width !== pixelWidth || this.canvas.height !== pixelHeight) {
+      this.canvas.width = pixelWidth;
+      this.canvas.height = pixelHeight;
+    }
+
+    if (this.glState) {
+      this.renderGl(this.glState, transform, width, height);
+    } else if (this.ctx2d) {
+      this.render2d(this.ctx2d, transform, dpr);
+    }
+  }
+
+  private renderGl(state: GlState, [tx, ty, zoom]: LodTransform, width: number, height: number) {
+    const { gl } = state;
+    if (!this.uploaded) {
+      gl.bindBuffer(gl.ARRAY_BUFFER, state.instanceBuffer);
+      gl.bufferData(gl.ARRAY_BUFFER, this.instances.subarray(0, this.instanceCount * NODE_STRIDE), gl.DYNAMIC_DRAW);
+      gl.bindBuffer(gl.ARRAY_BUFFER, state.lineBuffer);
+      gl.bufferData(gl.ARRAY_BUFFER, this.lines.subarray(0, this.lineCount * 4), gl.DYNAMIC_DRAW);
+      gl.bindBuffer(gl.ARRAY_BUFFER, state.hiddenBuffer);
+      gl.bufferData(gl.ARRAY_BUFFER, this.hidden.subarray(0, this.instanceCount), gl.DYNAMIC_DRAW);
+      this.uploaded = true;
+      this.hiddenUploaded = true;
+    } else if (!this.hiddenUploaded) {
+      gl.bindBuffer(gl.ARRAY_BUFFER, state.hiddenBuffer);
+      gl.bufferSubData(gl.ARRAY_BUFFER, 0, this.hidden.subarray(0, this.instanceCount));
+      this.hiddenUploaded = true;
+    }
+
+    gl.viewport(0, 0, this.canvas.width, this.canvas.height);
+    gl.clearColor(0, 0, 0, 0);
+    gl.clear(gl.COLOR_BUFFER_BIT);
+
+    if (this.lineCount > 0) {
+      gl.useProgram(state.edgeProgram);
+      gl.uniform3f(state.edgeUniforms.transform, tx, ty, zoom);
+      gl.uniform2f(state.edgeUniforms.resolution, width, height);
+      gl.uniform4f(state.edgeUniforms.color, ...EDGE_COLOR);
+      gl.bindVertexArray(state.edgeVao);
+      gl.drawArrays(gl.LINES, 0, this.lineCount * 2);
+    }
+
+    if (this.instanceCount > 0) {
+      gl.useProgram(state.nodeProgram);
+      gl.uniform3f(state.nodeUniforms.transform, tx, ty, zoom);
+      gl.uniform2f(state.nodeUniforms.resolution, width, height);
+      gl.uniform1f(state.nodeUniforms.minSize, MIN_NODE_PIXELS);
+      gl.bindVertexArray(state.nodeVao);
+      gl.drawArraysInstanced(gl.TRIANGLE_STRIP, 0, 4, this.instanceCount);
+    }
+
+    gl.bindVertexArray(null);
+  }
+
+  private render2d(ctx: CanvasRenderingContext2D, [tx, ty, zoom]: LodTransform, dpr: number) {
+    ctx.setTransform(1, 0, 0, 1, 0, 0);
+    ctx.clearRect(0, 0, this.canvas.width, this.canvas.height);
+    ctx.setTransform(dpr * zoom, 0, 0, dpr * zoom, dpr * tx, dpr * ty);
+
+    if (this.lineCount > 0) {
+      const [r, g, b, a] = EDGE_COLOR;
+      ctx.strokeStyle = `rgba(${r * 255}, ${g * 255}, ${b * 255}, ${a})`;
+      ctx.lineWidth = 1 / zoom;
+      ctx.beginPath();
+      for (let i = 0; i < this.lineCount; i++) {
+        const offset = i * 4;
+        ctx.moveTo(this.lines[offset], this.lines[offset + 1]);
+        ctx.lineTo(this.lines[offset + 2], this.lines[offset + 3]);
+      }
+      ctx.stroke();
+    }
+
+    const minSize = MIN_NODE_PIXELS / zoom;
+    let fill = '';
+    ctx.globalAlpha = NODE_ALPHA;
+    for (let i = 0; i < this.instanceCount; i++) {
+      if (this.hidden[i]) continue;
+      const offset = i * NODE_STRIDE;
+      // Palettes are small - only restyle when the colour changes
+      if (this.instanceStyles[i] !== fill) {
+        fill = this.instanceStyles[i];
+        ctx.fillStyle = fill;
+      }
+      ctx.fillRect(
+        this.instances[offset],
+        this.instances[offset + 1],
+        Math.max(this.instances[offset + 2], minSize),
+        Math.max(this.instances[offset + 3], minSize)
+      );
+    }
+    ctx.globalAlpha = 1;
+  }
+
+  destroy() {
+    this.canvas.removeEventListener('webglcontextlost', this.handleContextLost);
+    this.canvas.removeEventListener('webglcontextrestored', this.handleContextRestored);
+    this.glState?.gl.getExtension('WEBGL_lose_context')?.loseContext();
+    this.glState = null;
+    this.ctx2d = null;
+  }
+}
@@ -0,0 +1,107 @@
+import { useCanvasStore } from '@/state/canvasStore';
+import { useWorkspaceStore } from '@/state/workspaceStore';
+import type { NodeChange } from '@/state/workspaceStore';
+import {
+  isPartialContent,
+  MAX_CONTENT_NODES_PER_REQUEST,
+  PARTIAL_CONTENT_KEY,
+} from './graphPayload';
+
+/**
+ * Fetch the full content of nodes loaded from the binary skeleton (lib/graphPayload.ts)
+ * Nodes nearest the middle of the viewport go first, one chunk at a time. Content that
+ * arrives is merged under whatever the node already has (local edits made meanwhile win;
+ * text or array content replaces the placeholder as is), and isn't broadcast or recorded for undo - it's what the server already holds.
+ * Stops early when `signal` aborts (workspace switched or unmounted).
+ */
+export async function loadPendingNodeContents(workspaceId: string, signal: AbortSignal): Promise<void> {
+  const pending = useWorkspaceStore
+    .getState()
+    .nodes.filter((node) => node.workspaceId === workspaceId && isPartialContent(node.content));
+  if (pending.length === 0) return;
+
+  const { viewport } = useCanvasStore.getState();
+  const zoom = viewport.zoom || 1;
+  const centerX = (window.innerWidth / 2 - viewport.x) / zoom;
+  const centerY = (window.innerHeight / 2 - viewport.y) / zoom;
+  const ids = pending
+    .map((node) => ({ id: node.id, distance: (node.x - centerX) ** 2 + (node.y - centerY) ** 2 }))
+    .sort((a, b) => a.distance - b.distance)
+    .map((entry) => entry.id);
+
+  for (let start = 0; start < ids.length && !signal.aborted; start += MAX_CONTENT_NODES_PER_REQUEST) {
+    const chunk = ids.slice(start, start + MAX_CONTENT_NODES_PER_REQUEST);
+    let contents: Record<string, any>;
+    try {
+      const response = await fetch(`/api/workspaces/${workspaceId}/content`, {
+        method: 'POST',
+        headers: { 'Content-Type': 'application/json' },
+        body: JSON.stringify({ nodeIds: chunk }),
+        signal,
+      });
+      if (!response.ok) {
+        console.error('[nodeContentLoader] Failed to load node contents:', response.statusText);
+        return;
+      }
+      contents = (await response.json()).contents || {};
+    } catch (error: any) {
+      if (error?.name !== 'AbortError') {
+        console.error('[nodeContentLoader] Error loading node contents:', error);
+      }
+      return;
+    }
+    if (signal.aborted) return;
+
+    mergeArrivedContents(contents);
+  }
+}
+
+/**
+ * Full content of one node, fetching it first if the node is still a skeleton
+ * For anything that copies content elsewhere (duplicate, delete with undo) - the
+ * placeholder must never be written back to the server. Throws when it can't be loaded.
+ */
+export async function ensureNodeContent(workspaceId: string, nodeId: string): Promise<any> {
+  const current = findNode(nodeId);
+  if (!current) throw new Error('Node not found');
+  if (!isPartialContent(current.content)) return current.content;
+
+  const response = await fetch(`/api/workspaces/${workspaceId}/content`, {
+    method: 'POST',
+    headers: { 'Content-Type': 'application/json' },
+    body: JSON.stringify({ nodeIds: [nodeId] }),
+  });
+  if (!response.ok) throw new Error(`Failed to load node content: ${response.statusText}`);
+  const contents = (await response.json()).contents || {};
+  if (!(nodeId in contents)) throw new Error('Node content not found');
+  mergeArrivedContents(contents);
+
+  const merged = findNode(nodeId);
+  if (!merged || isPartialContent(merged.content)) throw new Error('Node content not found');
+  return merged.content;
+}
+
+function findNode(nodeId: string) {
+  const { nodes, nodeIndex } = useWorkspaceStore.getState();
+  const index = nodeIndex.get(nodeId);
+  return index === undefined ? undefined : nodes[index];
+}
+
+function mergeArrivedContents(contents: Record<string, any>) {
+  // Re-read the store - nodes may have been edited, replaced by a delta, or deleted
+  const { updateNodes } = useWorkspaceStore.getState();
+  const changes: NodeChange[] = [];
+  for (const [id, content] of Object.entries(contents)) {
+    const current = findNode(id);
+    if (!current || !isPartialContent(current.content)) continue;
+    const { [PARTIAL_CONTENT_KEY]: _partial, ...local } = current.content;
+    // Plain text or an array has no keys to keep local edits under - take it as stored
+    const merged = content == null || isPlainObject(content) ? { ...(content || {}), ...local } : content;
+    changes.push({ id, updates: { content: merged } });
+  }
+  updateNodes(changes, { broadcast: false, record: false });
+}
+
+function isPlainObject(value: unknown): value is Record<string, any> {
+  return typeof value === 'object' && value !== null && !Array.isArray(value);
+}
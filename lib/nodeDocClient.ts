@@ -0,0 +1,283 @@
+import { useEffect, useState } from 'react';
+import * as Y from 'yjs';
+import { useCollabChannel, type CollabChannel } from './collabClient';
+import { useWorkspaceStore } from '@/state/workspaceStore';
+
+// Browser side of collaborative node text (app/api/nodes/[id]/doc, lib/nodeDocuments.ts)
+// - the editor edits a Y.Doc; local changes leave as merged binary Yjs updates, a few
+//   bytes per keystroke instead of the whole TipTap document
+// - other editors' updates arrive on the workspace collaboration channel; a state-vector
+//   resync after reconnects, and when delta sync brings a newer copy of this node (a
+//   snapshot landed), catches whatever the channel missed (updates relayed by another
+//   server instance)
+// - failed loads are retried with backoff rather than reported as 'unavailable': that
+//   status makes the editor fall back to whole-content PUTs, which reset everyone's document
+
+// Local updates within this window go out as one request
+const FLUSH_DELAY_MS = 50;
+const RETRY_DELAY_MS = 2000;
+// Document load/resync retries: RETRY_DELAY_MS doubling up to MAX_RETRY_DELAY_MS
+const MAX_RETRY_DELAY_MS = 30000;
+
+// 'missing' - the node has no rich text document (409); 'failed' - try again later
+type SyncResult = 'ok' | 'missing' | 'failed';
+
+// Transaction origin for updates that came from the server, so they are not sent back
+const REMOTE_ORIGIN = 'remote';
+
+function toBase64(bytes: Uint8Array): string {
+  let binary = '';
+  for (let i = 0; i < bytes.length; i += 0x8000) {
+    binary += String.fromCharCode(...bytes.subarray(i, i + 0x8000));
+  }
+  return btoa(binary);
+}
+
+function fromBase64(value: string): Uint8Array {
+  const binary = atob(value);
+  const bytes = new Uint8Array(binary.length);
+  for (let i = 0; i < binary.length; i++) bytes[i] = binary.charCodeAt(i);
+  return bytes;
+}
+
+export class NodeDocSession {
+  readonly doc = new Y.Doc();
+  private epoch: string | null = null;
+  private pending: Uint8Array[] = [];
+  private timer: ReturnType<typeof setTimeout> | null = null;
+  private sending = false;
+  private syncing: Promise<SyncResult> | null = null;
+  private retryTimer: ReturnType<typeof setTimeout> | null = null;
+  private retryDelay = RETRY_DELAY_MS;
+  private closed = false;
+  private unsubscribers: (() => void)[] = [];
+
+  constructor(
+    readonly nodeId: string,
+    private channel: CollabChannel,
+    // The server rebuilt the document (content replaced wholesale) - start a new session
+    private onReset: () => void
+  ) {
+    this.doc.on('update', this.handleLocalUpdate);
+    this.unsubscribers.push(
+      channel.on('doc', ({ nodeId: target, update }) => {
+        if (target === this.nodeId) Y.applyUpdate(this.doc, fromBase64(update), REMOTE_ORIGIN);
+      }),
+      channel.on('hello', () => void this.resync()),
+      // Version notices fire on every change in the workspace - only a newer copy of this
+      // node (its snapshot rendered into nodes.content) is worth a resync
+      useWorkspaceStore.subscribe((state, previous) => {
+        if (this.epoch && nodeUpdatedAt(state, this.nodeId) !== nodeUpdatedAt(previous, this.nodeId)) {
+          void this.resync();
+        }
+      })
+    );
+  }
+
+  /**
+   * Initial load, retried until it gets an answer; resolves false when the node has no
+   * collaborative document (or the session was closed first)
+   */
+  async load(): Promise<boolean> {
+    let delay = RETRY_DELAY_MS;
+    while (!this.closed) {
+      const result = await this.sync();
+      if (result !== 'failed') return result === 'ok';
+      await new Promise((resolve) => setTimeout(resolve, delay));
+      delay = Math.min(delay * 2, MAX_RETRY_DELAY_MS);
+    }
+    return false;
+  }
+
+  close() {
+    this.closed = true;
+    if (this.timer) clearTimeout(this.timer);
+    if (this.retryTimer) clearTimeout(this.retryTimer);
+    // Last keystrokes before switching nodes; Yjs updates commute, so this may overtake
+    // a request still in flight
+    if (this.pending.length > 0 && this.epoch) {
+      void this.post(Y.mergeUpdates(this.pending.splice(0)), true).catch(() => {});
+    }
+    this.doc.off('update', this.handleLocalUpdate);
+    this.unsubscribers.forEach((unsubscribe) => unsubscribe());
+    this.doc.destroy();
+  }
+
+  private handleLocalUpdate = (update: Uint8Array, origin: unknown) => {
+    if (origin === REMOTE_ORIGIN || this.closed) return;
+    this.pending.push(update);
+    this.scheduleFlush(FLUSH_DELAY_MS);
+  };
+
+  // Catch up after load; failures back off and try again
+  private async resync() {
+    if (this.retryTimer) {
+      clearTimeout(this.retryTimer);
+      this.retryTimer = null;
+    }
+    const result = await this.sync();
+    if (result === 'failed' && !this.closed) {
+      this.retryTimer = setTimeout(() => {
+        this.retryTimer = null;
+        void this.resync();
+      }, this.retryDelay);
+      this.retryDelay = Math.min(this.retryDelay * 2, MAX_RETRY_DELAY_MS);
+    } else {
+      this.retryDelay = RETRY_DELAY_MS;
+    }
+  }
+
+  // Fetch what we are missing (everything, on first load)
+  private sync(): Promise<SyncResult> {
+    if (this.closed) return Promise.resolve('missing');
+    if (!this.syncing) {
+      this.syncing = this.fetchMissing().finally(() => {
+        this.syncing = null;
+      });
+    }
+    return this.syncing;
+  }
+
+  private async fetchMissing(): Promise<SyncResult> {
+    try {
+      const query = this.epoch
+        ? `?sv=${encodeURIComponent(toBase64(Y.encodeStateVector(this.doc)))}`
+        : '';
+      const response = await fetch(`/api/nodes/${this.nodeId}/doc${query}`, { cache: 'no-store' });
+      if (this.closed) return 'missing';
+      if (response.status === 409) {
+        // Content is no longer rich text - an open session has to start over
+        if (this.epoch) this.onReset();
+        return 'missing';
+      }
+      if (!response.ok) {
+        console.warn('[nodeDocClient] Document sync failed:', response.status);
+        return 'failed';
+      }
+
+      const epoch = response.headers.get('X-Doc-Epoch');
+      if (this.epoch && epoch !== this.epoch) {
+        this.onReset();
+        return 'missing';
+      }
+      this.epoch = epoch;
+
+      const update = new Uint8Array(await response.arrayBuffer());
+      if (!this.closed && update.byteLength > 0) Y.applyUpdate(this.doc, update, REMOTE_ORIGIN);
+      return 'ok';
+    } catch (error) {
+      console.warn('[nodeDocClient] Document sync failed:', error);
+      return 'failed';
+    }
+  }
+
+  private scheduleFlush(delayMs: number) {
+    if (this.timer || this.sending) return;
+    this.timer = setTimeout(() => {
+      this.timer = null;
+      void this.flush();
+    }, delayMs);
+  }
+
+  private post(update: Uint8Array, keepalive = false): Promise<Response> {
+    return fetch(`/api/nodes/${this.nodeId}/doc`, {
+      method: 'POST',
+      headers: {
+        'Content-Type': 'application/octet-stream',
+        'X-Doc-Epoch': this.epoch!,
+        'X-Collab-Client': this.channel.clientId,
+      },
+      body: update,
+      keepalive,
+    });
+  }
+
+  private async flush() {
+    if (this.sending || this.closed || this.pending.length === 0 || !this.epoch) return;
+    this.sending = true;
+
+    const batch = this.pending.splice(0);
+    const update = batch.length === 1 ? batch[0] : Y.mergeUpdates(batch);
+    let retry = false;
+    try {
+      const response = await this.post(update);
+      if (response.status === 409) {
+        this.onReset();
+      } else if (response.status >= 500) {
+        retry = true;
+      }
+    } catch (error) {
+      console.warn('[nodeDocClient] Failed to send document update:', error);
+      retry = true;
+    } finally {
+      this.sending = false;
+    }
+
+    if (retry && !this.closed) {
+      this.pending.unshift(update);
+      this.scheduleFlush(RETRY_DELAY_MS);
+    } else if (this.pending.length > 0) {
+      this.scheduleFlush(FLUSH_DELAY_MS);
+    }
+  }
+}
+
+function nodeUpdatedAt(state: ReturnType<typeof useWorkspaceStore.getState>, nodeId: string) {
+  const index = state.nodeIndex.get(nodeId);
+  return index === undefined ? undefined : state.nodes[index]?.updatedAt;
+}
+
+export type NodeDocStatus = 'idle' | 'loading' | 'ready' | 'unavailable';
+
+/**
+ * Collaborative document for a node's rich text
+ * `doc` is set once the server state is loaded; 'unavailable' means edit the plain
+ * content instead (no rich text, or no collaboration channel). Load errors keep the
+ * status at 'loading' while the session retries
+ */
+export function useNodeDocument(
+  workspaceId: string | null | undefined,
+  nodeId: string | null
+): { doc: Y.Doc | null; status: NodeDocStatus } {
+  const channel = useCollabChannel(workspaceId);
+  const [state, setState] = useState<{ nodeId: string | null; doc: Y.Doc | null; status: NodeDocStatus }>({
+    nodeId: null,
+    doc: null,
+    status: 'idle',
+  });
+  // Bumped when the server rebuilt the document, which needs a fresh session
+  const [generation, setGeneration] = useState(0);
+
+  useEffect(() => {
+    if (!nodeId) {
+      setState({ nodeId, doc: null, status: 'idle' });
+      return;
+    }
+    if (!channel) {
+      const status = typeof EventSource === 'undefined' ? 'unavailable' : 'loading';
+      setState({ nodeId, doc: null, status });
+      return;
+    }
+
+    setState({ nodeId, doc: null, status: 'loading' });
+    const session = new NodeDocSession(nodeId, channel, () => setGeneration((g) => g + 1));
+    let active = true;
+    session.load().then((loaded) => {
+      if (!active) return;
+      setState(
+        loaded
+          ? { nodeId, doc: session.doc, status: 'ready' }
+          : { nodeId, doc: null, status: 'unavailable' }
+      );
+    });
+
+    return () => {
+      active = false;
+      session.close();
+    };
+  }, [channel, nodeId, generation]);
+
+  // Until the effect catches up with a new node, the previous node's session is stale
+  if (state.nodeId !== nodeId) return { doc: null, status: nodeId ? 'loading' : 'idle' };
+  return { doc: state.doc, status: state.status };
+}
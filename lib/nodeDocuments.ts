@@ -0,0 +1,252 @@
+import { randomUUID } from 'crypto';
+import * as Y from 'yjs';
+import { prosemirrorJSONToYDoc, yDocToProsemirrorJSON } from 'y-prosemirror';
+import { getSchema } from '@tiptap/core';
+import StarterKit from '@tiptap/starter-kit';
+import type { Schema } from '@tiptap/pm/model';
+import { Prisma } from '@prisma/client';
+import { prisma } from './db';
+import { enqueueJob, registerJobHandler } from './jobQueue';
+import { enqueueNodeIndexing } from './nodeJobs';
+import { recordNodeRevision } from './nodeRevisions';
+
+// Server-only CRDT storage for node rich text (Yjs, as used by TipTap's Collaboration extension)
+// - clients send small binary Yjs updates; they are appended to node_document_updates, so
+//   concurrent editors never overwrite each other - Yjs merges them
+// - a debounced snapshot job folds the appended updates into node_documents.state and
+//   renders the result into nodes.content (search, embeddings, canvas and delta sync keep
+//   reading plain JSON)
+// - documents are built from nodes.content on first open; a whole-content write through
+//   PUT /api/nodes/update drops the document so the next open rebuilds it (new epoch)
+
+// XML fragment TipTap's Collaboration extension binds to
+export const NODE_DOC_FIELD = 'default';
+
+// Largest single update accepted from a client (a paste of a long document)
+export const MAX_NODE_DOC_UPDATE_BYTES = 1024 * 1024;
+
+const SNAPSHOT_JOB = 'snapshot_node_doc';
+// Quiet period before a snapshot; continuous typing still snapshots every
+// MAX_COALESCE_DELAY_MS (lib/jobQueue.ts)
+const SNAPSHOT_DEBOUNCE_MS = 2000;
+
+interface SnapshotPayload {
+  nodeId: string;
+  userId?: string;
+}
+
+export interface NodeDocumentState {
+  epoch: string;
+  // Full merged document, or only what the caller's state vector is missing
+  update: Uint8Array;
+}
+
+// Must match the editor's schema (components/NodeEditorPanel.tsx uses StarterKit)
+let schema: Schema | null = null;
+
+function getNodeDocSchema(): Schema {
+  if (!schema) schema = getSchema([StarterKit]);
+  return schema;
+}
+
+/**
+ * nodes.content as a ProseMirror document, or null when the node holds structured content
+ * (charts, images, links...) that is not edited as rich text
+ */
+function toProsemirrorJSON(content: unknown): any | null {
+  if (content === null || content === undefined || content === '') {
+    return { type: 'doc', content: [{ type: 'paragraph' }] };
+  }
+  if (typeof content === 'string') {
+    return {
+      type: 'doc',
+      content: content.split('\n').map((line) =>
+        line ? { type: 'paragraph', content: [{ type: 'text', text: line }] } : { type: 'paragraph' }
+      ),
+    };
+  }
+  if (typeof content === 'object') {
+    if ((content as any).type === 'doc') return content;
+    if (Object.keys(content as object).length === 0) return toProsemirrorJSON(null);
+  }
+  return null;
+}
+
+/**
+ * Validate a client update without applying it anywhere
+ */
+export function isValidNodeDocUpdate(update: Uint8Array): boolean {
+  if (update.byteLength === 0 || update.byteLength > MAX_NODE_DOC_UPDATE_BYTES) return false;
+  try {
+    Y.decodeUpdate(update);
+    return true;
+  } catch {
+    return false;
+  }
+}
+
+async function createNodeDocument(node: { id: string; content: unknown }): Promise<boolean> {
+  const json = toProsemirrorJSON(node.content);
+  if (!json) return false;
+
+  let state: Uint8Array;
+  try {
+    state = Y.encodeStateAsUpdate(prosemirrorJSONToYDoc(getNodeDocSchema(), json, NODE_DOC_FIELD));
+  } catch (error: any) {
+    // Content that does not fit the editor schema stays on the plain JSON path
+    console.warn('[nodeDocuments] Cannot build document for node:', node.id, error?.message);
+    return false;
+  }
+
+  // Concurrent first opens race here; skipDuplicates keeps exactly one, and every caller
+  // then reads the winner
+  await prisma.nodeDocument.createMany({
+    data: [{ nodeId: node.id, epoch: randomUUID(), state: Buffer.from(state) }],
+    skipDuplicates: true,
+  });
+  return true;
+}
+
+async function readMergedState(nodeId: string) {
+  // Repeatable read: state and pending updates from the same snapshot, even while the
+  // snapshot job is moving one into the other
+  return prisma.$transaction(
+    async (tx) => {
+      const document = await tx.nodeDocument.findUnique({
+        where: { nodeId },
+        select: { epoch: true, state: true },
+      });
+      if (!document) return null;
+
+      const updates = await tx.nodeDocumentUpdate.findMany({
+        where: { nodeId },
+        orderBy: { id: 'asc' },
+        select: { update: true },
+      });
+      const merged =
+        updates.length === 0
+          ? new Uint8Array(document.state)
+          : Y.mergeUpdates([document.state, ...updates.map((u) => u.update)]);
+      return { epoch: document.epoch, state: merged };
+    },
+    { isolationLevel: 'RepeatableRead' }
+  );
+}
+
+/**
+ * Current document for a node, created from nodes.content on first use
+ * Pass the client's state vector to get only the missing part. Returns null for nodes
+ * without rich text content.
+ */
+export async function getNodeDocument(
+  node: { id: string; content: unknown },
+  stateVector?: Uint8Array
+): Promise<NodeDocumentState | null> {
+  let current = await readMergedState(node.id);
+  if (!current) {
+    if (!(await createNodeDocument(node))) return null;
+    current = await readMergedState(node.id);
+    if (!current) return null; // Node deleted meanwhile
+  }
+
+  return {
+    epoch: current.epoch,
+    update: stateVector ? Y.diffUpdate(current.state, stateVector) : current.state,
+  };
+}
+
+/**
+ * Append a client update to the document with this epoch and schedule a snapshot
+ * Returns false when the document was rebuilt or dropped since the client loaded it
+ */
+export async function appendNodeDocumentUpdate(
+  nodeId: string,
+  epoch: string,
+  update: Uint8Array,
+  userId?: string
+): Promise<boolean> {
+  const inserted = await prisma.$executeRaw`
+    INSERT INTO node_document_updates (node_id, update, created_at)
+    SELECT ${nodeId}, ${Buffer.from(update)}, NOW()
+    WHERE EXISTS (SELECT 1 FROM node_documents WHERE node_id = ${nodeId} AND epoch = ${epoch})
+  `;
+  if (inserted === 0) return false;
+
+  try {
+    const payload: SnapshotPayload = { nodeId, userId };
+    await enqueueJob(SNAPSHOT_JOB, `${SNAPSHOT_JOB}:${nodeId}`, payload, {
+      delayMs: SNAPSHOT_DEBOUNCE_MS,
+    });
+  } catch (error: any) {
+    // The update is stored; the next accepted update schedules the snapshot again
+    console.warn('[nodeDocuments] Failed to queue snapshot (continuing):', error?.message);
+  }
+  return true;
+}
+
+/**
+ * Update a node with a whole-content write and forget its collaborative state, in one
+ * transaction under the node_documents row lock snapshots take - a snapshot running
+ * concurrently either commits first (and is overwritten) or finds the document gone,
+ * never renders older CRDT text over the new content
+ */
+export async function replaceNodeContent(nodeId: string, data: Prisma.NodeUpdateInput) {
+  return prisma.$transaction(async (tx) => {
+    await tx.$queryRaw`SELECT node_id FROM node_documents WHERE node_id = ${nodeId} FOR UPDATE`;
+    const node = await tx.node.update({ where: { id: nodeId }, data });
+    await tx.nodeDocument.deleteMany({ where: { nodeId } });
+    await tx.nodeDocumentUpdate.deleteMany({ where: { nodeId } });
+    return node;
+  });
+}
+
+/**
+ * Fold pending updates into the stored state and render nodes.content from it
+ */
+export async function snapshotNodeDocument(nodeId: string): Promise<boolean> {
+  return prisma.$transaction(async (tx) => {
+    // Row lock serialises snapshots with resets of the same document
+    const locked = await tx.$queryRaw<{ state: Buffer }[]>`
+      SELECT state FROM node_documents WHERE node_id = ${nodeId} FOR UPDATE
+    `;
+    if (locked.length === 0) return false;
+
+    const updates = await tx.nodeDocumentUpdate.findMany({
+      where: { nodeId },
+      orderBy: { id: 'asc' },
+      select: { id: true, update: true },
+    });
+    if (updates.length === 0) return false;
+
+    const ydoc = new Y.Doc({ gc: true });
+    Y.applyUpdate(ydoc, locked[0].state);
+    updates.forEach(({ update }) => Y.applyUpdate(ydoc, update));
+
+    // Re-encoding from a Doc (rather than mergeUpdates) drops deleted content
+    const state = Y.encodeStateAsUpdate(ydoc);
+    const content = yDocToProsemirrorJSON(ydoc, NODE_DOC_FIELD);
+    ydoc.destroy();
+
+    await tx.nodeDocument.update({ where: { nodeId }, data: { state: Buffer.from(state) } });
+    await tx.nodeDocumentUpdate.deleteMany({
+      where: { nodeId, id: { lte: updates[updates.length - 1].id } },
+    });
+    // Bumps the graph version, so other clients pick the text up through delta sync
+    await tx.node.update({ where: { id: nodeId }, data: { content } });
+    return true;
+  });
+}
+
+registerJobHandler(SNAPSHOT_JOB, async (payload: SnapshotPayload) => {
+  if (!(await snapshotNodeDocument(payload.nodeId))) return;
+
+  const node = await prisma.node.findUnique({
+    where: { id: payload.nodeId },
+    select: { id: true, workspaceId: true, title: true, content: true, tags: true },
+  });
+  if (!node) return;
+  // One revision per snapshot, so a typing session is one entry rather than one per keystroke
+  await recordNodeRevision(node, payload.userId);
+  // Text changed - re-embed and re-link like a regular content update
+  await enqueueNodeIndexing(node, payload.userId, { debounce: true });
+});
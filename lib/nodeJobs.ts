@@ -0,0 +1,158 @@
+import { prisma } from './db';
+import { autoLinkNode, autoLinkNodes, storeNodeEmbeddings } from './db-server';
+import { getNodeEmbeddings } from './embeddings';
+import { assignNodesToClusters } from './clusterCache';
+import { enqueueJob, registerJobHandler, startJobWorker } from './jobQueue';
+
+// Server-only background indexing for nodes: embedding + auto-link (+ cluster assignment)
+// Runs on the durable job queue so node create/update never wait on OpenAI;
+// edges it creates bump the graph version and reach clients through delta sync
+
+const INDEX_NODE_JOB = 'index_node';
+// Many nodes at once (imports): one batched embedding call per job instead of one per node
+const INDEX_NODES_JOB = 'index_nodes';
+const INDEX_NODES_BATCH_SIZE = 500;
+
+// Edits arriving within this window coalesce into one embedding call
+const UPDATE_DEBOUNCE_MS = 2000;
+
+interface IndexNodePayload {
+  nodeId: string;
+  workspaceId: string;
+  userId?: string;
+}
+
+interface IndexNodesPayload {
+  workspaceId: string;
+  nodeIds: string[];
+  autoLink: boolean;
+}
+
+registerJobHandler(INDEX_NODE_JOB, async (payload: IndexNodePayload) => {
+  const { nodeId, userId } = payload;
+
+  // Always embed the latest stored text, not what was current at enqueue time
+  const node = await prisma.node.findUnique({
+    where: { id: nodeId },
+    select: { title: true, content: true, workspaceId: true },
+  });
+
+  if (!node) return; // Deleted before the job ran
+  if (!process.env.OPENAI_API_KEY) return; // Embeddings disabled - nothing to retry
+
+  const [embedding] = await getNodeEmbeddings([node]);
+  if (!embedding) {
+    // Thrown so the queue retries with backoff (rate limits, transient API errors)
+    throw new Error('Embedding generation failed');
+  }
+
+  const stored = await storeNodeEmbeddings([{ id: nodeId, embedding }]);
+  if (stored === 0) return; // Node deleted or pgvector not set up - auto-link needs the column
+
+  await assignNodesToClusters(node.workspaceId, [{ id: nodeId, embedding }]);
+
+  const edges = await autoLinkNode(node.workspaceId, nodeId);
+
+  if (edges.length > 0 && userId) {
+    try {
+      await prisma.activityLog.create({
+        data: {
+          workspaceId: node.workspaceId,
+          userId,
+          action: 'auto_link',
+          entityType: 'edge',
+          details: {
+            sourceNodeId: nodeId,
+            targetNodesCount: edges.length,
+          },
+        },
+      });
+    } catch (logError: any) {
+      console.warn('[nodeJobs] Failed to log auto-link activity (continuing):', logError?.message);
+    }
+  }
+});
+
+registerJobHandler(INDEX_NODES_JOB, async (payload: IndexNodesPayload) => {
+  const { workspaceId, nodeIds, autoLink } = payload;
+  if (!process.env.OPENAI_API_KEY) return;
+
+  const nodes = await prisma.node.findMany({
+    where: { workspaceId, id: { in: nodeIds } },
+    select: { id: true, title: true, content: true },
+  });
+  if (nodes.length === 0) return;
+
+  const embeddings = await getNodeEmbeddings(nodes);
+  const entries = nodes.flatMap((node, i) => {
+    const embedding = embeddings[i];
+    return embedding ? [{ id: node.id, embedding }] : [];
+  });
+  if (entries.length === 0) {
+    throw new Error('Embedding generation failed');
+  }
+
+  const stored = await storeNodeEmbeddings(entries);
+  if (stored === 0) return;
+
+  await assignNodesToClusters(workspaceId, entries);
+  if (!autoLink) return;
+
+  // Links against everything embedded so far - batches that finish later link back to this one
+  await autoLinkNodes(workspaceId, entries.map((entry) => entry.id));
+});
+
+/**
+ * Queue (re)embedding and auto-linking for a node
+ * Returns false if the job could not be queued (queue saturated or DB error) -
+ * the node write itself has already succeeded either way
+ */
+export async function enqueueNodeIndexing(
+  node: { id: string; workspaceId: string },
+  userId?: string,
+  options: { debounce?: boolean } = {}
+): Promise<boolean> {
+  const payload: IndexNodePayload = { nodeId: node.id, workspaceId: node.workspaceId, userId };
+
+  try {
+    return await enqueueJob(INDEX_NODE_JOB, `${INDEX_NODE_JOB}:${node.id}`, payload, {
+      delayMs: options.debounce ? UPDATE_DEBOUNCE_MS : 0,
+    });
+  } catch (error: any) {
+    console.warn('[nodeJobs] Failed to enqueue indexing job (continuing):', error?.message);
+    return false;
+  }
+}
+
+/**
+ * Queue embedding (and optionally auto-linking) for many new nodes, in batches
+ * Returns how many nodes were queued
+ */
+export async function enqueueBulkNodeIndexing(
+  workspaceId: string,
+  nodeIds: string[],
+  options: { autoLink?: boolean } = {}
+): Promise<number> {
+  let queued = 0;
+  for (let i = 0; i < nodeIds.length; i += INDEX_NODES_BATCH_SIZE) {
+    const batch = nodeIds.slice(i, i + INDEX_NODES_BATCH_SIZE);
+    const payload: IndexNodesPayload = { workspaceId, nodeIds: batch, autoLink: !!options.autoLink };
+    try {
+      // Node ids are fresh uuids, so the first one identifies the batch
+      if (await enqueueJob(INDEX_NODES_JOB, `${INDEX_NODES_JOB}:${batch[0]}`, payload)) {
+        queued += batch.length;
+      }
+    } catch (error: any) {
+      console.warn('[nodeJobs] Failed to enqueue bulk indexing job (continuing):', error?.message);
+      break;
+    }
+  }
+  return queued;
+}
+
+/**
+ * Start the in-process worker with node handlers registered
+ */
+export function startNodeJobWorker(): void {
+  startJobWorker();
+}
@@ -0,0 +1,270 @@
+import { prisma } from './db';
+import { enqueueJob, registerJobHandler } from './jobQueue';
+import { applyJsonPatch, diffJson, type JsonPatchOp } from './jsonPatch';
+
+// Server-only node version history (node_history)
+// - every revision is the node's title, content and tags after a change. A revision is stored
+//   as a full copy (keyframe) every KEYFRAME_INTERVAL revisions, or when its patch would be
+//   about as large as a copy; the ones in between hold a JSON patch (lib/jsonPatch.ts)
+//   against the previous revision
+// - any revision is rebuilt on demand from the nearest keyframe at or before it, so reads
+//   touch at most KEYFRAME_INTERVAL rows; listings return metadata only
+// - a background job thins out old revisions (everything recent, then one per day) and
+//   re-encodes the chain; numbers of kept revisions don't change
+
+export interface NodeSnapshot {
+  title: string;
+  content: unknown;
+  tags: string[];
+}
+
+export interface NodeRevisionSummary {
+  revision: number;
+  keyframe: boolean;
+  createdBy: string | null;
+  createdAt: Date;
+}
+
+const KEYFRAME_INTERVAL = 20;
+// A patch at least this share of the full snapshot is stored as a keyframe instead
+const KEYFRAME_PATCH_SHARE = 0.5;
+
+const COMPACT_JOB = 'compact_node_history';
+// Compaction is queued every COMPACT_EVERY revisions of a node
+const COMPACT_EVERY = 100;
+const COMPACT_DEBOUNCE_MS = 60_000;
+// Compaction keeps every revision younger than this, and the newest KEEP_RECENT regardless
+const KEEP_ALL_DAYS = 7;
+const KEEP_RECENT = 50;
+// Older revisions: the last of each day, up to MAX_REVISIONS per node in total
+const MAX_REVISIONS = 500;
+
+export const MAX_REVISIONS_PAGE = 100;
+
+interface CompactPayload {
+  nodeId: string;
+}
+
+registerJobHandler(COMPACT_JOB, async (payload: CompactPayload) => {
+  await compactNodeHistory(payload.nodeId);
+});
+
+function toSnapshot(node: { title: string; content: unknown; tags: string[] }): NodeSnapshot {
+  return { title: node.title, content: node.content ?? null, tags: node.tags };
+}
+
+type HistoryClient = Pick<typeof prisma, 'nodeHistory'>;
+
+// Rebuild `revision` (or the latest, if omitted) from its keyframe and the patches after it
+async function loadSnapshot(
+  client: HistoryClient,
+  nodeId: string,
+  revision?: number
+): Promise<{ revision: number; snapshot: NodeSnapshot } | null> {
+  const keyframe = await client.nodeHistory.findFirst({
+    where: { nodeId, keyframe: true, ...(revision !== undefined ? { revision: { lte: revision } } : {}) },
+    orderBy: { revision: 'desc' },
+    select: { revision: true, data: true },
+  });
+  if (!keyframe) return null;
+
+  const patches = await client.nodeHistory.findMany({
+    where: {
+      nodeId,
+      revision: { gt: keyframe.revision, ...(revision !== undefined ? { lte: revision } : {}) },
+    },
+    orderBy: { revision: 'asc' },
+    select: { revision: true, keyframe: true, data: true },
+  });
+
+  let snapshot = keyframe.data as unknown as NodeSnapshot;
+  let current = keyframe.revision;
+  for (const row of patches) {
+    snapshot = row.keyframe
+      ? (row.data as unknown as NodeSnapshot)
+      : applyJsonPatch(snapshot, row.data as unknown as JsonPatchOp[]);
+    current = row.revision;
+  }
+  return { revision: current, snapshot };
+}
+
+// Keyframe or patch for `snapshot` following `previous`, `sinceKeyframe` revisions after the
+// last keyframe
+function encodeRevision(previous: NodeSnapshot | null, snapshot: NodeSnapshot, sinceKeyframe: number) {
+  if (!previous || sinceKeyframe >= KEYFRAME_INTERVAL) return { keyframe: true, data: snapshot };
+  const patch = diffJson(previous, snapshot);
+  if (JSON.stringify(patch).length >= JSON.stringify(snapshot).length * KEYFRAME_PATCH_SHARE) {
+    return { keyframe: true, data: snapshot };
+  }
+  return { keyframe: false, data: patch };
+}
+
+/**
+ * Record a node's current title, content and tags as a new revision (no-op when unchanged)
+ * `previous` is the state before the change; it becomes the first revision of nodes that
+ * have no history yet. Never throws - history must not fail the edit.
+ */
+export async function recordNodeRevision(
+  node: { id: string; title: string; content: unknown; tags: string[] },
+  createdBy?: string | null,
+  previous?: { title: string; content: unknown; tags: string[] }
+): Promise<void> {
+  try {
+    const snapshot = toSnapshot(node);
+    const revision = await prisma.$transaction(async (tx) => {
+      // Row lock serialises revisions of the same node
+      const locked = await tx.$queryRaw<{ id: string }[]>`
+        SELECT id FROM nodes WHERE id = ${node.id} FOR UPDATE
+      `;
+      if (locked.length === 0) return null;
+
+      let latest = await loadSnapshot(tx, node.id);
+      if (!latest && previous) {
+        const base = toSnapshot(previous);
+        await tx.nodeHistory.create({
+          data: { nodeId: node.id, revision: 1, keyframe: true, data: base as any, createdBy: null },
+        });
+        latest = { revision: 1, snapshot: base };
+      }
+      if (latest && diffJson(latest.snapshot, snapshot).length === 0) return null;
+
+      const lastKeyframe = latest
+        ? await tx.nodeHistory.findFirst({
+            where: { nodeId: node.id, keyframe: true },
+            orderBy: { revision: 'desc' },
+            select: { revision: true },
+          })
+        : null;
+      const next = (latest?.revision ?? 0) + 1;
+      const encoded = encodeRevision(
+        latest?.snapshot ?? null,
+        snapshot,
+        lastKeyframe ? next - lastKeyframe.revision : KEYFRAME_INTERVAL
+      );
+      await tx.nodeHistory.create({
+        data: { nodeId: node.id, revision: next, keyframe: encoded.keyframe, data: encoded.data as any, createdBy: createdBy ?? null },
+      });
+      return next;
+    });
+
+    if (revision !== null && revision % COMPACT_EVERY === 0) {
+      const payload: CompactPayload = { nodeId: node.id };
+      await enqueueJob(COMPACT_JOB, `${COMPACT_JOB}:${node.id}`, payload, { delayMs: COMPACT_DEBOUNCE_MS });
+    }
+  } catch (error: any) {
+    console.warn('[nodeRevisions] Failed to record revision (continuing):', error?.message);
+  }
+}
+
+/**
+ * One page of a node's revisions, newest first - `before` is the revision to continue below
+ */
+export async function listNodeRevisions(
+  nodeId: string,
+  options: { before?: number; limit?: number } = {}
+): Promise<{ revisions: NodeRevisionSummary[]; nextCursor: number | null }> {
+  const limit = Math.min(Math.max(options.limit ?? 20, 1), MAX_REVISIONS_PAGE);
+  const rows = await prisma.nodeHistory.findMany({
+    where: { nodeId, ...(options.before !== undefined ? { revision: { lt: options.before } } : {}) },
+    orderBy: { revision: 'desc' },
+    take: limit + 1,
+    select: { revision: true, keyframe: true, createdBy: true, createdAt: true },
+  });
+  const revisions = rows.slice(0, limit);
+  return {
+    revisions,
+    nextCursor: rows.length > limit ? revisions[revisions.length - 1].revision : null,
+  };
+}
+
+/**
+ * Title, content and tags of one revision, rebuilt from its keyframe (null if it doesn't exist)
+ */
+export async function getNodeRevision(
+  nodeId: string,
+  revision: number
+): Promise<(NodeRevisionSummary & { snapshot: NodeSnapshot }) | null> {
+  const row = await prisma.nodeHistory.findUnique({
+    where: { nodeId_revision: { nodeId, revision } },
+    select: { revision: true, keyframe: true, createdBy: true, createdAt: true },
+  });
+  if (!row) return null;
+  const rebuilt = await loadSnapshot(prisma, nodeId, revision);
+  return rebuilt ? { ...row, snapshot: rebuilt.snapshot } : null;
+}
+
+// Revisions compaction keeps: the newest KEEP_RECENT, everything from the last KEEP_ALL_DAYS,
+// and the last revision of each earlier day - then at most MAX_REVISIONS, newest first
+function revisionsToKeep(rows: Array<{ revision: number; createdAt: Date }>, now: Date): Set<number> {
+  const keep = new Set<number>();
+  const cutoff = now.getTime() - KEEP_ALL_DAYS * 24 * 60 * 60 * 1000;
+  const days = new Set<string>();
+  // Newest first
+  for (let i = rows.length - 1; i >= 0; i--) {
+    const { revision, createdAt } = rows[i];
+    if (keep.size >= MAX_REVISIONS) break;
+    if (rows.length - i <= KEEP_RECENT || createdAt.getTime() >= cutoff) {
+      keep.add(revision);
+      continue;
+    }
+    const day = createdAt.toISOString().slice(0, 10);
+    if (days.has(day)) continue;
+    days.add(day);
+    keep.add(revision);
+  }
+  return keep;
+}
+
+/**
+ * Drop old revisions of a node and re-encode the remaining chain
+ * Returns how many revisions were removed.
+ */
+export async function compactNodeHistory(nodeId: string): Promise<number> {
+  return prisma.$transaction(async (tx) => {
+    const locked = await tx.$queryRaw<{ id: string }[]>`
+      SELECT id FROM nodes WHERE id = ${nodeId} FOR UPDATE
+    `;
+    if (locked.length === 0) return 0;
+
+    const rows = await tx.nodeHistory.findMany({
+      where: { nodeId },
+      orderBy: { revision: 'asc' },
+      select: { id: true, revision: true, keyframe: true, data: true, createdBy: true, createdAt: true },
+    });
+    const keep = revisionsToKeep(rows, new Date());
+    if (keep.size === rows.length) return 0;
+
+    // Replay the whole chain, re-encoding kept revisions against the previous kept one
+    let snapshot: NodeSnapshot | null = null;
+    let previousKept: NodeSnapshot | null = null;
+    let sinceKeyframe = KEYFRAME_INTERVAL;
+    // A kept row whose predecessor is kept too only needs rewriting if its kind changes
+    let predecessorKept = true;
+    const removed: string[] = [];
+    for (const row of rows) {
+      snapshot = row.keyframe
+        ? (row.data as unknown as NodeSnapshot)
+        : applyJsonPatch(snapshot as NodeSnapshot, row.data as unknown as JsonPatchOp[]);
+
+      if (!keep.has(row.revision)) {
+        removed.push(row.id);
+        predecessorKept = false;
+        continue;
+      }
+      const encoded = encodeRevision(previousKept, snapshot, sinceKeyframe);
+      sinceKeyframe = encoded.keyframe ? 1 : sinceKeyframe + 1;
+      previousKept = snapshot;
+      const rewrite = encoded.keyframe !== row.keyframe || !predecessorKept;
+      predecessorKept = true;
+      if (rewrite) {
+        await tx.nodeHistory.update({
+          where: { id: row.id },
+          data: { keyframe: encoded.keyframe, data: encoded.data as any },
+        });
+      }
+    }
+
+    await tx.nodeHistory.deleteMany({ where: { id: { in: removed } } });
+    return removed.length;
+  }, { timeout: 60_000 });
+}
@@ -0,0 +1,36 @@
+// Plain-text extraction from node content - shared by embeddings (server) and the
+// client search index, so it must stay free of server-only imports
+
+/**
+ * Extract plain text from JSONB content
+ */
+export function extractTextFromJSON(content: any): string {
+  if (typeof content === 'string') return content;
+  if (typeof content === 'object' && content !== null) {
+    if (content.type === 'doc' && content.content) {
+      // TipTap JSON format
+      return extractTextFromTipTap(content);
+    }
+    // Fallback: stringify, minus layout-only metadata (size/rotation/zIndex) so
+    // moving or re-layering a node doesn't change its embedding text
+    const rest = { ...content };
+    delete rest.nodeMetadata;
+    return JSON.stringify(rest);
+  }
+  return '';
+}
+
+/**
+ * Extract text from TipTap JSON structure
+ */
+function extractTextFromTipTap(node: any): string {
+  if (node.type === 'text' && node.text) {
+    return node.text;
+  }
+  
+  if (node.content && Array.isArray(node.content)) {
+    return node.content.map((child: any) => extractTextFromTipTap(child)).join(' ');
+  }
+  
+  return '';
+}
@@ -42,15 +42,23 @@ export function throttle<T extends (...args: any[]) => any>(
 export class Cache<T> {
   private cache = new Map<string, { value: T; expires: number }>();
   private defaultTTL: number;
+  private maxEntries: number;
 
-  constructor(defaultTTL: number = 5 * 60 * 1000) {
+  constructor(defaultTTL: number = 5 * 60 * 1000, maxEntries: number = Infinity) {
     // 5 minutes default
     this.defaultTTL = defaultTTL;
+    this.maxEntries = maxEntries;
   }
 
   set(key: string, value: T, ttl?: number): void {
     const expires = Date.now() + (ttl || this.defaultTTL);
+    // Re-insert so Map order tracks recency, then evict the oldest entries over the cap
+    this.cache.delete(key);
     this.cache.set(key, { value, expires });
+    while (this.cache.size > this.maxEntries) {
+      const oldest = this.cache.keys().next().value as string;
+      this.cache.delete(oldest);
+    }
   }
 
   get(key: string): T | null {
@@ -78,18 +86,141 @@ export class Cache<T> {
   }
 }
 
-// Embedding cache
-export const embeddingCache = new Cache<number[]>(30 * 60 * 1000); // 30 minutes
-
-// Node position update debouncer
-export const debouncedPositionUpdate = debounce(
-  async (updates: Array<{ id: string; x: number; y: number }>) => {
-    // Batch update positions
-    // This would call the API
-    console.log('Batch position update:', updates);
-  },
-  500
-);
+// Embedding cache - in-process front of the Postgres cache in lib/embeddingService.ts
+// Keyed by content hash; capped so bulk imports can't grow it without bound (~12 KB per entry)
+export const embeddingCache = new Cache<number[]>(30 * 60 * 1000, 1000); // 30 minutes
+
+// Node position/layer update queue
+// Coalesces position and zIndex changes per node and flushes them to
+// PUT /api/nodes/batch once per idle callback (or animation frame), so a drag,
+// multi-select move or auto-organize of N nodes costs one request instead of N
+export interface NodePositionUpdate {
+  nodeId: string;
+  x?: number;
+  y?: number;
+  zIndex?: number;
+}
+
+// Must not exceed MAX_BATCH_SIZE in app/api/nodes/batch/route.ts
+const POSITION_BATCH_SIZE = 500;
+
+class NodeUpdateQueue {
+  // workspaceId -> nodeId -> merged pending update
+  private pending = new Map<string, Map<string, NodePositionUpdate>>();
+  private scheduled = false;
+  private flushing: Promise<void> | null = null;
+
+  enqueue(workspaceId: string, update: NodePositionUpdate): void {
+    let workspaceUpdates = this.pending.get(workspaceId);
+    if (!workspaceUpdates) {
+      workspaceUpdates = new Map();
+      this.pending.set(workspaceId, workspaceUpdates);
+    }
+
+    // Later values for the same node overwrite earlier ones field by field
+    const existing = workspaceUpdates.get(update.nodeId);
+    workspaceUpdates.set(update.nodeId, existing ? { ...existing, ...update } : { ...update });
+
+    this.schedule();
+  }
+
+  enqueueMany(workspaceId: string, updates: NodePositionUpdate[]): void {
+    updates.forEach((update) => this.enqueue(workspaceId, update));
+  }
+
+  get size(): number {
+    let total = 0;
+    this.pending.forEach((updates) => (total += updates.size));
+    return total;
+  }
+
+  private schedule(): void {
+    if (this.scheduled) return;
+    this.scheduled = true;
+
+    const run = () => {
+      this.scheduled = false;
+      void this.flush();
+    };
+
+    if (typeof window === 'undefined') {
+      setTimeout(run, 0);
+    } else if ('requestIdleCallback' in window) {
+      // Bounded timeout so updates still go out while the main thread is busy animating
+      (window as any).requestIdleCallback(run, { timeout: 250 });
+    } else {
+      requestAnimationFrame(run);
+    }
+  }
+
+  // Send everything queued so far; concurrent callers share the in-flight flush
+  async flush(options: { keepalive?: boolean } = {}): Promise<void> {
+    if (this.flushing) {
+      await this.flushing;
+    }
+    if (this.pending.size === 0) return;
+
+    const batches = this.pending;
+    this.pending = new Map();
+
+    this.flushing = (async () => {
+      const requests: Promise<void>[] = [];
+
+      batches.forEach((updates, workspaceId) => {
+        const all = Array.from(updates.values());
+        for (let i = 0; i < all.length; i += POSITION_BATCH_SIZE) {
+          const chunk = all.slice(i, i + POSITION_BATCH_SIZE);
+          requests.push(this.send(workspaceId, chunk, options.keepalive));
+        }
+      });
+
+      await Promise.all(requests);
+    })();
+
+    try {
+      await this.flushing;
+    } finally {
+      this.flushing = null;
+    }
+  }
+
+  private async send(workspaceId: string, updates: NodePositionUpdate[], keepalive?: boolean) {
+    try {
+      const response = await fetch('/api/nodes/batch', {
+        method: 'PUT',
+        headers: { 'Content-Type': 'application/json' },
+        body: JSON.stringify({ workspaceId, updates }),
+        keepalive,
+      });
+
+      if (!response.ok) {
+        console.error('[NodeUpdateQueue] Batch update failed:', response.status, response.statusText);
+      }
+    } catch (error) {
+      console.error('[NodeUpdateQueue] Error sending batch update:', error);
+    }
+  }
+}
+
+export const nodeUpdateQueue = new NodeUpdateQueue();
+
+// Don't lose the last drag when the tab is closed before the idle callback fires
+if (typeof window !== 'undefined') {
+  window.addEventListener('pagehide', () => {
+    void nodeUpdateQueue.flush({ keepalive: true });
+  });
+}
+
+// Queue position updates for a workspace (coalesced and flushed in batches)
+export function debouncedPositionUpdate(
+  workspaceId: string,
+  updates: Array<{ id: string; x: number; y: number }>
+): void {
+  nodeUpdateQueue.enqueueMany(
+    workspaceId,
+    updates.map((u) => ({ nodeId: u.id, x: u.x, y: u.y }))
+  );
+}
 
 // Pagination helper
 export function paginate<T>(array: T[], page: number, pageSize: number) {
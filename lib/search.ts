@@ -1,13 +1,134 @@
 import Fuse from 'fuse.js';
 import type { Node } from '@/types/Node';
+import { extractTextFromJSON } from './nodeText';
 
 export interface SearchResult {
   node: Node;
   score?: number;
 }
 
+interface SearchDocument {
+  id: string;
+  title: string;
+  tags: string[];
+  text: string;
+}
+
+const SEARCH_KEYS = [
+  { name: 'title', weight: 3 },
+  { name: 'tags', weight: 2 },
+  { name: 'text', weight: 1 },
+];
+
+/**
+ * Incrementally maintained Fuse index over a node list
+ * `sync` diffs by reference: a node whose title/content/tags are the same objects as last
+ * time (e.g. it only moved) is not re-indexed, so keeping the index current after a store
+ * update costs one pass over the ids plus work for the nodes that actually changed.
+ */
+export class NodeSearchIndex {
+  private fuse: Fuse<SearchDocument>;
+  private entries = new Map<string, { node: Node; doc: SearchDocument }>();
+
+  constructor(nodes: Node[] = [], private threshold = 0.3) {
+    const docs: SearchDocument[] = [];
+    for (const node of nodes) {
+      const doc = toSearchDocument(node);
+      this.entries.set(node.id, { node, doc });
+      docs.push(doc);
+    }
+    this.fuse = new Fuse(docs, this.fuseOptions());
+  }
+
+  get size(): number {
+    return this.entries.size;
+  }
+
+  /**
+   * Bring the index in line with `nodes` (the full current list)
+   */
+  sync(nodes: Node[]): void {
+    const seen = new Set<string>();
+    const stale = new Set<string>();
+    const added: SearchDocument[] = [];
+
+    for (const node of nodes) {
+      seen.add(node.id);
+      const entry = this.entries.get(node.id);
+      if (entry?.node === node) continue;
+
+      if (
+        entry &&
+        entry.node.title === node.title &&
+        entry.node.content === node.content &&
+        entry.node.tags === node.tags
+      ) {
+        entry.node = node; // Same searchable fields - only the result reference changes
+        continue;
+      }
+
+      if (entry) stale.add(node.id);
+      const doc = toSearchDocument(node);
+      this.entries.set(node.id, { node, doc });
+      added.push(doc);
+    }
+
+    if (this.entries.size > seen.size) {
+      this.entries.forEach((_, id) => {
+        if (!seen.has(id)) {
+          stale.add(id);
+          this.entries.delete(id);
+        }
+      });
+    }
+
+    // One removal pass (Fuse scans its records per remove call), then appends
+    if (stale.size > 0) {
+      this.fuse.remove((doc) => stale.has(doc.id));
+    }
+    for (const doc of added) {
+      this.fuse.add(doc);
+    }
+  }
+
+  search(query: string, limit: number = 10): SearchResult[] {
+    if (!query.trim()) {
+      return [];
+    }
+
+    const results: SearchResult[] = [];
+    for (const result of this.fuse.search(query, { limit })) {
+      const entry = this.entries.get(result.item.id);
+      if (entry) results.push({ node: entry.node, score: result.score });
+    }
+    return results;
+  }
+
+  private fuseOptions() {
+    return {
+      keys: SEARCH_KEYS,
+      threshold: this.threshold,
+      includeScore: true,
+      ignoreLocation: true, // Matches deep in long content count as much as ones at the start
+    };
+  }
+}
+
+function toSearchDocument(node: Node): SearchDocument {
+  return {
+    id: node.id,
+    title: node.title || '',
+    tags: node.tags || [],
+    text: extractTextFromJSON(node.content),
+  };
+}
+
+// One long-lived index per threshold, shared by searchNodes callers
+const sharedIndexes = new Map<number, NodeSearchIndex>();
+
 /**
  * Search nodes using Fuse.js fuzzy search
+ * Reuses a persistent index synced against `nodes`, instead of rebuilding it per call
  */
 export function searchNodes(
   query: string,
@@ -21,21 +142,16 @@ export function searchNodes(
     return [];
   }
 
-  const fuse = new Fuse(nodes, {
-    keys: ['title', 'content', 'tags'],
-    threshold: options?.threshold || 0.3,
-    includeScore: true,
-  });
-
-  const results = fuse.search(query);
-  
-  const limit = options?.limit || 10;
-  const limitedResults = results.slice(0, limit);
+  const threshold = options?.threshold || 0.3;
+  let index = sharedIndexes.get(threshold);
+  if (!index) {
+    index = new NodeSearchIndex(nodes, threshold);
+    sharedIndexes.set(threshold, index);
+  } else {
+    index.sync(nodes);
+  }
 
-  return limitedResults.map((result) => ({
-    node: result.item,
-    score: result.score,
-  }));
+  return index.search(query, options?.limit || 10);
 }
 
 /**
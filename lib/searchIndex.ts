@@ -0,0 +1,194 @@
+import { Prisma } from '@prisma/client';
+import { prisma } from './db';
+import { searchNodesByEmbedding } from './db-server';
+import { embedTexts } from './embeddingService';
+
+// Server-only node search over the Postgres search index (prisma/sql/search_index.sql)
+// - full-text: weighted tsvector (title > tags > content), prefix-matched on the last term
+// - fuzzy: trigram substring / word similarity, so partial words and typos still match
+// - semantic: the query embedding against stored node embeddings (pgvector)
+// The text and semantic rankings are fused with reciprocal rank fusion, then paginated.
+
+const MAX_QUERY_TERMS = 16;
+// Candidates taken from each ranking; pages beyond this window are not reachable
+const MAX_CANDIDATES = 500;
+// Query-to-node similarity runs lower than node-to-node, so this sits below SUGGEST_LINK
+const MIN_SEMANTIC_SIMILARITY = 0.3;
+// Standard RRF damping constant - keeps the top few ranks from dominating
+const RRF_K = 60;
+
+export interface NodeSearchOptions {
+  limit?: number;
+  offset?: number;
+  tags?: string[];
+  dateFrom?: Date;
+  dateTo?: Date;
+  // Include semantic (embedding) matches; skipped anyway without an OpenAI key
+  semantic?: boolean;
+}
+
+export interface NodeSearchHit {
+  id: string;
+  score: number;
+  textRank: number | null;
+  similarity: number | null;
+}
+
+export interface NodeSearchPage {
+  hits: NodeSearchHit[];
+  total: number;
+  nextOffset: number | null;
+}
+
+/**
+ * Build a to_tsquery expression from free text: every term must match, the last one
+ * as a prefix so results keep up while the user is still typing. Terms are reduced to
+ * letters/digits, so user input can never inject tsquery operators.
+ */
+export function buildPrefixTsQuery(query: string): string | null {
+  const terms = query.toLowerCase().match(/[\p{L}\p{N}]+/gu);
+  if (!terms || terms.length === 0) return null;
+
+  const used = terms.slice(0, MAX_QUERY_TERMS);
+  used[used.length - 1] += ':*';
+  return used.join(' & ');
+}
+
+function escapeLike(text: string): string {
+  return text.replace(/[\\%_]/g, (ch) => `\\${ch}`);
+}
+
+function buildFilter(options: NodeSearchOptions): Prisma.Sql {
+  const conditions: Prisma.Sql[] = [];
+  if (options.tags && options.tags.length > 0) {
+    conditions.push(Prisma.sql`AND n.tags && ${options.tags}::text[]`);
+  }
+  if (options.dateFrom) {
+    conditions.push(Prisma.sql`AND n.created_at >= ${options.dateFrom}`);
+  }
+  if (options.dateTo) {
+    conditions.push(Prisma.sql`AND n.created_at <= ${options.dateTo}`);
+  }
+  return conditions.length > 0 ? Prisma.join(conditions, ' ') : Prisma.empty;
+}
+
+/**
+ * Full-text + trigram matches, best first, with the total number of matches
+ * The WHERE clause uses exactly the indexed expressions, so both GIN indexes apply
+ */
+async function searchText(
+  workspaceId: string,
+  query: string,
+  limit: number,
+  filter: Prisma.Sql
+): Promise<{ rows: Array<{ id: string; rank: number }>; total: number }> {
+  const tsQuery = buildPrefixTsQuery(query);
+  const raw = query.trim().toLowerCase();
+  const pattern = `%${escapeLike(raw)}%`;
+
+  const rows = await prisma.$queryRaw<Array<{ id: string; rank: number; total: bigint }>>`
+    WITH q AS (SELECT to_tsquery('english', ${tsQuery}::text) AS tsq)
+    SELECT n.id,
+           coalesce(ts_rank_cd(node_search_document(n.title, n.tags, n.content), q.tsq), 0)
+             + word_similarity(${raw}, node_search_text(n.title, n.tags, n.content)) AS rank,
+           COUNT(*) OVER () AS total
+    FROM nodes n, q
+    WHERE n.workspace_id = ${workspaceId}
+      ${filter}
+      AND (
+        node_search_document(n.title, n.tags, n.content) @@ q.tsq
+        OR node_search_text(n.title, n.tags, n.content) LIKE ${pattern}
+        OR ${raw} <% node_search_text(n.title, n.tags, n.content)
+      )
+    ORDER BY rank DESC, n.updated_at DESC
+    LIMIT ${limit}
+  `;
+
+  return {
+    rows: rows.map((row) => ({ id: row.id, rank: Number(row.rank) })),
+    total: rows.length > 0 ? Number(rows[0].total) : 0,
+  };
+}
+
+async function searchSemantic(
+  workspaceId: string,
+  query: string,
+  limit: number,
+  filter: Prisma.Sql
+): Promise<Array<{ id: string; similarity: number }>> {
+  if (!process.env.OPENAI_API_KEY) return [];
+
+  try {
+    // Repeated queries hit the embedding cache instead of OpenAI
+    const [embedding] = await embedTexts([query]);
+    if (!embedding) return [];
+    return await searchNodesByEmbedding(workspaceId, embedding, limit, MIN_SEMANTIC_SIMILARITY, filter);
+  } catch (error: any) {
+    // Semantic ranking is best-effort - text results are still returned
+    console.warn('[searchIndex] Semantic search failed (continuing):', error?.message);
+    return [];
+  }
+}
+
+/**
+ * Hybrid ranked search over a workspace's nodes
+ * Each node scores sum(1 / (RRF_K + rank)) over the rankings it appears in, so a node
+ * found by both text and meaning outranks one found by either alone. `total` counts all
+ * text matches plus semantic-only matches within the candidate window.
+ */
+export async function searchWorkspaceNodes(
+  workspaceId: string,
+  query: string,
+  options: NodeSearchOptions = {}
+): Promise<NodeSearchPage> {
+  const limit = Math.max(1, Math.min(options.limit ?? 20, 100));
+  const offset = Math.max(0, options.offset ?? 0);
+
+  if (!query.trim() || offset >= MAX_CANDIDATES) {
+    return { hits: [], total: 0, nextOffset: null };
+  }
+
+  const candidateLimit = Math.min(offset + limit, MAX_CANDIDATES);
+  const filter = buildFilter(options);
+
+  const [text, semantic] = await Promise.all([
+    searchText(workspaceId, query, candidateLimit, filter),
+    options.semantic === false
+      ? Promise.resolve([])
+      : searchSemantic(workspaceId, query, candidateLimit, filter),
+  ]);
+
+  const fused = new Map<string, NodeSearchHit>();
+  const hitFor = (id: string): NodeSearchHit => {
+    let hit = fused.get(id);
+    if (!hit) {
+      hit = { id, score: 0, textRank: null, similarity: null };
+      fused.set(id, hit);
+    }
+    return hit;
+  };
+
+  text.rows.forEach((row, rank) => {
+    const hit = hitFor(row.id);
+    hit.score += 1 / (RRF_K + rank + 1);
+    hit.textRank = row.rank;
+  });
+
+  let semanticOnly = 0;
+  semantic.forEach((row, rank) => {
+    if (!fused.has(row.id)) semanticOnly++;
+    const hit = hitFor(row.id);
+    hit.score += 1 / (RRF_K + rank + 1);
+    hit.similarity = row.similarity;
+  });
+
+  const ranked = Array.from(fused.values()).sort((a, b) => b.score - a.score);
+  const total = text.total + semanticOnly;
+  const end = offset + limit;
+
+  return {
+    hits: ranked.slice(offset, end),
+    total,
+    nextOffset: end < Math.min(total, MAX_CANDIDATES) ? end : null,
+  };
+}
@@ -0,0 +1,197 @@
+import type { FlowRect } from './viewportTiles';
+
+// Uniform grid of node bounds in canvas (flow) coordinates
+// - each node is listed in every cell its bounds touch, so a rect query only looks at the
+//   nodes in the cells it covers instead of every node on the canvas
+// - CanvasContainer keeps canvasNodeIndex in step with React Flow's nodes (measured sizes once
+//   React Flow has them); drop-to-connect, drag hover and new node placement query it
+// Cells are sized around a typical node so most nodes sit in one to four cells.
+
+export const SPATIAL_CELL_SIZE = 256;
+
+// Gap kept around a new node when looking for free space
+const PLACEMENT_GAP = 24;
+// Rings of candidate positions tried around the requested point before giving up
+const PLACEMENT_MAX_RINGS = 12;
+
+function cellKey(cx: number, cy: number): string {
+  return `${cx}:${cy}`;
+}
+
+export function rectsOverlap(a: FlowRect, b: FlowRect): boolean {
+  return a.minX < b.maxX && b.minX < a.maxX && a.minY < b.maxY && b.minY < a.maxY;
+}
+
+export function overlapArea(a: FlowRect, b: FlowRect): number {
+  const width = Math.min(a.maxX, b.maxX) - Math.max(a.minX, b.minX);
+  const height = Math.min(a.maxY, b.maxY) - Math.max(a.minY, b.minY);
+  return width > 0 && height > 0 ? width * height : 0;
+}
+
+export class SpatialGrid {
+  private cells = new Map<string, Set<string>>();
+  private bounds = new Map<string, FlowRect>();
+
+  constructor(private readonly cellSize = SPATIAL_CELL_SIZE) {}
+
+  get size(): number {
+    return this.bounds.size;
+  }
+
+  has(id: string): boolean {
+    return this.bounds.has(id);
+  }
+
+  get(id: string): FlowRect | undefined {
+    return this.bounds.get(id);
+  }
+
+  ids(): IterableIterator<string> {
+    return this.bounds.keys();
+  }
+
+  /**
+   * Insert or move a node; a no-op when its bounds are unchanged
+   */
+  set(id: string, rect: FlowRect) {
+    const previous = this.bounds.get(id);
+    if (
+      previous &&
+      previous.minX === rect.minX &&
+      previous.minY === rect.minY &&
+      previous.maxX === rect.maxX &&
+      previous.maxY === rect.maxY
+    ) {
+      return;
+    }
+    if (previous) this.forEachCell(previous, (key) => this.removeFromCell(key, id));
+    this.bounds.set(id, rect);
+    this.forEachCell(rect, (key) => {
+      let cell = this.cells.get(key);
+      if (!cell) {
+        cell = new Set();
+        this.cells.set(key, cell);
+      }
+      cell.add(id);
+    });
+  }
+
+  delete(id: string) {
+    const previous = this.bounds.get(id);
+    if (!previous) return;
+    this.forEachCell(previous, (key) => this.removeFromCell(key, id));
+    this.bounds.delete(id);
+  }
+
+  clear() {
+    this.cells.clear();
+    this.bounds.clear();
+  }
+
+  /**
+   * Ids of nodes whose bounds intersect `rect`
+   */
+  query(rect: FlowRect): string[] {
+    const found = new Set<string>();
+    this.forEachCell(rect, (key) => {
+      this.cells.get(key)?.forEach((id) => {
+        if (found.has(id)) return;
+        const bounds = this.bounds.get(id);
+        if (bounds && rectsOverlap(bounds, rect)) found.add(id);
+      });
+    });
+    return Array.from(found);
+  }
+
+  /**
+   * Ids of nodes containing the point
+   */
+  queryPoint(x: number, y: number): string[] {
+    const cell = this.cells.get(cellKey(Math.floor(x / this.cellSize), Math.floor(y / this.cellSize)));
+    if (!cell) return [];
+    const found: string[] = [];
+    cell.forEach((id) => {
+      const bounds = this.bounds.get(id);
+      if (bounds && x >= bounds.minX && x <= bounds.maxX && y >= bounds.minY && y <= bounds.maxY) found.push(id);
+    });
+    return found;
+  }
+
+  private forEachCell(rect: FlowRect, visit: (key: string) => void) {
+    const minCx = Math.floor(rect.minX / this.cellSize);
+    const maxCx = Math.floor(rect.maxX / this.cellSize);
+    const minCy = Math.floor(rect.minY / this.cellSize);
+    const maxCy = Math.floor(rect.maxY / this.cellSize);
+    for (let cx = minCx; cx <= maxCx; cx++) {
+      for (let cy = minCy; cy <= maxCy; cy++) visit(cellKey(cx, cy));
+    }
+  }
+
+  private removeFromCell(key: string, id: string) {
+    const cell = this.cells.get(key);
+    if (!cell) return;
+    cell.delete(id);
+    if (cell.size === 0) this.cells.delete(key);
+  }
+}
+
+/**
+ * Node of the index that a dragged rect overlaps most, ignoring `exclude` (the dragged nodes)
+ */
+export function findDropTarget(index: SpatialGrid, rect: FlowRect, exclude: Set<string>): string | null {
+  let best: string | null = null;
+  let bestArea = 0;
+  for (const id of index.query(rect)) {
+    if (exclude.has(id)) continue;
+    const area = overlapArea(index.get(id)!, rect);
+    if (area > bestArea) {
+      best = id;
+      bestArea = area;
+    }
+  }
+  return best;
+}
+
+/**
+ * Top-left position for a new node of the given size at or near (x, y) that doesn't overlap
+ * any indexed node. Tries rings of positions one node step apart around the point; returns
+ * the point itself if everything nearby is taken.
+ */
+export function findOpenPosition(
+  index: SpatialGrid,
+  x: number,
+  y: number,
+  width: number,
+  height: number
+): { x: number; y: number } {
+  const fits = (left: number, top: number) =>
+    index.query({
+      minX: left - PLACEMENT_GAP,
+      minY: top - PLACEMENT_GAP,
+      maxX: left + width + PLACEMENT_GAP,
+      maxY: top + height + PLACEMENT_GAP,
+    }).length === 0;
+
+  if (index.size === 0 || fits(x, y)) return { x, y };
+
+  const stepX = width + PLACEMENT_GAP;
+  const stepY = height + PLACEMENT_GAP;
+  for (let ring = 1; ring <= PLACEMENT_MAX_RINGS; ring++) {
+    // Nearest candidates of the ring first
+    const candidates: Array<{ dx: number; dy: number }> = [];
+    for (let i = -ring; i <= ring; i++) {
+      for (let j = -ring; j <= ring; j++) {
+        if (Math.max(Math.abs(i), Math.abs(j)) === ring) candidates.push({ dx: i * stepX, dy: j * stepY });
+      }
+    }
+    candidates.sort((a, b) => a.dx * a.dx + a.dy * a.dy - (b.dx * b.dx + b.dy * b.dy));
+    for (const { dx, dy } of candidates) {
+      if (fits(x + dx, y + dy)) return { x: x + dx, y: y + dy };
+    }
+  }
+  return { x, y };
+}
+
+// The mounted canvas's index. One canvas is mounted at a time; CanvasContainer fills it and
+// clears it on unmount, and node creation reads it to place new nodes in free space
+export const canvasNodeIndex = new SpatialGrid();
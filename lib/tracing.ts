@@ -0,0 +1,346 @@
+import { AsyncLocalStorage } from 'async_hooks';
+import { randomBytes } from 'crypto';
+
+// Server-only request tracing
+// - traceRoute wraps a route handler: it times the request, adds a Server-Timing header
+//   (span durations summed per category - auth, db, embed, vector) and records the duration
+//   in a per-route latency histogram (p50/p95/p99 via getLatencyMetrics, GET /api/metrics)
+// - withSpan times one unit of work inside the current request; Prisma queries are spans
+//   automatically (lib/db.ts). Outside a request, spans only feed the histograms
+// - one structured log line per sampled request (TRACE_SAMPLE_RATE, default 1%); errors and
+//   slow requests (>= TRACE_SLOW_MS) are always logged
+// - with OTEL_EXPORTER_OTLP_ENDPOINT set, spans of sampled requests are batched to the OTLP/HTTP
+//   JSON endpoint; an incoming W3C traceparent is continued, including its sampled flag
+
+type SpanAttributes = Record<string, string | number | boolean | undefined>;
+
+interface SpanRecord {
+  spanId: string;
+  parentSpanId: string;
+  name: string;
+  startMs: number; // Epoch ms, fractional
+  durationMs: number;
+  attributes?: SpanAttributes;
+  error?: string;
+}
+
+interface RequestTrace {
+  traceId: string;
+  rootSpanId: string;
+  parentSpanId?: string; // From traceparent
+  sampled: boolean;
+  spans: SpanRecord[];
+}
+
+interface TraceScope {
+  trace: RequestTrace;
+  spanId: string;
+}
+
+const SAMPLE_RATE = Number(process.env.TRACE_SAMPLE_RATE ?? 0.01);
+const SLOW_REQUEST_MS = Number(process.env.TRACE_SLOW_MS ?? 1000);
+const OTLP_ENDPOINT = process.env.OTEL_EXPORTER_OTLP_ENDPOINT?.replace(/\/$/, '');
+const SERVICE_NAME = process.env.OTEL_SERVICE_NAME || 'meshflow';
+
+// A request keeps at most this many spans (a relink can run thousands of queries)
+const MAX_SPANS_PER_TRACE = 500;
+const EXPORT_BATCH_SPANS = 512;
+const EXPORT_INTERVAL_MS = 5000;
+const MAX_QUEUED_SPANS = 10_000;
+
+// Histogram buckets: exponential from 0.1ms, ~9% apart, up to ~2 minutes
+const BUCKET_BASE_MS = 0.1;
+const BUCKET_GROWTH = 1.09;
+const BUCKET_COUNT = 160;
+const LOG_GROWTH = Math.log(BUCKET_GROWTH);
+
+class LatencyHistogram {
+  private buckets = new Uint32Array(BUCKET_COUNT);
+  count = 0;
+  sum = 0;
+  max = 0;
+
+  observe(ms: number) {
+    const index = ms <= BUCKET_BASE_MS ? 0 : Math.min(BUCKET_COUNT - 1, Math.ceil(Math.log(ms / BUCKET_BASE_MS) / LOG_GROWTH));
+    this.buckets[index]++;
+    this.count++;
+    this.sum += ms;
+    if (ms > this.max) this.max = ms;
+  }
+
+  // Upper bound of the bucket holding the q-th quantile (within ~9%)
+  quantile(q: number): number {
+    if (this.count === 0) return 0;
+    const rank = Math.ceil(q * this.count);
+    let seen = 0;
+    for (let i = 0; i < BUCKET_COUNT; i++) {
+      seen += this.buckets[i];
+      if (seen >= rank) return Math.min(this.max, BUCKET_BASE_MS * Math.pow(BUCKET_GROWTH, i));
+    }
+    return this.max;
+  }
+}
+
+// Kept on globalThis so dev hot reloads don't reset the histograms or drop queued spans
+const globalForTracing = globalThis as unknown as {
+  traceStorage: AsyncLocalStorage<TraceScope> | undefined;
+  routeHistograms: Map<string, LatencyHistogram> | undefined;
+  spanHistograms: Map<string, LatencyHistogram> | undefined;
+  exportQueue: Array<{ trace: RequestTrace; span: SpanRecord }> | undefined;
+};
+
+const traceStorage = globalForTracing.traceStorage ?? new AsyncLocalStorage<TraceScope>();
+const routeHistograms = globalForTracing.routeHistograms ?? new Map<string, LatencyHistogram>();
+const spanHistograms = globalForTracing.spanHistograms ?? new Map<string, LatencyHistogram>();
+const exportQueue = globalForTracing.exportQueue ?? [];
+globalForTracing.traceStorage = traceStorage;
+globalForTracing.routeHistograms = routeHistograms;
+globalForTracing.spanHistograms = spanHistograms;
+globalForTracing.exportQueue = exportQueue;
+
+let exportTimer: NodeJS.Timeout | null = null;
+
+function observe(histograms: Map<string, LatencyHistogram>, name: string, ms: number) {
+  let histogram = histograms.get(name);
+  if (!histogram) {
+    histogram = new LatencyHistogram();
+    histograms.set(name, histogram);
+  }
+  histogram.observe(ms);
+}
+
+function nowMs(): number {
+  return performance.timeOrigin + performance.now();
+}
+
+function hexId(bytes: number): string {
+  return randomBytes(bytes).toString('hex');
+}
+
+// W3C traceparent: version-traceid-parentid-flags
+function parseTraceparent(header: string | null): { traceId: string; parentSpanId: string; sampled: boolean } | null {
+  const match = header?.trim().match(/^[0-9a-f]{2}-([0-9a-f]{32})-([0-9a-f]{16})-([0-9a-f]{2})$/);
+  if (!match || /^0+$/.test(match[1]) || /^0+$/.test(match[2])) return null;
+  return { traceId: match[1], parentSpanId: match[2], sampled: (parseInt(match[3], 16) & 1) === 1 };
+}
+
+/**
+ * Run `fn` as a span named `name` (dotted, category first: "db.Node.create", "embed.openai")
+ * Nested calls become child spans. Errors are recorded on the span and rethrown.
+ */
+export async function withSpan<T>(name: string, fn: () => Promise<T>, attributes?: SpanAttributes): Promise<T> {
+  const scope = traceStorage.getStore();
+  const startMs = nowMs();
+  const spanId = scope ? hexId(8) : '';
+  let error: string | undefined;
+
+  try {
+    return scope ? await traceStorage.run({ trace: scope.trace, spanId }, fn) : await fn();
+  } catch (err: any) {
+    error = err?.message || String(err);
+    throw err;
+  } finally {
+    const durationMs = nowMs() - startMs;
+    observe(spanHistograms, name, durationMs);
+    if (scope && scope.trace.spans.length < MAX_SPANS_PER_TRACE) {
+      scope.trace.spans.push({ spanId, parentSpanId: scope.spanId, name, startMs, durationMs, attributes, error });
+    }
+  }
+}
+
+// "name;dur=12.3;desc=\"4\"" per span category (the part of the name before the first dot)
+function serverTimingHeader(trace: RequestTrace, totalMs: number): string {
+  const categoryOf = new Map<string, string>();
+  for (const span of trace.spans) categoryOf.set(span.spanId, span.name.split('.', 1)[0]);
+
+  const categories = new Map<string, { count: number; durationMs: number }>();
+  for (const span of trace.spans) {
+    // Only top-level spans of each category, so nested spans of the same kind aren't counted twice
+    const category = categoryOf.get(span.spanId)!;
+    if (categoryOf.get(span.parentSpanId) === category) continue;
+    const entry = categories.get(category) ?? { count: 0, durationMs: 0 };
+    entry.count++;
+    entry.durationMs += span.durationMs;
+    categories.set(category, entry);
+  }
+  const parts = Array.from(categories, ([category, { count, durationMs }]) =>
+    `${category};dur=${durationMs.toFixed(1)};desc="${count}"`
+  );
+  parts.push(`total;dur=${totalMs.toFixed(1)}`);
+  return parts.join(', ');
+}
+
+function logRequest(route: string, status: number, durationMs: number, trace: RequestTrace, error?: string) {
+  const spans: Record<string, { count: number; ms: number }> = {};
+  for (const span of trace.spans) {
+    const entry = (spans[span.name] ??= { count: 0, ms: 0 });
+    entry.count++;
+    entry.ms = Math.round((entry.ms + span.durationMs) * 10) / 10;
+  }
+  const event = {
+    event: 'request',
+    route,
+    status,
+    durationMs: Math.round(durationMs * 10) / 10,
+    traceId: trace.traceId,
+    spans,
+    ...(error ? { error } : {}),
+  };
+  if (status >= 500) console.error(JSON.stringify(event));
+  else console.log(JSON.stringify(event));
+}
+
+/**
+ * Wrap a route handler with tracing - `route` names it in metrics and logs ("POST /api/nodes/create")
+ */
+export function traceRoute<Args extends [Request, ...any[]]>(
+  route: string,
+  handler: (...args: Args) => Promise<Response>
+): (...args: Args) => Promise<Response> {
+  return async (...args: Args) => {
+    const incoming = parseTraceparent(args[0].headers.get('traceparent'));
+    const trace: RequestTrace = {
+      traceId: incoming?.traceId ?? hexId(16),
+      rootSpanId: hexId(8),
+      parentSpanId: incoming?.parentSpanId,
+      sampled: incoming ? incoming.sampled : Math.random() < SAMPLE_RATE,
+      spans: [],
+    };
+    const startMs = nowMs();
+    let status = 500;
+    let error: string | undefined;
+
+    try {
+      const response = await traceStorage.run({ trace, spanId: trace.rootSpanId }, () => handler(...args));
+      status = response.status;
+      try {
+        response.headers.append('Server-Timing', serverTimingHeader(trace, nowMs() - startMs));
+      } catch {
+        // Immutable headers (a fetched Response passed through) - skip the header
+      }
+      return response;
+    } catch (err: any) {
+      error = err?.message || String(err);
+      throw err;
+    } finally {
+      const durationMs = nowMs() - startMs;
+      observe(routeHistograms, route, durationMs);
+      const keep = trace.sampled || status >= 500 || durationMs >= SLOW_REQUEST_MS;
+      if (keep) {
+        logRequest(route, status, durationMs, trace, error);
+        if (OTLP_ENDPOINT) queueExport(route, trace, startMs, durationMs, status, error);
+      }
+    }
+  };
+}
+
+/**
+ * Request and span latency percentiles since the process started, in ms
+ */
+export function getLatencyMetrics() {
+  const summarize = (histograms: Map<string, LatencyHistogram>) =>
+    Object.fromEntries(
+      Array.from(histograms, ([name, histogram]) => [
+        name,
+        {
+          count: histogram.count,
+          meanMs: Math.round((histogram.sum / histogram.count) * 10) / 10,
+          p50Ms: Math.round(histogram.quantile(0.5) * 10) / 10,
+          p95Ms: Math.round(histogram.quantile(0.95) * 10) / 10,
+          p99Ms: Math.round(histogram.quantile(0.99) * 10) / 10,
+          maxMs: Math.round(histogram.max * 10) / 10,
+        },
+      ])
+    );
+  return { routes: summarize(routeHistograms), spans: summarize(spanHistograms) };
+}
+
+/**
+ * Forget all recorded latencies (benchmarks measure one phase at a time)
+ */
+export function resetLatencyMetrics() {
+  routeHistograms.clear();
+  spanHistograms.clear();
+}
+
+// --- OTLP/HTTP JSON export ---
+
+function queueExport(route: string, trace: RequestTrace, startMs: number, durationMs: number, status: number, error?: string) {
+  const root: SpanRecord = {
+    spanId: trace.rootSpanId,
+    parentSpanId: trace.parentSpanId ?? '',
+    name: route,
+    startMs,
+    durationMs,
+    attributes: { 'http.route': route, 'http.response.status_code': status },
+    error: error ?? (status >= 500 ? `HTTP ${status}` : undefined),
+  };
+  for (const span of [root, ...trace.spans]) {
+    if (exportQueue.length >= MAX_QUEUED_SPANS) break; // Collector unreachable - drop, don't grow
+    exportQueue.push({ trace, span });
+  }
+  if (exportQueue.length >= EXPORT_BATCH_SPANS) {
+    void flushSpans();
+  } else if (!exportTimer) {
+    exportTimer = setTimeout(() => void flushSpans(), EXPORT_INTERVAL_MS);
+    exportTimer.unref?.();
+  }
+}
+
+function unixNano(ms: number): string {
+  const whole = Math.floor(ms);
+  return (BigInt(whole) * BigInt(1_000_000) + BigInt(Math.round((ms - whole) * 1_000_000))).toString();
+}
+
+function otlpAttributes(attributes: SpanAttributes = {}) {
+  return Object.entries(attributes)
+    .filter(([, value]) => value !== undefined)
+    .map(([key, value]) => ({
+      key,
+      value:
+        typeof value === 'number'
+          ? Number.isInteger(value) ? { intValue: value } : { doubleValue: value }
+          : typeof value === 'boolean' ? { boolValue: value } : { stringValue: String(value) },
+    }));
+}
+
+async function flushSpans() {
+  if (exportTimer) {
+    clearTimeout(exportTimer);
+    exportTimer = null;
+  }
+  const batch = exportQueue.splice(0, EXPORT_BATCH_SPANS);
+  if (batch.length === 0) return;
+
+  const spans = batch.map(({ trace, span }) => ({
+    traceId: trace.traceId,
+    spanId: span.spanId,
+    ...(span.parentSpanId ? { parentSpanId: span.parentSpanId } : {}),
+    name: span.name,
+    kind: span.spanId === trace.rootSpanId ? 2 : 1, // SERVER : INTERNAL
+    startTimeUnixNano: unixNano(span.startMs),
+    endTimeUnixNano: unixNano(span.startMs + span.durationMs),
+    attributes: otlpAttributes(span.attributes),
+    status: span.error ? { code: 2, message: span.error } : { code: 0 },
+  }));
+
+  try {
+    await fetch(`${OTLP_ENDPOINT}/v1/traces`, {
+      method: 'POST',
+      headers: { 'Content-Type': 'application/json' },
+      body: JSON.stringify({
+        resourceSpans: [{
+          resource: { attributes: otlpAttributes({ 'service.name': SERVICE_NAME }) },
+          scopeSpans: [{ scope: { name: 'meshflow.tracing' }, spans }],
+        }],
+      }),
+    });
+  } catch (error: any) {
+    console.warn('[tracing] Failed to export spans (dropping batch):', error?.message);
+  }
+
+  if (exportQueue.length > 0 && !exportTimer) {
+    exportTimer = setTimeout(() => void flushSpans(), EXPORT_INTERVAL_MS);
+    exportTimer.unref?.();
+  }
+}
@@ -1,200 +1,168 @@
-import { useEffect, useRef, useCallback } from 'react';
-import * as d3 from 'd3-force';
+import { useEffect, useRef, useState } from 'react';
 import type { Node as ReactFlowNode, Edge as ReactFlowEdge } from 'reactflow';
-
-interface LayoutNode extends d3.SimulationNodeDatum {
-  id: string;
-  x: number;
-  y: number;
-}
+import { toLayoutGraph } from './forceLayout';
+import { INCREMENTAL_MAX_NEW_SHARE, INCREMENTAL_RUN_OPTIONS, buildIncrementalGraph } from './layoutEngine';
+import { runLayout } from './layoutWorkerClient';
 
 interface UseAutoOrganizeOptions {
   nodes: ReactFlowNode[];
   edges: ReactFlowEdge[];
   enabled: boolean;
-  onPositionUpdate: (nodeId: string, position: { x: number; y: number }) => void;
+  // Called once per animation frame with the interpolated position of every moving node
+  onPositionsUpdate: (positions: Map<string, { x: number; y: number }>) => void;
+  // Called once with the final positions of the moved nodes when the animation finishes (e.g. to persist them)
+  onComplete?: (positions: Map<string, { x: number; y: number }>) => void;
   width?: number;
   height?: number;
   duration?: number;
+  // Only place nodes added since the last run (and their neighbours) when there are few
+  incremental?: boolean;
 }
 
+// Simulation settings for auto-organize (slightly looser than the one-shot layouts)
+const ORGANIZE_LAYOUT_OPTIONS = {
+  iterations: 340,
+  linkDistance: 150,
+  linkStrength: 0.6,
+  charge: -400,
+  collideRadius: 60,
+  velocityDecay: 0.4,
+};
+
 /**
  * Hook for smooth auto-organizing animation using force-directed layout
+ * The simulation runs in the layout worker; partial results stream back and the
+ * animation eases towards the latest ones, so large graphs start moving immediately.
+ * After the first run, nodes added since then are placed incrementally: everything outside
+ * their 1-hop neighbourhood stays where it is.
  */
 export function useAutoOrganize({
   nodes,
   edges,
   enabled,
-  onPositionUpdate,
+  onPositionsUpdate,
+  onComplete,
   width = 2000,
   height = 2000,
   duration = 2000,
+  incremental = true,
 }: UseAutoOrganizeOptions) {
-  const simulationRef = useRef<d3.Simulation<LayoutNode> | null>(null);
-  const animationFrameRef = useRef<number | null>(null);
-  const startPositionsRef = useRef<Map<string, { x: number; y: number }>>(new Map());
-  const targetPositionsRef = useRef<Map<string, { x: number; y: number }>>(new Map());
-  const startTimeRef = useRef<number | null>(null);
-
-  // Initialize or update simulation
-  const initializeSimulation = useCallback(() => {
-    if (nodes.length === 0) return;
-
-    const nodeMap = new Map<string, LayoutNode>();
-
-    // Initialize nodes with current positions
-    nodes.forEach((node) => {
-      const x = node.position?.x ?? width / 2 + (Math.random() - 0.5) * 400;
-      const y = node.position?.y ?? height / 2 + (Math.random() - 0.5) * 400;
-
-      nodeMap.set(node.id, {
-        id: node.id,
-        x,
-        y,
-        vx: 0,
-        vy: 0,
-      });
+  const [isAnimating, setIsAnimating] = useState(false);
 
-      // Store start position
-      startPositionsRef.current.set(node.id, { x, y });
-    });
-
-    // Create D3 force simulation
-    const simulation = d3
-      .forceSimulation(Array.from(nodeMap.values()))
-      .force(
-        'link',
-        d3
-          .forceLink(edges.map((e) => ({ source: e.source, target: e.target })))
-          .id((d: any) => d.id)
-          .distance(150)
-          .strength(0.6)
-      )
-      .force('charge', d3.forceManyBody().strength(-400))
-      .force('center', d3.forceCenter(width / 2, height / 2))
-      .force('collision', d3.forceCollide().radius(60))
-      .alphaDecay(0.02)
-      .velocityDecay(0.4)
-      .on('end', () => {
-        // Stop simulation when it ends
-        if (simulationRef.current) {
-          simulationRef.current.stop();
-        }
-      });
+  // Node ids the last completed run laid out
+  const organizedIdsRef = useRef<Set<string> | null>(null);
 
-    // Store target positions as simulation runs
-    simulation.on('tick', () => {
-      nodeMap.forEach((node) => {
-        if (node.x !== undefined && node.y !== undefined) {
-          targetPositionsRef.current.set(node.id, {
-            x: node.x,
-            y: node.y,
-          });
-        }
-      });
-    });
-
-    simulationRef.current = simulation;
-
-    // Run simulation for initial layout calculation
-    simulation.stop();
-    for (let i = 0; i < 300; i++) {
-      simulation.tick();
-    }
-
-    // Extract final target positions
-    nodeMap.forEach((node) => {
-      if (node.x !== undefined && node.y !== undefined) {
-        targetPositionsRef.current.set(node.id, {
-          x: node.x,
-          y: node.y,
-        });
-      }
-    });
-  }, [nodes, edges, width, height]);
-
-  // Smooth interpolation animation
-  const animatePositions = useCallback(
-    (currentTime: number) => {
-      if (!startTimeRef.current) {
-        startTimeRef.current = currentTime;
+  // Read the graph at trigger time only - position updates must not restart the layout
+  const nodesRef = useRef(nodes);
+  const edgesRef = useRef(edges);
+  const onPositionsUpdateRef = useRef(onPositionsUpdate);
+  const onCompleteRef = useRef(onComplete);
+  nodesRef.current = nodes;
+  edgesRef.current = edges;
+  onPositionsUpdateRef.current = onPositionsUpdate;
+  onCompleteRef.current = onComplete;
+
+  useEffect(() => {
+    const currentNodes = nodesRef.current;
+    if (!enabled || currentNodes.length === 0) return;
+
+    const layoutNodes = currentNodes.map((node) => ({
+      id: node.id,
+      x: node.position?.x ?? 0,
+      y: node.position?.y ?? 0,
+    }));
+    const layoutEdges = edgesRef.current.map((edge) => ({ source: edge.source, target: edge.target }));
+    const layoutOptions = { ...ORGANIZE_LAYOUT_OPTIONS, centerX: width / 2, centerY: height / 2 };
+
+    const organized = organizedIdsRef.current;
+    const newIds = new Set(
+      organized ? currentNodes.filter((node) => !organized.has(node.id)).map((node) => node.id) : []
+    );
+    const local =
+      incremental && newIds.size > 0 && newIds.size <= currentNodes.length * INCREMENTAL_MAX_NEW_SHARE
+        ? buildIncrementalGraph(layoutNodes, layoutEdges, newIds, layoutOptions)
+        : null;
+
+    const { graph, ids } = local || toLayoutGraph(layoutNodes, layoutEdges, layoutOptions);
+
+    // Only movable nodes are animated - pinned context nodes never change
+    const animated = local
+      ? ids.flatMap((id, i) => (local.movable.has(id) ? [i] : []))
+      : ids.map((_, i) => i);
+    const allIds = currentNodes.map((node) => node.id);
+
+    // Start positions are the packed ones (missing positions already seeded)
+    const start = graph.positions.slice();
+    let target: Float32Array = start;
+    let finished = false;
+    let startTime: number | null = null;
+    let animationFrame: number | null = null;
+
+    const layoutRun = runLayout(
+      graph,
+      local ? { ...layoutOptions, ...INCREMENTAL_RUN_OPTIONS } : layoutOptions,
+      {
+        onProgress: (positions) => {
+          target = positions;
+        },
       }
+    );
+
+    layoutRun.result
+      .then((positions) => {
+        if (!positions) return;
+        target = positions;
+        finished = true;
+      })
+      .catch((error) => {
+        // Settle on the last partial result rather than leaving the animation hanging
+        console.error('[useAutoOrganize] Layout failed:', error);
+        finished = true;
+      });
 
-      const elapsed = currentTime - startTimeRef.current;
-      const progress = Math.min(elapsed / duration, 1);
+    const animate = (currentTime: number) => {
+      if (startTime === null) startTime = currentTime;
+      const progress = Math.min((currentTime - startTime) / duration, 1);
 
       // Easing function for smooth animation
       const easeOutCubic = 1 - Math.pow(1 - progress, 3);
 
-      // Interpolate each node's position
-      targetPositionsRef.current.forEach((targetPos, nodeId) => {
-        const startPos = startPositionsRef.current.get(nodeId);
-        if (!startPos) return;
-
-        const currentX = startPos.x + (targetPos.x - startPos.x) * easeOutCubic;
-        const currentY = startPos.y + (targetPos.y - startPos.y) * easeOutCubic;
-
-        onPositionUpdate(nodeId, { x: currentX, y: currentY });
-      });
-
-      if (progress < 1) {
-        animationFrameRef.current = requestAnimationFrame(animatePositions);
-      } else {
-        startTimeRef.current = null;
-        animationFrameRef.current = null;
+      // Interpolate each node's position towards the latest layout result
+      const frame = new Map<string, { x: number; y: number }>();
+      for (const i of animated) {
+        const sx = start[i * 2];
+        const sy = start[i * 2 + 1];
+        frame.set(ids[i], {
+          x: sx + (target[i * 2] - sx) * easeOutCubic,
+          y: sy + (target[i * 2 + 1] - sy) * easeOutCubic,
+        });
       }
-    },
-    [duration, onPositionUpdate]
-  );
+      onPositionsUpdateRef.current(frame);
 
-  // Trigger auto-organize when enabled
-  useEffect(() => {
-    if (!enabled || nodes.length === 0) {
-      // Clean up
-      if (simulationRef.current) {
-        simulationRef.current.stop();
-        simulationRef.current = null;
-      }
-      if (animationFrameRef.current) {
-        cancelAnimationFrame(animationFrameRef.current);
-        animationFrameRef.current = null;
+      // Past the easing window the nodes track the simulation until it settles
+      if (progress < 1 || !finished) {
+        animationFrame = requestAnimationFrame(animate);
+      } else {
+        animationFrame = null;
+        setIsAnimating(false);
+        organizedIdsRef.current = new Set(allIds);
+        onCompleteRef.current?.(frame);
       }
-      return;
-    }
-
-    // Store current positions as start positions
-    nodes.forEach((node) => {
-      startPositionsRef.current.set(node.id, {
-        x: node.position?.x ?? width / 2,
-        y: node.position?.y ?? height / 2,
-      });
-    });
-
-    // Initialize simulation to calculate target positions
-    initializeSimulation();
+    };
 
-    // Start smooth animation
-    startTimeRef.current = null;
-    animationFrameRef.current = requestAnimationFrame(animatePositions);
+    setIsAnimating(true);
+    animationFrame = requestAnimationFrame(animate);
 
     // Cleanup - ensure everything stops
     return () => {
-      if (simulationRef.current) {
-        simulationRef.current.stop();
-        simulationRef.current.on('tick', null); // Remove all tick listeners
-        simulationRef.current.on('end', null);
-        simulationRef.current = null;
-      }
-      if (animationFrameRef.current) {
-        cancelAnimationFrame(animationFrameRef.current);
-        animationFrameRef.current = null;
+      layoutRun.cancel();
+      if (animationFrame !== null) {
+        cancelAnimationFrame(animationFrame);
+        animationFrame = null;
       }
-      startTimeRef.current = null;
+      setIsAnimating(false);
     };
-  }, [enabled, nodes.length, edges.length, initializeSimulation, animatePositions, width, height]);
+  }, [enabled, width, height, duration, incremental]);
 
-  return {
-    isAnimating: animationFrameRef.current !== null,
-  };
+  return { isAnimating };
 }
-
@@ -0,0 +1,71 @@
+import { useEffect, useRef } from 'react';
+import { useCanvasStore } from '@/state/canvasStore';
+import { useWorkspaceStore } from '@/state/workspaceStore';
+import { tilesInRect, viewportRect } from './viewportTiles';
+
+interface UseViewportTilesOptions {
+  workspaceId: string;
+  // Canvas size in screen pixels
+  width: number;
+  height: number;
+}
+
+/**
+ * Page graph tiles in as the viewport moves (windowed workspaces only)
+ * Requests the non-empty, not yet loaded tiles under the viewport plus a margin.
+ * When the view spans too many tiles nothing is loaded - the canvas shows aggregates.
+ */
+export function useViewportTiles({ workspaceId, width, height }: UseViewportTilesOptions) {
+  const viewport = useCanvasStore((state) => state.viewport);
+  const windowed = useWorkspaceStore((state) => state.windowed);
+  const tileSummaries = useWorkspaceStore((state) => state.tileSummaries);
+  const loadedTiles = useWorkspaceStore((state) => state.loadedTiles);
+  const tileGeneration = useWorkspaceStore((state) => state.tileGeneration);
+
+  const inFlightRef = useRef<Set<string>>(new Set());
+
+  // A (re)load discards everything - requests for the previous generation are ignored
+  useEffect(() => {
+    inFlightRef.current = new Set();
+  }, [tileGeneration]);
+
+  useEffect(() => {
+    if (!windowed || width <= 0 || height <= 0) return;
+
+    const keys = tilesInRect(viewportRect(viewport, width, height));
+    if (!keys) return; // Zoomed out past the tile budget
+
+    const nonEmpty = new Set(tileSummaries.map((summary) => summary.key));
+    const missing = keys.filter(
+      (key) => nonEmpty.has(key) && !loadedTiles.has(key) && !inFlightRef.current.has(key)
+    );
+    if (missing.length === 0) return;
+
+    const inFlight = inFlightRef.current;
+    missing.forEach((key) => inFlight.add(key));
+    const generation = tileGeneration;
+
+    (async () => {
+      try {
+        const response = await fetch(
+          `/api/workspaces/${workspaceId}/tiles?tiles=${encodeURIComponent(missing.join(','))}`
+        );
+        if (!response.ok) {
+          console.error('[useViewportTiles] Failed to load tiles:', response.statusText);
+          return;
+        }
+
+        const data = await response.json();
+        if (useWorkspaceStore.getState().tileGeneration !== generation) return;
+
+        useWorkspaceStore
+          .getState()
+          .mergeGraphTiles(data.tiles || missing, data.nodes || [], data.edges || [], data.version);
+      } catch (error) {
+        console.error('[useViewportTiles] Error loading tiles:', error);
+      } finally {
+        missing.forEach((key) => inFlight.delete(key));
+      }
+    })();
+  }, [workspaceId, windowed, viewport, width, height, tileSummaries, loadedTiles, tileGeneration]);
+}
@@ -0,0 +1,475 @@
+// In-process vector store for similarity ranking (client and server safe - no Node APIs)
+// - embeddings live as L2-normalized rows in one contiguous Float32Array, so cosine
+//   similarity is a plain dot product and norms are never recomputed per query
+// - optional int8 (4x smaller) or binary sign-bit (32x smaller) codes for a fast first
+//   pass, followed by exact rescoring of the best candidates against the float rows
+// - top-k uses a bounded min-heap: O(n log k) instead of sorting every score
+//
+// Also compiled into backend/ (copied by backend/scripts/copy-shared.ts), so imports stay
+// relative and confined to the shared modules.
+
+export type VectorQuantization = 'none' | 'int8' | 'binary';
+
+export interface VectorStoreOptions {
+  quantization?: VectorQuantization;
+  // Keep full-precision rows for exact rescoring. Turning this off with a quantization
+  // saves the memory (int8 ~4x, binary ~32x) at the cost of approximate scores
+  keepFullPrecision?: boolean;
+  initialCapacity?: number;
+}
+
+export interface VectorSearchOptions {
+  minSimilarity?: number;
+  exclude?: string | Set<string>;
+  // Candidates kept from the quantized pass for exact rescoring (default 4 * k)
+  rescoreCandidates?: number;
+}
+
+export interface VectorMatch {
+  id: string;
+  similarity: number;
+}
+
+/**
+ * L2-normalize into a new Float32Array; null for zero, empty or non-finite vectors
+ */
+export function normalizeVector(vector: ArrayLike<number>): Float32Array | null {
+  const length = vector.length;
+  if (length === 0) return null;
+
+  let norm = 0;
+  for (let i = 0; i < length; i++) {
+    norm += vector[i] * vector[i];
+  }
+  if (!Number.isFinite(norm) || norm === 0) return null;
+
+  const inv = 1 / Math.sqrt(norm);
+  const out = new Float32Array(length);
+  for (let i = 0; i < length; i++) {
+    out[i] = vector[i] * inv;
+  }
+  return out;
+}
+
+// Dot product of a query with row `row` of a packed matrix - unrolled by 4
+export function dotRow(query: Float32Array, rows: Float32Array, offset: number, dim: number): number {
+  let s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  let i = 0;
+  for (; i + 3 < dim; i += 4) {
+    s0 += query[i] * rows[offset + i];
+    s1 += query[i + 1] * rows[offset + i + 1];
+    s2 += query[i + 2] * rows[offset + i + 2];
+    s3 += query[i + 3] * rows[offset + i + 3];
+  }
+  for (; i < dim; i++) {
+    s0 += query[i] * rows[offset + i];
+  }
+  return s0 + s1 + s2 + s3;
+}
+
+function dotInt8Row(query: Int8Array, rows: Int8Array, offset: number, dim: number): number {
+  let s0 = 0, s1 = 0;
+  let i = 0;
+  for (; i + 1 < dim; i += 2) {
+    s0 += query[i] * rows[offset + i];
+    s1 += query[i + 1] * rows[offset + i + 1];
+  }
+  if (i < dim) s0 += query[i] * rows[offset + i];
+  return s0 + s1;
+}
+
+function popcount32(x: number): number {
+  x = x - ((x >>> 1) & 0x55555555);
+  x = (x & 0x33333333) + ((x >>> 2) & 0x33333333);
+  x = (x + (x >>> 4)) & 0x0f0f0f0f;
+  return (x * 0x01010101) >>> 24;
+}
+
+// Symmetric int8 code of a normalized vector; returns the dequantization scale
+function quantizeInt8(vector: Float32Array, out: Int8Array, offset: number): number {
+  let maxAbs = 0;
+  for (let i = 0; i < vector.length; i++) {
+    const abs = Math.abs(vector[i]);
+    if (abs > maxAbs) maxAbs = abs;
+  }
+  const scale = maxAbs / 127 || 1;
+  for (let i = 0; i < vector.length; i++) {
+    out[offset + i] = Math.round(vector[i] / scale);
+  }
+  return scale;
+}
+
+function quantizeBinary(vector: Float32Array, out: Uint32Array, offset: number) {
+  const words = Math.ceil(vector.length / 32);
+  for (let w = 0; w < words; w++) out[offset + w] = 0;
+  for (let i = 0; i < vector.length; i++) {
+    if (vector[i] > 0) out[offset + (i >>> 5)] |= 1 << (i & 31);
+  }
+}
+
+/**
+ * Fixed-size min-heap keeping the k highest scores seen
+ */
+export class TopK {
+  private scores: Float64Array;
+  private items: Int32Array;
+  private count = 0;
+
+  constructor(private readonly k: number) {
+    this.scores = new Float64Array(Math.max(k, 0));
+    this.items = new Int32Array(Math.max(k, 0));
+  }
+
+  get size(): number {
+    return this.count;
+  }
+
+  // Lowest score currently kept - anything at or below it cannot enter a full heap
+  get threshold(): number {
+    return this.count < this.k ? -Infinity : this.scores[0];
+  }
+
+  push(item: number, score: number) {
+    if (this.k === 0) return;
+    if (this.count < this.k) {
+      let i = this.count++;
+      // Sift up
+      while (i > 0) {
+        const parent = (i - 1) >> 1;
+        if (this.scores[parent] <= score) break;
+        this.scores[i] = this.scores[parent];
+        this.items[i] = this.items[parent];
+        i = parent;
+      }
+      this.scores[i] = score;
+      this.items[i] = item;
+    } else if (score > this.scores[0]) {
+      // Replace the root and sift down
+      let i = 0;
+      const n = this.count;
+      while (true) {
+        const left = 2 * i + 1;
+        if (left >= n) break;
+        const right = left + 1;
+        const child = right < n && this.scores[right] < this.scores[left] ? right : left;
+        if (this.scores[child] >= score) break;
+        this.scores[i] = this.scores[child];
+        this.items[i] = this.items[child];
+        i = child;
+      }
+      this.scores[i] = score;
+      this.items[i] = item;
+    }
+  }
+
+  // Items with scores, highest first
+  drain(): Array<{ item: number; score: number }> {
+    const out: Array<{ item: number; score: number }> = [];
+    for (let i = 0; i < this.count; i++) {
+      out.push({ item: this.items[i], score: this.scores[i] });
+    }
+    out.sort((a, b) => b.score - a.score);
+    return out;
+  }
+}
+
+export class VectorStore {
+  readonly dimension: number;
+  readonly quantization: VectorQuantization;
+  readonly keepFullPrecision: boolean;
+
+  private ids: string[] = [];
+  private indexById = new Map<string, number>();
+  private capacity: number;
+
+  private rows: Float32Array | null = null;
+  private int8Rows: Int8Array | null = null;
+  private int8Scales: Float32Array | null = null;
+  private bitRows: Uint32Array | null = null;
+  private readonly words: number;
+
+  constructor(dimension: number, options: VectorStoreOptions = {}) {
+    this.dimension = dimension;
+    this.quantization = options.quantization ?? 'none';
+    // Without a quantized code the float rows are the only copy
+    this.keepFullPrecision = this.quantization === 'none' || options.keepFullPrecision !== false;
+    this.words = Math.ceil(dimension / 32);
+    this.capacity = Math.max(options.initialCapacity ?? 64, 1);
+    this.allocate(this.capacity);
+  }
+
+  /**
+   * Build a store from rows, skipping entries whose vector is missing or has the wrong size
+   */
+  static from(
+    entries: Iterable<{ id: string; embedding?: ArrayLike<number> | null }>,
+    options: VectorStoreOptions & { dimension?: number } = {}
+  ): VectorStore {
+    const list = Array.from(entries);
+    const dimension =
+      options.dimension ?? list.find((e) => e.embedding && e.embedding.length > 0)?.embedding?.length ?? 0;
+    const store = new VectorStore(dimension, { ...options, initialCapacity: Math.max(list.length, 1) });
+    for (const entry of list) {
+      if (entry.embedding) store.add(entry.id, entry.embedding);
+    }
+    return store;
+  }
+
+  get size(): number {
+    return this.ids.length;
+  }
+
+  // Approximate bytes held by vector data
+  get byteLength(): number {
+    return (
+      (this.rows?.byteLength ?? 0) +
+      (this.int8Rows?.byteLength ?? 0) +
+      (this.int8Scales?.byteLength ?? 0) +
+      (this.bitRows?.byteLength ?? 0)
+    );
+  }
+
+  has(id: string): boolean {
+    return this.indexById.has(id);
+  }
+
+  keys(): string[] {
+    return this.ids.slice();
+  }
+
+  /**
+   * Normalized row for `id` (a view - do not mutate); null if absent or not kept
+   */
+  get(id: string): Float32Array | null {
+    const index = this.indexById.get(id);
+    if (index === undefined || !this.rows) return null;
+    const offset = index * this.dimension;
+    return this.rows.subarray(offset, offset + this.dimension);
+  }
+
+  /**
+   * Insert or replace a vector; returns false if it is empty, zero or the wrong size
+   */
+  add(id: string, vector: ArrayLike<number>): boolean {
+    if (vector.length !== this.dimension) return false;
+    const normalized = normalizeVector(vector);
+    if (!normalized) return false;
+
+    let index = this.indexById.get(id);
+    if (index === undefined) {
+      if (this.ids.length === this.capacity) this.grow();
+      index = this.ids.length;
+      this.ids.push(id);
+      this.indexById.set(id, index);
+    }
+    this.writeRow(index, normalized);
+    return true;
+  }
+
+  remove(id: string): boolean {
+    const index = this.indexById.get(id);
+    if (index === undefined) return false;
+
+    // Move the last row into the gap so rows stay contiguous
+    const last = this.ids.length - 1;
+    if (index !== last) {
+      this.copyRow(last, index);
+      const movedId = this.ids[last];
+      this.ids[index] = movedId;
+      this.indexById.set(movedId, index);
+    }
+    this.ids.pop();
+    this.indexById.delete(id);
+    return true;
+  }
+
+  /**
+   * Cosine similarity between two stored vectors (null if either is missing)
+   */
+  similarity(a: string, b: string): number | null {
+    const ia = this.indexById.get(a);
+    const ib = this.indexById.get(b);
+    if (ia === undefined || ib === undefined) return null;
+    if (this.rows) {
+      const query = this.rows.subarray(ia * this.dimension, (ia + 1) * this.dimension);
+      return dotRow(query, this.rows, ib * this.dimension, this.dimension);
+    }
+    return this.approximateScore(this.encodeQuery(this.decodeApproximate(ia)), ib);
+  }
+
+  /**
+   * k most similar stored vectors to `query`, highest first
+   */
+  search(query: ArrayLike<number>, k: number, options: VectorSearchOptions = {}): VectorMatch[] {
+    if (k <= 0 || this.ids.length === 0 || query.length !== this.dimension) return [];
+    const normalized = normalizeVector(query);
+    if (!normalized) return [];
+
+    k = Math.min(k, this.ids.length);
+    const minSimilarity = options.minSimilarity ?? -Infinity;
+    const excluded = this.excludedIndexes(options.exclude);
+
+    // Exact scan over float rows
+    if (this.quantization === 'none') {
+      return this.exactTopK(normalized, k, minSimilarity, excluded);
+    }
+
+    // Quantized first pass
+    const encoded = this.encodeQuery(normalized);
+    const candidateCount = this.keepFullPrecision
+      ? Math.max(options.rescoreCandidates ?? k * 4, k)
+      : k;
+    const candidates = new TopK(candidateCount);
+    for (let i = 0; i < this.ids.length; i++) {
+      if (excluded?.has(i)) continue;
+      candidates.push(i, this.approximateScore(encoded, i));
+    }
+
+    let results: Array<{ item: number; score: number }>;
+    if (this.keepFullPrecision && this.rows) {
+      // Exact rescoring of the shortlist
+      const rescored = new TopK(k);
+      for (const { item } of candidates.drain()) {
+        rescored.push(item, dotRow(normalized, this.rows, item * this.dimension, this.dimension));
+      }
+      results = rescored.drain();
+    } else {
+      results = candidates.drain();
+    }
+
+    const matches: VectorMatch[] = [];
+    for (const { item, score } of results) {
+      if (score < minSimilarity) break;
+      matches.push({ id: this.ids[item], similarity: score });
+    }
+    return matches;
+  }
+
+  private exactTopK(
+    query: Float32Array,
+    k: number,
+    minSimilarity: number,
+    excluded: Set<number> | null
+  ): VectorMatch[] {
+    const rows = this.rows!;
+    const dim = this.dimension;
+    const top = new TopK(k);
+
+    for (let i = 0; i < this.ids.length; i++) {
+      if (excluded?.has(i)) continue;
+      const score = dotRow(query, rows, i * dim, dim);
+      if (score >= minSimilarity && score > top.threshold) top.push(i, score);
+    }
+
+    return top.drain().map(({ item, score }) => ({ id: this.ids[item], similarity: score }));
+  }
+
+  private excludedIndexes(exclude?: string | Set<string>): Set<number> | null {
+    if (!exclude) return null;
+    const ids = typeof exclude === 'string' ? [exclude] : Array.from(exclude);
+    const indexes = new Set<number>();
+    for (const id of ids) {
+      const index = this.indexById.get(id);
+      if (index !== undefined) indexes.add(index);
+    }
+    return indexes.size > 0 ? indexes : null;
+  }
+
+  private encodeQuery(normalized: Float32Array): { int8?: Int8Array; scale?: number; bits?: Uint32Array } {
+    if (this.quantization === 'int8') {
+      const int8 = new Int8Array(this.dimension);
+      const scale = quantizeInt8(normalized, int8, 0);
+      return { int8, scale };
+    }
+    const bits = new Uint32Array(this.words);
+    quantizeBinary(normalized, bits, 0);
+    return { bits };
+  }
+
+  // Similarity estimate from the quantized codes
+  private approximateScore(
+    query: { int8?: Int8Array; scale?: number; bits?: Uint32Array },
+    index: number
+  ): number {
+    if (query.int8 && this.int8Rows && this.int8Scales) {
+      return (
+        dotInt8Row(query.int8, this.int8Rows, index * this.dimension, this.dimension) *
+        query.scale! *
+        this.int8Scales[index]
+      );
+    }
+
+    // Hamming distance between sign bits estimates the angle: cos(pi * h / d)
+    const bits = this.bitRows!;
+    const offset = index * this.words;
+    let hamming = 0;
+    for (let w = 0; w < this.words; w++) {
+      hamming += popcount32(query.bits![w] ^ bits[offset + w]);
+    }
+    return Math.cos((Math.PI * hamming) / this.dimension);
+  }
+
+  // Best available reconstruction of a stored row when float rows were dropped
+  private decodeApproximate(index: number): Float32Array {
+    const out = new Float32Array(this.dimension);
+    if (this.int8Rows && this.int8Scales) {
+      const offset = index * this.dimension;
+      const scale = this.int8Scales[index];
+      for (let i = 0; i < this.dimension; i++) out[i] = this.int8Rows[offset + i] * scale;
+    } else if (this.bitRows) {
+      const offset = index * this.words;
+      for (let i = 0; i < this.dimension; i++) {
+        out[i] = this.bitRows[offset + (i >>> 5)] & (1 << (i & 31)) ? 1 : -1;
+      }
+    }
+    return normalizeVector(out) ?? out;
+  }
+
+  private allocate(capacity: number) {
+    const dim = this.dimension;
+    const resize = <T extends Float32Array | Int8Array | Uint32Array>(
+      current: T | null,
+      make: (length: number) => T,
+      stride: number
+    ): T => {
+      const next = make(capacity * stride);
+      if (current) next.set(current.subarray(0, this.ids.length * stride) as any);
+      return next;
+    };
+
+    if (this.keepFullPrecision) {
+      this.rows = resize(this.rows, (n) => new Float32Array(n), dim);
+    }
+    if (this.quantization === 'int8') {
+      this.int8Rows = resize(this.int8Rows, (n) => new Int8Array(n), dim);
+      this.int8Scales = resize(this.int8Scales, (n) => new Float32Array(n), 1);
+    } else if (this.quantization === 'binary') {
+      this.bitRows = resize(this.bitRows, (n) => new Uint32Array(n), this.words);
+    }
+  }
+
+  private grow() {
+    this.capacity *= 2;
+    this.allocate(this.capacity);
+  }
+
+  private writeRow(index: number, normalized: Float32Array) {
+    if (this.rows) this.rows.set(normalized, index * this.dimension);
+    if (this.int8Rows && this.int8Scales) {
+      this.int8Scales[index] = quantizeInt8(normalized, this.int8Rows, index * this.dimension);
+    }
+    if (this.bitRows) quantizeBinary(normalized, this.bitRows, index * this.words);
+  }
+
+  private copyRow(from: number, to: number) {
+    const dim = this.dimension;
+    if (this.rows) this.rows.copyWithin(to * dim, from * dim, (from + 1) * dim);
+    if (this.int8Rows && this.int8Scales) {
+      this.int8Rows.copyWithin(to * dim, from * dim, (from + 1) * dim);
+      this.int8Scales[to] = this.int8Scales[from];
+    }
+    if (this.bitRows) {
+      this.bitRows.copyWithin(to * this.words, from * this.words, (from + 1) * this.words);
+    }
+  }
+}
@@ -0,0 +1,96 @@
+// Fixed tile grid over canvas (flow) coordinates - shared by the tile API and the client
+// Tile (tx, ty) covers x in [tx * TILE_SIZE, (tx + 1) * TILE_SIZE), same for y.
+// Large workspaces load tiles around the viewport instead of the whole graph
+// (GET /api/workspaces/[id]/tiles); tiles that are not loaded render as aggregates.
+
+export const TILE_SIZE = 1024;
+
+// Workspaces with more nodes than this load windowed (summary first, tiles on demand)
+export const WINDOWED_NODE_THRESHOLD = 2000;
+
+// Extra flow-space margin loaded around the visible rect, so short pans never show gaps
+export const VIEWPORT_MARGIN = TILE_SIZE / 2;
+
+// Most tiles one request (and one viewport) may load; beyond this the view is zoomed out
+// far enough that aggregates say more than thousands of tiny nodes would
+export const MAX_TILES_PER_REQUEST = 64;
+
+export interface TileCoord {
+  tx: number;
+  ty: number;
+}
+
+// Per-tile aggregate: node count and centroid (flow coordinates)
+export interface TileSummary extends TileCoord {
+  key: string;
+  count: number;
+  cx: number;
+  cy: number;
+}
+
+export interface FlowRect {
+  minX: number;
+  minY: number;
+  maxX: number;
+  maxY: number;
+}
+
+export function tileKey(tx: number, ty: number): string {
+  return `${tx}:${ty}`;
+}
+
+export function parseTileKey(key: string): TileCoord | null {
+  const match = /^(-?\d+):(-?\d+)$/.exec(key);
+  if (!match) return null;
+  return { tx: Number(match[1]), ty: Number(match[2]) };
+}
+
+export function tileOf(x: number, y: number): TileCoord {
+  return { tx: Math.floor(x / TILE_SIZE), ty: Math.floor(y / TILE_SIZE) };
+}
+
+export function tileRect({ tx, ty }: TileCoord): FlowRect {
+  return {
+    minX: tx * TILE_SIZE,
+    minY: ty * TILE_SIZE,
+    maxX: (tx + 1) * TILE_SIZE,
+    maxY: (ty + 1) * TILE_SIZE,
+  };
+}
+
+/**
+ * Visible flow-space rect for a React Flow viewport ({x, y, zoom} transform) of the given
+ * screen size, grown by `margin` on every side
+ */
+export function viewportRect(
+  viewport: { x: number; y: number; zoom: number },
+  width: number,
+  height: number,
+  margin: number = VIEWPORT_MARGIN
+): FlowRect {
+  const zoom = viewport.zoom || 1;
+  return {
+    minX: -viewport.x / zoom - margin,
+    minY: -viewport.y / zoom - margin,
+    maxX: (width - viewport.x) / zoom + margin,
+    maxY: (height - viewport.y) / zoom + margin,
+  };
+}
+
+/**
+ * Keys of every tile overlapping `rect`, or null when that is more than `maxTiles`
+ */
+export function tilesInRect(rect: FlowRect, maxTiles: number = MAX_TILES_PER_REQUEST): string[] | null {
+  const min = tileOf(rect.minX, rect.minY);
+  const max = tileOf(rect.maxX, rect.maxY);
+  const count = (max.tx - min.tx + 1) * (max.ty - min.ty + 1);
+  if (count > maxTiles) return null;
+
+  const keys: string[] = [];
+  for (let ty = min.ty; ty <= max.ty; ty++) {
+    for (let tx = min.tx; tx <= max.tx; tx++) {
+      keys.push(tileKey(tx, ty));
+    }
+  }
+  return keys;
+}
@@ -0,0 +1,180 @@
+import { randomUUID } from 'crypto';
+import { Prisma } from '@prisma/client';
+import { prisma } from './db';
+
+// Server-only bulk import (POST /api/workspaces/[id]/import)
+// - records arrive as an async stream (NDJSON lines, or the items of a JSON body) and are
+//   written in multi-row INSERTs as they come, inside one transaction: an import lands
+//   completely or not at all
+// - node ids are generated here and source ids remapped in memory, so edges resolve with
+//   a map lookup instead of a scan over the imported nodes
+// - edges are held back until the end, since they may reference nodes later in the stream
+// - embeddings are not computed here; callers queue the new ids for batch indexing
+
+// Rows per INSERT - 1000 nodes x 7 columns stays well under Postgres' 65535 bind parameters
+const NODE_BATCH_SIZE = 1000;
+const EDGE_BATCH_SIZE = 2000;
+export const MAX_IMPORT_NODES = 200_000;
+export const MAX_IMPORT_EDGES = 1_000_000;
+const IMPORT_TIMEOUT_MS = 10 * 60 * 1000;
+
+// Thrown for malformed input - the route maps it to 400
+export class ImportError extends Error {}
+
+export interface ImportResult {
+  nodeIds: string[];
+  edgeCount: number;
+  // Edges dropped because an endpoint was not in the import
+  skippedEdges: number;
+}
+
+interface PendingEdge {
+  source: string;
+  target: string;
+  label: string | null;
+  similarity: number | null;
+}
+
+function toNumber(value: unknown): number {
+  const number = Number(value);
+  return Number.isFinite(number) ? number : 0;
+}
+
+/**
+ * Parse an NDJSON byte stream into records, one per non-empty line
+ */
+export async function* readNdjson(body: ReadableStream<Uint8Array>): AsyncGenerator<any> {
+  const reader = body.pipeThrough(new TextDecoderStream()).getReader();
+  let buffer = '';
+  let lineNumber = 0;
+
+  const parse = (line: string) => {
+    lineNumber++;
+    try {
+      return JSON.parse(line);
+    } catch {
+      throw new ImportError(`Invalid JSON on line ${lineNumber}`);
+    }
+  };
+
+  try {
+    while (true) {
+      const { value, done } = await reader.read();
+      if (done) break;
+      buffer += value;
+
+      let start = 0;
+      let newline: number;
+      while ((newline = buffer.indexOf('\n', start)) !== -1) {
+        const line = buffer.slice(start, newline).trim();
+        start = newline + 1;
+        if (line) yield parse(line);
+        else lineNumber++;
+      }
+      buffer = buffer.slice(start);
+    }
+    if (buffer.trim()) yield parse(buffer.trim());
+  } finally {
+    reader.releaseLock();
+  }
+}
+
+/**
+ * Records of a legacy JSON body ({ nodes, edges }) in import order
+ */
+export async function* jsonBodyRecords(body: { nodes: any[]; edges?: any[] }): AsyncGenerator<any> {
+  for (const node of body.nodes) yield { ...node, type: 'node' };
+  for (const edge of body.edges || []) yield { ...edge, type: 'edge' };
+}
+
+/**
+ * Import a stream of records into a workspace
+ * Records use the ndjson export shape: { type: 'node', id?, title, content, tags, x, y } and
+ * { type: 'edge', source, target, label?, similarity? }; other types (workspace, member,
+ * end) are ignored. Edge endpoints may name a node by its source id or by its title.
+ */
+export async function importWorkspaceRecords(
+  workspaceId: string,
+  records: AsyncIterable<any>
+): Promise<ImportResult> {
+  return prisma.$transaction(
+    async (tx) => {
+      const nodeIds: string[] = [];
+      const idMap = new Map<string, string>();
+      const titleMap = new Map<string, string>();
+      const edges: PendingEdge[] = [];
+      let nodeBatch: Prisma.NodeCreateManyInput[] = [];
+
+      const flushNodes = async () => {
+        if (nodeBatch.length === 0) return;
+        await tx.node.createMany({ data: nodeBatch });
+        nodeBatch = [];
+      };
+
+      for await (const record of records) {
+        if (!record || typeof record !== 'object') {
+          throw new ImportError('Import records must be JSON objects');
+        }
+
+        if (record.type === 'node') {
+          if (nodeIds.length >= MAX_IMPORT_NODES) {
+            throw new ImportError(`Too many nodes (max ${MAX_IMPORT_NODES})`);
+          }
+          const id = randomUUID();
+          const title = typeof record.title === 'string' && record.title ? record.title : 'Untitled';
+          nodeIds.push(id);
+          if (record.id !== undefined && record.id !== null) idMap.set(String(record.id), id);
+          if (!titleMap.has(title)) titleMap.set(title, id);
+
+          nodeBatch.push({
+            id,
+            workspaceId,
+            title,
+            content: record.content ?? {},
+            tags: Array.isArray(record.tags) ? record.tags.map(String) : [],
+            x: toNumber(record.x),
+            y: toNumber(record.y),
+          });
+          if (nodeBatch.length >= NODE_BATCH_SIZE) await flushNodes();
+        } else if (record.type === 'edge') {
+          if (edges.length >= MAX_IMPORT_EDGES) {
+            throw new ImportError(`Too many edges (max ${MAX_IMPORT_EDGES})`);
+          }
+          edges.push({
+            source: String(record.source),
+            target: String(record.target),
+            label: typeof record.label === 'string' && record.label ? record.label : null,
+            similarity: typeof record.similarity === 'number' ? record.similarity : null,
+          });
+        }
+      }
+      await flushNodes();
+
+      const resolve = (ref: string) => idMap.get(ref) ?? titleMap.get(ref);
+      const edgeRows: Prisma.EdgeCreateManyInput[] = [];
+      let skippedEdges = 0;
+      for (const edge of edges) {
+        const source = resolve(edge.source);
+        const target = resolve(edge.target);
+        if (!source || !target) {
+          skippedEdges++;
+          continue;
+        }
+        edgeRows.push({ workspaceId, source, target, label: edge.label, similarity: edge.similarity });
+      }
+
+      let edgeCount = 0;
+      for (let i = 0; i < edgeRows.length; i += EDGE_BATCH_SIZE) {
+        // Duplicate (source, target) pairs in the input collapse onto the unique index
+        const { count } = await tx.edge.createMany({
+          data: edgeRows.slice(i, i + EDGE_BATCH_SIZE),
+          skipDuplicates: true,
+        });
+        edgeCount += count;
+      }
+
+      return { nodeIds, edgeCount, skippedEdges };
+    },
+    { timeout: IMPORT_TIMEOUT_MS, maxWait: 10_000 }
+  );
+}
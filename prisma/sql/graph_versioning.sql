@@ -0,0 +1,79 @@
+-- Graph change versioning for delta sync (GET /api/workspaces/[id]/graph?since=<version>)
+--
+-- Every insert/update/delete on nodes or edges bumps workspaces.graph_version and stamps
+-- the row with the new value, so "what changed since version N" is a range scan on
+-- (workspace_id, version). Deletes leave a row in graph_tombstones.
+--
+-- workspaces.topology_version moves only when the graph's shape changes (node insert/delete,
+-- edge insert/delete or endpoint change). Cached layouts (lib/layoutCache.ts) are keyed by it,
+-- so writing layout positions back to the nodes does not invalidate the layout itself.
+--
+-- Bumping the counter takes a row lock on the workspace, so versions become visible to
+-- readers in commit order - a client that has seen version N can never miss a change <= N.
+--
+-- prisma db push cannot create triggers; apply after pushing the schema:
+--   psql "$DATABASE_URL" -f prisma/sql/graph_versioning.sql
+
+CREATE OR REPLACE FUNCTION bump_graph_version()
+RETURNS TRIGGER AS $$
+DECLARE
+  ws workspaces.id%TYPE;
+  v INTEGER;
+  topology INTEGER := 0;
+BEGIN
+  IF TG_OP = 'DELETE' THEN
+    ws := OLD.workspace_id;
+  ELSE
+    ws := NEW.workspace_id;
+  END IF;
+
+  IF TG_OP <> 'UPDATE' THEN
+    topology := 1;
+  ELSIF TG_ARGV[0] = 'edge' THEN
+    IF NEW.source IS DISTINCT FROM OLD.source OR NEW.target IS DISTINCT FROM OLD.target THEN
+      topology := 1;
+    END IF;
+  END IF;
+
+  UPDATE workspaces
+  SET graph_version = graph_version + 1,
+      topology_version = topology_version + topology
+  WHERE id = ws
+  RETURNING graph_version INTO v;
+
+  -- Workspace itself is being deleted (cascade) - nothing to sync
+  IF NOT FOUND THEN
+    IF TG_OP = 'DELETE' THEN
+      RETURN OLD;
+    END IF;
+    RETURN NEW;
+  END IF;
+
+  IF TG_OP = 'DELETE' THEN
+    INSERT INTO graph_tombstones (id, workspace_id, entity_type, entity_id, version)
+    VALUES (gen_random_uuid(), ws, TG_ARGV[0], OLD.id, v);
+    RETURN OLD;
+  END IF;
+
+  NEW.version := v;
+  RETURN NEW;
+END;
+$$ LANGUAGE plpgsql;
+
+-- Only columns clients render - embedding writes must not invalidate every client's copy
+DROP TRIGGER IF EXISTS nodes_graph_version ON nodes;
+CREATE TRIGGER nodes_graph_version
+  BEFORE INSERT OR DELETE OR UPDATE OF title, content, tags, x, y ON nodes
+  FOR EACH ROW
+  EXECUTE FUNCTION bump_graph_version('node');
+
+DROP TRIGGER IF EXISTS edges_graph_version ON edges;
+CREATE TRIGGER edges_graph_version
+  BEFORE INSERT OR DELETE OR UPDATE OF source, target, label, similarity ON edges
+  FOR EACH ROW
+  EXECUTE FUNCTION bump_graph_version('edge');
+
+-- One server-computed layout per (workspace, layout type); user presets leave topology_version null
+CREATE UNIQUE INDEX IF NOT EXISTS layout_presets_cached_layout_key
+  ON layout_presets (workspace_id, layout_type)
+  WHERE topology_version IS NOT NULL;
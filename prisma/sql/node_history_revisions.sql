@@ -0,0 +1,59 @@
+-- Convert node_history from full copies written by a trigger to numbered revisions
+-- (lib/nodeRevisions.ts: keyframes plus JSON patches, recorded by the application)
+--
+-- Databases built from supabase/migrations.sql have node_history_trigger, a BEFORE UPDATE
+-- trigger on nodes that inserts (title, content, tags). Those columns no longer exist in
+-- the Prisma schema, so once it is pushed every node UPDATE would fail inside the trigger.
+--
+-- Run BEFORE `prisma db push` on such databases (push drops the old columns):
+--   psql "$DATABASE_URL" -f prisma/sql/node_history_revisions.sql
+-- scripts/setup-database.sh does this ahead of the push. Safe to re-run, and a no-op on a
+-- database without the tables yet; one created by `prisma db push` only gets the trigger drop.
+--
+-- Existing rows: each legacy row is a full copy of the node as it was before one update.
+-- Per node they become revisions 1..n in (created_at, id) order, every one a keyframe whose
+-- data is {title, content, tags} - the same shape the application writes. The next
+-- compaction (compact_node_history job) thins them and re-encodes the chain as patches.
+
+BEGIN;
+
+DROP TRIGGER IF EXISTS node_history_trigger ON nodes;
+DROP FUNCTION IF EXISTS create_node_history();
+
+DO $$
+BEGIN
+  IF EXISTS (
+    SELECT 1 FROM information_schema.columns
+    WHERE table_name = 'node_history' AND column_name = 'title'
+  ) THEN
+    ALTER TABLE node_history ADD COLUMN IF NOT EXISTS revision INTEGER;
+    ALTER TABLE node_history ADD COLUMN IF NOT EXISTS keyframe BOOLEAN NOT NULL DEFAULT false;
+    ALTER TABLE node_history ADD COLUMN IF NOT EXISTS data JSONB;
+
+    UPDATE node_history h
+    SET revision = numbered.revision,
+        keyframe = true,
+        data = jsonb_build_object(
+          'title', h.title,
+          'content', h.content,
+          'tags', to_jsonb(coalesce(h.tags, ARRAY[]::TEXT[]))
+        )
+    FROM (
+      SELECT id, row_number() OVER (PARTITION BY node_id ORDER BY created_at, id) AS revision
+      FROM node_history
+    ) numbered
+    WHERE numbered.id = h.id AND h.data IS NULL;
+
+    ALTER TABLE node_history ALTER COLUMN revision SET NOT NULL;
+    ALTER TABLE node_history ALTER COLUMN data SET NOT NULL;
+    ALTER TABLE node_history DROP COLUMN title;
+    ALTER TABLE node_history DROP COLUMN content;
+    ALTER TABLE node_history DROP COLUMN tags;
+
+    CREATE UNIQUE INDEX IF NOT EXISTS node_history_node_id_revision_key
+      ON node_history (node_id, revision);
+  END IF;
+END
+$$;
+
+COMMIT;
@@ -0,0 +1,47 @@
+-- Full-text + trigram search index over nodes (lib/searchIndex.ts)
+--
+-- Both indexes are expression indexes over IMMUTABLE functions of (title, tags, content),
+-- so Postgres keeps them current on every insert/update - no extra columns or triggers.
+-- Queries must call the same functions with the same arguments to use them.
+--
+-- prisma db push cannot create expression indexes; apply after pushing the schema:
+--   psql "$DATABASE_URL" -f prisma/sql/search_index.sql
+
+CREATE EXTENSION IF NOT EXISTS pg_trgm;
+
+-- Plain text of node content: every "text" field of a TipTap document (at any depth),
+-- or the content itself when it is a bare string
+CREATE OR REPLACE FUNCTION node_content_text(content JSONB)
+RETURNS TEXT AS $$
+  SELECT CASE
+    WHEN content IS NULL THEN ''
+    WHEN jsonb_typeof(content) = 'string' THEN content #>> '{}'
+    ELSE coalesce(
+      (SELECT string_agg(t #>> '{}', ' ')
+        FROM jsonb_path_query(content, 'strict $.**.text ? (@.type() == "string")') AS t),
+      ''
+    )
+  END
+$$ LANGUAGE sql IMMUTABLE PARALLEL SAFE;
+
+-- Weighted document: title (A) > tags (B) > content (C)
+CREATE OR REPLACE FUNCTION node_search_document(title TEXT, tags TEXT[], content JSONB)
+RETURNS TSVECTOR AS $$
+  SELECT setweight(to_tsvector('english'::regconfig, coalesce(title, '')), 'A')
+      || setweight(to_tsvector('english'::regconfig, coalesce(array_to_string(tags, ' '), '')), 'B')
+      || setweight(to_tsvector('english'::regconfig, node_content_text(content)), 'C')
+$$ LANGUAGE sql IMMUTABLE PARALLEL SAFE;
+
+-- Lower-cased flat text for substring / typo-tolerant matching
+CREATE OR REPLACE FUNCTION node_search_text(title TEXT, tags TEXT[], content JSONB)
+RETURNS TEXT AS $$
+  SELECT lower(
+    coalesce(title, '') || ' ' || coalesce(array_to_string(tags, ' '), '') || ' ' || node_content_text(content)
+  )
+$$ LANGUAGE sql IMMUTABLE PARALLEL SAFE;
+
+CREATE INDEX IF NOT EXISTS nodes_search_document_idx
+  ON nodes USING gin (node_search_document(title, tags, content));
+
+CREATE INDEX IF NOT EXISTS nodes_search_text_trgm_idx
+  ON nodes USING gin (node_search_text(title, tags, content) gin_trgm_ops);
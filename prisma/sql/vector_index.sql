@@ -0,0 +1,12 @@
+-- Approximate nearest-neighbour index for embedding similarity (lib/db-server.ts)
+--
+-- HNSW needs no training data (unlike the ivfflat index in supabase/schema.sql, whose
+-- lists are fixed at build time), so recall stays stable as workspaces grow. It turns the
+-- per-node top-k lookups in autoLinkNodes into index scans, which is what makes a
+-- workspace-wide relink run in seconds.
+--
+-- prisma db push cannot create HNSW indexes; apply after pushing the schema:
+--   psql "$DATABASE_URL" -f prisma/sql/vector_index.sql
+
+CREATE INDEX IF NOT EXISTS nodes_embedding_hnsw_idx
+  ON nodes USING hnsw (embedding vector_cosine_ops);
@@ -0,0 +1,474 @@
+/**
+ * Benchmark suite: synthetic workspaces at several sizes, core operations timed against them
+ *
+ * Usage:
+ *   npm run bench -- [--sizes 1000,10000,100000] [--seed 1] [--runs 5]
+ *                    [--out benchmark-results.json] [--compare baseline.json] [--threshold 0.25]
+ *                    [--keep]
+ *
+ * For each size a workspace is generated (scripts/synthetic-workspace.ts - same seed, same
+ * data), written to DATABASE_URL and measured:
+ *   data_load            GET /api/workspaces/[id]/data's queries + serialization
+ *   data_load_binary     the ?format=binary skeleton (lib/graphPayload.ts), encoded and decoded
+ *   data_load_windowed   the ?windowed=1 tile summaries
+ *   search_text          full-text/trigram search (searchWorkspaceNodes, semantic off)
+ *   search_hybrid        with semantic matches - only when OPENAI_API_KEY is set
+ *   find_similar         findSimilarNodes for sampled node embeddings
+ *   auto_link_node       autoLinkNode (the per-node job after create)
+ *   auto_link_bulk       autoLinkNodes over AUTO_LINK_SAMPLE nodes
+ *   export_ndjson        streamWorkspaceExport, fully consumed
+ *   import_ndjson        importWorkspaceRecords of that export into a scratch workspace
+ *   layout_*             lib/layoutEngine.ts layouts on the generated graph
+ * Results (p50/p95/mean/min/max per operation, plus per-span percentiles from lib/tracing)
+ * are written as JSON to --out. With --compare, operations whose p50 got slower than the
+ * baseline by more than --threshold are listed and the exit code is 1.
+ * Workspaces are deleted afterwards unless --keep is given. Use a scratch database: the
+ * pgvector, search and versioning SQL from prisma/sql should be applied.
+ */
+
+import { execSync } from 'child_process';
+import { readFileSync, existsSync, writeFileSync } from 'fs';
+import { resolve } from 'path';
+import type { SyntheticWorkspace } from './synthetic-workspace';
+
+// Load environment variables from .env.local or .env
+function loadEnvFile() {
+  const envPaths = [
+    resolve(process.cwd(), '.env.local'),
+    resolve(process.cwd(), '.env'),
+  ];
+
+  for (const envPath of envPaths) {
+    if (existsSync(envPath)) {
+      const envFile = readFileSync(envPath, 'utf-8');
+
+      for (const line of envFile.split('\n')) {
+        const trimmedLine = line.trim();
+        // Skip comments and empty lines
+        if (!trimmedLine || trimmedLine.startsWith('#')) continue;
+
+        const [key, ...valueParts] = trimmedLine.split('=');
+        if (key && valueParts.length > 0) {
+          const cleanValue = valueParts.join('=').trim().replace(/^["']|["']$/g, '');
+          if (!process.env[key.trim()]) {
+            process.env[key.trim()] = cleanValue;
+          }
+        }
+      }
+      console.log(`✅ Loaded environment variables from ${envPath}`);
+      return;
+    }
+  }
+
+  console.warn('⚠️  No .env.local or .env file found. Make sure DATABASE_URL is set.');
+}
+
+const BENCH_USER_EMAIL = 'bench@meshflow.local';
+const SIMILAR_QUERIES = 20;
+const AUTO_LINK_NODE_RUNS = 10;
+const AUTO_LINK_SAMPLE = 1000;
+const INCREMENTAL_NEW_SHARE = 0.01;
+// semanticClusterLayout compares every pair of nodes
+const SEMANTIC_LAYOUT_MAX_NODES = 2000;
+// Differences below this are noise whatever the ratio
+const REGRESSION_FLOOR_MS = 2;
+
+interface Args {
+  sizes: number[];
+  seed: number;
+  runs: number;
+  out: string;
+  compare: string | null;
+  threshold: number;
+  keep: boolean;
+}
+
+function parseArgs(argv: string[]): Args {
+  const args: Args = {
+    sizes: [1000, 10_000, 100_000],
+    seed: 1,
+    runs: 5,
+    out: 'benchmark-results.json',
+    compare: null,
+    threshold: 0.25,
+    keep: false,
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const flag = argv[i];
+    const value = () => {
+      const next = argv[++i];
+      if (next === undefined) throw new Error(`Missing value for ${flag}`);
+      return next;
+    };
+    switch (flag) {
+      case '--sizes':
+        args.sizes = value().split(',').map((size) => parseInt(size.replace(/k$/i, '000'), 10));
+        break;
+      case '--seed':
+        args.seed = parseInt(value(), 10);
+        break;
+      case '--runs':
+        args.runs = Math.max(1, parseInt(value(), 10));
+        break;
+      case '--out':
+        args.out = value();
+        break;
+      case '--compare':
+        args.compare = value();
+        break;
+      case '--threshold':
+        args.threshold = parseFloat(value());
+        break;
+      case '--keep':
+        args.keep = true;
+        break;
+      default:
+        throw new Error(`Unknown option ${flag}`);
+    }
+  }
+  if (args.sizes.some((size) => !Number.isInteger(size) || size < 2)) {
+    throw new Error('--sizes must be a comma-separated list of node counts >= 2');
+  }
+  return args;
+}
+
+interface MeasuredOperation {
+  name: string;
+  runs: number;
+  p50Ms: number;
+  p95Ms: number;
+  meanMs: number;
+  minMs: number;
+  maxMs: number;
+  details?: Record<string, unknown>;
+}
+
+type OperationResult =
+  | MeasuredOperation
+  | { name: string; skipped: string }
+  | { name: string; error: string };
+
+interface SizeResult {
+  nodes: number;
+  edges: number;
+  topics: number;
+  generateMs: number;
+  insertMs: number;
+  operations: OperationResult[];
+  spans: Record<string, unknown>;
+}
+
+function round(ms: number): number {
+  return Math.round(ms * 100) / 100;
+}
+
+function summarize(name: string, durations: number[], details?: Record<string, unknown>): MeasuredOperation {
+  const sorted = [...durations].sort((a, b) => a - b);
+  const rank = (q: number) => sorted[Math.min(sorted.length - 1, Math.ceil(q * sorted.length) - 1)];
+  return {
+    name,
+    runs: sorted.length,
+    p50Ms: round(rank(0.5)),
+    p95Ms: round(rank(0.95)),
+    meanMs: round(sorted.reduce((sum, ms) => sum + ms, 0) / sorted.length),
+    minMs: round(sorted[0]),
+    maxMs: round(sorted[sorted.length - 1]),
+    ...(details ? { details } : {}),
+  };
+}
+
+/**
+ * Time `fn` `runs` times after one untimed warm-up (skipped with warmup: false, for
+ * operations that change the data). `fn` gets the run number and may return details.
+ */
+async function measure(
+  name: string,
+  runs: number,
+  fn: (run: number) => Promise<Record<string, unknown> | void>,
+  options: { warmup?: boolean } = {}
+): Promise<OperationResult> {
+  try {
+    if (options.warmup !== false) await fn(-1);
+    const durations: number[] = [];
+    let details: Record<string, unknown> | undefined;
+    for (let run = 0; run < runs; run++) {
+      const start = performance.now();
+      details = (await fn(run)) || details;
+      durations.push(performance.now() - start);
+    }
+    const result = summarize(name, durations, details);
+    console.log(`  ${name.padEnd(24)} p50 ${String(result.p50Ms).padStart(10)} ms   p95 ${String(result.p95Ms).padStart(10)} ms`);
+    return result;
+  } catch (error: any) {
+    console.warn(`  ${name.padEnd(24)} failed: ${error?.message}`);
+    return { name, error: error?.message || String(error) };
+  }
+}
+
+function skip(name: string, reason: string): OperationResult {
+  console.log(`  ${name.padEnd(24)} skipped (${reason})`);
+  return { name, skipped: reason };
+}
+
+function gitCommit(): string | null {
+  try {
+    return execSync('git rev-parse --short HEAD', { stdio: ['ignore', 'pipe', 'ignore'] }).toString().trim();
+  } catch {
+    return null;
+  }
+}
+
+async function benchmarkSize(size: number, args: Args, ownerId: string): Promise<SizeResult> {
+  const { prisma } = await import('../lib/db');
+  const { findSimilarNodes, autoLinkNode, autoLinkNodes, storeNodeEmbeddings } = await import('../lib/db-server');
+  const { nodeSyncSelect, edgeSyncSelect, serializeNode, serializeEdge, getGraphSkeleton } = await import('../lib/graphSync');
+  const { encodeGraphPayload, decodeGraphPayload } = await import('../lib/graphPayload');
+  const { getTileSummaries } = await import('../lib/graphTiles');
+  const { searchWorkspaceNodes } = await import('../lib/searchIndex');
+  const { streamWorkspaceExport } = await import('../lib/exportStream');
+  const { importWorkspaceRecords, readNdjson } = await import('../lib/workspaceImport');
+  const layouts = await import('../lib/layoutEngine');
+  const { getLatencyMetrics, resetLatencyMetrics } = await import('../lib/tracing');
+  const { generateSyntheticWorkspace, insertSyntheticWorkspace, createRandom } = await import('./synthetic-workspace');
+
+  console.log(`\n📦 ${size.toLocaleString()} nodes`);
+  let start = performance.now();
+  const synthetic: SyntheticWorkspace = generateSyntheticWorkspace({ nodes: size, seed: args.seed });
+  const generateMs = performance.now() - start;
+  console.log(`  generated ${synthetic.edges.length.toLocaleString()} edges, ${synthetic.topics.length} topics in ${Math.round(generateMs)} ms`);
+
+  start = performance.now();
+  let lastLogged = 0;
+  const { workspaceId, nodeIds } = await insertSyntheticWorkspace(synthetic, {
+    prisma,
+    storeNodeEmbeddings,
+    ownerId,
+    name: `Benchmark ${size} (seed ${args.seed})`,
+    onProgress: (stage, done, total) => {
+      if (done === total || performance.now() - lastLogged > 5000) {
+        lastLogged = performance.now();
+        console.log(`  inserting ${stage}: ${done.toLocaleString()}/${total.toLocaleString()}`);
+      }
+    },
+  });
+  const insertMs = performance.now() - start;
+
+  const scratchWorkspaces: string[] = [];
+  const operations: OperationResult[] = [];
+  const runs = args.runs;
+  // Whole-workspace operations get fewer runs on big workspaces
+  const heavyRuns = size >= 100_000 ? 1 : Math.min(runs, 3);
+  const random = createRandom(args.seed + size);
+  const sampleIndex = () => Math.floor(random() * size);
+
+  resetLatencyMetrics();
+  try {
+    const workspace = await prisma.workspace.findUniqueOrThrow({ where: { id: workspaceId } });
+
+    operations.push(await measure('data_load', heavyRuns, async () => {
+      const [nodes, edges] = await Promise.all([
+        prisma.node.findMany({ where: { workspaceId }, orderBy: { createdAt: 'desc' }, select: nodeSyncSelect }),
+        prisma.edge.findMany({ where: { workspaceId }, select: edgeSyncSelect }),
+      ]);
+      const body = JSON.stringify({ nodes: nodes.map(serializeNode), edges: edges.map(serializeEdge) });
+      return { bytes: Buffer.byteLength(body) };
+    }));
+
+    operations.push(await measure('data_load_binary', heavyRuns, async () => {
+      const skeleton = await getGraphSkeleton(workspaceId);
+      const payload = encodeGraphPayload({ workspaceId, version: workspace.graphVersion, ...skeleton });
+      const decoded = decodeGraphPayload(payload);
+      return { bytes: payload.byteLength, nodes: decoded.nodes.length };
+    }));
+
+    operations.push(await measure('data_load_windowed', runs, async () => {
+      const summaries = await getTileSummaries(workspaceId);
+      return { tiles: summaries.length };
+    }));
+
+    const [largest] = synthetic.topics;
+    const queries = [largest.name, `${largest.keywords[0]} ${largest.keywords[1]}`, largest.keywords[2].slice(0, 3)];
+    operations.push(await measure('search_text', runs * queries.length, async (run) => {
+      const page = await searchWorkspaceNodes(workspaceId, queries[Math.max(0, run) % queries.length], { limit: 20, semantic: false });
+      return { total: page.total };
+    }));
+    operations.push(
+      process.env.OPENAI_API_KEY
+        ? await measure('search_hybrid', runs * queries.length, async (run) => {
+            const page = await searchWorkspaceNodes(workspaceId, queries[Math.max(0, run) % queries.length], { limit: 20 });
+            return { total: page.total };
+          })
+        : skip('search_hybrid', 'OPENAI_API_KEY not set')
+    );
+
+    const similarSample = Array.from({ length: SIMILAR_QUERIES }, sampleIndex);
+    operations.push(await measure('find_similar', similarSample.length, async (run) => {
+      const index = similarSample[Math.max(0, run)];
+      const matches = await findSimilarNodes(Array.from(synthetic.embedding(index)), workspaceId, nodeIds[index], 0.65, 10);
+      return { matches: matches.length };
+    }));
+
+    operations.push(await measure('auto_link_node', AUTO_LINK_NODE_RUNS, async () => {
+      await autoLinkNode(workspaceId, nodeIds[sampleIndex()]);
+    }, { warmup: false }));
+
+    const bulkSample = Array.from({ length: Math.min(AUTO_LINK_SAMPLE, size) }, sampleIndex);
+    operations.push(await measure('auto_link_bulk', 1, async () => {
+      const created = await autoLinkNodes(workspaceId, Array.from(new Set(bulkSample.map((i) => nodeIds[i]))));
+      return { nodes: bulkSample.length, created: created.length };
+    }, { warmup: false }));
+
+    let exported: Uint8Array = new Uint8Array();
+    operations.push(await measure('export_ndjson', heavyRuns, async () => {
+      const chunks: Uint8Array[] = [];
+      const reader = streamWorkspaceExport(workspace, 'ndjson', ownerId).getReader();
+      while (true) {
+        const { value, done } = await reader.read();
+        if (done) break;
+        chunks.push(value);
+      }
+      exported = Buffer.concat(chunks);
+      return { bytes: exported.byteLength };
+    }));
+
+    operations.push(await measure('import_ndjson', heavyRuns, async () => {
+      const scratch = await prisma.workspace.create({ data: { name: `Benchmark import ${size}`, ownerId } });
+      scratchWorkspaces.push(scratch.id);
+      const result = await importWorkspaceRecords(scratch.id, readNdjson(new Response(exported).body!));
+      return { nodes: result.nodeIds.length, edges: result.edgeCount };
+    }, { warmup: false }));
+
+    // Layouts run on the generated graph in memory
+    const layoutNodes = synthetic.nodes.map((node) => ({ id: nodeIds[node.index], x: node.x, y: node.y }));
+    const idOf = new Map(synthetic.nodes.map((node) => [node.id, nodeIds[node.index]]));
+    const layoutEdges = synthetic.edges.map((edge) => ({ source: idOf.get(edge.source)!, target: idOf.get(edge.target)! }));
+
+    operations.push(await measure('layout_force', heavyRuns, async () => {
+      layouts.forceDirectedLayout(layoutNodes, layoutEdges);
+    }, { warmup: size < 100_000 }));
+
+    const newIds = new Set(layoutNodes.slice(-Math.max(1, Math.round(size * INCREMENTAL_NEW_SHARE))).map((node) => node.id));
+    operations.push(await measure('layout_incremental', runs, async () => {
+      const moved = layouts.incrementalLayout(layoutNodes, layoutEdges, newIds);
+      return { newNodes: newIds.size, moved: moved.size };
+    }));
+
+    operations.push(await measure('layout_hierarchical', runs, async () => {
+      layouts.hierarchicalLayout(layoutNodes, layoutEdges, layoutNodes[0].id);
+    }));
+
+    operations.push(await measure('layout_radial', runs, async () => {
+      layouts.radialLayout(layoutNodes[0], layoutNodes);
+    }));
+
+    if (size <= SEMANTIC_LAYOUT_MAX_NODES) {
+      const embeddings = new Map(layoutNodes.map((node, i) => [node.id, Array.from(synthetic.embedding(i))]));
+      operations.push(await measure('layout_semantic_cluster', heavyRuns, async () => {
+        layouts.semanticClusterLayout(layoutNodes as any, embeddings);
+      }));
+    } else {
+      operations.push(skip('layout_semantic_cluster', `quadratic, only run up to ${SEMANTIC_LAYOUT_MAX_NODES} nodes`));
+    }
+  } finally {
+    if (!args.keep) {
+      // Cascades to nodes, edges and everything hanging off them
+      await prisma.workspace.deleteMany({ where: { id: { in: [workspaceId, ...scratchWorkspaces] } } });
+    } else {
+      console.log(`  kept workspace ${workspaceId}`);
+    }
+  }
+
+  return {
+    nodes: size,
+    edges: synthetic.edges.length,
+    topics: synthetic.topics.length,
+    generateMs: round(generateMs),
+    insertMs: round(insertMs),
+    operations,
+    spans: getLatencyMetrics().spans,
+  };
+}
+
+// Operations whose p50 grew by more than `threshold` over the baseline
+function findRegressions(results: SizeResult[], baselinePath: string, threshold: number) {
+  const baseline = JSON.parse(readFileSync(baselinePath, 'utf-8')) as { results: SizeResult[] };
+  const regressions: Array<{ nodes: number; name: string; baselineMs: number; currentMs: number }> = [];
+  for (const result of results) {
+    const previous = baseline.results.find((candidate) => candidate.nodes === result.nodes);
+    if (!previous) continue;
+    for (const operation of result.operations) {
+      if (!('p50Ms' in operation)) continue;
+      const before = previous.operations.find((candidate) => candidate.name === operation.name);
+      if (!before || !('p50Ms' in before)) continue;
+      if (operation.p50Ms > before.p50Ms * (1 + threshold) && operation.p50Ms - before.p50Ms > REGRESSION_FLOOR_MS) {
+        regressions.push({ nodes: result.nodes, name: operation.name, baselineMs: before.p50Ms, currentMs: operation.p50Ms });
+      }
+    }
+  }
+  return regressions;
+}
+
+async function main() {
+  const args = parseArgs(process.argv.slice(2));
+  loadEnvFile();
+
+  if (!process.env.DATABASE_URL) {
+    console.error('❌ DATABASE_URL environment variable is not set!');
+    process.exit(1);
+  }
+  // Benchmarks time the operations themselves - keep background jobs out of the process
+  process.env.JOB_WORKER = 'off';
+
+  // Imported after the env is loaded so the Prisma client picks up DATABASE_URL
+  const { prisma } = await import('../lib/db');
+  const { warmVectorSupport } = await import('../lib/db-server');
+  await warmVectorSupport();
+
+  const owner = await prisma.user.upsert({
+    where: { email: BENCH_USER_EMAIL },
+    update: {},
+    // Not a bcrypt hash, so nobody can sign in as this user
+    create: { email: BENCH_USER_EMAIL, name: 'Benchmark', password: '!' },
+  });
+
+  const startedAt = new Date().toISOString();
+  const results: SizeResult[] = [];
+  try {
+    for (const size of args.sizes) {
+      results.push(await benchmarkSize(size, args, owner.id));
+    }
+  } finally {
+    await prisma.$disconnect();
+  }
+
+  const report = {
+    schemaVersion: 1,
+    startedAt,
+    finishedAt: new Date().toISOString(),
+    commit: gitCommit(),
+    node: process.version,
+    platform: `${process.platform}-${process.arch}`,
+    seed: args.seed,
+    runs: args.runs,
+    results,
+  };
+  writeFileSync(args.out, JSON.stringify(report, null, 2) + '\n');
+  console.log(`\n📝 Wrote ${args.out}`);
+
+  if (args.compare) {
+    const regressions = findRegressions(results, args.compare, args.threshold);
+    if (regressions.length > 0) {
+      console.error(`\n❌ ${regressions.length} regression(s) over ${Math.round(args.threshold * 100)}% against ${args.compare}:`);
+      for (const r of regressions) {
+        console.error(`   ${String(r.nodes).padStart(7)} nodes  ${r.name.padEnd(24)} ${r.baselineMs} ms → ${r.currentMs} ms`);
+      }
+      process.exit(1);
+    }
+    console.log(`\n✅ No regressions against ${args.compare}`);
+  }
+}
+
+main().catch((error) => {
+  console.error('❌ Benchmark failed:', error);
+  process.exit(1);
+});
@@ -8,6 +8,10 @@
  * 
  * This will create a workspace with various node types and connections
  * suitable for taking screenshots for the landing page.
+ *
+ * For a large workspace instead (synthetic topics, embeddings and edges - see
+ * scripts/synthetic-workspace.ts; scripts/benchmark.ts times operations on these):
+ *   npx tsx scripts/generate-test-workspace.ts --nodes 10000 [--seed 1]
  */
 
 import { PrismaClient } from '@prisma/client';
@@ -120,6 +124,41 @@ const CONTENT_TEMPLATES: Record<string, any> = {
   circle: {},
 };
 
+// --nodes <n> / --seed <n> from the command line
+function readNumberArg(flag: string): number | null {
+  const index = process.argv.indexOf(flag);
+  if (index === -1) return null;
+  const value = parseInt(process.argv[index + 1], 10);
+  if (!Number.isInteger(value) || value < 1) {
+    console.error(`❌ ${flag} needs a positive integer`);
+    process.exit(1);
+  }
+  return value;
+}
+
+async function generateSyntheticTestWorkspace(userId: string, nodeCount: number, seed: number) {
+  const { generateSyntheticWorkspace, insertSyntheticWorkspace } = await import('./synthetic-workspace');
+  const { storeNodeEmbeddings } = await import('../lib/db-server');
+
+  console.log(`📝 Generating ${nodeCount} nodes (seed ${seed})...`);
+  const synthetic = generateSyntheticWorkspace({ nodes: nodeCount, seed });
+  const { workspaceId } = await insertSyntheticWorkspace(synthetic, {
+    prisma,
+    storeNodeEmbeddings,
+    ownerId: userId,
+    name: `Synthetic ${nodeCount} nodes (seed ${seed})`,
+    onProgress: (stage, done, total) => {
+      if (done === total) console.log(`  ✓ ${stage}: ${total}`);
+    },
+  });
+
+  console.log('\n✅ Synthetic workspace created successfully!');
+  console.log(`   Workspace ID: ${workspaceId}`);
+  console.log(`   Nodes Created: ${synthetic.nodes.length}`);
+  console.log(`   Edges Created: ${synthetic.edges.length}`);
+  console.log(`\n🌐 View at: /workspace/${workspaceId}/canvas`);
+}
+
 async function generateTestWorkspace() {
   try {
     console.log('🔍 Finding test user...');
@@ -135,6 +174,12 @@ async function generateTestWorkspace() {
 
     console.log(`✅ Found user: ${user.email}`);
 
+    const nodeCount = readNumberArg('--nodes');
+    if (nodeCount) {
+      await generateSyntheticTestWorkspace(user.id, nodeCount, readNumberArg('--seed') ?? 1);
+      return;
+    }
+
     // Create workspace
     console.log('📦 Creating test workspace...');
     const workspace = await prisma.workspace.create({
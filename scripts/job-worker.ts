@@ -0,0 +1,83 @@
+/**
+ * Standalone background job worker (embeddings, auto-link, cached layouts)
+ *
+ * Usage:
+ *   npm run jobs:worker
+ *
+ * The Next.js server runs an in-process worker by default. For deployments that
+ * should keep OpenAI calls off the web servers, set JOB_WORKER=off for the app and
+ * run one or more of these instead - claims use SKIP LOCKED, so any number is safe.
+ */
+
+import { readFileSync, existsSync } from 'fs';
+import { resolve } from 'path';
+
+// Load environment variables from .env.local or .env
+function loadEnvFile() {
+  const envPaths = [
+    resolve(process.cwd(), '.env.local'),
+    resolve(process.cwd(), '.env'),
+  ];
+
+  for (const envPath of envPaths) {
+    if (existsSync(envPath)) {
+      const envFile = readFileSync(envPath, 'utf-8');
+
+      for (const line of envFile.split('\n')) {
+        const trimmedLine = line.trim();
+        // Skip comments and empty lines
+        if (!trimmedLine || trimmedLine.startsWith('#')) continue;
+
+        const [key, ...valueParts] = trimmedLine.split('=');
+        if (key && valueParts.length > 0) {
+          const cleanValue = valueParts.join('=').trim().replace(/^["']|["']$/g, '');
+          if (!process.env[key.trim()]) {
+            process.env[key.trim()] = cleanValue;
+          }
+        }
+      }
+      console.log(`✅ Loaded environment variables from ${envPath}`);
+      return;
+    }
+  }
+
+  console.warn('⚠️  No .env.local or .env file found. Make sure DATABASE_URL is set.');
+}
+
+async function main() {
+  loadEnvFile();
+
+  if (!process.env.DATABASE_URL) {
+    console.error('❌ DATABASE_URL environment variable is not set!');
+    process.exit(1);
+  }
+
+  // This process is the worker, whatever the app is configured to do
+  delete process.env.JOB_WORKER;
+
+  // Imported after the env is loaded so the Prisma client picks up DATABASE_URL
+  const { startNodeJobWorker } = await import('../lib/nodeJobs');
+  // Register the layout, document snapshot, clustering and history compaction job handlers
+  await import('../lib/layoutCache');
+  await import('../lib/nodeDocuments');
+  await import('../lib/clusterCache');
+  await import('../lib/nodeRevisions');
+  const { stopJobWorker } = await import('../lib/jobQueue');
+  const { flushActivityLog } = await import('../lib/activityLog');
+
+  startNodeJobWorker();
+
+  const shutdown = () => {
+    console.log('🛑 Stopping job worker...');
+    stopJobWorker();
+    // Handlers finishing in the next second can still queue activity rows
+    setTimeout(() => void flushActivityLog().finally(() => process.exit(0)), 1000);
+  };
+  process.on('SIGINT', shutdown);
+  process.on('SIGTERM', shutdown);
+}
+
+main().catch((error) => {
+  console.error('❌ Job worker failed to start:', error);
+  process.exit(1);
+});
@@ -78,10 +78,37 @@ psql "$DB_NAME" -c "CREATE EXTENSION IF NOT EXISTS vector;" 2>/dev/null || {
     echo "   - Linux/Windows: See https://github.com/pgvector/pgvector"
 }
 
+# Must run before the push: it converts legacy node_history rows (databases built from
+# supabase/migrations.sql) into revisions, and the push drops the columns it reads.
+# Safe to re-run; on a new database it does nothing
+PRE_PUSH_SQL="prisma/sql/node_history_revisions.sql"
+echo ""
+echo "🔧 Converting legacy node history ($PRE_PUSH_SQL)..."
+psql "$DB_NAME" -v ON_ERROR_STOP=1 -q -f "$PRE_PUSH_SQL" || {
+    echo "❌ Failed to apply $PRE_PUSH_SQL. Fix it and apply it BEFORE pushing the schema -"
+    echo "   prisma db push would drop the old node_history columns and their data:"
+    echo "   psql $DB_NAME -f $PRE_PUSH_SQL"
+    exit 1
+}
+
 echo ""
 echo "📊 Pushing database schema..."
 npx prisma db push --accept-data-loss
 
+# Apply triggers/indexes that prisma db push cannot express (they need the pushed tables)
+echo ""
+echo "🔧 Applying SQL extensions (prisma/sql)..."
+for sql_file in prisma/sql/*.sql; do
+    [ -f "$sql_file" ] || continue
+    [ "$sql_file" = "$PRE_PUSH_SQL" ] && continue
+    echo "   - $sql_file"
+    psql "$DB_NAME" -v ON_ERROR_STOP=1 -q -f "$sql_file" || {
+        echo "⚠️  Failed to apply $sql_file - apply it manually, after the schema push"
+        echo "   (these files expect the tables prisma db push creates):"
+        echo "   psql $DB_NAME -f $sql_file"
+    }
+done
+
 echo ""
 echo "✅ Database setup complete!"
 echo ""
@@ -20,6 +20,10 @@ NEXTAUTH_SECRET="${execSync('openssl rand -base64 32').toString().trim()}"
 # MeshFlow works without OpenAI, but auto-linking requires it
 # OPENAI_API_KEY="your-openai-api-key"
 
+# Background jobs (embeddings + auto-link)
+# Set to "off" when running workers separately with: npm run jobs:worker
+# JOB_WORKER="off"
+
 # App Configuration
 NEXT_PUBLIC_APP_URL="http://localhost:3000"
 
@@ -0,0 +1,372 @@
+/**
+ * Synthetic workspaces for load tests (scripts/benchmark.ts, generate-test-workspace --nodes)
+ *
+ * Everything is derived from a seed, so the same (nodes, seed) always yields the same
+ * titles, text, tags, positions, embeddings and edges:
+ * - nodes belong to topics of Zipf-distributed size; titles, text and tags are drawn
+ *   mostly from their topic's keywords, so full-text search has realistic selectivity
+ * - embeddings mix a direction shared by every node, the topic centroid and per-node
+ *   noise, tuned so nodes of one topic sit around cosine 0.6 and unrelated nodes around
+ *   0.15 (roughly what text-embedding-3-small gives for notes). Each embedding is rebuilt
+ *   from (seed, index) on demand - 100k x 1536 floats would not fit in memory comfortably
+ * - edges follow preferential attachment within topics plus some cross-topic links, a
+ *   heavy-tailed degree distribution averaging ~3; similarity edges carry their expected
+ *   cosine, the rest are "manual" (similarity null)
+ */
+
+import { randomUUID } from 'crypto';
+import type { PrismaClient } from '@prisma/client';
+
+export const SYNTHETIC_EMBEDDING_DIMENSION = 1536;
+
+// Squared weights of the shared direction, topic centroid and noise (sum to 1)
+const SHARED_WEIGHT = Math.sqrt(0.15);
+const TOPIC_WEIGHT = Math.sqrt(0.45);
+const NOISE_WEIGHT = Math.sqrt(0.4);
+
+const MAX_OUT_DEGREE = 24;
+const SAME_TOPIC_EDGE_SHARE = 0.85;
+const PREFERENTIAL_SHARE = 0.7;
+// Same-topic edges that look auto-linked (similarity set) rather than hand-drawn
+const SIMILARITY_EDGE_SHARE = 0.7;
+
+const NODE_INSERT_CHUNK = 1000;
+const EDGE_INSERT_CHUNK = 5000;
+const EMBEDDING_INSERT_CHUNK = 200;
+
+const TOPIC_NAMES = [
+  'research', 'design', 'roadmap', 'marketing', 'hiring', 'security', 'performance', 'pricing',
+  'onboarding', 'analytics', 'support', 'infrastructure', 'mobile', 'billing', 'search', 'privacy',
+  'partnerships', 'documentation', 'release', 'testing', 'accessibility', 'localization', 'growth',
+  'retention', 'compliance', 'architecture', 'experiments', 'feedback', 'strategy', 'operations',
+  'finance', 'legal', 'community', 'events', 'content', 'sales', 'training', 'vendors', 'quality',
+  'reliability',
+];
+
+const WORDS = [
+  'account', 'action', 'agenda', 'alert', 'api', 'approach', 'asset', 'audit', 'backlog', 'baseline',
+  'batch', 'benchmark', 'budget', 'cache', 'campaign', 'capacity', 'channel', 'checklist', 'client',
+  'cluster', 'cohort', 'contract', 'cost', 'customer', 'dashboard', 'dataset', 'deadline', 'decision',
+  'dependency', 'deploy', 'draft', 'estimate', 'feature', 'flow', 'forecast', 'framework', 'funnel',
+  'goal', 'guideline', 'hypothesis', 'incident', 'index', 'insight', 'integration', 'interview',
+  'issue', 'journey', 'kpi', 'latency', 'launch', 'lead', 'ledger', 'library', 'limit', 'log',
+  'meeting', 'metric', 'migration', 'milestone', 'model', 'module', 'monitor', 'network', 'note',
+  'objective', 'outline', 'owner', 'pattern', 'persona', 'pipeline', 'plan', 'policy', 'priority',
+  'process', 'proposal', 'prototype', 'query', 'queue', 'question', 'quota', 'rollout', 'review',
+  'risk', 'schedule', 'schema', 'scope', 'segment', 'service', 'signal', 'sketch', 'snapshot',
+  'spec', 'sprint', 'stakeholder', 'summary', 'survey', 'task', 'template', 'threshold', 'ticket',
+  'timeline', 'token', 'tradeoff', 'trend', 'update', 'usage', 'user', 'vendor', 'version',
+  'vision', 'workflow', 'workshop',
+];
+
+const KEYWORDS_PER_TOPIC = 8;
+const TOPIC_WORD_SHARE = 0.4;
+const CONTENT_WORDS = [20, 60];
+
+export interface SyntheticWorkspaceOptions {
+  nodes: number;
+  seed?: number;
+}
+
+export interface SyntheticNode {
+  id: string;
+  index: number;
+  topic: number;
+  title: string;
+  content: Record<string, unknown>;
+  tags: string[];
+  x: number;
+  y: number;
+}
+
+export interface SyntheticEdge {
+  source: string;
+  target: string;
+  similarity: number | null;
+}
+
+export interface SyntheticTopic {
+  name: string;
+  keywords: string[];
+}
+
+export interface SyntheticWorkspace {
+  seed: number;
+  topics: SyntheticTopic[];
+  nodes: SyntheticNode[];
+  edges: SyntheticEdge[];
+  // 1536-d unit vector of node `index`, rebuilt from the seed each call
+  embedding(index: number): Float32Array;
+}
+
+// mulberry32 - small, fast and good enough for test data
+export function createRandom(seed: number): () => number {
+  let state = seed >>> 0;
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+function mixSeed(seed: number, salt: number): number {
+  let h = (seed ^ Math.imul(salt + 1, 0x9e3779b1)) >>> 0;
+  h = Math.imul(h ^ (h >>> 16), 0x85ebca6b);
+  h = Math.imul(h ^ (h >>> 13), 0xc2b2ae35);
+  return (h ^ (h >>> 16)) >>> 0;
+}
+
+function gaussian(random: () => number): number {
+  // Box-Muller; 1 - random() keeps log() away from 0
+  return Math.sqrt(-2 * Math.log(1 - random())) * Math.cos(2 * Math.PI * random());
+}
+
+function randomUnitVector(random: () => number, dim: number): Float32Array {
+  const vector = new Float32Array(dim);
+  let norm = 0;
+  for (let d = 0; d < dim; d++) {
+    vector[d] = gaussian(random);
+    norm += vector[d] * vector[d];
+  }
+  norm = Math.sqrt(norm);
+  for (let d = 0; d < dim; d++) vector[d] /= norm;
+  return vector;
+}
+
+function pick<T>(random: () => number, items: T[]): T {
+  return items[Math.floor(random() * items.length)];
+}
+
+function capitalize(word: string): string {
+  return word.charAt(0).toUpperCase() + word.slice(1);
+}
+
+/**
+ * Build a synthetic workspace in memory (ids included, nothing is written)
+ */
+export function generateSyntheticWorkspace(options: SyntheticWorkspaceOptions): SyntheticWorkspace {
+  const seed = options.seed ?? 1;
+  const count = options.nodes;
+  const random = createRandom(seed);
+  const dim = SYNTHETIC_EMBEDDING_DIMENSION;
+
+  // Topics: ~sqrt(n)/2 of them, Zipf-sized (weight 1/rank)
+  const topicCount = Math.max(4, Math.min(TOPIC_NAMES.length * 4, Math.round(Math.sqrt(count) / 2)));
+  const topics: SyntheticTopic[] = [];
+  for (let t = 0; t < topicCount; t++) {
+    const base = TOPIC_NAMES[t % TOPIC_NAMES.length];
+    const name = t < TOPIC_NAMES.length ? base : `${base}-${Math.floor(t / TOPIC_NAMES.length) + 1}`;
+    const keywords = new Set<string>();
+    while (keywords.size < KEYWORDS_PER_TOPIC) keywords.add(pick(random, WORDS));
+    topics.push({ name, keywords: Array.from(keywords) });
+  }
+  const totalWeight = topics.reduce((sum, _, t) => sum + 1 / (t + 1), 0);
+  const cumulative: number[] = [];
+  let running = 0;
+  for (let t = 0; t < topicCount; t++) {
+    running += 1 / (t + 1) / totalWeight;
+    cumulative.push(running);
+  }
+  const sampleTopic = () => {
+    const r = random();
+    const t = cumulative.findIndex((c) => r < c);
+    return t === -1 ? topicCount - 1 : t;
+  };
+
+  const shared = randomUnitVector(createRandom(mixSeed(seed, -1)), dim);
+  const centroids = topics.map((_, t) => randomUnitVector(createRandom(mixSeed(seed, -2 - t)), dim));
+  // Per-node topic strength - spreads same-topic similarity instead of one fixed value
+  const strength = new Float32Array(count);
+
+  // Topic positions on a grid, nodes scattered around their topic's centre
+  const gridColumns = Math.ceil(Math.sqrt(topicCount));
+  const topicSpacing = 400 * Math.sqrt(count / topicCount) + 1500;
+
+  const nodes: SyntheticNode[] = [];
+  const members: number[][] = topics.map(() => []);
+  for (let i = 0; i < count; i++) {
+    const topic = sampleTopic();
+    const { name, keywords } = topics[topic];
+    strength[i] = 0.7 + random() * 0.6;
+
+    const words: string[] = [];
+    const wordCount = CONTENT_WORDS[0] + Math.floor(random() * (CONTENT_WORDS[1] - CONTENT_WORDS[0]));
+    for (let w = 0; w < wordCount; w++) {
+      words.push(random() < TOPIC_WORD_SHARE ? pick(random, keywords) : pick(random, WORDS));
+    }
+    const title = `${capitalize(name)} ${pick(random, keywords)} ${pick(random, WORDS)} ${i + 1}`;
+    const tags = random() < 0.5 ? [name, pick(random, keywords)] : [name];
+
+    const spread = 150 * Math.sqrt(Math.max(1, count / topicCount));
+    nodes.push({
+      id: randomUUIDFrom(random),
+      index: i,
+      topic,
+      title,
+      content: {
+        type: 'doc',
+        content: [{ type: 'paragraph', content: [{ type: 'text', text: `${capitalize(words.join(' '))}.` }] }],
+      },
+      tags,
+      x: (topic % gridColumns) * topicSpacing + gaussian(random) * spread,
+      y: Math.floor(topic / gridColumns) * topicSpacing + gaussian(random) * spread,
+    });
+    members[topic].push(i);
+  }
+
+  // Expected cosine of two nodes: shared part + topic part if they share a topic, over the norms
+  const expectedSimilarity = (a: number, b: number) => {
+    const same = nodes[a].topic === nodes[b].topic;
+    const topicA = TOPIC_WEIGHT * strength[a];
+    const topicB = TOPIC_WEIGHT * strength[b];
+    const normA = Math.sqrt(SHARED_WEIGHT ** 2 + topicA ** 2 + NOISE_WEIGHT ** 2);
+    const normB = Math.sqrt(SHARED_WEIGHT ** 2 + topicB ** 2 + NOISE_WEIGHT ** 2);
+    return (SHARED_WEIGHT ** 2 + (same ? topicA * topicB : 0)) / (normA * normB);
+  };
+
+  // Edges: heavy-tailed out-degree (Pareto, mean ~1.5) towards earlier nodes
+  const edges: SyntheticEdge[] = [];
+  const seen = new Set<number>();
+  const topicPosition = new Int32Array(count);
+  members.forEach((list) => list.forEach((i, position) => (topicPosition[i] = position)));
+  // Endpoints of a topic's edges so far - sampling from it is preferential attachment
+  const endpoints: number[][] = topics.map(() => []);
+
+  for (let i = 1; i < count; i++) {
+    const degree = Math.min(MAX_OUT_DEGREE, Math.floor(0.75 / Math.pow(1 - random(), 1 / 1.6)));
+    const topic = nodes[i].topic;
+    const earlierInTopic = topicPosition[i];
+
+    for (let e = 0; e < degree; e++) {
+      let j: number;
+      const sameTopic = earlierInTopic > 0 && random() < SAME_TOPIC_EDGE_SHARE;
+      if (sameTopic) {
+        const pool = endpoints[topic];
+        j = pool.length > 0 && random() < PREFERENTIAL_SHARE
+          ? pick(random, pool)
+          : members[topic][Math.floor(random() * earlierInTopic)];
+      } else {
+        j = Math.floor(random() * i);
+      }
+      if (j === i) continue;
+
+      const low = Math.min(i, j);
+      const high = Math.max(i, j);
+      const key = low * count + high;
+      if (seen.has(key)) continue;
+      seen.add(key);
+
+      const similarity = sameTopic && random() < SIMILARITY_EDGE_SHARE
+        ? Math.round(expectedSimilarity(i, j) * 1000) / 1000
+        : null;
+      edges.push({ source: nodes[i].id, target: nodes[j].id, similarity });
+      if (sameTopic) endpoints[topic].push(i, j);
+    }
+  }
+
+  const embedding = (index: number) => {
+    const noise = createRandom(mixSeed(seed, index));
+    const centroid = centroids[nodes[index].topic];
+    const topicWeight = TOPIC_WEIGHT * strength[index];
+    const vector = new Float32Array(dim);
+    let norm = 0;
+    for (let d = 0; d < dim; d++) {
+      // Noise is a random direction of length ~NOISE_WEIGHT
+      vector[d] = SHARED_WEIGHT * shared[d] + topicWeight * centroid[d] + (NOISE_WEIGHT / Math.sqrt(dim)) * gaussian(noise);
+      norm += vector[d] * vector[d];
+    }
+    norm = Math.sqrt(norm);
+    for (let d = 0; d < dim; d++) vector[d] /= norm;
+    return vector;
+  };
+
+  return { seed, topics, nodes, edges, embedding };
+}
+
+// UUID v4 from the seeded generator, so ids are reproducible too
+function randomUUIDFrom(random: () => number): string {
+  const bytes = new Uint8Array(16);
+  for (let i = 0; i < 16; i++) bytes[i] = Math.floor(random() * 256);
+  bytes[6] = (bytes[6] & 0x0f) | 0x40;
+  bytes[8] = (bytes[8] & 0x3f) | 0x80;
+  const hex = Array.from(bytes, (b) => b.toString(16).padStart(2, '0')).join('');
+  return `${hex.slice(0, 8)}-${hex.slice(8, 12)}-${hex.slice(12, 16)}-${hex.slice(16, 20)}-${hex.slice(20)}`;
+}
+
+export interface InsertSyntheticOptions {
+  prisma: PrismaClient;
+  // lib/db-server storeNodeEmbeddings; omitted = no embeddings
+  storeNodeEmbeddings?: (entries: Array<{ id: string; embedding: ArrayLike<number> }>, chunkSize?: number) => Promise<number>;
+  ownerId: string;
+  name: string;
+  onProgress?: (stage: 'nodes' | 'embeddings' | 'edges', done: number, total: number) => void;
+}
+
+/**
+ * Write a synthetic workspace (workspace, owner membership, nodes, embeddings, edges)
+ * Node ids are the generated ones when they are free; a second insert of the same seed
+ * gets fresh ids. Returns the workspace id and the ids actually used, by node index.
+ */
+export async function insertSyntheticWorkspace(
+  workspace: SyntheticWorkspace,
+  options: InsertSyntheticOptions
+): Promise<{ workspaceId: string; nodeIds: string[] }> {
+  const { prisma, ownerId } = options;
+
+  const existing = await prisma.node.count({ where: { id: workspace.nodes[0]?.id } });
+  const idMap = new Map<string, string>();
+  const nodeIds = workspace.nodes.map((node) => {
+    const id = existing > 0 ? randomUUID() : node.id;
+    idMap.set(node.id, id);
+    return id;
+  });
+
+  const created = await prisma.workspace.create({ data: { name: options.name, ownerId } });
+  await prisma.workspaceMember.create({ data: { workspaceId: created.id, userId: ownerId, role: 'owner' } });
+
+  for (let i = 0; i < workspace.nodes.length; i += NODE_INSERT_CHUNK) {
+    const chunk = workspace.nodes.slice(i, i + NODE_INSERT_CHUNK);
+    await prisma.node.createMany({
+      data: chunk.map((node) => ({
+        id: nodeIds[node.index],
+        workspaceId: created.id,
+        title: node.title,
+        content: node.content as any,
+        tags: node.tags,
+        x: node.x,
+        y: node.y,
+      })),
+    });
+    options.onProgress?.('nodes', Math.min(i + NODE_INSERT_CHUNK, workspace.nodes.length), workspace.nodes.length);
+  }
+
+  if (options.storeNodeEmbeddings) {
+    for (let i = 0; i < workspace.nodes.length; i += EMBEDDING_INSERT_CHUNK) {
+      const chunk = workspace.nodes.slice(i, i + EMBEDDING_INSERT_CHUNK);
+      await options.storeNodeEmbeddings(
+        chunk.map((node) => ({ id: nodeIds[node.index], embedding: workspace.embedding(node.index) })),
+        EMBEDDING_INSERT_CHUNK
+      );
+      options.onProgress?.('embeddings', Math.min(i + EMBEDDING_INSERT_CHUNK, workspace.nodes.length), workspace.nodes.length);
+    }
+  }
+
+  for (let i = 0; i < workspace.edges.length; i += EDGE_INSERT_CHUNK) {
+    const chunk = workspace.edges.slice(i, i + EDGE_INSERT_CHUNK);
+    await prisma.edge.createMany({
+      data: chunk.map((edge) => {
+        const source = idMap.get(edge.source)!;
+        const target = idMap.get(edge.target)!;
+        // Similarity edges are stored canonically (source < target), like auto-link does
+        const [s, t] = edge.similarity !== null && source > target ? [target, source] : [source, target];
+        return { workspaceId: created.id, source: s, target: t, label: null, similarity: edge.similarity };
+      }),
+      skipDuplicates: true,
+    });
+    options.onProgress?.('edges', Math.min(i + EDGE_INSERT_CHUNK, workspace.edges.length), workspace.edges.length);
+  }
+
+  return { workspaceId: created.id, nodeIds };
+}
@@ -4,27 +4,41 @@ import { create } from 'zustand';
 import type { Node } from '@/types/Node';
 import type { Edge } from '@/types/Edge';
 
-export type HistoryAction = 
+// Operation log for undo/redo
+// - updates store only the fields that changed (before and after), moves store positions as
+//   packed x,y pairs in Float64Arrays - an auto-organize of the whole graph is one compact entry
+// - consecutive edits of the same node(s) within MERGE_WINDOW_MS collapse into one entry, so a
+//   series of nudges or keystrokes undoes in one step
+// - past + future are capped by entry count and by an estimated memory budget; the oldest
+//   entries go first (the newest one is always kept)
+
+export type HistoryAction =
   | { type: 'create_node'; node: Node }
   | { type: 'delete_node'; node: Node }
   | { type: 'update_node'; nodeId: string; before: Partial<Node>; after: Partial<Node> }
+  // before/after: x, y per node id, in nodeIds order
+  | { type: 'move_nodes'; nodeIds: string[]; before: Float64Array; after: Float64Array }
   | { type: 'create_edge'; edge: Edge }
-  | { type: 'delete_edge'; edge: Edge }
-  | { type: 'update_nodes'; nodes: Node[] }
-  | { type: 'update_edges'; edges: Edge[] };
+  | { type: 'delete_edge'; edge: Edge };
 
 export interface HistoryEntry {
   id: string;
   action: HistoryAction;
   timestamp: Date;
   description: string;
+  bytes: number; // Estimated size, counted against HISTORY_BUDGET_BYTES
 }
 
+const MAX_HISTORY_ENTRIES = 200;
+const HISTORY_BUDGET_BYTES = 4 * 1024 * 1024;
+const MERGE_WINDOW_MS = 1500;
+
 interface HistoryStore {
   past: HistoryEntry[];
   future: HistoryEntry[];
   isRecording: boolean;
-  
+  bytes: number; // Estimated size of past + future
+
   // Actions
   recordAction: (action: HistoryAction, description: string) => void;
   undo: () => HistoryEntry | null;
@@ -57,88 +71,159 @@ function getActionDescription(action: HistoryAction): string {
         return `Moved node "${action.after.title || action.nodeId}"`;
       }
       return `Updated node "${action.after.title || action.nodeId}"`;
+    case 'move_nodes':
+      return `Moved ${action.nodeIds.length} node(s)`;
     case 'create_edge':
       return `Created connection`;
     case 'delete_edge':
       return `Deleted connection`;
-    case 'update_nodes':
-      return `Updated ${action.nodes.length} node(s)`;
-    case 'update_edges':
-      return `Updated ${action.edges.length} connection(s)`;
     default:
       return 'Unknown action';
   }
 }
 
+// Snapshots don't need the embedding - the server keeps it and recomputes it on re-create
+function withoutEmbedding(node: Node): Node {
+  if (node.embedding === undefined) return node;
+  const rest = { ...node };
+  delete rest.embedding;
+  return rest;
+}
+
+function compactAction(action: HistoryAction): HistoryAction {
+  switch (action.type) {
+    case 'create_node':
+    case 'delete_node':
+      return { ...action, node: withoutEmbedding(action.node) };
+    default:
+      return action;
+  }
+}
+
+// UTF-16 string sizes plus typed array bytes - close enough to budget by
+function estimateBytes(action: HistoryAction): number {
+  if (action.type === 'move_nodes') {
+    return action.before.byteLength + action.after.byteLength +
+      action.nodeIds.reduce((sum, id) => sum + id.length * 2, 0);
+  }
+  return JSON.stringify(action).length * 2;
+}
+
+function sameIds(a: string[], b: string[]): boolean {
+  return a.length === b.length && a.every((id, i) => id === b[i]);
+}
+
+function sameKeys(a: object, b: object): boolean {
+  const aKeys = Object.keys(a);
+  const bKeys = Object.keys(b);
+  return aKeys.length === bKeys.length && aKeys.every((key) => key in b);
+}
+
+// One action covering `previous` then `next`, or null if they are unrelated
+function mergeActions(previous: HistoryAction, next: HistoryAction): HistoryAction | null {
+  if (previous.type === 'move_nodes' && next.type === 'move_nodes' && sameIds(previous.nodeIds, next.nodeIds)) {
+    return { ...next, before: previous.before };
+  }
+  if (
+    previous.type === 'update_node' &&
+    next.type === 'update_node' &&
+    previous.nodeId === next.nodeId &&
+    sameKeys(previous.after, next.after)
+  ) {
+    return { ...next, before: previous.before };
+  }
+  return null;
+}
+
+// Drop the oldest entries until both caps hold
+function trimToBudget(past: HistoryEntry[], bytes: number) {
+  let start = 0;
+  while ((past.length - start > MAX_HISTORY_ENTRIES || bytes > HISTORY_BUDGET_BYTES) && start < past.length - 1) {
+    bytes -= past[start++].bytes;
+  }
+  return { past: start > 0 ? past.slice(start) : past, bytes };
+}
+
 export const useHistoryStore = create<HistoryStore>((set, get) => ({
   past: [],
   future: [],
   isRecording: true,
-  
+  bytes: 0,
+
   recordAction: (action, description) => {
     const state = get();
     if (!state.isRecording) return;
-    
+
+    const compact = compactAction(action);
+    const timestamp = new Date();
+    const last = state.past[state.past.length - 1];
+    const merged =
+      last && timestamp.getTime() - last.timestamp.getTime() < MERGE_WINDOW_MS
+        ? mergeActions(last.action, compact)
+        : null;
+
+    const entryAction = merged || compact;
     const entry: HistoryEntry = {
-      id: generateHistoryId(),
-      action,
-      timestamp: new Date(),
-      description: description || getActionDescription(action),
+      id: merged ? last.id : generateHistoryId(),
+      action: entryAction,
+      timestamp,
+      description: description || getActionDescription(entryAction),
+      bytes: estimateBytes(entryAction),
     };
-    
-    set((state) => ({
-      past: [...state.past, entry].slice(-50), // Keep last 50 actions
-      future: [], // Clear future when new action is recorded
-    }));
+
+    // Recording clears future (redo is no longer possible)
+    const futureBytes = state.future.reduce((sum, e) => sum + e.bytes, 0);
+    const past = merged ? [...state.past.slice(0, -1), entry] : [...state.past, entry];
+    const bytes = state.bytes - futureBytes - (merged ? last.bytes : 0) + entry.bytes;
+    set({ ...trimToBudget(past, bytes), future: [] });
   },
-  
+
   undo: () => {
     const state = get();
     if (state.past.length === 0) return null;
-    
+
     const lastEntry = state.past[state.past.length - 1];
-    
+
     set((state) => ({
       past: state.past.slice(0, -1),
       future: [lastEntry, ...state.future],
     }));
-    
+
     return lastEntry;
   },
-  
+
   redo: () => {
     const state = get();
     if (state.future.length === 0) return null;
-    
+
     const firstEntry = state.future[0];
-    
+
     set((state) => ({
       past: [...state.past, firstEntry],
       future: state.future.slice(1),
     }));
-    
+
     return firstEntry;
   },
-  
+
   canUndo: () => {
     return get().past.length > 0;
   },
-  
+
   canRedo: () => {
     return get().future.length > 0;
   },
-  
+
   clearHistory: () => {
-    set({ past: [], future: [] });
+    set({ past: [], future: [], bytes: 0 });
   },
-  
+
   setRecording: (recording) => {
     set({ isRecording: recording });
   },
-  
+
   getHistory: () => {
     const state = get();
     return [...state.past].reverse(); // Most recent first
   },
 }));
-
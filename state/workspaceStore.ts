@@ -1,98 +1,352 @@
 'use client';
 
 import { create } from 'zustand';
-import type { Workspace } from '@/types/Workspace';
-import type { Node } from '@/types/Node';
+import { useShallow } from 'zustand/react/shallow';
+import type { Workspace, WorkspaceGraphDelta } from '@/types/Workspace';
+import type { Node, NodePosition } from '@/types/Node';
 import type { Edge } from '@/types/Edge';
+import type { TileSummary } from '@/lib/viewportTiles';
+import { emitGraphOps, type GraphOp } from '@/lib/collabOps';
 import { useHistoryStore, type HistoryAction } from './historyStore';
 
 interface WorkspaceStore {
   currentWorkspace: Workspace | null;
   nodes: Node[];
   edges: Edge[];
+  // id -> position in `nodes`. Replaced only when nodes are added, removed or reordered, so
+  // edits swap a single slot and per-node selectors (useWorkspaceNode) stay O(1)
+  nodeIndex: Map<string, number>;
   layout: 'force-directed' | 'radial' | 'hierarchical' | 'semantic';
+  graphVersion: number | null; // Server graph version the nodes/edges reflect (for ?since= sync)
+  // Windowed loading (large workspaces): nodes/edges hold only the loaded tiles
+  windowed: boolean;
+  tileSummaries: TileSummary[]; // Per-tile aggregates, drawn for tiles not loaded yet
+  loadedTiles: Set<string>;
+  tileGeneration: number; // Bumped on every windowed (re)load - stale tile responses are dropped
   
   // Actions
   setWorkspace: (workspace: Workspace | null) => void;
+  setGraphVersion: (version: number | null) => void;
+  applyGraphDelta: (delta: WorkspaceGraphDelta) => void;
   setNodes: (nodes: Node[]) => void;
   setEdges: (edges: Edge[]) => void;
+  setWindowedGraph: (summaries: TileSummary[] | null) => void;
+  mergeGraphTiles: (tiles: string[], nodes: Node[], edges: Edge[], version: number) => void;
+  applyRemoteOps: (ops: GraphOp[]) => void;
   addNode: (node: Node) => void;
-  updateNode: (id: string, updates: Partial<Node>) => void;
+  // broadcast: false for changes that reach collaborators another way (rich text travels
+  // as Yjs updates, lib/nodeDocClient.ts)
+  updateNode: (id: string, updates: Partial<Node>, options?: { broadcast?: boolean }) => void;
+  // Several node edits as one store update - subscribers are notified once
+  updateNodes: (changes: NodeChange[], options?: { broadcast?: boolean; record?: boolean }) => void;
+  updateNodePositions: (positions: NodePosition[]) => void;
   deleteNode: (id: string) => void;
   addEdge: (edge: Edge) => void;
   deleteEdge: (id: string) => void;
   setLayout: (layout: 'force-directed' | 'radial' | 'hierarchical' | 'semantic') => void;
 }
 
+export interface NodeChange {
+  id: string;
+  updates: Partial<Node>;
+}
+
+function indexNodes(nodes: Node[]): Map<string, number> {
+  const index = new Map<string, number>();
+  nodes.forEach((node, i) => index.set(node.id, i));
+  return index;
+}
+
+// Structural sharing: only the changed slots get new objects, every other node keeps its
+// identity (React Flow and memoized rows skip it). Returns `nodes` itself if nothing matched
+function patchNodes(nodes: Node[], nodeIndex: Map<string, number>, changes: NodeChange[]): Node[] {
+  let next = nodes;
+  for (const { id, updates } of changes) {
+    const i = nodeIndex.get(id);
+    if (i === undefined) continue;
+    if (next === nodes) next = nodes.slice();
+    next[i] = { ...next[i], ...updates };
+  }
+  return next;
+}
+
+// History keeps only the fields the update touches, before and after
+function recordNodeUpdate(node: Node, updates: Partial<Node>) {
+  const historyStore = useHistoryStore.getState();
+  if (!historyStore.isRecording) return;
+  const before: Partial<Node> = {};
+  for (const key of Object.keys(updates) as Array<keyof Node>) {
+    (before as Record<string, unknown>)[key] = node[key];
+  }
+  historyStore.recordAction(
+    { type: 'update_node', nodeId: node.id, before, after: updates },
+    `Updated node "${node.title}"`
+  );
+}
+
 export const useWorkspaceStore = create<WorkspaceStore>((set) => ({
   currentWorkspace: null,
   nodes: [],
   edges: [],
+  nodeIndex: new Map(),
   layout: 'force-directed',
+  graphVersion: null,
+  windowed: false,
+  tileSummaries: [],
+  loadedTiles: new Set(),
+  tileGeneration: 0,
 
   setWorkspace: (workspace) => set({ currentWorkspace: workspace }),
 
-  setNodes: (nodes) => set({ nodes }),
+  setGraphVersion: (graphVersion) => set({ graphVersion }),
+
+  // Merge a server delta in place: unchanged nodes/edges keep their object identity,
+  // so memoized components and React Flow only see the rows that actually changed
+  applyGraphDelta: (delta) => {
+    return set((state) => {
+      const changes: Partial<WorkspaceStore> = { graphVersion: delta.version };
+      const deletedNodes = new Set(delta.deletedNodeIds);
+
+      if (delta.nodes.length > 0 || deletedNodes.size > 0) {
+        const upserts = new Map(delta.nodes.map((node) => [node.id, node]));
+        const nodes: Node[] = [];
+        for (const node of state.nodes) {
+          if (deletedNodes.has(node.id)) continue;
+          const updated = upserts.get(node.id);
+          if (updated) {
+            // Keep client-only fields (width/height/rotation) that the server doesn't send
+            nodes.push({ ...node, ...updated });
+            upserts.delete(node.id);
+          } else {
+            nodes.push(node);
+          }
+        }
+        upserts.forEach((node) => nodes.push(node));
+        changes.nodes = nodes;
+        changes.nodeIndex = indexNodes(nodes);
+      }
+
+      if (delta.edges.length > 0 || delta.deletedEdgeIds.length > 0 || deletedNodes.size > 0) {
+        const upserts = new Map(delta.edges.map((edge) => [edge.id, edge]));
+        const deletedEdges = new Set(delta.deletedEdgeIds);
+        const edges: Edge[] = [];
+        for (const edge of state.edges) {
+          if (deletedEdges.has(edge.id)) continue;
+          if (deletedNodes.has(edge.source) || deletedNodes.has(edge.target)) continue;
+          const updated = upserts.get(edge.id);
+          if (updated) {
+            edges.push(updated);
+            upserts.delete(edge.id);
+          } else {
+            edges.push(edge);
+          }
+        }
+        upserts.forEach((edge) => edges.push(edge));
+        changes.edges = edges;
+      }
+
+      return changes;
+    });
+  },
+
+  setNodes: (nodes) => set({ nodes, nodeIndex: indexNodes(nodes) }),
 
   setEdges: (edges) => set({ edges }),
 
+  // Start (or leave, with null) windowed mode: the graph is emptied and tiles load on demand
+  setWindowedGraph: (summaries) => set((state) => (
+    summaries
+      ? {
+          windowed: true,
+          tileSummaries: summaries,
+          loadedTiles: new Set(),
+          tileGeneration: state.tileGeneration + 1,
+          nodes: [],
+          nodeIndex: new Map(),
+          edges: [],
+        }
+      : state.windowed
+        ? { windowed: false, tileSummaries: [], loadedTiles: new Set(), tileGeneration: state.tileGeneration + 1 }
+        : {}
+  )),
+
+  // Add a page of tiles. Rows already in the store are kept - delta sync keeps those current,
+  // and they may carry newer local edits. If the tiles were read at an older version than the
+  // store has, the sync version steps back so the next delta replays anything (e.g. a delete)
+  // that happened in between; deltas are idempotent.
+  mergeGraphTiles: (tiles, nodes, edges, version) => set((state) => {
+    const loadedTiles = new Set(state.loadedTiles);
+    tiles.forEach((key) => loadedTiles.add(key));
+
+    const edgeIds = new Set(state.edges.map((edge) => edge.id));
+    const newNodes = nodes.filter((node) => !state.nodeIndex.has(node.id));
+    const newEdges = edges.filter((edge) => !edgeIds.has(edge.id));
+
+    let nodeIndex = state.nodeIndex;
+    if (newNodes.length > 0) {
+      nodeIndex = new Map(nodeIndex);
+      newNodes.forEach((node, i) => nodeIndex.set(node.id, state.nodes.length + i));
+    }
+
+    return {
+      loadedTiles,
+      nodes: newNodes.length > 0 ? [...state.nodes, ...newNodes] : state.nodes,
+      nodeIndex,
+      edges: newEdges.length > 0 ? [...state.edges, ...newEdges] : state.edges,
+      graphVersion:
+        state.graphVersion !== null && version < state.graphVersion ? version : state.graphVersion,
+    };
+  }),
+
+  // Ops from other members (collaboration channel). Not recorded in history and not
+  // re-broadcast; the next delta sync replaces them with the persisted rows
+  applyRemoteOps: (ops) => set((state) => {
+    let nodes = state.nodes;
+    let edges = state.edges;
+    // Copied on the first create, rebuilt after removals
+    let nodeIndex = state.nodeIndex;
+    const writableIndex = () => {
+      if (nodeIndex === state.nodeIndex) nodeIndex = new Map(nodeIndex);
+      return nodeIndex;
+    };
+    const writableNodes = () => {
+      if (nodes === state.nodes) nodes = nodes.slice();
+      return nodes;
+    };
+
+    for (const op of ops) {
+      switch (op.op) {
+        case 'move':
+        case 'node': {
+          const id = op.op === 'move' ? op.id : op.node.id;
+          const fields = op.op === 'move' ? { x: op.x, y: op.y } : op.node;
+          const index = nodeIndex.get(id);
+          if (index !== undefined) {
+            writableNodes()[index] = { ...nodes[index], ...fields };
+          } else if (op.op === 'node' && typeof op.node.title === 'string' && typeof op.node.x === 'number') {
+            // A create - edits to nodes we don't hold (unloaded tiles) are skipped
+            writableNodes().push(op.node as Node);
+            writableIndex().set(id, nodes.length - 1);
+          }
+          break;
+        }
+        case 'delete_node':
+          if (!nodeIndex.has(op.id)) break;
+          nodes = nodes.filter((node) => node.id !== op.id);
+          nodeIndex = indexNodes(nodes);
+          edges = edges.filter((edge) => edge.source !== op.id && edge.target !== op.id);
+          break;
+        case 'edge':
+          edges = [...edges.filter((edge) => edge.id !== op.edge.id), op.edge];
+          break;
+        case 'delete_edge':
+          edges = edges.filter((edge) => edge.id !== op.id);
+          break;
+      }
+    }
+
+    return nodes === state.nodes && edges === state.edges ? {} : { nodes, nodeIndex, edges };
+  }),
+
   addNode: (node) => {
-    console.log('[WorkspaceStore] Adding node:', node);
     // Record history action
     const historyStore = useHistoryStore.getState();
     historyStore.recordAction(
       { type: 'create_node', node },
       `Created node "${node.title}"`
     );
+    emitGraphOps([{ op: 'node', node }]);
     
     return set((state) => {
-      // Check if node already exists to avoid duplicates
-      if (state.nodes.some(n => n.id === node.id)) {
-        console.log('[WorkspaceStore] Node already exists, updating instead:', node.id);
-        return {
-          nodes: state.nodes.map(n => n.id === node.id ? node : n),
-        };
+      // Node already exists (e.g. delta sync got there first) - replace it in place
+      const index = state.nodeIndex.get(node.id);
+      if (index !== undefined) {
+        const nodes = state.nodes.slice();
+        nodes[index] = node;
+        return { nodes };
       }
-      console.log('[WorkspaceStore] Adding new node, total nodes:', state.nodes.length + 1);
+      const nodeIndex = new Map(state.nodeIndex);
+      nodeIndex.set(node.id, state.nodes.length);
       return {
         nodes: [...state.nodes, node],
+        nodeIndex,
       };
     });
   },
 
-  updateNode: (id, updates) => {
-    console.log('[WorkspaceStore] Updating node:', id, updates);
-    
-    // Record history action - get the before state
+  updateNode: (id, updates, options = {}) => {
     return set((state) => {
-      const beforeNode = state.nodes.find((node) => node.id === id);
-      if (beforeNode && useHistoryStore.getState().isRecording) {
-        const historyStore = useHistoryStore.getState();
-        const before: Partial<Node> = {
-          title: beforeNode.title,
-          content: beforeNode.content,
-          tags: beforeNode.tags,
-          x: beforeNode.x,
-          y: beforeNode.y,
-        };
-        historyStore.recordAction(
-          { type: 'update_node', nodeId: id, before, after: updates },
-          `Updated node "${beforeNode.title}"`
-        );
+      const index = state.nodeIndex.get(id);
+      if (index !== undefined) recordNodeUpdate(state.nodes[index], updates);
+
+      if (options.broadcast !== false) {
+        emitGraphOps([{ op: 'node', node: { ...updates, id } }]);
       }
-      
-      const updatedNodes = state.nodes.map((node) =>
-        node.id === id ? { ...node, ...updates } : node
+      const nodes = patchNodes(state.nodes, state.nodeIndex, [{ id, updates }]);
+      return nodes === state.nodes ? {} : { nodes };
+    });
+  },
+
+  updateNodes: (changes, options = {}) => {
+    if (changes.length === 0) return;
+    return set((state) => {
+      if (options.record !== false) {
+        for (const { id, updates } of changes) {
+          const index = state.nodeIndex.get(id);
+          if (index !== undefined) recordNodeUpdate(state.nodes[index], updates);
+        }
+      }
+      if (options.broadcast !== false) {
+        emitGraphOps(changes.map(({ id, updates }) => ({ op: 'node', node: { ...updates, id } })));
+      }
+      const nodes = patchNodes(state.nodes, state.nodeIndex, changes);
+      return nodes === state.nodes ? {} : { nodes };
+    });
+  },
+
+  // Apply many position changes in a single store update (drag of a selection, auto-organize)
+  // Recorded as one packed move_nodes entry; positions are persisted through nodeUpdateQueue
+  updateNodePositions: (positions) => {
+    if (positions.length === 0) return;
+    emitGraphOps(positions.map((p) => ({ op: 'move', id: p.id, x: p.x, y: p.y })));
+    return set((state) => {
+      const historyStore = useHistoryStore.getState();
+      if (historyStore.isRecording) {
+        const nodeIds: string[] = [];
+        const before: number[] = [];
+        const after: number[] = [];
+        for (const p of positions) {
+          const index = state.nodeIndex.get(p.id);
+          if (index === undefined) continue;
+          const node = state.nodes[index];
+          if (node.x === p.x && node.y === p.y) continue;
+          nodeIds.push(p.id);
+          before.push(node.x, node.y);
+          after.push(p.x, p.y);
+        }
+        if (nodeIds.length > 0) {
+          const title = state.nodes[state.nodeIndex.get(nodeIds[0])!].title;
+          historyStore.recordAction(
+            { type: 'move_nodes', nodeIds, before: Float64Array.from(before), after: Float64Array.from(after) },
+            nodeIds.length === 1 ? `Moved node "${title}"` : `Moved ${nodeIds.length} nodes`
+          );
+        }
+      }
+
+      const nodes = patchNodes(
+        state.nodes,
+        state.nodeIndex,
+        positions.map((p) => ({ id: p.id, updates: { x: p.x, y: p.y } }))
       );
-      console.log('[WorkspaceStore] Node updated, new nodes count:', updatedNodes.length);
-      return { nodes: updatedNodes };
+      return nodes === state.nodes ? {} : { nodes };
     });
   },
 
   deleteNode: (id) => {
     // Record history action - get the node before deletion
     return set((state) => {
-      const nodeToDelete = state.nodes.find((node) => node.id === id);
+      const index = state.nodeIndex.get(id);
+      const nodeToDelete = index === undefined ? undefined : state.nodes[index];
       if (nodeToDelete && useHistoryStore.getState().isRecording) {
         const historyStore = useHistoryStore.getState();
         historyStore.recordAction(
@@ -100,9 +354,12 @@ export const useWorkspaceStore = create<WorkspaceStore>((set) => ({
           `Deleted node "${nodeToDelete.title}"`
         );
       }
+      emitGraphOps([{ op: 'delete_node', id }]);
       
+      const nodes = nodeToDelete ? state.nodes.filter((node) => node.id !== id) : state.nodes;
       return {
-        nodes: state.nodes.filter((node) => node.id !== id),
+        nodes,
+        nodeIndex: nodes === state.nodes ? state.nodeIndex : indexNodes(nodes),
         edges: state.edges.filter(
           (edge) => edge.source !== id && edge.target !== id
         ),
@@ -125,6 +382,7 @@ export const useWorkspaceStore = create<WorkspaceStore>((set) => ({
           'Created connection'
         );
       }
+      emitGraphOps([{ op: 'edge', edge }]);
       
       return { edges: [...state.edges, edge] };
     });
@@ -141,6 +399,7 @@ export const useWorkspaceStore = create<WorkspaceStore>((set) => ({
           'Deleted connection'
         );
       }
+      emitGraphOps([{ op: 'delete_edge', id }]);
       
       return {
         edges: state.edges.filter((edge) => edge.id !== id),
@@ -150,3 +409,40 @@ export const useWorkspaceStore = create<WorkspaceStore>((set) => ({
 
   setLayout: (layout) => set({ layout }),
 }));
+
+// Fine-grained subscriptions. Components that show one node (or a handful) select just those
+// rows instead of the whole `nodes` array, so a drag or edit elsewhere doesn't re-render them
+
+export function selectWorkspaceNode(state: WorkspaceStore, id: string | null | undefined): Node | undefined {
+  if (!id) return undefined;
+  const index = state.nodeIndex.get(id);
+  return index === undefined ? undefined : state.nodes[index];
+}
+
+/**
+ * One node by id - re-renders only when that node changes
+ */
+export function useWorkspaceNode(id: string | null | undefined): Node | undefined {
+  return useWorkspaceStore((state) => selectWorkspaceNode(state, id));
+}
+
+/**
+ * Nodes connected to `id` by an edge - re-renders when the edges or one of those nodes change
+ */
+export function useLinkedNodes(id: string | null | undefined): Node[] {
+  return useWorkspaceStore(
+    useShallow((state) => {
+      if (!id) return [];
+      const linked: Node[] = [];
+      const seen = new Set<string>();
+      for (const edge of state.edges) {
+        const other = edge.source === id ? edge.target : edge.target === id ? edge.source : null;
+        if (!other || other === id || seen.has(other)) continue;
+        seen.add(other);
+        const node = selectWorkspaceNode(state, other);
+        if (node) linked.push(node);
+      }
+      return linked;
+    })
+  );
+}
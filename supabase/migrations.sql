@@ -38,14 +38,18 @@ CREATE TABLE IF NOT EXISTS attachments (
 );
 
 -- Node history table (version control)
+-- Numbered revisions written by the application (lib/nodeRevisions.ts): keyframes hold
+-- {title, content, tags}, the rest a JSON patch against the previous revision.
+-- Older databases: prisma/sql/node_history_revisions.sql converts the trigger-era rows
 CREATE TABLE IF NOT EXISTS node_history (
   id UUID PRIMARY KEY DEFAULT uuid_generate_v4(),
   node_id UUID NOT NULL REFERENCES nodes(id) ON DELETE CASCADE,
-  title TEXT NOT NULL,
-  content JSONB NOT NULL,
-  tags TEXT[],
+  revision INTEGER NOT NULL,
+  keyframe BOOLEAN NOT NULL DEFAULT false,
+  data JSONB NOT NULL,
   created_by UUID REFERENCES profiles(id),
-  created_at TIMESTAMP WITH TIME ZONE DEFAULT NOW()
+  created_at TIMESTAMP WITH TIME ZONE DEFAULT NOW(),
+  UNIQUE (node_id, revision)
 );
 
 -- Activity log table
@@ -377,20 +381,9 @@ BEGIN
 END;
 $$ LANGUAGE plpgsql SECURITY DEFINER;
 
--- Trigger to create node history on update
-CREATE OR REPLACE FUNCTION create_node_history()
-RETURNS TRIGGER AS $$
-BEGIN
-  INSERT INTO node_history (node_id, title, content, tags, created_by)
-  VALUES (OLD.id, OLD.title, OLD.content, OLD.tags, auth.uid());
-  RETURN NEW;
-END;
-$$ LANGUAGE plpgsql SECURITY DEFINER;
-
-CREATE TRIGGER node_history_trigger
-  BEFORE UPDATE ON nodes
-  FOR EACH ROW
-  EXECUTE FUNCTION create_node_history();
+-- Node history is recorded by the application (lib/nodeRevisions.ts), not a trigger
+DROP TRIGGER IF EXISTS node_history_trigger ON nodes;
+DROP FUNCTION IF EXISTS create_node_history();
 
 -- Trigger to update user_preferences updated_at
 CREATE TRIGGER update_user_preferences_updated_at
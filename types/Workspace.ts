@@ -1,3 +1,6 @@
+import type { Node } from './Node';
+import type { Edge } from './Edge';
+
 export interface Workspace {
   id: string;
   ownerId: string;
@@ -10,3 +13,14 @@ export interface WorkspaceMember {
   userId: string;
   role: 'owner' | 'editor' | 'viewer';
 }
+
+// Changes to a workspace graph since a given version (GET /api/workspaces/[id]/graph?since=)
+export interface WorkspaceGraphDelta {
+  version: number; // Pass back as `since` on the next request
+  since: number;
+  reset: boolean; // `since` is too old or unknown - client must do a full reload
+  nodes: Node[]; // Created or updated
+  edges: Edge[]; // Created or updated
+  deletedNodeIds: string[];
+  deletedEdgeIds: string[];
+}